@@ -0,0 +1,167 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+// Load time of an AssetPack of 256 sprite-like 256x256 images per codec, serially and on 1 to 8 threads.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <SDL3/SDL_surface.h>
+
+#include "psyengine/resources/asset_pack.hpp"
+#include "psyengine/utils/thread_pool.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using namespace psyengine::resources;
+
+    constexpr int IMAGES = 256;
+    constexpr int SIZE = 256;
+    constexpr int PASSES = 3;
+
+    using Image = std::vector<Uint32>;
+
+    /// Opaque disc of flat tiles with a little noise on a transparent background, roughly like a sprite.
+    std::vector<Image> Generate()
+    {
+        std::mt19937 rng(1);
+        std::vector<Image> images(IMAGES, Image(static_cast<size_t>(SIZE) * SIZE));
+        constexpr int radius = SIZE / 2 - 8;
+        for (Image& image : images)
+        {
+            const auto base = static_cast<Uint32>(rng());
+            for (int y = 0; y < SIZE; ++y)
+            {
+                for (int x = 0; x < SIZE; ++x)
+                {
+                    const int dx = x - SIZE / 2;
+                    const int dy = y - SIZE / 2;
+                    const auto tile = static_cast<Uint32>((x / 16 + y / 16) & 3);
+                    const auto noise = static_cast<Uint32>(rng()) & 0x03030303U;
+                    const Uint32 color = ((base + tile * 0x101010U) | 0xFF000000U) ^ noise;
+                    image[static_cast<size_t>(y) * SIZE + static_cast<size_t>(x)] =
+                        dx * dx + dy * dy < radius * radius ? color : 0U;
+                }
+            }
+        }
+        return images;
+    }
+
+    bool Matches(const LoadedSurface& loaded, const std::vector<Image>& images)
+    {
+        return loaded.surface->pitch == SIZE * 4 &&
+            std::memcmp(loaded.surface->pixels, images[loaded.index].data(), images[loaded.index].size() * 4) == 0;
+    }
+
+    void Report(const char* label, const size_t loaded, const size_t wrong, const double seconds, const Uint64 bytes)
+    {
+        std::printf("  %-10s %3zu loaded, %zu wrong  %8.2f ms  %7.0f MB/s raw\n", label, loaded, wrong, seconds * 1e3,
+                    static_cast<double>(bytes) / (seconds * 1e6));
+    }
+
+    void Run(const char* name, const PackCompression compression, const std::vector<Image>& images,
+             const std::filesystem::path& path)
+    {
+        AssetPackWriter writer;
+        for (int i = 0; i < IMAGES; ++i)
+        {
+            SDL_Surface* surface = SDL_CreateSurfaceFrom(SIZE, SIZE, SDL_PIXELFORMAT_RGBA8888,
+                                                         const_cast<Uint32*>(images[static_cast<size_t>(i)].data()),
+                                                         SIZE * 4);
+            const bool added = surface != nullptr && writer.add("image" + std::to_string(i), surface, compression);
+            SDL_DestroySurface(surface);
+            if (!added)
+            {
+                std::printf("%s: adding image %d failed\n", name, i);
+                return;
+            }
+        }
+        AssetPack pack;
+        if (!writer.save(path.string()) || !pack.open(path.string()))
+        {
+            std::printf("%s: writing %s failed\n", name, path.string().c_str());
+            return;
+        }
+
+        const Uint64 rawBytes = static_cast<Uint64>(IMAGES) * SIZE * SIZE * 4;
+        std::printf("%s: %.1f MB stored, %.2fx\n", name, static_cast<double>(writer.storedBytes()) / 1e6,
+                    static_cast<double>(rawBytes) / static_cast<double>(writer.storedBytes()));
+
+        // What loading cost before loadSurfaces: one entry after another on the calling thread
+        double best = 1e30;
+        size_t loaded = 0;
+        size_t wrong = 0;
+        for (int pass = 0; pass < PASSES; ++pass)
+        {
+            loaded = 0;
+            wrong = 0;
+            const auto start = Clock::now();
+            for (size_t i = 0; i < pack.entries().size(); ++i)
+            {
+                if (auto surface = pack.loadSurface(i))
+                {
+                    ++loaded;
+                    wrong += Matches(*surface, images) ? 0U : 1U;
+                    SDL_DestroySurface(surface->surface);
+                }
+            }
+            best = std::min(best, std::chrono::duration<double>(Clock::now() - start).count());
+        }
+        Report("serial", loaded, wrong, best, rawBytes);
+
+        const size_t hardware = std::max(1U, std::thread::hardware_concurrency());
+        std::vector<size_t> threadCounts{1, 2, 4, 8};
+        if (std::ranges::find(threadCounts, hardware) == threadCounts.end())
+        {
+            threadCounts.push_back(hardware);
+        }
+        for (const size_t threadCount : threadCounts)
+        {
+            psyengine::utils::ThreadPool threads(threadCount);
+            best = 1e30;
+            for (int pass = 0; pass < PASSES; ++pass)
+            {
+                wrong = 0;
+                loaded = pack.loadSurfaces(threads, [&](LoadedSurface& surface)
+                {
+                    wrong += Matches(surface, images) ? 0U : 1U;
+                    SDL_DestroySurface(surface.surface);
+                });
+                best = std::min(best, pack.lastLoadStats().wallTime);
+            }
+            char label[32];
+            std::snprintf(label, sizeof(label), "%zu thread%s", threadCount, threadCount == 1 ? "" : "s");
+            Report(label, loaded, wrong, best, rawBytes);
+        }
+    }
+}
+
+int main()
+{
+    std::printf("%d images of %dx%d, best of %d warm passes, %u hardware threads\n", IMAGES, SIZE, SIZE, PASSES,
+                std::thread::hardware_concurrency());
+    const std::vector<Image> images = Generate();
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "psyengine_asset_pack_bench.pack";
+
+    Run("none", PackCompression::None, images, path);
+    if (AssetPackWriter::IsSupported(PackCompression::Lz4))
+    {
+        Run("lz4", PackCompression::Lz4, images, path);
+    }
+    if (AssetPackWriter::IsSupported(PackCompression::Zstd))
+    {
+        Run("zstd", PackCompression::Zstd, images, path);
+    }
+
+    std::filesystem::remove(path);
+    return 0;
+}
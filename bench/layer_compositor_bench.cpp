@@ -0,0 +1,228 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+// Draw calls per frame of a scrolling parallax scene (sky, hills, a tilemap and a HUD) composited with every
+// layer cached, against the same layers drawn straight into the frame, on the software renderer. Fails if
+// caching does not cut the draws or a cached layer ends up drawn directly.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include <SDL3/SDL_render.h>
+#include <SDL3/SDL_surface.h>
+
+#include "psyengine/graphics/layer_compositor.hpp"
+#include "psyengine/graphics/render_context.hpp"
+#include "psyengine/platform/sdl_raii.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using namespace psyengine::graphics;
+    using psyengine::platform::SdlRendererPtr;
+    using psyengine::platform::SdlSurfacePtr;
+    using psyengine::platform::SdlTexturePtr;
+
+    constexpr int WIDTH = 640;
+    constexpr int HEIGHT = 360;
+    constexpr int TILE = 32;
+    constexpr int FRAMES = 240;
+    constexpr SDL_FPoint SCROLL{3.0F, 1.0F}; ///< Camera movement per frame.
+    constexpr size_t LAYERS = 4;
+
+    struct Totals
+    {
+        size_t drawCalls = 0;
+        size_t batchBreaks = 0;
+        size_t textureSwitches = 0;
+        size_t redrawn = 0;
+        double milliseconds = 0.0;
+    };
+
+    SdlTexturePtr MakeTile(SDL_Renderer* renderer, const Uint8 shade)
+    {
+        SdlTexturePtr texture(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC, TILE,
+                                                TILE));
+        if (texture)
+        {
+            std::vector<Uint8> pixels(static_cast<size_t>(TILE) * TILE * 4, 255);
+            for (size_t i = 0; i < pixels.size(); i += 4)
+            {
+                pixels[i] = shade;
+            }
+            SDL_UpdateTexture(texture.get(), nullptr, pixels.data(), TILE * 4);
+        }
+        return texture;
+    }
+
+    /// Tiles of a checkerboard of two textures covering rows [firstRow, lastRow) of the layer's space.
+    void DrawTiles(RenderContext& context, const SDL_FRect& area, SDL_Texture* const (&tiles)[2], const int firstRow,
+                   const int lastRow)
+    {
+        const int left = static_cast<int>(std::floor(area.x / TILE));
+        const int right = static_cast<int>(std::ceil((area.x + area.w) / TILE));
+        const int top = std::max(static_cast<int>(std::floor(area.y / TILE)), firstRow);
+        const int bottom = std::min(static_cast<int>(std::ceil((area.y + area.h) / TILE)), lastRow);
+        for (int y = top; y < bottom; ++y)
+        {
+            for (int x = left; x < right; ++x)
+            {
+                const SDL_FRect destination{
+                    static_cast<float>(x * TILE) - area.x, static_cast<float>(y * TILE) - area.y,
+                    static_cast<float>(TILE), static_cast<float>(TILE)
+                };
+                context.renderTexture(tiles[(x + y) & 1], nullptr, &destination);
+            }
+        }
+    }
+
+    void AddLayers(SDL_Texture* const (&tiles)[2], const bool cached)
+    {
+        LayerCompositor& compositor = LayerCompositor::instance();
+        compositor.clear();
+        compositor.setCamera(SDL_FPoint{0.0F, 0.0F});
+
+        LayerSettings sky;
+        sky.depth = -3;
+        sky.parallax = SDL_FPoint{0.25F, 0.25F};
+        sky.cached = cached;
+        compositor.addLayer("sky", sky, [](RenderContext& context, const SDL_FRect& area)
+        {
+            // Bands of the sky gradient, one color each
+            for (int band = 0; band < 8; ++band)
+            {
+                const auto shade = static_cast<float>(band) / 8.0F;
+                context.setDrawColorFloat(0.2F * shade, 0.4F * shade, 0.6F + 0.4F * shade, 1.0F);
+                const SDL_FRect rect{0.0F, static_cast<float>(band) * area.h / 8.0F, area.w, area.h / 8.0F};
+                context.renderFillRect(&rect);
+            }
+        });
+
+        LayerSettings hills;
+        hills.depth = -2;
+        hills.parallax = SDL_FPoint{0.5F, 0.5F};
+        hills.cached = cached;
+        compositor.addLayer("hills", hills, [&tiles](RenderContext& context, const SDL_FRect& area)
+        {
+            DrawTiles(context, area, tiles, 6, 9);
+        });
+
+        LayerSettings ground;
+        ground.parallax = SDL_FPoint{1.0F, 1.0F};
+        ground.cached = cached;
+        compositor.addLayer("ground", ground, [&tiles](RenderContext& context, const SDL_FRect& area)
+        {
+            DrawTiles(context, area, tiles, 8, 1000);
+        });
+
+        LayerSettings hud;
+        hud.depth = 0;
+        hud.parallax = SDL_FPoint{0.0F, 0.0F};
+        hud.margin = 0;
+        hud.cached = cached;
+        compositor.addLayer("hud", hud, [](RenderContext& context, const SDL_FRect&)
+        {
+            // A frame of panels with outlines
+            for (int panel = 0; panel < 12; ++panel)
+            {
+                const SDL_FRect rect{8.0F + static_cast<float>(panel) * 52.0F, 8.0F, 48.0F, 24.0F};
+                context.setDrawColorFloat(0.1F, 0.1F, 0.1F, 0.8F);
+                context.renderFillRect(&rect);
+                context.setDrawColorFloat(1.0F, 1.0F, 1.0F, 1.0F);
+                context.renderRect(&rect);
+            }
+        });
+    }
+
+    Totals Run(SDL_Renderer* renderer, SDL_Texture* const (&tiles)[2], const bool cached, bool& failed)
+    {
+        LayerCompositor& compositor = LayerCompositor::instance();
+        AddLayers(tiles, cached);
+        RenderContext context(renderer);
+
+        Totals totals;
+        const auto start = Clock::now();
+        for (int frame = 0; frame < FRAMES; ++frame)
+        {
+            const auto elapsed = static_cast<float>(frame);
+            compositor.setCamera(SDL_FPoint{SCROLL.x * elapsed, SCROLL.y * elapsed});
+
+            context.beginFrame();
+            compositor.prepare(context, WIDTH, HEIGHT);
+            context.setDrawColorFloat(0.0F, 0.0F, 0.0F, 1.0F);
+            context.clear();
+            compositor.composite(context, LayerPass::Below);
+            compositor.composite(context, LayerPass::Above);
+            SDL_FlushRenderer(renderer);
+
+            const RenderStats& stats = context.stats();
+            const LayerStats& layers = compositor.stats();
+            totals.drawCalls += stats.drawCalls;
+            totals.batchBreaks += stats.batchBreaks;
+            totals.textureSwitches += stats.textureSwitches;
+            totals.redrawn += layers.redrawn;
+            if ((cached ? layers.composited : layers.direct) != LAYERS)
+            {
+                failed = true;
+            }
+        }
+        totals.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        compositor.clear();
+        return totals;
+    }
+
+    void Print(const char* name, const Totals& totals)
+    {
+        std::printf("%-9s %10.1f %10.1f %10.1f %8zu %10.3f\n", name,
+                    static_cast<double>(totals.drawCalls) / FRAMES, static_cast<double>(totals.batchBreaks) / FRAMES,
+                    static_cast<double>(totals.textureSwitches) / FRAMES, totals.redrawn,
+                    totals.milliseconds / FRAMES);
+    }
+}
+
+int main()
+{
+    const SdlSurfacePtr surface(SDL_CreateSurface(WIDTH, HEIGHT, SDL_PIXELFORMAT_ARGB8888));
+    const SdlRendererPtr renderer(surface ? SDL_CreateSoftwareRenderer(surface.get()) : nullptr);
+    if (!renderer)
+    {
+        std::printf("software renderer creation failed: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    const SdlTexturePtr light = MakeTile(renderer.get(), 200);
+    const SdlTexturePtr dark = MakeTile(renderer.get(), 90);
+    if (!light || !dark)
+    {
+        std::printf("tile creation failed: %s\n", SDL_GetError());
+        return 1;
+    }
+    SDL_Texture* const tiles[2] = {light.get(), dark.get()};
+
+    bool failed = false;
+    const Totals uncached = Run(renderer.get(), tiles, false, failed);
+    const Totals cached = Run(renderer.get(), tiles, true, failed);
+
+    std::printf("%zu layers, %dx%d, %d frames scrolling (%.0f, %.0f) per frame\n", LAYERS, WIDTH, HEIGHT, FRAMES,
+                static_cast<double>(SCROLL.x), static_cast<double>(SCROLL.y));
+    std::printf("%-9s %10s %10s %10s %8s %10s\n", "layers", "draws", "breaks", "switches", "redrawn", "ms");
+    Print("uncached", uncached);
+    Print("cached", cached);
+
+    if (failed)
+    {
+        std::printf("FAILED: layers were not drawn the way their settings ask for\n");
+        return 1;
+    }
+    if (cached.drawCalls >= uncached.drawCalls)
+    {
+        std::printf("FAILED: caching did not reduce the draw calls\n");
+        return 1;
+    }
+    return 0;
+}
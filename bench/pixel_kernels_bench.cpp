@@ -0,0 +1,198 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+// Time of every pixels kernel on a 1024x1024 surface with the scalar reference and each SIMD level the CPU
+// supports. Fails if a SIMD result differs from the scalar one.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <SDL3/SDL_surface.h>
+
+#include "psyengine/graphics/pixels.hpp"
+#include "psyengine/platform/sdl_raii.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using namespace psyengine::graphics;
+    using psyengine::platform::SdlSurfacePtr;
+
+    constexpr int SIZE = 1024;
+    constexpr int REPETITIONS = 20;
+
+    struct Level
+    {
+        pixels::SimdLevel level;
+        const char* name;
+    };
+
+    constexpr Level SIMD_LEVELS[] = {{pixels::SimdLevel::Avx2, "avx2"}, {pixels::SimdLevel::Neon, "neon"}};
+
+    /// Runs a kernel on the work surface, or on the source for kernels that copy, and returns what it produced.
+    struct Kernel
+    {
+        const char* name;
+        std::function<SdlSurfacePtr(SDL_Surface* source, SDL_Surface* work)> run;
+    };
+
+    void Fill(SDL_Surface* surface, std::mt19937& rng)
+    {
+        for (int y = 0; y < surface->h; ++y)
+        {
+            auto* row = static_cast<Uint8*>(surface->pixels) + static_cast<ptrdiff_t>(y) * surface->pitch;
+            for (int x = 0; x < surface->w * 4; ++x)
+            {
+                row[x] = static_cast<Uint8>(rng());
+            }
+        }
+    }
+
+    void Copy(SDL_Surface* from, SDL_Surface* to)
+    {
+        for (int y = 0; y < from->h; ++y)
+        {
+            std::memcpy(static_cast<Uint8*>(to->pixels) + static_cast<ptrdiff_t>(y) * to->pitch,
+                        static_cast<const Uint8*>(from->pixels) + static_cast<ptrdiff_t>(y) * from->pitch,
+                        static_cast<size_t>(from->w) * 4);
+        }
+    }
+
+    bool Same(SDL_Surface* a, SDL_Surface* b)
+    {
+        if (a == nullptr || b == nullptr || a->w != b->w || a->h != b->h || a->format != b->format)
+        {
+            return a == b;
+        }
+        for (int y = 0; y < a->h; ++y)
+        {
+            if (std::memcmp(static_cast<const Uint8*>(a->pixels) + static_cast<ptrdiff_t>(y) * a->pitch,
+                            static_cast<const Uint8*>(b->pixels) + static_cast<ptrdiff_t>(y) * b->pitch,
+                            static_cast<size_t>(a->w) * 4) != 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// @return Best milliseconds per run; the result of the last run is left in result.
+    double Time(const Kernel& kernel, SDL_Surface* source, SDL_Surface* work, SdlSurfacePtr& result)
+    {
+        double best = 1e30;
+        for (int i = 0; i < REPETITIONS; ++i)
+        {
+            Copy(source, work);
+            const auto start = Clock::now();
+            result = kernel.run(source, work);
+            best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        return best;
+    }
+
+    /// In-place kernels hand back a copy of the work surface, so it can be compared after the next run.
+    SdlSurfacePtr Snapshot(SDL_Surface* work)
+    {
+        return SdlSurfacePtr(SDL_DuplicateSurface(work));
+    }
+}
+
+int main()
+{
+    std::mt19937 rng(42);
+    const SdlSurfacePtr source(SDL_CreateSurface(SIZE, SIZE, SDL_PIXELFORMAT_ARGB8888));
+    const SdlSurfacePtr work(SDL_CreateSurface(SIZE, SIZE, SDL_PIXELFORMAT_ARGB8888));
+    const SdlSurfacePtr sprite(SDL_CreateSurface(SIZE, SIZE, SDL_PIXELFORMAT_ARGB8888));
+    if (!source || !work || !sprite)
+    {
+        std::printf("surface creation failed\n");
+        return 1;
+    }
+    Fill(source.get(), rng);
+
+    // TrimBounds scans a mostly transparent sprite, as it would in practice
+    std::memset(sprite->pixels, 0, static_cast<size_t>(sprite->pitch) * SIZE);
+    for (int y = SIZE * 3 / 10; y < SIZE * 7 / 10; ++y)
+    {
+        (static_cast<Uint8*>(sprite->pixels) + static_cast<ptrdiff_t>(y) * sprite->pitch)[SIZE / 2 * 4 + 3] = 255;
+    }
+
+    const std::vector<Kernel> kernels{
+        {"copy (memcpy baseline)", [](SDL_Surface*, SDL_Surface* w) { return Snapshot(w); }},
+        {"convert ARGB->ABGR", [](SDL_Surface* s, SDL_Surface*)
+        {
+            return pixels::Convert(s, SDL_PIXELFORMAT_ABGR8888);
+        }},
+        {"premultiply", [](SDL_Surface*, SDL_Surface* w)
+        {
+            pixels::Premultiply(w);
+            return Snapshot(w);
+        }},
+        {"unpremultiply", [](SDL_Surface*, SDL_Surface* w)
+        {
+            pixels::Unpremultiply(w);
+            return Snapshot(w);
+        }},
+        {"multiply", [](SDL_Surface*, SDL_Surface* w)
+        {
+            pixels::Multiply(w, {200, 100, 50, 255});
+            return Snapshot(w);
+        }},
+        {"color key", [](SDL_Surface*, SDL_Surface* w)
+        {
+            pixels::ColorKey(w, {255, 0, 255, 0});
+            return Snapshot(w);
+        }},
+        {"box downscale /2", [](SDL_Surface* s, SDL_Surface*) { return pixels::DownscaleBox(s, 2); }},
+        {"bilinear to 75%", [](SDL_Surface* s, SDL_Surface*)
+        {
+            return pixels::DownscaleBilinear(s, SIZE * 3 / 4, SIZE * 3 / 4);
+        }},
+        {"trim bounds", [&sprite](SDL_Surface*, SDL_Surface*)
+        {
+            const SDL_Rect bounds = pixels::TrimBounds(sprite.get());
+            SdlSurfacePtr result(SDL_CreateSurface(4, 1, SDL_PIXELFORMAT_ARGB8888));
+            std::memcpy(result->pixels, &bounds, sizeof(bounds));
+            return result;
+        }},
+    };
+
+    const pixels::SimdLevel initial = pixels::ActiveSimdLevel();
+    std::printf("%dx%d ARGB8888, best of %d, ms\n", SIZE, SIZE, REPETITIONS);
+    int mismatches = 0;
+    for (const Kernel& kernel : kernels)
+    {
+        pixels::SetSimdLevel(pixels::SimdLevel::Scalar);
+        SdlSurfacePtr expected;
+        const double scalar = Time(kernel, source.get(), work.get(), expected);
+        std::printf("%-24s scalar %8.3f", kernel.name, scalar);
+
+        for (const Level& level : SIMD_LEVELS)
+        {
+            if (!pixels::SetSimdLevel(level.level))
+            {
+                continue;
+            }
+            SdlSurfacePtr actual;
+            const double simd = Time(kernel, source.get(), work.get(), actual);
+            const bool same = Same(expected.get(), actual.get());
+            mismatches += same ? 0 : 1;
+            std::printf("  %s %8.3f  x%4.1f%s", level.name, simd, scalar / simd, same ? "" : "  MISMATCH");
+        }
+        std::printf("\n");
+    }
+    pixels::SetSimdLevel(initial);
+
+    if (mismatches > 0)
+    {
+        std::printf("%d kernels differ from the scalar reference\n", mismatches);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,128 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+// Renders a fixed sequence through RenderContext on the software renderer and checks what it counted: draw
+// calls, vertices, batch breaks, texture switches, state changes with redundant ones skipped, uploads, and
+// the reset between frames. Fails on any count that differs from the one worked out by hand.
+
+#include <cstdio>
+#include <vector>
+
+#include <SDL3/SDL_render.h>
+#include <SDL3/SDL_surface.h>
+
+#include "psyengine/graphics/render_context.hpp"
+#include "psyengine/platform/sdl_raii.hpp"
+
+namespace
+{
+    using psyengine::graphics::RenderContext;
+    using psyengine::graphics::RenderStats;
+    using psyengine::platform::SdlRendererPtr;
+    using psyengine::platform::SdlSurfacePtr;
+    using psyengine::platform::SdlTexturePtr;
+
+    constexpr int SIZE = 16;
+
+    bool Expect(const char* name, const Uint64 actual, const Uint64 expected)
+    {
+        const bool ok = actual == expected;
+        std::printf("  %-16s %6llu  expected %6llu%s\n", name, static_cast<unsigned long long>(actual),
+                    static_cast<unsigned long long>(expected), ok ? "" : "  MISMATCH");
+        return ok;
+    }
+
+    /// Frame one: every kind of batch break, with redundant state changes mixed in.
+    bool FirstFrame(RenderContext& context, SDL_Texture* a, SDL_Texture* b)
+    {
+        const SDL_FRect rect{0.0F, 0.0F, 8.0F, 8.0F};
+        const SDL_Vertex vertex{{0.0F, 0.0F}, {1.0F, 1.0F, 1.0F, 1.0F}, {0.0F, 0.0F}};
+        const std::vector<SDL_Vertex> vertices(6, vertex);
+        const std::vector<Uint8> pixels(static_cast<size_t>(SIZE) * SIZE * 4, 255);
+
+        context.beginFrame();
+        context.setDrawColor(0, 0, 0, 255); // change 1
+        context.clear(); // draw 1
+        context.setDrawColor(0, 0, 0, 255); // redundant
+        context.renderTexture(a, nullptr, &rect); // break 1: untextured to a
+        context.renderTexture(a, nullptr, &rect);
+        context.renderTexture(a, nullptr, &rect);
+        context.renderTexture(b, nullptr, &rect); // break 2, switch 1
+        context.renderTexture(a, nullptr, &rect); // break 3, switch 2
+        context.setDrawBlendMode(SDL_BLENDMODE_BLEND); // change 2
+        context.renderTexture(a, nullptr, &rect); // break 4: state in between
+        context.setDrawColorFloat(1.0F, 1.0F, 1.0F, 1.0F); // change 3
+        context.renderFillRect(&rect); // break 5: a to untextured
+        context.renderFillRect(&rect);
+        context.setScale(1.0F, 1.0F); // redundant
+        context.setScale(2.0F, 2.0F); // change 4
+        context.renderLine(0.0F, 0.0F, 8.0F, 8.0F); // break 6
+        context.setTarget(nullptr); // redundant
+        context.renderGeometry(a, vertices.data(), static_cast<int>(vertices.size()), nullptr, 0); // break 7
+        context.renderTexture(b, nullptr, &rect); // break 8, switch 3
+        context.updateTexture(a, nullptr, pixels.data(), SIZE * 4);
+
+        const RenderStats& stats = context.stats();
+        std::printf("frame 1\n");
+        bool ok = Expect("draw calls", stats.drawCalls, 12);
+        ok &= Expect("vertices", stats.vertices, 44);
+        ok &= Expect("batch breaks", stats.batchBreaks, 8);
+        ok &= Expect("texture switches", stats.textureSwitches, 3);
+        ok &= Expect("state changes", stats.stateChanges, 4);
+        ok &= Expect("uploads", stats.uploads, 1);
+        ok &= Expect("uploaded bytes", stats.uploadedBytes, static_cast<Uint64>(SIZE) * SIZE * 4);
+        return ok;
+    }
+
+    /// Frame two: the counts start over, and the state set last frame is read back rather than assumed.
+    bool SecondFrame(RenderContext& context, SDL_Texture* a, SDL_Texture* b)
+    {
+        const SDL_FRect rect{0.0F, 0.0F, 8.0F, 8.0F};
+
+        context.beginFrame();
+        context.setScale(2.0F, 2.0F); // redundant: still set from frame one
+        context.renderTexture(b, nullptr, &rect); // first draw: no break, no switch
+        context.renderTexture(a, nullptr, &rect); // break 1, switch 1
+
+        const RenderStats& stats = context.stats();
+        std::printf("frame 2\n");
+        bool ok = Expect("draw calls", stats.drawCalls, 2);
+        ok &= Expect("vertices", stats.vertices, 8);
+        ok &= Expect("batch breaks", stats.batchBreaks, 1);
+        ok &= Expect("texture switches", stats.textureSwitches, 1);
+        ok &= Expect("state changes", stats.stateChanges, 0);
+        ok &= Expect("uploads", stats.uploads, 0);
+        return ok;
+    }
+}
+
+int main()
+{
+    const SdlSurfacePtr surface(SDL_CreateSurface(64, 64, SDL_PIXELFORMAT_ARGB8888));
+    const SdlRendererPtr renderer(surface ? SDL_CreateSoftwareRenderer(surface.get()) : nullptr);
+    const SdlTexturePtr a(renderer ? SDL_CreateTexture(renderer.get(), SDL_PIXELFORMAT_RGBA32,
+                                                       SDL_TEXTUREACCESS_STATIC, SIZE, SIZE) : nullptr);
+    const SdlTexturePtr b(renderer ? SDL_CreateTexture(renderer.get(), SDL_PIXELFORMAT_RGBA32,
+                                                       SDL_TEXTUREACCESS_STATIC, SIZE, SIZE) : nullptr);
+    if (!a || !b)
+    {
+        std::printf("software renderer setup failed: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    // Known starting state, set directly so it is not counted
+    SDL_SetRenderDrawColorFloat(renderer.get(), 1.0F, 1.0F, 1.0F, 1.0F);
+    SDL_SetRenderDrawBlendMode(renderer.get(), SDL_BLENDMODE_NONE);
+    SDL_SetRenderScale(renderer.get(), 1.0F, 1.0F);
+
+    RenderContext context(renderer.get());
+    bool ok = FirstFrame(context, a.get(), b.get());
+    ok &= SecondFrame(context, a.get(), b.get());
+    if (!ok)
+    {
+        std::printf("FAILED: RenderContext counted differently\n");
+        return 1;
+    }
+    return 0;
+}
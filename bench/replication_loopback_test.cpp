@@ -0,0 +1,182 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+// A ReplicationServer feeding hundreds of ReplicationClients over UDP loopback, with packet loss in both
+// directions. Reports bytes per client per tick and fails if a client decodes garbage or ends up with state
+// that differs from the server's beyond the quantization step.
+
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "psyengine/net/replication.hpp"
+#include "psyengine/net/udp_socket.hpp"
+
+namespace
+{
+    using namespace psyengine;
+
+    constexpr int ENTITIES = 2000;
+    constexpr int CLIENTS = 300;
+    constexpr Uint32 TICKS = 120;
+    constexpr double LOSS_RATE = 0.1;
+    constexpr float VIEW_RADIUS = 200.0F;
+}
+
+int main()
+{
+    net::ReplicationSchema schema;
+    schema.worldMin = math::Vector2F(-1024.0F, -1024.0F);
+    schema.worldMax = math::Vector2F(1024.0F, 1024.0F);
+    schema.precision = 1.0F / 16.0F;
+    schema.fieldBits = {4, 8};
+    net::ReplicationServer server(schema, 128.0F);
+
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> coordinate(-1000.0F, 1000.0F);
+    std::bernoulli_distribution lost(LOSS_RATE);
+
+    std::vector<net::EntityState> entities(ENTITIES);
+    for (int i = 0; i < ENTITIES; ++i)
+    {
+        entities[static_cast<size_t>(i)].id = static_cast<net::EntityId>(i * 3 + 1);
+        entities[static_cast<size_t>(i)].position = math::Vector2F(coordinate(rng), coordinate(rng));
+        entities[static_cast<size_t>(i)].fields[0] = 1;
+    }
+
+    net::UdpSocket serverSocket;
+    if (!serverSocket.open(0, true))
+    {
+        std::printf("FAIL: could not open the server socket\n");
+        return 1;
+    }
+
+    std::vector<net::ClientId> ids;
+    std::vector<net::ReplicationClient> clients;
+    std::vector<net::UdpSocket> sockets(CLIENTS);
+    std::unordered_map<Uint16, size_t> clientByPort;
+    for (int c = 0; c < CLIENTS; ++c)
+    {
+        const auto index = static_cast<size_t>(c);
+        ids.push_back(server.addClient());
+        clients.emplace_back(schema);
+        server.setClientView(ids[index], math::Vector2F(coordinate(rng), coordinate(rng)), VIEW_RADIUS);
+        if (!sockets[index].open(0, true))
+        {
+            std::printf("FAIL: could not open client socket %d\n", c);
+            return 1;
+        }
+        clientByPort[sockets[index].localPort()] = index;
+    }
+
+    size_t decodeErrors = 0;
+    std::vector<std::byte> packet;
+    std::vector<std::byte> buffer(65536);
+    for (Uint32 tick = 1; tick <= TICKS; ++tick)
+    {
+        // A quarter of the entities move every tick; a few change a field now and then
+        for (int i = 0; i < ENTITIES; ++i)
+        {
+            net::EntityState& entity = entities[static_cast<size_t>(i)];
+            if (i % 4 == 0)
+            {
+                entity.position = math::Vector2F(entity.position.x + std::sin(static_cast<float>(tick)) * 3.0F,
+                                                 entity.position.y + 1.0F);
+            }
+            if (tick % 30 == 0 && i % 50 == 0)
+            {
+                entity.fields[1] = tick % 256;
+            }
+            server.setEntity(entity);
+        }
+
+        server.update(tick);
+        for (size_t c = 0; c < clients.size(); ++c)
+        {
+            packet.clear();
+            server.writeSnapshot(ids[c], packet);
+            if (!lost(rng))
+            {
+                serverSocket.sendTo(net::Endpoint::Loopback(sockets[c].localPort()), packet);
+            }
+        }
+        server.endTick();
+
+        // Clients decode and acknowledge their newest snapshot, over the same lossy link
+        for (size_t c = 0; c < clients.size(); ++c)
+        {
+            net::Endpoint from;
+            while (const auto size = sockets[c].receiveFrom(from, buffer))
+            {
+                if (!clients[c].readSnapshot(std::span(buffer).first(*size)))
+                {
+                    ++decodeErrors;
+                }
+            }
+            if (const auto latest = clients[c].latestTick(); latest && !lost(rng))
+            {
+                std::array<std::byte, sizeof(Uint32)> ack{};
+                std::memcpy(ack.data(), &*latest, sizeof(Uint32));
+                sockets[c].sendTo(net::Endpoint::Loopback(serverSocket.localPort()), ack);
+            }
+        }
+
+        net::Endpoint from;
+        while (const auto size = serverSocket.receiveFrom(from, buffer))
+        {
+            const auto client = clientByPort.find(from.port);
+            if (*size == sizeof(Uint32) && client != clientByPort.end())
+            {
+                Uint32 acked = 0;
+                std::memcpy(&acked, buffer.data(), sizeof(Uint32));
+                server.acknowledge(ids[client->second], acked);
+            }
+        }
+
+        if (tick % 20 == 0)
+        {
+            const net::ReplicationStats& stats = server.stats();
+            std::printf("tick %3u: %6.1f bytes/client (mean %6.1f), %5.1f entities/client, %llu full snapshots\n",
+                        tick, stats.lastTickBytesPerClient, stats.meanBytesPerClientPerTick,
+                        stats.lastTickEntitiesPerClient, static_cast<unsigned long long>(stats.fullSnapshots));
+        }
+    }
+
+    // Clients that received the last tick must match the server within the quantization step
+    const float tolerance = schema.precision;
+    size_t current = 0;
+    size_t mismatches = 0;
+    for (const net::ReplicationClient& client : clients)
+    {
+        if (client.latestTick() != TICKS)
+        {
+            continue;
+        }
+        ++current;
+        for (const net::EntityState& received : client.entities())
+        {
+            const net::EntityState& truth = entities[(received.id - 1) / 3];
+            if (std::fabs(truth.position.x - received.position.x) > tolerance ||
+                std::fabs(truth.position.y - received.position.y) > tolerance ||
+                truth.fields[1] != received.fields[1])
+            {
+                ++mismatches;
+            }
+        }
+    }
+
+    std::printf("%d clients, %d entities, %.0f%% loss: %zu clients current, %zu decode errors, %zu mismatches\n",
+                CLIENTS, ENTITIES, LOSS_RATE * 100.0, current, decodeErrors, mismatches);
+    if (decodeErrors != 0 || mismatches != 0 || current == 0)
+    {
+        std::printf("FAIL\n");
+        return 1;
+    }
+    std::printf("OK\n");
+    return 0;
+}
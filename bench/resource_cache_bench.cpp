@@ -0,0 +1,152 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+// Throughput of ResourceCache acquire/get/release on 1 to 8 threads, against a bare shared_mutex-guarded map.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "psyengine/resources/resource_cache.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /// Keys every thread picks from at random; all loaded up front, so the run measures hits.
+    constexpr size_t KEYS = 256;
+    constexpr auto DURATION = std::chrono::milliseconds(500);
+
+    struct IntLoader
+    {
+        int* load(const std::string& key)
+        {
+            return new int(static_cast<int>(key.size()));
+        }
+
+        void destroy(const int* value)
+        {
+            delete value;
+        }
+
+        [[nodiscard]] size_t cost(const int& /*value*/) const noexcept
+        {
+            return sizeof(int);
+        }
+    };
+
+    using Cache = psyengine::resources::ResourceCache<int, IntLoader>;
+
+    std::vector<std::string> Keys()
+    {
+        std::vector<std::string> keys;
+        for (size_t i = 0; i < KEYS; ++i)
+        {
+            keys.push_back("textures/sprites/sprite_" + std::to_string(i) + ".png");
+        }
+        return keys;
+    }
+
+    /// Runs the operation on every thread until the time is up. @return Operations per second over all threads.
+    double Measure(const size_t threadCount, const std::function<long(const std::string&)>& operation,
+                   const std::vector<std::string>& keys)
+    {
+        std::atomic<bool> stop{false};
+        std::atomic<Uint64> operations{0};
+        std::atomic<long> checksum{0};
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&, t]
+            {
+                std::mt19937 rng(static_cast<unsigned>(t));
+                std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+                Uint64 done = 0;
+                long sum = 0;
+                while (!stop.load(std::memory_order_relaxed))
+                {
+                    for (int i = 0; i < 256; ++i)
+                    {
+                        sum += operation(keys[pick(rng)]);
+                    }
+                    done += 256;
+                }
+                operations.fetch_add(done);
+                checksum.fetch_add(sum);
+            });
+        }
+
+        const auto start = Clock::now();
+        std::this_thread::sleep_for(DURATION);
+        stop = true;
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (checksum.load() == 0)
+        {
+            std::printf("no work was done\n");
+        }
+        return static_cast<double>(operations.load()) / seconds;
+    }
+}
+
+int main()
+{
+    const std::vector<std::string> keys = Keys();
+
+    Cache cache;
+    for (const std::string& key : keys)
+    {
+        cache.release(cache.acquire(key));
+    }
+    const auto acquireGetRelease = [&cache](const std::string& key) -> long
+    {
+        const Cache::Handle handle = cache.acquire(key);
+        const long value = *cache.get(handle);
+        cache.release(handle);
+        return value;
+    };
+
+    // The least a thread-safe cache can do: look the key up under a shared lock
+    std::shared_mutex mutex;
+    std::unordered_map<std::string, int> map;
+    for (const std::string& key : keys)
+    {
+        map.emplace(key, static_cast<int>(key.size()));
+    }
+    const auto lookup = [&mutex, &map](const std::string& key) -> long
+    {
+        std::shared_lock lock(mutex);
+        return map.find(key)->second;
+    };
+
+    std::printf("%zu keys, %u hardware threads, Mops/s over all threads\n", KEYS, std::thread::hardware_concurrency());
+    std::printf("threads  acquire+get+release  shared_mutex map lookup\n");
+    std::vector<size_t> threadCounts{1, 2, 4, 8};
+    if (const size_t hardware = std::max(1U, std::thread::hardware_concurrency());
+        std::ranges::find(threadCounts, hardware) == threadCounts.end())
+    {
+        threadCounts.push_back(hardware);
+    }
+    for (const size_t threadCount : threadCounts)
+    {
+        std::printf("%7zu  %19.2f  %23.2f\n", threadCount, Measure(threadCount, acquireGetRelease, keys) / 1e6,
+                    Measure(threadCount, lookup, keys) / 1e6);
+    }
+
+    const psyengine::resources::ResourceCacheStats stats = cache.stats();
+    std::printf("hits %llu, misses %llu\n", static_cast<unsigned long long>(stats.hits),
+                static_cast<unsigned long long>(stats.misses));
+    return 0;
+}
@@ -0,0 +1,179 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+// Two RollbackSessions over loopback with simulated latency, jitter and loss. Each peer drives its simulation
+// the way SdlRuntime does: a tick gate on canAdvance(), a snapshot per simulated tick, and rollbacks applied at
+// the start of the next frame. Fails unless both peers end on the same tick with identical state at every
+// confirmed tick.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "psyengine/net/rollback_session.hpp"
+
+namespace
+{
+    using namespace psyengine::net;
+
+    constexpr Uint64 TICKS = 600;
+    constexpr auto FRAME_TIME = std::chrono::milliseconds(2);
+
+    struct Peer
+    {
+        explicit Peer(const size_t player) :
+            session(RollbackSettings{
+                .playerCount = 2, .localPlayer = player, .inputDelay = 2, .maxPredictionTicks = 8,
+                .historySize = 128, .maxInputsPerPacket = 32
+            }),
+            player(player)
+        {
+            states.push_back(0);
+        }
+
+        /// Scripted local input, different per player and changing every few ticks.
+        [[nodiscard]] InputBits localInput(const Uint64 tick) const
+        {
+            return static_cast<InputBits>((tick / 7 + player * 3) % 5);
+        }
+
+        /// One fixed update, as SdlRuntime::fixedUpdate runs it. @return false if the gate stalled the tick.
+        bool fixedUpdate(const bool resimulating)
+        {
+            const Uint64 next = tick + 1;
+            if (!resimulating && !session.canAdvance(next))
+            {
+                ++stalledTicks;
+                return false;
+            }
+            if (!resimulating)
+            {
+                session.addLocalInput(next, localInput(next));
+            }
+
+            const Uint64 state = states.back() * 31 + session.input(next, 0) * 7 + session.input(next, 1) * 13;
+            states.push_back(state);
+            tick = next;
+            return true;
+        }
+
+        /// Restores the requested tick and replays up to the current one, as SdlRuntime::applyRollback does.
+        void applyRollback()
+        {
+            if (!pendingRollback)
+            {
+                return;
+            }
+            const Uint64 target = tick;
+            tick = *pendingRollback;
+            states.resize(static_cast<size_t>(tick) + 1);
+            pendingRollback.reset();
+            while (tick < target)
+            {
+                fixedUpdate(true);
+                ++resimulatedTicks;
+            }
+        }
+
+        void frame(const bool advance)
+        {
+            session.poll(tick);
+            applyRollback();
+            if (advance && tick < TICKS)
+            {
+                fixedUpdate(false);
+            }
+        }
+
+        RollbackSession session;
+        size_t player;
+        Uint64 tick = 0;
+        std::vector<Uint64> states; ///< Snapshot per tick; index is the tick.
+        std::optional<Uint64> pendingRollback;
+        Uint64 stalledTicks = 0;
+        Uint64 resimulatedTicks = 0;
+    };
+}
+
+int main()
+{
+    Peer a(0);
+    Peer b(1);
+    if (!a.session.open(0, true) || !b.session.open(0, true))
+    {
+        std::printf("FAIL: could not open the sockets\n");
+        return 1;
+    }
+    a.session.addPeer(1, Endpoint::Loopback(b.session.localPort()));
+    b.session.addPeer(0, Endpoint::Loopback(a.session.localPort()));
+
+    constexpr NetworkConditions conditions{.latency = 0.03, .jitter = 0.01, .lossRate = 0.2};
+    for (Peer* peer : {&a, &b})
+    {
+        peer->session.setNetworkConditions(conditions);
+        peer->session.setRollbackHandler([peer](const Uint64 tick)
+        {
+            if (tick > peer->tick)
+            {
+                return false;
+            }
+            peer->pendingRollback = peer->pendingRollback ? std::min(*peer->pendingRollback, tick) : tick;
+            return true;
+        });
+    }
+
+    // Simulate, then keep polling so resent input settles every prediction
+    for (int frame = 0; frame < 2000 && (a.tick < TICKS || b.tick < TICKS); ++frame)
+    {
+        a.frame(true);
+        b.frame(true);
+        std::this_thread::sleep_for(FRAME_TIME);
+    }
+    for (int frame = 0; frame < 300; ++frame)
+    {
+        a.frame(false);
+        b.frame(false);
+        std::this_thread::sleep_for(FRAME_TIME);
+    }
+
+    const Uint64 confirmed = std::min({a.session.confirmedTick(), b.session.confirmedTick(), a.tick, b.tick});
+    Uint64 firstMismatch = 0;
+    for (Uint64 tick = 1; tick <= confirmed && firstMismatch == 0; ++tick)
+    {
+        if (a.states[tick] != b.states[tick])
+        {
+            firstMismatch = tick;
+        }
+    }
+
+    for (const Peer* peer : {&a, &b})
+    {
+        const RollbackStats& stats = peer->session.stats();
+        std::printf("player %zu: tick %llu, sent %llu, received %llu, dropped %llu, bytes %llu, misses %llu, "
+                    "rollbacks %llu (max %llu ticks, %llu resimulated), stalls %llu\n",
+                    peer->player, static_cast<unsigned long long>(peer->tick),
+                    static_cast<unsigned long long>(stats.packetsSent),
+                    static_cast<unsigned long long>(stats.packetsReceived),
+                    static_cast<unsigned long long>(stats.packetsDropped),
+                    static_cast<unsigned long long>(stats.bytesSent),
+                    static_cast<unsigned long long>(stats.predictionMisses),
+                    static_cast<unsigned long long>(stats.rollbacks),
+                    static_cast<unsigned long long>(stats.maxRollbackTicks),
+                    static_cast<unsigned long long>(peer->resimulatedTicks),
+                    static_cast<unsigned long long>(peer->stalledTicks));
+    }
+    std::printf("confirmed through tick %llu\n", static_cast<unsigned long long>(confirmed));
+
+    if (a.tick != TICKS || b.tick != TICKS || confirmed != TICKS || firstMismatch != 0)
+    {
+        std::printf("FAIL: peers diverged (first mismatch at tick %llu)\n",
+                    static_cast<unsigned long long>(firstMismatch));
+        return 1;
+    }
+    std::printf("OK: both peers simulated %llu identical ticks\n", static_cast<unsigned long long>(TICKS));
+    return 0;
+}
@@ -0,0 +1,95 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+// Capture and restore time of a SnapshotRing at 1, 10 and 100 MB of simulation state.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "psyengine/state/snapshot_ring.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /// State split over a few regions, like component arrays of a real simulation.
+    constexpr size_t REGIONS = 16;
+
+    /// Frames kept; few, so the 100 MB case stays within a desktop's memory.
+    constexpr size_t FRAMES = 4;
+
+    double Milliseconds(const Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    void Run(const size_t megabytes, const int iterations)
+    {
+        const size_t regionSize = megabytes * 1024 * 1024 / REGIONS;
+        std::vector<std::vector<unsigned char>> regions(REGIONS, std::vector<unsigned char>(regionSize));
+
+        psyengine::state::SnapshotRing ring(FRAMES);
+        for (auto& region : regions)
+        {
+            ring.addArray(region.data(), region.size());
+        }
+
+        // Touch every frame once, so page faults are not measured
+        Uint64 tick = 0;
+        for (size_t i = 0; i < FRAMES; ++i)
+        {
+            ring.capture(tick++);
+        }
+
+        double captureTotal = 0.0;
+        double captureBest = 1e30;
+        double restoreTotal = 0.0;
+        double restoreBest = 1e30;
+        for (int i = 0; i < iterations; ++i)
+        {
+            // Dirty the state between ticks, as a simulation would
+            for (auto& region : regions)
+            {
+                region[static_cast<size_t>(i) % region.size()] ^= 0x5A;
+            }
+
+            auto start = Clock::now();
+            ring.capture(tick);
+            const double capture = Milliseconds(Clock::now() - start);
+
+            start = Clock::now();
+            const bool restored = ring.restore(tick - 1);
+            const double restore = Milliseconds(Clock::now() - start);
+            ++tick;
+
+            if (!restored)
+            {
+                std::printf("restore of tick %llu failed\n", static_cast<unsigned long long>(tick - 2));
+                return;
+            }
+            captureTotal += capture;
+            captureBest = std::min(captureBest, capture);
+            restoreTotal += restore;
+            restoreBest = std::min(restoreBest, restore);
+        }
+
+        const double bytes = static_cast<double>(ring.snapshotSize());
+        const double captureAverage = captureTotal / iterations;
+        const double restoreAverage = restoreTotal / iterations;
+        std::printf("%4zu MB  capture avg %8.3f ms (best %8.3f, %5.1f GB/s)  restore avg %8.3f ms (best %8.3f)\n",
+                    megabytes, captureAverage, captureBest, bytes / (captureAverage * 1e6), restoreAverage,
+                    restoreBest);
+    }
+}
+
+int main()
+{
+    std::printf("SnapshotRing, %zu regions, %zu frames\n", REGIONS, FRAMES);
+    Run(1, 500);
+    Run(10, 100);
+    Run(100, 20);
+    return 0;
+}
@@ -0,0 +1,280 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+// Pixels a rasterizer shades for each sprite drawn as its full quad, its trimmed quad and fitted convex and
+// concave meshes, counted at pixel centres. Fails if a mesh leaves a visible pixel uncovered.
+//
+// Usage: sprite_mesh_bench [directory]; loads every PNG in the directory, or generates sprites without one.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL_surface.h>
+#include <SDL3_image/SDL_image.h>
+
+#include "psyengine/graphics/sprite_mesh.hpp"
+#include "psyengine/platform/sdl_raii.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using namespace psyengine::graphics;
+    using psyengine::platform::SdlSurfacePtr;
+
+    constexpr int SIZES[] = {64, 128, 256, 512};
+
+    struct Sprite
+    {
+        std::string name;
+        SdlSurfacePtr surface; ///< RGBA32, straight alpha.
+    };
+
+    struct Variant
+    {
+        const char* name;
+        SpriteMeshOptions options;
+    };
+
+    /// Shapes in [-1, 1] coordinates, leaving transparent margins as real sprites do.
+    struct Shape
+    {
+        const char* name;
+        std::function<bool(float x, float y)> inside;
+    };
+
+    const Shape SHAPES[] = {
+        {"disc", [](const float x, const float y) { return x * x + y * y < 0.8F * 0.8F; }},
+        {"ring", [](const float x, const float y)
+        {
+            const float r = x * x + y * y;
+            return r > 0.5F * 0.5F && r < 0.9F * 0.9F;
+        }},
+        {"diamond", [](const float x, const float y) { return std::abs(x) + std::abs(y) < 0.85F; }},
+        {"tree", [](const float x, const float y) { return y > -0.9F && std::abs(x) < (y + 0.9F) * 0.45F; }},
+        {"character", [](const float x, const float y)
+        {
+            const bool body = std::abs(x) < 0.3F && y > -0.3F && y < 0.95F;
+            const bool head = x * x + (y + 0.6F) * (y + 0.6F) < 0.3F * 0.3F;
+            return body || head;
+        }},
+    };
+
+    double Milliseconds(const Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    Uint8 Alpha(const SDL_Surface* surface, const int x, const int y)
+    {
+        return static_cast<const Uint8*>(surface->pixels)[static_cast<ptrdiff_t>(y) * surface->pitch + x * 4 + 3];
+    }
+
+    std::vector<Sprite> Generate()
+    {
+        std::mt19937 rng(7);
+        std::vector<Sprite> sprites;
+        for (const Shape& shape : SHAPES)
+        {
+            for (const int size : SIZES)
+            {
+                SdlSurfacePtr surface(SDL_CreateSurface(size, size, SDL_PIXELFORMAT_RGBA32));
+                if (!surface)
+                {
+                    continue;
+                }
+                for (int y = 0; y < size; ++y)
+                {
+                    auto* row = static_cast<Uint8*>(surface->pixels) + static_cast<ptrdiff_t>(y) * surface->pitch;
+                    const float v = (static_cast<float>(y) + 0.5F) / static_cast<float>(size) * 2.0F - 1.0F;
+                    for (int x = 0; x < size; ++x)
+                    {
+                        const float u = (static_cast<float>(x) + 0.5F) / static_cast<float>(size) * 2.0F - 1.0F;
+                        row[x * 4] = static_cast<Uint8>(rng());
+                        row[x * 4 + 1] = static_cast<Uint8>(rng());
+                        row[x * 4 + 2] = static_cast<Uint8>(rng());
+                        row[x * 4 + 3] = shape.inside(u, v) ? 255 : 0;
+                    }
+                }
+                sprites.push_back({std::string(shape.name) + "-" + std::to_string(size), std::move(surface)});
+            }
+        }
+        return sprites;
+    }
+
+    std::vector<Sprite> Load(const std::filesystem::path& directory)
+    {
+        std::vector<std::filesystem::path> paths;
+        for (const auto& entry : std::filesystem::directory_iterator(directory))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".png")
+            {
+                paths.push_back(entry.path());
+            }
+        }
+        std::ranges::sort(paths);
+
+        std::vector<Sprite> sprites;
+        for (const auto& path : paths)
+        {
+            const SdlSurfacePtr decoded(IMG_Load(path.string().c_str()));
+            SdlSurfacePtr surface(decoded ? SDL_ConvertSurface(decoded.get(), SDL_PIXELFORMAT_RGBA32) : nullptr);
+            if (!surface)
+            {
+                std::printf("skipping %s: %s\n", path.string().c_str(), SDL_GetError());
+                continue;
+            }
+            sprites.push_back({path.stem().string(), std::move(surface)});
+        }
+        return sprites;
+    }
+
+    /// Pixels whose centres fall inside a triangle of the mesh; missed counts visible pixels left out.
+    Uint64 Shaded(const SpriteMesh& mesh, const SDL_Surface* sprite, Uint64& missed)
+    {
+        std::vector<bool> covered(static_cast<size_t>(sprite->w) * static_cast<size_t>(sprite->h));
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            const SDL_FPoint a = mesh.positions[static_cast<size_t>(mesh.indices[i])];
+            const SDL_FPoint b = mesh.positions[static_cast<size_t>(mesh.indices[i + 1])];
+            const SDL_FPoint c = mesh.positions[static_cast<size_t>(mesh.indices[i + 2])];
+            const int left = std::max(static_cast<int>(std::floor(std::min({a.x, b.x, c.x}))), 0);
+            const int right = std::min(static_cast<int>(std::ceil(std::max({a.x, b.x, c.x}))), sprite->w);
+            const int top = std::max(static_cast<int>(std::floor(std::min({a.y, b.y, c.y}))), 0);
+            const int bottom = std::min(static_cast<int>(std::ceil(std::max({a.y, b.y, c.y}))), sprite->h);
+
+            for (int y = top; y < bottom; ++y)
+            {
+                const float cy = static_cast<float>(y) + 0.5F;
+                for (int x = left; x < right; ++x)
+                {
+                    const float cx = static_cast<float>(x) + 0.5F;
+                    const auto edge = [cx, cy](const SDL_FPoint p, const SDL_FPoint q)
+                    {
+                        return (q.x - p.x) * (cy - p.y) - (q.y - p.y) * (cx - p.x);
+                    };
+                    const float e0 = edge(a, b);
+                    const float e1 = edge(b, c);
+                    const float e2 = edge(c, a);
+                    if ((e0 >= 0.0F && e1 >= 0.0F && e2 >= 0.0F) || (e0 <= 0.0F && e1 <= 0.0F && e2 <= 0.0F))
+                    {
+                        covered[static_cast<size_t>(y) * static_cast<size_t>(sprite->w) + static_cast<size_t>(x)] =
+                            true;
+                    }
+                }
+            }
+        }
+
+        Uint64 shaded = 0;
+        for (int y = 0; y < sprite->h; ++y)
+        {
+            for (int x = 0; x < sprite->w; ++x)
+            {
+                const bool inside =
+                    covered[static_cast<size_t>(y) * static_cast<size_t>(sprite->w) + static_cast<size_t>(x)];
+                shaded += inside ? 1U : 0U;
+                missed += !inside && Alpha(sprite, x, y) > 0 ? 1U : 0U;
+            }
+        }
+        return shaded;
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    const std::vector<Sprite> sprites = argc > 1 ? Load(argv[1]) : Generate();
+    if (sprites.empty())
+    {
+        std::printf("no sprites\n");
+        return 1;
+    }
+
+    SpriteMeshOptions trimmed;
+    trimmed.minMeshArea = 0;
+    SpriteMeshOptions convex = trimmed;
+    convex.shape = SpriteMeshShape::Convex;
+    convex.minSavings = 0.0F;
+    SpriteMeshOptions concave = convex;
+    concave.shape = SpriteMeshShape::Concave;
+    concave.maxVertices = 16;
+    // What an engine would build: convex, but only where the size and savings thresholds allow
+    SpriteMeshOptions defaults;
+    defaults.shape = SpriteMeshShape::Convex;
+
+    const Variant variants[] = {
+        {"trimmed", trimmed}, {"convex8", convex}, {"concave16", concave}, {"default", defaults}
+    };
+    constexpr size_t VARIANTS = std::size(variants);
+
+    std::printf("%-20s %9s %9s", "sprite", "full", "visible");
+    for (const Variant& variant : variants)
+    {
+        std::printf(" %9s", variant.name);
+    }
+    std::printf(" %9s\n", "build ms");
+
+    Uint64 totalFull = 0;
+    Uint64 totalVisible = 0;
+    Uint64 totals[VARIANTS] = {};
+    Uint64 missed = 0;
+    double slowestBuild = 0.0;
+    for (const Sprite& sprite : sprites)
+    {
+        SDL_Surface* surface = sprite.surface.get();
+        const Uint64 full = static_cast<Uint64>(surface->w) * static_cast<Uint64>(surface->h);
+        Uint64 visible = 0;
+        for (int y = 0; y < surface->h; ++y)
+        {
+            for (int x = 0; x < surface->w; ++x)
+            {
+                visible += Alpha(surface, x, y) > 0 ? 1U : 0U;
+            }
+        }
+        totalFull += full;
+        totalVisible += visible;
+
+        std::printf("%-20s %9llu %9llu", sprite.name.c_str(), static_cast<unsigned long long>(full),
+                    static_cast<unsigned long long>(visible));
+        double build = 0.0;
+        for (size_t i = 0; i < VARIANTS; ++i)
+        {
+            const auto start = Clock::now();
+            const SpriteMesh mesh = BuildSpriteMesh(surface, variants[i].options);
+            build = std::max(build, Milliseconds(Clock::now() - start));
+
+            const Uint64 shaded = Shaded(mesh, surface, missed);
+            totals[i] += shaded;
+            std::printf(" %9llu", static_cast<unsigned long long>(shaded));
+        }
+        slowestBuild = std::max(slowestBuild, build);
+        std::printf(" %9.3f\n", build);
+    }
+
+    std::printf("%-20s %9llu %9llu", "total", static_cast<unsigned long long>(totalFull),
+                static_cast<unsigned long long>(totalVisible));
+    for (const Uint64 total : totals)
+    {
+        std::printf(" %9llu", static_cast<unsigned long long>(total));
+    }
+    std::printf("\nshaded vs full quads:");
+    for (size_t i = 0; i < VARIANTS; ++i)
+    {
+        std::printf(" %s %.1f%%", variants[i].name,
+                    100.0 * static_cast<double>(totals[i]) / static_cast<double>(totalFull));
+    }
+    std::printf("\nslowest mesh build %.3f ms\n", slowestBuild);
+
+    if (missed > 0)
+    {
+        std::printf("FAILED: meshes left %llu visible pixels uncovered\n", static_cast<unsigned long long>(missed));
+        return 1;
+    }
+    return 0;
+}
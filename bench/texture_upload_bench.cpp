@@ -0,0 +1,180 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+// Main-thread cost of getting 256 decoded 256x256 images onto a real renderer: SDL_CreateTextureFromSurface
+// against TextureLoader's prepare (normally on a worker) and upload, with straight and premultiplied alpha.
+//
+// Usage: texture_upload_bench [renderer], e.g. "opengl", "vulkan" or "software"; SDL's default otherwise.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <SDL3/SDL.h>
+
+#include "psyengine/resources/texture_manager.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using psyengine::resources::TextureLoader;
+
+    constexpr int IMAGES = 256;
+    constexpr int SIZE = 256;
+    constexpr int PASSES = 3;
+
+    double Milliseconds(const Clock::duration duration)
+    {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    /// Images as IMG_Load returns PNGs: RGBA32 with straight alpha.
+    std::vector<SDL_Surface*> Generate()
+    {
+        std::mt19937 rng(3);
+        std::vector<SDL_Surface*> images;
+        for (int i = 0; i < IMAGES; ++i)
+        {
+            SDL_Surface* surface = SDL_CreateSurface(SIZE, SIZE, SDL_PIXELFORMAT_RGBA32);
+            if (surface == nullptr)
+            {
+                break;
+            }
+            auto* pixels = static_cast<Uint8*>(surface->pixels);
+            for (int y = 0; y < SIZE; ++y)
+            {
+                for (int x = 0; x < SIZE * 4; ++x)
+                {
+                    pixels[y * surface->pitch + x] = static_cast<Uint8>(rng());
+                }
+            }
+            images.push_back(surface);
+        }
+        return images;
+    }
+
+    /// Makes the renderer finish the uploads, so lazy drivers cannot hide their cost.
+    void Finish(SDL_Renderer* renderer, const std::vector<SDL_Texture*>& textures)
+    {
+        const SDL_FRect target{0.0F, 0.0F, 1.0F, 1.0F};
+        for (SDL_Texture* texture : textures)
+        {
+            SDL_RenderTexture(renderer, texture, nullptr, &target);
+        }
+        SDL_FlushRenderer(renderer);
+    }
+
+    void Destroy(std::vector<SDL_Texture*>& textures)
+    {
+        for (SDL_Texture* texture : textures)
+        {
+            SDL_DestroyTexture(texture);
+        }
+        textures.clear();
+    }
+
+    void RunCreateFromSurface(SDL_Renderer* renderer, const std::vector<SDL_Surface*>& images)
+    {
+        double best = 1e30;
+        std::vector<SDL_Texture*> textures;
+        for (int pass = 0; pass < PASSES; ++pass)
+        {
+            const auto start = Clock::now();
+            for (SDL_Surface* image : images)
+            {
+                textures.push_back(SDL_CreateTextureFromSurface(renderer, image));
+            }
+            Finish(renderer, textures);
+            best = std::min(best, Milliseconds(Clock::now() - start));
+            Destroy(textures);
+        }
+        std::printf("  %-34s main thread %8.2f ms\n", "SDL_CreateTextureFromSurface", best);
+    }
+
+    void RunPrepared(SDL_Renderer* renderer, const std::vector<SDL_Surface*>& images, const bool premultiply)
+    {
+        TextureLoader loader;
+        loader.setPremultiplyAlpha(premultiply);
+        const SDL_PixelFormat format = loader.uploadFormat(renderer);
+
+        double bestPrepare = 1e30;
+        double bestUpload = 1e30;
+        std::vector<SDL_Surface*> prepared;
+        std::vector<SDL_Texture*> textures;
+        for (int pass = 0; pass < PASSES; ++pass)
+        {
+            std::vector<SDL_Surface*> copies;
+            for (SDL_Surface* image : images)
+            {
+                copies.push_back(SDL_DuplicateSurface(image));
+            }
+
+            auto start = Clock::now();
+            for (SDL_Surface* copy : copies)
+            {
+                prepared.push_back(loader.prepare(copy, format));
+            }
+            bestPrepare = std::min(bestPrepare, Milliseconds(Clock::now() - start));
+
+            start = Clock::now();
+            for (SDL_Surface* surface : prepared)
+            {
+                textures.push_back(surface != nullptr ? loader.upload(renderer, surface) : nullptr);
+            }
+            Finish(renderer, textures);
+            bestUpload = std::min(bestUpload, Milliseconds(Clock::now() - start));
+
+            Destroy(textures);
+            for (SDL_Surface* surface : prepared)
+            {
+                SDL_DestroySurface(surface);
+            }
+            prepared.clear();
+        }
+        std::printf("  %-34s main thread %8.2f ms, prepare %8.2f ms on a worker\n",
+                    premultiply ? "prepare + upload, premultiplied" : "prepare + upload, straight", bestUpload,
+                    bestPrepare);
+    }
+}
+
+int main(const int argc, char** argv)
+{
+    if (argc > 1)
+    {
+        SDL_SetHint(SDL_HINT_RENDER_DRIVER, argv[1]);
+    }
+    if (!SDL_Init(SDL_INIT_VIDEO))
+    {
+        std::printf("SDL_Init failed: %s\n", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Window* window = nullptr;
+    SDL_Renderer* renderer = nullptr;
+    if (!SDL_CreateWindowAndRenderer("texture_upload_bench", 640, 360, SDL_WINDOW_HIDDEN, &window, &renderer))
+    {
+        std::printf("SDL_CreateWindowAndRenderer failed: %s\n", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    std::vector<SDL_Surface*> images = Generate();
+    std::printf("%s renderer, %zu images of %dx%d, upload format %s, best of %d\n", SDL_GetRendererName(renderer),
+                images.size(), SIZE, SIZE,
+                SDL_GetPixelFormatName(TextureLoader{}.uploadFormat(renderer)), PASSES);
+    RunCreateFromSurface(renderer, images);
+    RunPrepared(renderer, images, false);
+    RunPrepared(renderer, images, true);
+
+    for (SDL_Surface* image : images)
+    {
+        SDL_DestroySurface(image);
+    }
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return 0;
+}
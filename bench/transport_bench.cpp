@@ -0,0 +1,141 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+// Loopback throughput of Transport in packets per second, against one send system call per packet.
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+#include "psyengine/net/transport.hpp"
+#include "psyengine/net/udp_socket.hpp"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+    using namespace psyengine::net;
+
+    /// Messages queued before each flush; below the pool size so the pool never runs dry.
+    constexpr size_t BURST = 256;
+
+    /// Payload of every message, a typical small game message.
+    constexpr size_t MESSAGE_SIZE = 64;
+
+    /// Gives up on a burst after this long, so lost datagrams cannot stall the benchmark.
+    constexpr auto BURST_TIMEOUT = std::chrono::milliseconds(200);
+
+    double Seconds(const Clock::duration duration)
+    {
+        return std::chrono::duration<double>(duration).count();
+    }
+
+    void Report(const char* name, const Uint64 packets, const Uint64 lost, const double seconds)
+    {
+        std::printf("%-28s %10.0f packets/s  %8.2f MB/s  %llu lost\n", name, static_cast<double>(packets) / seconds,
+                    static_cast<double>(packets * MESSAGE_SIZE) / (seconds * 1e6),
+                    static_cast<unsigned long long>(lost));
+    }
+
+    void RunTransport(const Channel channel, const size_t bursts)
+    {
+        Transport sender;
+        Transport receiver;
+        if (!sender.open(0, true) || !receiver.open(0, true))
+        {
+            std::printf("opening the loopback transports failed\n");
+            return;
+        }
+        const PeerId to = sender.addPeer(Endpoint::Loopback(receiver.localPort()));
+        receiver.addPeer(Endpoint::Loopback(sender.localPort()));
+
+        Uint64 delivered = 0;
+        receiver.setMessageHandler([&](PeerId, Channel, std::span<const std::byte>) { ++delivered; });
+
+        std::array<std::byte, MESSAGE_SIZE> message{};
+        Uint64 lost = 0;
+        const auto start = Clock::now();
+        for (size_t burst = 0; burst < bursts; ++burst)
+        {
+            const Uint64 expected = delivered + BURST;
+            for (size_t i = 0; i < BURST; ++i)
+            {
+                sender.send(to, channel, message);
+            }
+            sender.flush();
+
+            // Reliable bursts also need the receiver's acks back, or the sender's slots fill up
+            const auto deadline = Clock::now() + BURST_TIMEOUT;
+            while (delivered < expected && Clock::now() < deadline)
+            {
+                receiver.pump();
+                sender.pump();
+            }
+            receiver.flush();
+            sender.receive();
+            if (delivered < expected)
+            {
+                lost += expected - delivered;
+                delivered = expected;
+            }
+        }
+        const double seconds = Seconds(Clock::now() - start);
+
+        Report(channel == Channel::Reliable ? "Transport, reliable" : "Transport, unreliable", bursts * BURST - lost,
+               lost, seconds);
+    }
+
+    void RunSingleSends(const size_t bursts)
+    {
+        UdpSocket sender;
+        UdpSocket receiver;
+        if (!sender.open(0, true) || !receiver.open(0, true))
+        {
+            std::printf("opening the loopback sockets failed\n");
+            return;
+        }
+        const Endpoint to = Endpoint::Loopback(receiver.localPort());
+
+        std::vector<std::byte> storage(BURST * MESSAGE_SIZE);
+        std::vector<Datagram> datagrams(BURST);
+        for (size_t i = 0; i < BURST; ++i)
+        {
+            datagrams[i].buffer = std::span(storage).subspan(i * MESSAGE_SIZE, MESSAGE_SIZE);
+        }
+
+        const std::array<std::byte, MESSAGE_SIZE> message{};
+        Uint64 received = 0;
+        Uint64 lost = 0;
+        const auto start = Clock::now();
+        for (size_t burst = 0; burst < bursts; ++burst)
+        {
+            for (size_t i = 0; i < BURST; ++i)
+            {
+                sender.sendTo(to, message);
+            }
+
+            size_t got = 0;
+            const auto deadline = Clock::now() + BURST_TIMEOUT;
+            while (got < BURST && Clock::now() < deadline)
+            {
+                got += receiver.receiveBatch(std::span(datagrams).first(BURST - got));
+            }
+            received += got;
+            lost += BURST - got;
+        }
+        const double seconds = Seconds(Clock::now() - start);
+        Report("UdpSocket::sendTo per packet", received, lost, seconds);
+    }
+}
+
+int main()
+{
+    std::printf("Loopback, %zu-byte messages in bursts of %zu, batched system calls %s\n", MESSAGE_SIZE, BURST,
+                UdpSocket::HasBatchSyscalls() ? "available" : "unavailable");
+    RunSingleSends(2000);
+    RunTransport(Channel::Unreliable, 2000);
+    RunTransport(Channel::Reliable, 2000);
+    return 0;
+}
@@ -0,0 +1,155 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_DEBUG_DRAW_HPP
+#define PSYENGINE_DEBUG_DRAW_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <SDL3/SDL_render.h>
+
+#include "psyengine/graphics/render_context.hpp"
+
+namespace psyengine::debug
+{
+    /**
+     * @struct DebugDrawStats
+     * @brief What the last DebugDraw::flush submitted.
+     */
+    struct DebugDrawStats
+    {
+        size_t primitives = 0;
+        size_t vertices = 0;
+        size_t indices = 0;
+        size_t texts = 0;
+    };
+
+#ifndef NDEBUG
+    /**
+     * @class DebugDraw
+     * @brief Immediate-mode debug shapes, drawn in one batch per frame.
+     *
+     * States queue lines, rectangles, circles and text from anywhere in update or render, in render coordinates.
+     * SdlRuntime flushes the queue after the state stack and any resolution upscale, so the overlay is drawn at
+     * full resolution on top of the frame. Shapes become triangles in one vertex buffer and go out in a single
+     * SDL_RenderGeometry call; text uses SDL's built-in debug font afterwards.
+     *
+     * Builds with NDEBUG get an empty inline stand-in, so calls compile away without guards at the call site.
+     * Main thread only.
+     */
+    class DebugDraw
+    {
+    public:
+        static DebugDraw& instance();
+
+        void line(SDL_FPoint from, SDL_FPoint to, SDL_FColor color, float thickness = 1.0F);
+
+        void rect(const SDL_FRect& rect, SDL_FColor color, float thickness = 1.0F);
+
+        void fillRect(const SDL_FRect& rect, SDL_FColor color);
+
+        /// @param segments Edges of the polygon approximating the circle; 0 picks a count from the radius.
+        void circle(SDL_FPoint center, float radius, SDL_FColor color, float thickness = 1.0F, int segments = 0);
+
+        void fillCircle(SDL_FPoint center, float radius, SDL_FColor color, int segments = 0);
+
+        /// Queues text in SDL's 8x8 debug font, top-left at position.
+        void text(SDL_FPoint position, std::string_view text, SDL_FColor color);
+
+        /// Draws and clears everything queued, restoring the renderer's draw color and blend mode.
+        void flush(graphics::RenderContext& context);
+
+        /// Drops everything queued, e.g. when a frame is skipped.
+        void clear() noexcept;
+
+        /// Disabled, every call is ignored; lets a debug build toggle the overlay at runtime.
+        void setEnabled(const bool enabled) noexcept
+        {
+            enabled_ = enabled;
+        }
+
+        [[nodiscard]] bool enabled() const noexcept
+        {
+            return enabled_;
+        }
+
+        [[nodiscard]] const DebugDrawStats& lastFlush() const noexcept
+        {
+            return lastFlush_;
+        }
+
+        ~DebugDraw() = default;
+        DebugDraw(const DebugDraw& other) = delete;
+        DebugDraw(DebugDraw&& other) noexcept = delete;
+        DebugDraw& operator=(const DebugDraw& other) = delete;
+        DebugDraw& operator=(DebugDraw&& other) noexcept = delete;
+
+    private:
+        struct Text
+        {
+            SDL_FPoint position;
+            SDL_FColor color;
+            size_t offset; ///< Into text_, NUL-terminated.
+        };
+
+        DebugDraw() = default;
+
+        /// Adds a quad from four corners in order around it.
+        void quad(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_FPoint d, SDL_FColor color);
+
+        std::vector<SDL_Vertex> vertices_;
+        std::vector<int> indices_;
+        std::vector<Text> texts_;
+        std::string text_;
+        size_t primitives_ = 0;
+        DebugDrawStats lastFlush_{};
+        bool enabled_ = true;
+    };
+#else
+    class DebugDraw
+    {
+    public:
+        static DebugDraw& instance()
+        {
+            static DebugDraw draw;
+            return draw;
+        }
+
+        void line(SDL_FPoint, SDL_FPoint, SDL_FColor, float = 1.0F) {}
+        void rect(const SDL_FRect&, SDL_FColor, float = 1.0F) {}
+        void fillRect(const SDL_FRect&, SDL_FColor) {}
+        void circle(SDL_FPoint, float, SDL_FColor, float = 1.0F, int = 0) {}
+        void fillCircle(SDL_FPoint, float, SDL_FColor, int = 0) {}
+        void text(SDL_FPoint, std::string_view, SDL_FColor) {}
+        void flush(graphics::RenderContext&) {}
+        void clear() noexcept {}
+        void setEnabled(bool) noexcept {}
+
+        [[nodiscard]] bool enabled() const noexcept
+        {
+            return false;
+        }
+
+        [[nodiscard]] const DebugDrawStats& lastFlush() const noexcept
+        {
+            return lastFlush_;
+        }
+
+        ~DebugDraw() = default;
+        DebugDraw(const DebugDraw& other) = delete;
+        DebugDraw(DebugDraw&& other) noexcept = delete;
+        DebugDraw& operator=(const DebugDraw& other) = delete;
+        DebugDraw& operator=(DebugDraw&& other) noexcept = delete;
+
+    private:
+        DebugDraw() = default;
+
+        DebugDrawStats lastFlush_{};
+    };
+#endif
+}
+
+#endif //PSYENGINE_DEBUG_DRAW_HPP
@@ -0,0 +1,177 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_LATENCY_HARNESS_HPP
+#define PSYENGINE_LATENCY_HARNESS_HPP
+
+#include <array>
+#include <deque>
+
+#include <SDL3/SDL.h>
+
+namespace psyengine::debug
+{
+    /**
+     * @class LatencyHistogram
+     * @brief Fixed-bucket latency histogram with 0.1 ms resolution up to 100 ms.
+     *
+     * Recording is O(1) and allocation free, so it is safe to keep in the main loop.
+     * Samples above the range land in an overflow bucket but still count towards mean and max.
+     */
+    class LatencyHistogram
+    {
+    public:
+        static constexpr Uint64 BUCKET_WIDTH_NS = 100'000;
+        static constexpr size_t BUCKET_COUNT = 1000;
+
+        /// Records one latency sample in nanoseconds.
+        void record(Uint64 nanoseconds) noexcept;
+
+        /// Clears all samples.
+        void reset() noexcept;
+
+        /// @return Number of recorded samples.
+        [[nodiscard]] Uint64 count() const noexcept
+        {
+            return count_;
+        }
+
+        /// @return Mean latency in milliseconds, or 0 without samples.
+        [[nodiscard]] double meanMs() const noexcept;
+
+        /// @return Largest recorded latency in milliseconds.
+        [[nodiscard]] double maxMs() const noexcept;
+
+        /**
+         * Estimates a percentile from the buckets.
+         *
+         * @param percentile Percentile in [0, 100].
+         * @return Upper edge of the bucket containing the percentile, in milliseconds.
+         */
+        [[nodiscard]] double percentileMs(double percentile) const noexcept;
+
+    private:
+        std::array<Uint64, BUCKET_COUNT + 1> buckets_{};
+        Uint64 count_ = 0;
+        Uint64 sumNs_ = 0;
+        Uint64 maxNs_ = 0;
+    };
+
+    /**
+     * @class LatencyHarness
+     * @brief Measures end-to-end input latency by injecting synthetic key presses into the SDL event queue.
+     *
+     * Every probe is a key press pushed with SDL_PushEvent and stamped with SDL_GetTicksNS(). SdlRuntime reports
+     * the frame phases to the harness, which records, per probe, the first time each phase saw it:
+     * - Dispatched: SdlRuntime::handleEvents forwarded the event to the input and state managers.
+     * - InputUpdated: InputManager::update() ran, so the probe key is visible to queries.
+     * - FixedUpdate: the first fixedUpdate of the state stack after the input update.
+     * - Presented: the first SDL_RenderPresent after the input update.
+     *
+     * The probe key goes through the normal input path, so states can bind it like any other key.
+     * To compare pacer settings without a display, call configureHeadless() before SdlRuntime::init().
+     *
+     * Threading: main thread only, like the runtime it is attached to.
+     */
+    class LatencyHarness
+    {
+    public:
+        enum class Stage : Uint8
+        {
+            Dispatched,
+            InputUpdated,
+            FixedUpdate,
+            Presented,
+            Count
+        };
+
+        struct Summary
+        {
+            Uint64 count;
+            double meanMs;
+            double p50Ms;
+            double p90Ms;
+            double p99Ms;
+            double maxMs;
+        };
+
+        /// Keyboard id carried by synthetic events so they can be told apart from real input.
+        static constexpr SDL_KeyboardID SYNTHETIC_KEYBOARD_ID = 0xFFFFFF00U;
+
+        /**
+         * @param probeKey The key the synthetic presses use.
+         * @param injectionInterval Seconds between probes.
+         */
+        explicit LatencyHarness(SDL_Keycode probeKey = SDLK_F24, double injectionInterval = 0.1);
+
+        /**
+         * Selects the offscreen video driver and the software renderer.
+         * Must be called before SdlRuntime::init().
+         */
+        static void configureHeadless();
+
+        /// Sets the number of seconds between injected probes.
+        void setInjectionInterval(double seconds) noexcept;
+
+        /// Pushes a probe press immediately, regardless of the injection interval.
+        void inject();
+
+        // --- Frame phase hooks, called by SdlRuntime ---
+
+        /// Injects a probe when one is due and releases the previous one.
+        void onFrameBegin();
+        /// Called for every event SdlRuntime dispatches.
+        void onEventDispatched(const SDL_Event& event);
+        /// Called after InputManager::update().
+        void onInputUpdated();
+        /// Called after each fixed update of the state stack.
+        void onFixedUpdate();
+        /// Called after SDL_RenderPresent().
+        void onPresented();
+
+        /// @return The injection-to-stage histogram for the given stage.
+        [[nodiscard]] const LatencyHistogram& histogram(Stage stage) const noexcept;
+
+        /// @return Aggregated statistics for the given stage.
+        [[nodiscard]] Summary summary(Stage stage) const noexcept;
+
+        /// @return Number of probes still travelling through the frame.
+        [[nodiscard]] size_t pendingProbes() const noexcept
+        {
+            return pending_.size();
+        }
+
+        /// Logs one line per stage through SDL_Log.
+        void logReport() const;
+
+        /// Clears histograms and in-flight probes.
+        void reset();
+
+        /// @return Human-readable stage name.
+        [[nodiscard]] static const char* stageName(Stage stage) noexcept;
+
+    private:
+        static constexpr size_t STAGE_COUNT = static_cast<size_t>(Stage::Count);
+
+        struct Probe
+        {
+            Uint64 injectedNs = 0;
+            std::array<Uint64, STAGE_COUNT> stageNs{};
+        };
+
+        [[nodiscard]] static bool reached(const Probe& probe, Stage stage) noexcept;
+        void mark(Probe& probe, Stage stage, Uint64 nowNs);
+        void pushKey(bool down, Uint64 timestampNs) const;
+
+        SDL_Keycode probeKey_;
+        Uint64 intervalNs_;
+        Uint64 lastInjectNs_ = 0;
+        bool keyDown_ = false;
+
+        std::deque<Probe> pending_;
+        std::array<LatencyHistogram, STAGE_COUNT> histograms_{};
+    };
+}
+
+#endif //PSYENGINE_LATENCY_HARNESS_HPP
@@ -0,0 +1,108 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_TICK_HASH_LOG_HPP
+#define PSYENGINE_TICK_HASH_LOG_HPP
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+
+namespace psyengine::state
+{
+    class StateManager;
+}
+
+namespace psyengine::debug
+{
+    /**
+     * @class TickHashLog
+     * @brief Per-tick record of simulation hashes for determinism checks.
+     *
+     * Attach one to SdlRuntime or server::WorldContext; after every fixed update the state stack is hashed
+     * through BaseState::hashSimulation and recorded under the tick number. Two runs fed the same replayed
+     * input should produce identical logs, and FirstDivergence() points at the first tick where they do not.
+     *
+     * Logs are saved as text, one "tick hash" pair per line, so that they also diff well with ordinary tools.
+     */
+    class TickHashLog
+    {
+    public:
+        struct Entry
+        {
+            Uint64 tick;
+            Uint64 hash;
+        };
+
+        /**
+         * @struct Divergence
+         * @brief The first tick at which two logs disagree.
+         */
+        struct Divergence
+        {
+            Uint64 tick;
+            std::optional<Uint64> expected; ///< Hash in the first log, if it has this tick.
+            std::optional<Uint64> actual; ///< Hash in the second log, if it has this tick.
+        };
+
+        /**
+         * Appends the hash of a tick. Recording a tick that is not newer than the last one, as happens when a
+         * rollback resimulates, replaces it and drops everything after it.
+         */
+        void record(Uint64 tick, Uint64 hash);
+
+        /**
+         * Hashes a state stack through BaseState::hashSimulation and records the result, timing the hashing.
+         *
+         * @param tick The fixed tick that just completed.
+         * @param states The state stack to hash.
+         */
+        void recordStates(Uint64 tick, const state::StateManager& states);
+
+        /// @return The hash recorded for a tick, if any.
+        [[nodiscard]] std::optional<Uint64> hashAt(Uint64 tick) const;
+
+        [[nodiscard]] const std::vector<Entry>& entries() const noexcept
+        {
+            return entries_;
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return entries_.size();
+        }
+
+        void clear() noexcept;
+
+        /// @return Mean seconds recordStates spent hashing per recorded tick, to keep an eye on the cost in QA builds.
+        [[nodiscard]] double meanHashTime() const noexcept
+        {
+            return entries_.empty() ? 0.0 : hashTime_ / static_cast<double>(entries_.size());
+        }
+
+        /// Writes the log as text. @return true on success.
+        bool saveToFile(const std::string& path) const;
+
+        /// Replaces the log with the contents of a file written by saveToFile. @return true on success.
+        bool loadFromFile(const std::string& path);
+
+        /**
+         * Compares two logs tick by tick over their common range.
+         *
+         * @param expected Log of the reference run.
+         * @param actual Log of the run under test.
+         * @return The first tick whose hashes differ or that only one log recorded, or nullopt if they agree.
+         */
+        [[nodiscard]] static std::optional<Divergence> FirstDivergence(const TickHashLog& expected,
+                                                                      const TickHashLog& actual);
+
+    private:
+        std::vector<Entry> entries_;
+        double hashTime_ = 0.0;
+    };
+}
+
+#endif //PSYENGINE_TICK_HASH_LOG_HPP
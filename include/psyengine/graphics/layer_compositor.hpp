@@ -0,0 +1,195 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_LAYER_COMPOSITOR_HPP
+#define PSYENGINE_LAYER_COMPOSITOR_HPP
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <SDL3/SDL_render.h>
+
+#include "psyengine/graphics/render_context.hpp"
+#include "psyengine/platform/sdl_raii.hpp"
+
+namespace psyengine::graphics
+{
+    /**
+     * Draws a layer's content. Content at position p in the layer's space belongs at p - area.x/y in the
+     * current target; area is the part of the layer's space the target covers. Leave target, scale and viewport
+     * as they are; the draw color starts out white.
+     */
+    using LayerDrawFunction = std::function<void(RenderContext& context, const SDL_FRect& area)>;
+
+    /**
+     * @enum LayerPass
+     * @brief Where in the frame a group of layers is composited.
+     */
+    enum class LayerPass
+    {
+        Below, ///< Layers with negative depth, after the clear and before the state stack.
+        /// Layers with depth 0 and up, after the state stack and any resolution upscale, so HUDs stay sharp.
+        Above,
+    };
+
+    /**
+     * @struct LayerSettings
+     * @brief How a layer scrolls and when its cached texture is redrawn.
+     */
+    struct LayerSettings
+    {
+        int depth = -1; ///< Composite order, lowest first; see LayerPass.
+        SDL_FPoint parallax{1.0F, 1.0F}; ///< Layer scroll per unit of camera scroll; {0, 0} pins it to the screen.
+        /// Pixels drawn past each edge of the screen, so the layer scrolls this far before it is redrawn.
+        /// 0 suits pinned layers.
+        int margin = 64;
+        bool cached = true; ///< false draws the layer into the frame every frame, for content that always changes.
+        SDL_ScaleMode scaleMode = SDL_SCALEMODE_NEAREST; ///< Linear moves smoothly between pixels but blurs.
+    };
+
+    /**
+     * @struct LayerStats
+     * @brief What the last frame's LayerCompositor work was.
+     */
+    struct LayerStats
+    {
+        size_t composited = 0; ///< Cached layers blitted into the frame.
+        size_t redrawn = 0; ///< Cached layers whose texture was redrawn.
+        size_t direct = 0; ///< Uncached layers, plus cached ones without a texture, drawn straight into the frame.
+    };
+
+    /**
+     * @class LayerCompositor
+     * @brief Layers of mostly static content, each cached in its own render target and blitted every frame.
+     *
+     * Parallax backgrounds and HUD frames rarely change, yet redrawing them costs their full draw calls every
+     * frame. A cached layer keeps its content in a texture the size of the screen plus a margin on every side;
+     * scrolling within the margin only moves the blit's source rectangle, so a frame of static layers costs one
+     * draw per layer. The texture is redrawn when the layer is invalidated, the screen size changes or the
+     * scroll leaves the margin.
+     *
+     * States add layers in onEnter and remove them in onExit, set the camera as they scroll, and invalidate a
+     * layer when its content changes. SdlRuntime redraws stale layers at the start of render() and composites
+     * them around the state stack. Drawing into a target cleared to transparent leaves it holding premultiplied
+     * alpha, whichever blend modes the drawn textures use, so layers are composited with
+     * SDL_BLENDMODE_BLEND_PREMULTIPLIED.
+     *
+     * Main thread only.
+     */
+    class LayerCompositor
+    {
+    public:
+        static LayerCompositor& instance();
+
+        /**
+         * Adds a layer, or replaces the one with the same name.
+         *
+         * @param name Name to refer to the layer by.
+         * @param settings Depth, scrolling and caching.
+         * @param draw Draws the layer's content.
+         */
+        void addLayer(std::string name, const LayerSettings& settings, LayerDrawFunction draw);
+
+        /// @return true if a layer of that name existed.
+        bool removeLayer(std::string_view name);
+
+        /// @return true if a layer of that name exists.
+        [[nodiscard]] bool contains(std::string_view name) const;
+
+        /// Redraws the layer's texture before its next composite, retrying its creation if that failed before.
+        void invalidate(std::string_view name);
+
+        /// Redraws every layer's texture before its next composite, e.g. after the render targets were reset.
+        void invalidateAll() noexcept;
+
+        /// Hidden layers are neither redrawn nor composited, but keep their texture.
+        void setVisible(std::string_view name, bool visible);
+
+        /// Scroll position; each layer scrolls by the camera times its parallax.
+        void setCamera(SDL_FPoint camera) noexcept
+        {
+            camera_ = camera;
+        }
+
+        [[nodiscard]] SDL_FPoint camera() const noexcept
+        {
+            return camera_;
+        }
+
+        /**
+         * Redraws stale cached layers. Must run before the frame's target is set, since every redraw
+         * switches the target; the target is reset to the window afterwards.
+         *
+         * @param context Context to draw through.
+         * @param width Frame width in render coordinates.
+         * @param height Frame height in render coordinates.
+         */
+        void prepare(RenderContext& context, int width, int height);
+
+        /**
+         * Draws the layers of one pass into the current target, in depth order.
+         *
+         * @param context Context to draw through.
+         * @param pass Which layers to draw.
+         */
+        void composite(RenderContext& context, LayerPass pass);
+
+        /// Destroys every layer texture; they are recreated on the next prepare(). Layers are kept.
+        void releaseTargets() noexcept;
+
+        /// Removes every layer.
+        void clear() noexcept;
+
+        /// @return Counts of the current frame, reset by prepare().
+        [[nodiscard]] const LayerStats& stats() const noexcept
+        {
+            return stats_;
+        }
+
+        ~LayerCompositor() = default;
+        LayerCompositor(const LayerCompositor& other) = delete;
+        LayerCompositor(LayerCompositor&& other) noexcept = delete;
+        LayerCompositor& operator=(const LayerCompositor& other) = delete;
+        LayerCompositor& operator=(LayerCompositor&& other) noexcept = delete;
+
+    private:
+        struct Layer
+        {
+            std::string name;
+            LayerSettings settings;
+            LayerDrawFunction draw;
+            platform::SdlTexturePtr target = nullptr;
+            SDL_FRect area{}; ///< Part of the layer's space the target holds.
+            bool dirty = true;
+            bool visible = true;
+            /// The target could not be created; drawn uncached until invalidated or the targets are released.
+            bool targetFailed = false;
+        };
+
+        LayerCompositor() = default;
+
+        [[nodiscard]] Layer* find(std::string_view name);
+        [[nodiscard]] const Layer* find(std::string_view name) const;
+
+        /// @return The layer's scroll for the current camera.
+        [[nodiscard]] SDL_FPoint scrollOf(const Layer& layer) const noexcept;
+
+        /// @return true if the layer's target no longer covers the screen at its current scroll.
+        [[nodiscard]] bool stale(const Layer& layer) const noexcept;
+
+        /// Renders the layer into its target, creating it if needed; false, and marked failed, if the target
+        /// cannot be created.
+        bool redraw(RenderContext& context, Layer& layer);
+
+        std::vector<Layer> layers_; ///< Sorted by depth, ties in insertion order.
+        SDL_FPoint camera_{0.0F, 0.0F};
+        int width_ = 0;
+        int height_ = 0;
+        LayerStats stats_{};
+    };
+}
+
+#endif //PSYENGINE_LAYER_COMPOSITOR_HPP
@@ -0,0 +1,125 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_PIXELS_HPP
+#define PSYENGINE_PIXELS_HPP
+
+#include <vector>
+
+#include <SDL3/SDL_pixels.h>
+#include <SDL3/SDL_rect.h>
+#include <SDL3/SDL_surface.h>
+
+#include "psyengine/platform/sdl_raii.hpp"
+
+/**
+ * CPU pixel processing for surfaces at load time: format conversion, alpha premultiplication, tinting, color
+ * keying, downscaling and trim-bounds detection.
+ *
+ * The kernels work on 32-bit formats with 8-bit channels, such as ARGB8888, RGBA32 or XRGB8888, in any
+ * channel order. Each has a scalar reference implementation plus AVX2 (x86-64, picked at runtime) and NEON
+ * (AArch64) versions that produce bit-identical results. Other formats are left to SDL: Convert() falls back
+ * to SDL_ConvertSurface, everything else returns false or nullptr for them.
+ *
+ * Channel arithmetic rounds to nearest. Filtering and tinting treat the channels independently, so downscale
+ * premultiplied pixels to keep colors from bleeding out of transparent areas. None of the functions are
+ * thread-safe for the same surface; different surfaces may be processed concurrently.
+ */
+namespace psyengine::graphics::pixels
+{
+    /**
+     * @enum SimdLevel
+     * @brief Instruction set the kernels run with.
+     */
+    enum class SimdLevel
+    {
+        Scalar, ///< Portable reference implementation.
+        Avx2,
+        Neon,
+    };
+
+    /// @return The kernels in use: the best the CPU supports, unless SetSimdLevel() picked others.
+    [[nodiscard]] SimdLevel ActiveSimdLevel() noexcept;
+
+    /**
+     * Switches kernels for the whole process, e.g. to compare against the scalar reference.
+     *
+     * @return false if the CPU or build lacks the instruction set; the kernels stay unchanged.
+     */
+    bool SetSimdLevel(SimdLevel level) noexcept;
+
+    /// @return true if the kernels handle the format directly.
+    [[nodiscard]] bool IsSupported(SDL_PixelFormat format) noexcept;
+
+    /**
+     * Copies a surface into another pixel format. Between supported formats this is a byte shuffle; an alpha
+     * channel the source lacks becomes opaque.
+     *
+     * @return The converted copy, or nullptr on failure.
+     */
+    [[nodiscard]] platform::SdlSurfacePtr Convert(SDL_Surface* surface, SDL_PixelFormat format);
+
+    /// Multiplies the color channels by alpha, in place. @return false if the format has no alpha.
+    bool Premultiply(SDL_Surface* surface);
+
+    /// Divides premultiplied color channels by alpha, in place; fully transparent pixels become zero.
+    bool Unpremultiply(SDL_Surface* surface);
+
+    /// Multiplies every channel, alpha included, by the color's channel over 255, in place.
+    bool Multiply(SDL_Surface* surface, SDL_Color color);
+
+    /// Makes pixels whose color matches the key fully transparent, in place; alpha is ignored when matching.
+    bool ColorKey(SDL_Surface* surface, SDL_Color key);
+
+    /**
+     * Shrinks a surface by an integer factor, averaging each factor x factor block. Edge pixels that do not
+     * fill a block are dropped.
+     *
+     * @return The downscaled copy in the same format, or nullptr on failure.
+     */
+    [[nodiscard]] platform::SdlSurfacePtr DownscaleBox(SDL_Surface* surface, int factor);
+
+    /**
+     * Resizes a surface with bilinear filtering, sampling at pixel centers. Shrinking by more than half skips
+     * source pixels; use DownscaleBox() first for larger factors.
+     *
+     * @return The resized copy in the same format, or nullptr on failure.
+     */
+    [[nodiscard]] platform::SdlSurfacePtr DownscaleBilinear(SDL_Surface* surface, int width, int height);
+
+    /**
+     * Finds the smallest rectangle holding every pixel more opaque than a threshold, e.g. to trim the empty
+     * border of a sprite.
+     *
+     * @param surface Surface with an alpha channel.
+     * @param threshold Pixels with alpha at or below this count as empty.
+     * @return The bounds; empty (zero size) if no pixel passes or the format has no alpha.
+     */
+    [[nodiscard]] SDL_Rect TrimBounds(SDL_Surface* surface, Uint8 threshold = 0);
+
+    /**
+     * @struct Span
+     * @brief Columns [begin, end) of a row.
+     */
+    struct Span
+    {
+        int begin = 0;
+        int end = 0;
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return begin >= end;
+        }
+    };
+
+    /**
+     * Per-row version of TrimBounds(): for each row, the columns from the first to past the last pixel more
+     * opaque than the threshold. Gaps inside a row are included.
+     *
+     * @return One span per row, empty for rows without such pixels; no spans if the format has no alpha.
+     */
+    [[nodiscard]] std::vector<Span> OpaqueSpans(SDL_Surface* surface, Uint8 threshold = 0);
+}
+
+#endif //PSYENGINE_PIXELS_HPP
@@ -0,0 +1,126 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_RENDER_CONTEXT_HPP
+#define PSYENGINE_RENDER_CONTEXT_HPP
+
+#include <cstddef>
+
+#include <SDL3/SDL_render.h>
+
+namespace psyengine::graphics
+{
+    /**
+     * @struct RenderStats
+     * @brief Renderer work of one frame, as counted by a RenderContext.
+     */
+    struct RenderStats
+    {
+        size_t drawCalls = 0; ///< Clears, textures, geometry, rectangles, lines, points and text.
+        /// Draws that cannot join the previous draw's batch: another texture, or a state change in between.
+        size_t batchBreaks = 0;
+        size_t textureSwitches = 0; ///< Textured draws using another texture than the textured draw before.
+        size_t stateChanges = 0; ///< Draw color, blend mode, target, scale, viewport and clip changes.
+        size_t vertices = 0; ///< Geometry vertices; rectangles and glyphs count four, lines and points one each.
+        size_t uploads = 0; ///< Texture updates and uploads recorded with recordUpload().
+        Uint64 uploadedBytes = 0;
+    };
+
+    /**
+     * @class RenderContext
+     * @brief SDL_Renderer wrapper handed to states, counting the work each frame submits.
+     *
+     * Every call forwards to the SDL function of the same name and returns its result. Counting costs a few
+     * comparisons per call. State changes are only counted when they change something, but are always
+     * forwarded, so mixing in direct calls on renderer() never desynchronizes SDL; those calls are just not
+     * counted. SdlRuntime owns the context, resets it every frame and stores the counts in FrameTiming.
+     */
+    class RenderContext
+    {
+    public:
+        explicit RenderContext(SDL_Renderer* renderer) :
+            renderer_(renderer) {}
+
+        /// @return The wrapped renderer, for calls the context does not cover.
+        [[nodiscard]] SDL_Renderer* renderer() const noexcept
+        {
+            return renderer_;
+        }
+
+        /// Resets the counts and the tracked state for a new frame.
+        void beginFrame() noexcept;
+
+        [[nodiscard]] const RenderStats& stats() const noexcept
+        {
+            return stats_;
+        }
+
+        // ---- Drawing ----
+
+        bool clear();
+        bool renderTexture(SDL_Texture* texture, const SDL_FRect* source, const SDL_FRect* destination);
+        bool renderTextureRotated(SDL_Texture* texture, const SDL_FRect* source, const SDL_FRect* destination,
+                                  double angle, const SDL_FPoint* center, SDL_FlipMode flip);
+        bool renderGeometry(SDL_Texture* texture, const SDL_Vertex* vertices, int vertexCount, const int* indices,
+                            int indexCount);
+        bool renderFillRect(const SDL_FRect* rect);
+        bool renderFillRects(const SDL_FRect* rects, int count);
+        bool renderRect(const SDL_FRect* rect);
+        bool renderRects(const SDL_FRect* rects, int count);
+        bool renderLine(float x1, float y1, float x2, float y2);
+        bool renderLines(const SDL_FPoint* points, int count);
+        bool renderPoint(float x, float y);
+        bool renderPoints(const SDL_FPoint* points, int count);
+        bool renderDebugText(float x, float y, const char* text);
+
+        // ---- State ----
+
+        bool setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+        bool setDrawColorFloat(float r, float g, float b, float a);
+        bool setDrawBlendMode(SDL_BlendMode blendMode);
+        bool setTarget(SDL_Texture* texture);
+        bool setScale(float scaleX, float scaleY);
+        bool setViewport(const SDL_Rect* rect);
+        bool setClipRect(const SDL_Rect* rect);
+
+        // ---- Uploads ----
+
+        /// SDL_UpdateTexture, counting the bytes of the updated rows.
+        bool updateTexture(SDL_Texture* texture, const SDL_Rect* rect, const void* pixels, int pitch);
+
+        /// Counts uploads made elsewhere, e.g. textures created by a loader during the frame.
+        void recordUpload(Uint64 bytes, size_t count = 1) noexcept;
+
+        ~RenderContext() = default;
+        RenderContext(const RenderContext& other) = delete;
+        RenderContext(RenderContext&& other) noexcept = delete;
+        RenderContext& operator=(const RenderContext& other) = delete;
+        RenderContext& operator=(RenderContext&& other) noexcept = delete;
+
+    private:
+        /// Counts a draw call and whether it breaks the batch of the one before.
+        void countDraw(const SDL_Texture* texture, size_t vertices) noexcept;
+
+        /// Reads the renderer's state once per frame, so the first setter call only counts if it changes it.
+        void syncState() noexcept;
+
+        /// Counts a state change and marks the current batch as broken.
+        void countStateChange() noexcept;
+
+        SDL_Renderer* renderer_;
+        RenderStats stats_{};
+
+        // Tracked state, to count only changes and batch breaks; reset every frame
+        const SDL_Texture* lastTexture_ = nullptr; ///< Texture of the last draw; nullptr for untextured draws.
+        const SDL_Texture* lastBoundTexture_ = nullptr; ///< Texture of the last textured draw.
+        bool stateChanged_ = false; ///< State changed since the last draw.
+        bool knownState_ = false; ///< The cached values below are valid.
+        SDL_FColor drawColor_{};
+        SDL_BlendMode blendMode_{};
+        SDL_Texture* target_ = nullptr;
+        SDL_FPoint scale_{1.0F, 1.0F};
+    };
+}
+
+#endif //PSYENGINE_RENDER_CONTEXT_HPP
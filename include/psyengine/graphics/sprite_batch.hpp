@@ -0,0 +1,87 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_SPRITE_BATCH_HPP
+#define PSYENGINE_SPRITE_BATCH_HPP
+
+#include <vector>
+
+#include <SDL3/SDL_render.h>
+
+#include "psyengine/graphics/render_context.hpp"
+#include "psyengine/graphics/sprite_mesh.hpp"
+
+namespace psyengine::graphics
+{
+    /**
+     * @struct SpriteBatchStats
+     * @brief What a SpriteBatch submitted since its stats were last reset.
+     */
+    struct SpriteBatchStats
+    {
+        Uint64 sprites = 0;
+        Uint64 batches = 0; ///< SDL_RenderGeometry calls.
+        Uint64 vertices = 0;
+        Uint64 indices = 0;
+        double pixels = 0.0; ///< Screen pixels covered by the submitted triangles: the fill the batch costs.
+        double quadPixels = 0.0; ///< Screen pixels the same sprites would cover as untrimmed quads.
+    };
+
+    /**
+     * @class SpriteBatch
+     * @brief Collects sprite meshes that share a texture and draws them with one SDL_RenderGeometry call.
+     *
+     * A batch is drawn when the texture changes and on flush(). Flush before any other rendering that has to
+     * appear in order with the sprites, and before the end of the frame; the destructor drops what is pending.
+     */
+    class SpriteBatch
+    {
+    public:
+        explicit SpriteBatch(RenderContext& context) :
+            context_(context) {}
+
+        /**
+         * Queues a sprite, placed like SDL_RenderTexture would place the untrimmed sprite.
+         *
+         * @param texture Texture holding the sprite.
+         * @param mesh Mesh built from the sprite's pixels.
+         * @param source Where the untrimmed sprite lies in the texture, or nullptr for the whole texture. If the
+         *               stored image was cropped to mesh.bounds, offset this by -bounds.x and -bounds.y.
+         * @param destination Where the untrimmed sprite goes on the render target.
+         * @param color Color and alpha modulation.
+         */
+        void draw(SDL_Texture* texture, const SpriteMesh& mesh, const SDL_FRect* source,
+                  const SDL_FRect& destination, SDL_FColor color = SDL_FColor{1.0F, 1.0F, 1.0F, 1.0F});
+
+        /// Draws everything queued. @return false if SDL_RenderGeometry failed; the batch is dropped either way.
+        bool flush();
+
+        [[nodiscard]] const SpriteBatchStats& stats() const noexcept
+        {
+            return stats_;
+        }
+
+        void resetStats() noexcept
+        {
+            stats_ = SpriteBatchStats{};
+        }
+
+        ~SpriteBatch() = default;
+        SpriteBatch(const SpriteBatch& other) = delete;
+        SpriteBatch(SpriteBatch&& other) noexcept = delete;
+        SpriteBatch& operator=(const SpriteBatch& other) = delete;
+        SpriteBatch& operator=(SpriteBatch&& other) noexcept = delete;
+
+    private:
+        RenderContext& context_;
+        SDL_Texture* texture_ = nullptr;
+        float textureWidth_ = 0.0F;
+        float textureHeight_ = 0.0F;
+        std::vector<SDL_Vertex> vertices_;
+        std::vector<int> indices_;
+        SpriteBatchStats stats_{};
+    };
+}
+
+#endif //PSYENGINE_SPRITE_BATCH_HPP
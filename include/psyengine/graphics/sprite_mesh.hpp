@@ -0,0 +1,78 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_SPRITE_MESH_HPP
+#define PSYENGINE_SPRITE_MESH_HPP
+
+#include <vector>
+
+#include <SDL3/SDL_rect.h>
+#include <SDL3/SDL_surface.h>
+
+namespace psyengine::graphics
+{
+    /**
+     * @enum SpriteMeshShape
+     * @brief Geometry built around the visible pixels of a sprite.
+     */
+    enum class SpriteMeshShape
+    {
+        Quad, ///< The trimmed bounding rectangle; two triangles.
+        Convex, ///< Convex hull of the visible pixels, reduced to at most maxVertices corners.
+        Concave, ///< A stack of rectangles following the visible span of each group of rows.
+    };
+
+    /**
+     * @struct SpriteMeshOptions
+     * @brief How BuildSpriteMesh() fits geometry to a sprite.
+     */
+    struct SpriteMeshOptions
+    {
+        SpriteMeshShape shape = SpriteMeshShape::Quad;
+        Uint8 alphaThreshold = 0; ///< Pixels with alpha at or below this are not drawn.
+        int maxVertices = 8; ///< Convex corners, or four per rectangle for concave meshes.
+        int minMeshArea = 64 * 64; ///< Trimmed sprites with fewer pixels keep the quad; vertices cost too.
+        float minSavings = 0.1F; ///< Fraction of the quad's pixels a mesh has to save to replace it.
+    };
+
+    /**
+     * @struct SpriteMesh
+     * @brief Triangles covering every visible pixel of a sprite, so the transparent rest is never rasterized.
+     *
+     * Positions are in pixels of the untrimmed sprite, relative to its top-left corner, and double as texture
+     * coordinates into it. Drawing the mesh where the full sprite would go keeps the sprite's pivot.
+     */
+    struct SpriteMesh
+    {
+        int width = 0; ///< Untrimmed sprite size.
+        int height = 0;
+        SDL_Rect bounds{}; ///< Trimmed rectangle of visible pixels; empty for a fully transparent sprite.
+        std::vector<SDL_FPoint> positions;
+        std::vector<int> indices; ///< Triangle list into positions.
+        float area = 0.0F; ///< Pixels the triangles cover at the sprite's own size.
+
+        /// @return true if there is nothing to draw.
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return indices.empty();
+        }
+    };
+
+    /// @return A mesh covering the whole sprite, for sprites drawn without trimming.
+    [[nodiscard]] SpriteMesh MakeQuadMesh(int width, int height);
+
+    /**
+     * Trims a sprite's transparent margins and fits a mesh to what is left, e.g. in a content build step or right
+     * after decoding. Meshes only replace the trimmed quad on sprites large enough for the saved fill to outweigh
+     * the extra vertices.
+     *
+     * @param sprite The sprite's own pixels, before premultiplication or tinting; formats without alpha get a
+     *               full quad.
+     * @param options Shape and limits.
+     * @return The mesh; empty if every pixel is transparent.
+     */
+    [[nodiscard]] SpriteMesh BuildSpriteMesh(SDL_Surface* sprite, const SpriteMeshOptions& options = {});
+}
+
+#endif //PSYENGINE_SPRITE_MESH_HPP
@@ -8,9 +8,11 @@
 #include <string>
 #include <unordered_map>
 #include <variant>
+#include <vector>
 
 #include <SDL3/SDL.h>
 
+#include "psyengine/input/input_sequence.hpp"
 #include "psyengine/time/time.hpp"
 
 namespace psyengine::input
@@ -33,6 +35,15 @@ namespace psyengine::input
     public:
         static InputManager& instance();
 
+        /**
+         * @brief Creates an independent input manager.
+         *
+         * Used by contexts that host their own simulation, such as server::WorldContext; windowed applications
+         * use the instance() fed by SdlRuntime.
+         */
+        InputManager() = default;
+        ~InputManager() = default;
+
         /**
          * @enum MouseButton
          * @brief Represents the different standard buttons on a mouse.
@@ -130,6 +141,19 @@ namespace psyengine::input
             std::vector<Binding> bindings;
         };
 
+        /**
+         * @struct SequenceStep
+         * @brief One press in a registered input sequence.
+         *
+         * maxTicks is how many input ticks (calls to update()) may pass since the previous step. It is ignored
+         * for the first step, and 0 means the press must land in the same tick as the previous one.
+         */
+        struct SequenceStep
+        {
+            Binding binding;
+            Uint32 maxTicks = 8;
+        };
+
         // --- Action binding API ---
 
         /**
@@ -213,6 +237,50 @@ namespace psyengine::input
          */
         [[nodiscard]] bool isActionReleased(const std::string& actionName) const;
 
+        // --- Input sequences (combos) ---
+
+        /**
+         * @brief Registers a timed input sequence, such as a fighting-game command input.
+         *
+         * The sequence is compiled into the shared sequence automaton, so matching cost does not grow with the
+         * number of registered sequences. Registering the same name again adds an alternative spelling of the
+         * same sequence (e.g. a keyboard and a gamepad version).
+         *
+         * @param sequenceName The name used to query the sequence.
+         * @param steps The presses making up the sequence, in order. Must not be empty.
+         */
+        void registerSequence(const std::string& sequenceName, const std::vector<SequenceStep>& steps);
+
+        /**
+         * @brief Checks whether the named sequence completed during the last update() tick.
+         *
+         * @param sequenceName The name the sequence was registered with.
+         * @return True if the final step of the sequence landed in the last tick, otherwise false.
+         */
+        [[nodiscard]] bool isSequenceTriggered(const std::string& sequenceName) const;
+
+        /**
+         * @brief Drops all partially matched sequences, e.g. on a state change or a round reset.
+         */
+        void resetSequences();
+
+        /**
+         * @brief Removes every registered sequence.
+         */
+        void clearSequences();
+
+        /**
+         * @brief Retrieves the current input tick.
+         *
+         * The tick advances once per update() and is the unit sequence windows are measured in.
+         *
+         * @return The number of completed update() calls.
+         */
+        [[nodiscard]] Uint64 inputTick() const noexcept
+        {
+            return inputTick_;
+        }
+
         /**
          * @brief Handles an SDL event and processes it to update input states accordingly.
          *
@@ -240,6 +308,26 @@ namespace psyengine::input
          */
         void update();
 
+        /**
+         * @brief Re-evaluates input states from events received since the last update() without consuming edges.
+         *
+         * Used for late input sampling right before rendering: button states and the mouse position reflect the
+         * freshest events, while presses and releases seen here are still reported as edges by the next update(),
+         * so the simulation never misses them. Edges update() already reported for this frame are kept, so
+         * lateUpdate and render still see them. Does not advance the input tick.
+         */
+        void refresh();
+
+        /**
+         * @brief Retrieves the last known mouse position in window coordinates.
+         *
+         * @return The position from the most recent mouse motion or button event.
+         */
+        [[nodiscard]] SDL_FPoint mousePosition() const noexcept
+        {
+            return mousePosition_;
+        }
+
         /**
          * @brief Checks whether the specified key was clicked (pressed and released) during the current frame.
          *
@@ -433,19 +521,24 @@ namespace psyengine::input
         InputManager& operator=(InputManager&& other) noexcept = delete;
 
     private:
-        InputManager() = default;
-        ~InputManager() = default;
-
         std::unordered_map<Uint8, ButtonData> mouseButtons_;
         std::unordered_map<SDL_Keycode, ButtonData> keyboardButtons_;
 
         GamePad<SDL_GamepadButton, ButtonData> gamepadButtons_;
         GamePad<SDL_GamepadAxis, AxisData> axes_;
 
+        SDL_FPoint mousePosition_{};
+
         std::unordered_map<std::string, Action> actions_;
 
         float holdThreshold_{0.3F};
 
+        SequenceRecognizer sequences_;
+        std::unordered_map<std::string, std::vector<SequenceRecognizer::SequenceId>> sequenceIds_;
+        std::vector<bool> sequenceTriggered_;
+        std::vector<SequenceRecognizer::SequenceId> triggeredSequences_;
+        Uint64 inputTick_{0};
+
         // Helper to check each binding of an action with a callable that returns bool
         template <typename Func>
         bool forEachBinding(const std::string& actionName, Func&& func) const;
@@ -468,13 +561,17 @@ namespace psyengine::input
         [[nodiscard]] ButtonState getButtonState(SDL_Keycode key) const;
         [[nodiscard]] ButtonState getButtonState(Uint8 mouseButton) const;
 
+        // ---- sequence input codes ----
+        [[nodiscard]] static SequenceRecognizer::InputCode encodeInput(const Binding& binding) noexcept;
+        void updateSequences();
+
         static std::string getKeyName(SDL_Keycode key);
         static std::string getGamepadButtonName(SDL_GamepadButton button);
         static std::string getGamepadAxisName(SDL_GamepadAxis axis);
 
-        void updateGamepads(const time::TimePoint& now);
-        void updateMouseButtons(const time::TimePoint& now);
-        void updateKeyboardButtons(const time::TimePoint& now);
+        void updateGamepads(const time::TimePoint& now, bool commit);
+        void updateMouseButtons(const time::TimePoint& now, bool commit);
+        void updateKeyboardButtons(const time::TimePoint& now, bool commit);
     };
 }
 
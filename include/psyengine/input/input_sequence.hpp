@@ -0,0 +1,134 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_INPUT_SEQUENCE_HPP
+#define PSYENGINE_INPUT_SEQUENCE_HPP
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+
+namespace psyengine::input
+{
+    /**
+     * @class SequenceRecognizer
+     * @brief Incrementally matches timed input sequences (fighting-game style command inputs).
+     *
+     * Registered sequences are compiled into a prefix-sharing automaton where every node is a partial
+     * match and every edge is "input X arrived within N ticks of the previous step". Matching keeps a small
+     * set of live nodes (one per reachable prefix, with the tick it was reached) and advances it once per
+     * press edge. The cost of an input event therefore depends on the number of live partial matches, not on
+     * the number of registered sequences or on the length of any input history.
+     *
+     * Inputs are opaque 64-bit codes; InputManager maps its bindings onto them.
+     * Inputs that do not belong to a sequence do not break it, only an expired tick window does.
+     */
+    class SequenceRecognizer
+    {
+    public:
+        using InputCode = Uint64;
+        using SequenceId = Uint32;
+
+        /**
+         * @struct Step
+         * @brief One step of a sequence.
+         *
+         * maxTicks is the largest allowed distance, in ticks, from the previous step. It is ignored for
+         * the first step. A value of 0 requires the input in the same tick as the previous step, which is
+         * how simultaneous presses ("forward + punch") are expressed.
+         */
+        struct Step
+        {
+            InputCode input;
+            Uint32 maxTicks;
+        };
+
+        /**
+         * Compiles a sequence into the automaton.
+         *
+         * @param steps The steps of the sequence, must not be empty.
+         * @return The id reported in completed() when the sequence matches.
+         */
+        SequenceId add(std::span<const Step> steps);
+
+        /**
+         * Feeds a press edge into the automaton.
+         *
+         * @param input The encoded input that was pressed.
+         * @param tick The input tick the press belongs to; must be monotonically non-decreasing.
+         */
+        void onInput(InputCode input, Uint64 tick);
+
+        /// @return Sequences completed since the last call to clearCompleted(). May contain duplicates.
+        [[nodiscard]] std::span<const SequenceId> completed() const noexcept
+        {
+            return completed_;
+        }
+
+        /// Forgets completed sequences, keeps partial matches.
+        void clearCompleted() noexcept
+        {
+            completed_.clear();
+        }
+
+        /// Drops all partial matches, e.g. when a state changes and old input should not carry over.
+        void reset() noexcept;
+
+        /// Removes every registered sequence.
+        void clear();
+
+        /// @return Number of partial matches currently being tracked.
+        [[nodiscard]] size_t liveMatches() const noexcept
+        {
+            return live_.size();
+        }
+
+    private:
+        static constexpr Uint32 ROOT = 0;
+        static constexpr Uint32 NOT_LIVE = ~0U;
+
+        struct Node
+        {
+            Uint32 maxTicks = 0; ///< Window of the edge leading into this node.
+            Uint32 maxChildTicks = 0; ///< Largest window of any outgoing edge, used for expiry.
+            bool hasChildren = false;
+            std::vector<SequenceId> accepts;
+        };
+
+        struct Cursor
+        {
+            Uint32 node;
+            Uint64 tick;
+        };
+
+        struct EdgeKey
+        {
+            Uint32 node;
+            InputCode input;
+            bool operator==(const EdgeKey& other) const = default;
+        };
+
+        struct EdgeKeyHash
+        {
+            size_t operator()(const EdgeKey& key) const noexcept;
+        };
+
+        Uint32 findOrAddChild(Uint32 parent, const Step& step);
+        void reach(Uint32 node, Uint64 tick);
+
+        std::vector<Node> nodes_{Node{}};
+        std::unordered_map<EdgeKey, std::vector<Uint32>, EdgeKeyHash> edges_;
+
+        std::vector<Cursor> live_;
+        std::vector<Cursor> reached_;
+        std::vector<Uint32> liveIndex_{NOT_LIVE};
+        std::vector<SequenceId> completed_;
+
+        SequenceId nextId_ = 0;
+    };
+}
+
+#endif //PSYENGINE_INPUT_SEQUENCE_HPP
@@ -5,6 +5,8 @@
 #ifndef PSYENGINE_VECTOR2_HPP // NOLINT(*-redundant-preprocessor)
 #define PSYENGINE_VECTOR2_HPP
 
+#include <type_traits>
+
 namespace psyengine::math
 {
     template <typename T> requires std::is_arithmetic_v<T>
@@ -354,8 +356,9 @@ namespace psyengine::math
         constexpr Vector2& operator-=(T scalar);
         constexpr Vector2& operator-=(const Vector2& other);
 
-        static constinit Vector2 zero = {Vector2(static_cast<T>(0))};
-        static constinit Vector2 one = {Vector2(static_cast<T>(1))};
+        // Defined in the .ipp: the type is still incomplete here
+        static Vector2 zero;
+        static Vector2 one;
     };
 
     using Vector2F = Vector2<float>;
@@ -16,6 +16,11 @@
 
 namespace psyengine::math
 {
+    template <typename T> requires std::is_arithmetic_v<T>
+    constinit Vector2<T> Vector2<T>::zero = Vector2<T>(static_cast<T>(0));
+
+    template <typename T> requires std::is_arithmetic_v<T>
+    constinit Vector2<T> Vector2<T>::one = Vector2<T>(static_cast<T>(1));
 
     template <typename T> requires std::is_arithmetic_v<T>
     Vector2<T>::Vector2(const T x, const T y) : // NOLINT(*-easily-swappable-parameters)
@@ -0,0 +1,89 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_BIT_STREAM_HPP
+#define PSYENGINE_BIT_STREAM_HPP
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+
+namespace psyengine::net
+{
+    /**
+     * @class BitWriter
+     * @brief Appends values of arbitrary bit width to a byte buffer, least significant bit first.
+     */
+    class BitWriter
+    {
+    public:
+        /**
+         * @param out Buffer to append to; its existing contents are kept.
+         */
+        explicit BitWriter(std::vector<std::byte>& out) noexcept :
+            out_(out) {}
+
+        /// Writes the low bitCount bits of value; bitCount in [0, 32].
+        void write(Uint32 value, unsigned bitCount);
+
+        void writeBool(const bool value)
+        {
+            write(value ? 1U : 0U, 1);
+        }
+
+        /// Writes a signed value as zigzag with a 5-bit length prefix; small magnitudes stay small.
+        void writeSigned(Sint32 value);
+
+        /// Writes an unsigned value with a 5-bit length prefix.
+        void writeVarBits(Uint32 value);
+
+        /// @return Number of bits written through this writer.
+        [[nodiscard]] size_t bitCount() const noexcept
+        {
+            return bits_;
+        }
+
+    private:
+        std::vector<std::byte>& out_;
+        size_t bits_ = 0;
+        unsigned used_ = 8; ///< Bits used in the last byte; 8 forces a new byte.
+    };
+
+    /**
+     * @class BitReader
+     * @brief Reads values written by BitWriter. Reading past the end yields zeros and clears ok().
+     */
+    class BitReader
+    {
+    public:
+        explicit BitReader(const std::span<const std::byte> in) noexcept :
+            in_(in) {}
+
+        [[nodiscard]] Uint32 read(unsigned bitCount) noexcept;
+
+        [[nodiscard]] bool readBool() noexcept
+        {
+            return read(1) != 0;
+        }
+
+        [[nodiscard]] Sint32 readSigned() noexcept;
+
+        [[nodiscard]] Uint32 readVarBits() noexcept;
+
+        /// @return false once a read ran past the end of the data.
+        [[nodiscard]] bool ok() const noexcept
+        {
+            return ok_;
+        }
+
+    private:
+        std::span<const std::byte> in_;
+        size_t position_ = 0;
+        bool ok_ = true;
+    };
+}
+
+#endif //PSYENGINE_BIT_STREAM_HPP
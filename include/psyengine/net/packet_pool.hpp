@@ -0,0 +1,70 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_PACKET_POOL_HPP
+#define PSYENGINE_PACKET_POOL_HPP
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+
+namespace psyengine::net
+{
+    /**
+     * @class PacketPool
+     * @brief Fixed number of equally sized packet buffers carved out of one preallocated block.
+     *
+     * Acquiring and releasing never allocates. Not thread-safe.
+     */
+    class PacketPool
+    {
+    public:
+        using Index = Uint32;
+
+        /**
+         * @param packetCount Number of buffers.
+         * @param packetSize Size of each buffer in bytes.
+         */
+        PacketPool(size_t packetCount, size_t packetSize);
+
+        /// @return A free buffer, or nullopt if all are in use.
+        [[nodiscard]] std::optional<Index> acquire();
+
+        /// Returns a buffer to the pool.
+        void release(Index index);
+
+        /// @return The storage of an acquired buffer.
+        [[nodiscard]] std::span<std::byte> buffer(const Index index) noexcept
+        {
+            return {storage_.data() + static_cast<size_t>(index) * packetSize_, packetSize_};
+        }
+
+        [[nodiscard]] size_t packetSize() const noexcept
+        {
+            return packetSize_;
+        }
+
+        [[nodiscard]] size_t capacity() const noexcept
+        {
+            return inUse_.size();
+        }
+
+        /// @return Number of buffers currently free.
+        [[nodiscard]] size_t available() const noexcept
+        {
+            return free_.size();
+        }
+
+    private:
+        size_t packetSize_;
+        std::vector<std::byte> storage_;
+        std::vector<Index> free_;
+        std::vector<bool> inUse_;
+    };
+}
+
+#endif //PSYENGINE_PACKET_POOL_HPP
@@ -0,0 +1,256 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_REPLICATION_HPP
+#define PSYENGINE_REPLICATION_HPP
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+
+#include "psyengine/math/vector2.hpp"
+
+namespace psyengine::net
+{
+    using EntityId = Uint32;
+    using ClientId = Uint32;
+
+    /// Number of integer fields an entity can replicate besides its position.
+    inline constexpr size_t MAX_REPLICATED_FIELDS = 8;
+
+    /**
+     * @struct ReplicationSchema
+     * @brief How entity state is quantized on the wire; server and clients must use the same schema.
+     */
+    struct ReplicationSchema
+    {
+        math::Vector2F worldMin{-4096.0F, -4096.0F};
+        math::Vector2F worldMax{4096.0F, 4096.0F};
+        float precision = 1.0F / 64.0F; ///< Position resolution in world units.
+
+        /// Bit width of each field, at most 32; the number of entries is the number of fields.
+        std::vector<Uint8> fieldBits{};
+
+        /// @return Bits used per position axis.
+        [[nodiscard]] unsigned positionBits(int axis) const noexcept;
+    };
+
+    /**
+     * @struct EntityState
+     * @brief Server-side state of one replicated entity.
+     */
+    struct EntityState
+    {
+        EntityId id = 0;
+        math::Vector2F position{0.0F, 0.0F};
+        std::array<Uint32, MAX_REPLICATED_FIELDS> fields{};
+    };
+
+    /**
+     * @struct ReplicationStats
+     * @brief Bandwidth of a ReplicationServer.
+     */
+    struct ReplicationStats
+    {
+        Uint64 ticks = 0;
+        size_t clients = 0;
+        size_t lastTickBytes = 0; ///< Snapshot bytes written for all clients in the last tick.
+        double lastTickBytesPerClient = 0.0;
+        double meanBytesPerClientPerTick = 0.0; ///< Since the server was created.
+        double lastTickEntitiesPerClient = 0.0; ///< Entities inside the interest areas on average.
+        Uint64 fullSnapshots = 0; ///< Snapshots sent without a baseline.
+    };
+
+    namespace detail
+    {
+        struct QuantizedEntity
+        {
+            EntityId id;
+            Uint32 x;
+            Uint32 y;
+            std::array<Uint32, MAX_REPLICATED_FIELDS> fields;
+        };
+
+        /// Entities sorted by id, as seen by one client at one tick.
+        struct Snapshot
+        {
+            Uint32 tick = 0;
+            std::vector<QuantizedEntity> entities;
+        };
+
+        /// Fixed-size ring of snapshots keyed by tick.
+        class SnapshotHistory
+        {
+        public:
+            explicit SnapshotHistory(size_t size);
+
+            Snapshot& store(Uint32 tick);
+            [[nodiscard]] const Snapshot* find(Uint32 tick) const noexcept;
+            void clear() noexcept;
+
+        private:
+            std::vector<Snapshot> ring_;
+            std::vector<bool> valid_;
+        };
+    }
+
+    /**
+     * @class ReplicationServer
+     * @brief Server-authoritative snapshot replication with per-client delta compression and interest management.
+     *
+     * Every tick the server quantizes the entity table once and buckets it into a uniform spatial grid. For
+     * each client it then gathers the entities within the client's view radius and encodes them against the
+     * newest snapshot that client acknowledged: unchanged entities cost nothing, changed positions are sent as
+     * small zigzag deltas, and entities entering or leaving the view are sent in full or as removals.
+     * Without an acknowledged baseline the snapshot is sent in full.
+     *
+     * The output is transport independent: writeSnapshot appends to a byte buffer that the caller sends
+     * however it likes, and acknowledge() is fed from whatever the client sends back.
+     *
+     * writeSnapshot() may run concurrently for different clients after update(); everything else must not
+     * overlap with other calls.
+     */
+    class ReplicationServer
+    {
+    public:
+        /**
+         * @param schema Quantization settings shared with the clients.
+         * @param gridCellSize Edge length of interest grid cells; about the typical view radius works well.
+         * @param historySize Snapshots remembered per client as possible baselines.
+         */
+        explicit ReplicationServer(ReplicationSchema schema, float gridCellSize = 64.0F, size_t historySize = 32);
+
+        /// Adds or updates an entity.
+        void setEntity(const EntityState& state);
+
+        /// Removes an entity. @return false if it did not exist.
+        bool removeEntity(EntityId id);
+
+        /// @return Number of entities in the table.
+        [[nodiscard]] size_t entityCount() const noexcept
+        {
+            return entities_.size();
+        }
+
+        /// Registers a client. @return Its id.
+        ClientId addClient();
+
+        /// Unregisters a client. @return false if it did not exist.
+        bool removeClient(ClientId client);
+
+        /// Sets the center and radius of the area a client is interested in.
+        void setClientView(ClientId client, math::Vector2F center, float radius);
+
+        /// Records that a client has received the snapshot of a tick, making it the next baseline.
+        void acknowledge(ClientId client, Uint32 tick);
+
+        /**
+         * Quantizes the entity table and rebuilds the spatial grid. Call once per tick before writeSnapshot.
+         *
+         * @param tick The server tick being replicated.
+         */
+        void update(Uint32 tick);
+
+        /**
+         * Encodes the current tick for a client and appends it to a buffer.
+         *
+         * @param client The receiving client.
+         * @param out Buffer the snapshot is appended to.
+         * @return Bytes appended, 0 if the client is unknown.
+         */
+        size_t writeSnapshot(ClientId client, std::vector<std::byte>& out);
+
+        /// Finishes a tick's statistics after all writeSnapshot calls.
+        void endTick();
+
+        [[nodiscard]] const ReplicationStats& stats() const noexcept
+        {
+            return stats_;
+        }
+
+        [[nodiscard]] const ReplicationSchema& schema() const noexcept
+        {
+            return schema_;
+        }
+
+    private:
+        struct Client
+        {
+            explicit Client(const size_t historySize) :
+                history(historySize) {}
+
+            math::Vector2F center{0.0F, 0.0F};
+            float radius = 0.0F;
+            std::optional<Uint32> acked;
+            detail::SnapshotHistory history;
+            size_t lastBytes = 0;
+            size_t lastEntities = 0;
+            bool lastFull = false;
+        };
+
+        [[nodiscard]] Sint64 cellKey(Sint32 cx, Sint32 cy) const noexcept;
+        void gatherVisible(const Client& client, std::vector<Uint32>& indices) const;
+
+        ReplicationSchema schema_;
+        float cellSize_;
+        size_t historySize_;
+
+        std::vector<EntityState> entities_;
+        std::unordered_map<EntityId, size_t> entityIndex_;
+
+        Uint32 tick_ = 0;
+        std::vector<detail::QuantizedEntity> quantized_; ///< Same order as entities_.
+        std::unordered_map<Sint64, std::vector<Uint32>> grid_; ///< Cell to indices into quantized_.
+
+        std::unordered_map<ClientId, Client> clients_;
+        ClientId nextClient_ = 1;
+
+        ReplicationStats stats_{};
+        Uint64 totalBytes_ = 0;
+        Uint64 totalClientTicks_ = 0;
+    };
+
+    /**
+     * @class ReplicationClient
+     * @brief Decodes snapshots from a ReplicationServer and keeps the replicated entity set.
+     */
+    class ReplicationClient
+    {
+    public:
+        explicit ReplicationClient(ReplicationSchema schema, size_t historySize = 32);
+
+        /**
+         * Decodes one snapshot.
+         *
+         * @param data The bytes produced by ReplicationServer::writeSnapshot.
+         * @return false if the snapshot is malformed or its baseline is no longer known.
+         */
+        bool readSnapshot(std::span<const std::byte> data);
+
+        /// @return The newest tick decoded, to be acknowledged to the server.
+        [[nodiscard]] std::optional<Uint32> latestTick() const noexcept
+        {
+            return latest_;
+        }
+
+        /// @return The entities of the newest decoded snapshot, sorted by id, positions dequantized.
+        [[nodiscard]] const std::vector<EntityState>& entities() const noexcept
+        {
+            return entities_;
+        }
+
+    private:
+        ReplicationSchema schema_;
+        detail::SnapshotHistory history_;
+        std::optional<Uint32> latest_;
+        std::vector<EntityState> entities_;
+    };
+}
+
+#endif //PSYENGINE_REPLICATION_HPP
@@ -0,0 +1,233 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_ROLLBACK_SESSION_HPP
+#define PSYENGINE_ROLLBACK_SESSION_HPP
+
+#include <deque>
+#include <functional>
+#include <optional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "psyengine/net/udp_socket.hpp"
+#include "psyengine/time/time.hpp"
+
+namespace psyengine::input
+{
+    class InputManager;
+}
+
+namespace psyengine::net
+{
+    /// Per-tick input of one player: one bit per action.
+    using InputBits = Uint32;
+
+    /**
+     * @struct RollbackSettings
+     * @brief Fixed parameters of a RollbackSession; both peers must agree on them.
+     */
+    struct RollbackSettings
+    {
+        size_t playerCount = 2;
+        size_t localPlayer = 0;
+        Uint32 inputDelay = 2; ///< Ticks between sampling local input and simulating it; hides some latency.
+        Uint32 maxPredictionTicks = 8; ///< How far the simulation may run ahead of confirmed remote input.
+        Uint32 historySize = 128; ///< Ticks of input kept per player; must exceed delay plus prediction.
+        size_t maxInputsPerPacket = 32; ///< Unacknowledged local inputs resent in every packet.
+    };
+
+    /**
+     * @struct NetworkConditions
+     * @brief Artificial degradation applied to outgoing packets, for testing over loopback.
+     */
+    struct NetworkConditions
+    {
+        double latency = 0.0; ///< One-way delay in seconds.
+        double jitter = 0.0; ///< Extra random delay in [0, jitter] seconds.
+        double lossRate = 0.0; ///< Probability in [0, 1] that a packet is dropped.
+    };
+
+    /**
+     * @struct RollbackStats
+     * @brief Counters of a RollbackSession since it was opened.
+     */
+    struct RollbackStats
+    {
+        Uint64 packetsSent = 0;
+        Uint64 packetsReceived = 0;
+        Uint64 packetsDropped = 0; ///< Dropped by the simulated NetworkConditions.
+        Uint64 bytesSent = 0;
+        Uint64 predictionMisses = 0; ///< Remote inputs that differed from what was simulated.
+        Uint64 rollbacks = 0;
+        Uint64 maxRollbackTicks = 0; ///< Deepest rollback requested.
+        Uint64 stalls = 0; ///< Times canAdvance() refused because prediction ran too far ahead.
+    };
+
+    /**
+     * @class RollbackSession
+     * @brief GGPO-style peer-to-peer input exchange with prediction and rollback.
+     *
+     * Each peer sends its local player's input over UDP, resending everything the other side has not
+     * acknowledged, encoded as XOR deltas so that held buttons cost a byte per tick. Remote input that has not
+     * arrived yet is predicted by repeating the last confirmed value. When the real input arrives and differs
+     * from what was simulated, the session asks for a rollback to the tick before the first miss; SdlRuntime
+     * then restores that snapshot and resimulates (see SdlRuntime::requestRollback).
+     *
+     * Typical use with SdlRuntime and a SnapshotRing, where tick is the tick about to be simulated
+     * (SdlRuntime::fixedTick() + 1):
+     * - once per frame, before the fixed updates: poll(fixedTick()), e.g. from a FramePhase::AfterInput hook.
+     * - SdlRuntime::setTickGate with canAdvance(tick), so a stalled tick is neither counted nor captured and
+     *   both peers keep the same tick numbers.
+     * - in fixedUpdate: unless resimulating, addLocalInput(tick, bits); then simulate with input(tick, player)
+     *   for every player.
+     *
+     * Not thread-safe; use from the thread running the simulation.
+     */
+    class RollbackSession
+    {
+    public:
+        /// Called with the tick to restore; return false if it cannot be restored.
+        using RollbackHandler = std::function<bool(Uint64 tick)>;
+
+        explicit RollbackSession(const RollbackSettings& settings = RollbackSettings{});
+
+        /**
+         * Opens the UDP socket.
+         *
+         * @param port Local port, 0 picks a free one (see localPort()).
+         * @param loopbackOnly Only accept traffic from this machine.
+         * @return true on success.
+         */
+        bool open(Uint16 port = 0, bool loopbackOnly = false);
+
+        /// @return The bound local port.
+        [[nodiscard]] Uint16 localPort() const noexcept
+        {
+            return socket_.localPort();
+        }
+
+        /**
+         * Declares where a remote player's peer lives.
+         *
+         * @param player Remote player index, not the local one.
+         * @param endpoint The peer's address.
+         */
+        void addPeer(size_t player, const Endpoint& endpoint);
+
+        /// Sets how rollbacks are requested, typically forwarding to SdlRuntime::requestRollback.
+        void setRollbackHandler(RollbackHandler handler);
+
+        /// Degrades outgoing traffic to simulate a real network.
+        void setNetworkConditions(const NetworkConditions& conditions);
+
+        /**
+         * Sends local input and processes everything received. Call once per frame before the fixed updates.
+         *
+         * @param simulatedTick The last tick that has been simulated.
+         */
+        void poll(Uint64 simulatedTick);
+
+        /**
+         * @return false if simulating the tick would predict remote input further than maxPredictionTicks;
+         * the caller should wait for input instead of advancing.
+         */
+        [[nodiscard]] bool canAdvance(Uint64 tick);
+
+        /**
+         * Records the local input sampled while simulating a tick. It takes effect inputDelay ticks later.
+         * Do not call while resimulating.
+         */
+        void addLocalInput(Uint64 tick, InputBits bits);
+
+        /**
+         * @return The input of a player for a tick: confirmed if known, predicted otherwise.
+         * Predictions are remembered and checked when the real input arrives.
+         */
+        [[nodiscard]] InputBits input(Uint64 tick, size_t player);
+
+        /// @return true if the player's input for the tick is known rather than predicted.
+        [[nodiscard]] bool isConfirmed(Uint64 tick, size_t player) const;
+
+        /// @return The newest tick for which every player's input is confirmed.
+        [[nodiscard]] Uint64 confirmedTick() const noexcept;
+
+        [[nodiscard]] const RollbackStats& stats() const noexcept
+        {
+            return stats_;
+        }
+
+        [[nodiscard]] const RollbackSettings& settings() const noexcept
+        {
+            return settings_;
+        }
+
+        /**
+         * Packs the held state of named actions into input bits; bit i is actions[i].
+         *
+         * @param input The input manager to sample.
+         * @param actions At most 32 action names.
+         */
+        [[nodiscard]] static InputBits SampleActions(const input::InputManager& input,
+                                                     std::span<const std::string> actions);
+
+    private:
+        static constexpr Uint64 NO_TICK = ~Uint64{0};
+
+        struct Slot
+        {
+            Uint64 tick = NO_TICK;
+            InputBits bits = 0;
+            bool confirmed = false;
+            bool predicted = false;
+        };
+
+        struct Player
+        {
+            std::vector<Slot> slots;
+            Uint64 confirmedUpTo = 0; ///< Every tick up to this one is confirmed.
+            InputBits lastConfirmed = 0;
+        };
+
+        struct Peer
+        {
+            size_t player;
+            Endpoint endpoint;
+            Uint64 acked = 0; ///< Newest local tick the peer has confirmed.
+        };
+
+        struct DelayedPacket
+        {
+            time::TimePoint release;
+            Endpoint to;
+            std::vector<std::byte> data;
+        };
+
+        [[nodiscard]] Slot& slot(size_t player, Uint64 tick);
+        [[nodiscard]] const Slot* findSlot(size_t player, Uint64 tick) const;
+
+        void confirm(size_t player, Uint64 tick, InputBits bits, std::optional<Uint64>& firstMiss);
+        void sendInputs();
+        void send(const Endpoint& to, std::vector<std::byte> data);
+        void flushDelayed();
+        void receive(std::optional<Uint64>& firstMiss);
+
+        RollbackSettings settings_;
+        UdpSocket socket_;
+        std::vector<Player> players_;
+        std::vector<Peer> peers_;
+        Uint64 localNewest_ = 0; ///< Newest tick with local input.
+
+        RollbackHandler rollbackHandler_;
+        NetworkConditions conditions_{};
+        std::deque<DelayedPacket> delayed_;
+        std::mt19937 rng_;
+
+        RollbackStats stats_{};
+    };
+}
+
+#endif //PSYENGINE_ROLLBACK_SESSION_HPP
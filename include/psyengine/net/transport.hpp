@@ -0,0 +1,257 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_TRANSPORT_HPP
+#define PSYENGINE_TRANSPORT_HPP
+
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+
+#include "psyengine/net/packet_pool.hpp"
+#include "psyengine/net/udp_socket.hpp"
+#include "psyengine/time/time.hpp"
+
+namespace psyengine::net
+{
+    using PeerId = Uint32;
+
+    /**
+     * @enum Channel
+     * @brief Delivery guarantee of a message.
+     */
+    enum class Channel : Uint8
+    {
+        Unreliable, ///< Sent once; may be lost, duplicated packets are dropped.
+        Reliable, ///< Resent until acknowledged and delivered exactly once, in send order.
+    };
+
+    /**
+     * @struct TransportSettings
+     * @brief Sizing and timing of a Transport.
+     */
+    struct TransportSettings
+    {
+        size_t packetCount = 1024; ///< Buffers in the packet pool, shared by sending, receiving and resending.
+        size_t packetSize = 1200; ///< Largest datagram, header included; stays under common path MTUs.
+        size_t batchSize = 64; ///< Datagrams per batched receive.
+        size_t maxPendingReliable = 256; ///< Unacknowledged reliable messages allowed per peer.
+        double minResendDelay = 0.05; ///< Seconds before an unacknowledged reliable message is resent.
+        bool acceptUnknownPeers = false; ///< Register unknown senders as new peers instead of ignoring them.
+    };
+
+    /**
+     * @struct TransportStats
+     * @brief Counters since the transport was opened.
+     */
+    struct TransportStats
+    {
+        Uint64 packetsSent = 0;
+        Uint64 packetsReceived = 0;
+        Uint64 bytesSent = 0;
+        Uint64 bytesReceived = 0;
+        Uint64 sendBatches = 0; ///< sendBatch calls; one system call each where batching is available.
+        Uint64 receiveBatches = 0; ///< receiveBatch calls.
+        Uint64 messagesDelivered = 0;
+        Uint64 ackOnlyPackets = 0; ///< Header-only packets sent to acknowledge peers that were not sent anything.
+        Uint64 retransmits = 0;
+        Uint64 sendDropped = 0; ///< Packets dropped because the OS send buffer was full.
+        Uint64 invalidPackets = 0; ///< Datagrams with a bad header or from unknown senders.
+        Uint64 poolExhausted = 0; ///< Sends refused because no packet buffer was free.
+    };
+
+    /**
+     * @class Transport
+     * @brief Batched UDP transport multiplexing reliable and unreliable messages over one socket.
+     *
+     * Each message travels in its own datagram. Every datagram carries a 16-bit sequence number plus the newest
+     * sequence received from the peer and a 32-bit field acknowledging the 32 before it, so every packet acks
+     * up to 33 of the peer's. Reliable messages stay in their pool buffer until a packet carrying them is
+     * acknowledged and are resent after max(minResendDelay, 2 * RTT) otherwise.
+     *
+     * send() only queues; flush() writes headers and hands the whole queue to the OS in as few system calls as
+     * the platform allows (sendmmsg on Linux), and receive() drains the socket the same way (recvmmsg).
+     * Peers that were sent nothing since their last packets arrived get a header-only ack packet on flush, and
+     * one is sent right away whenever 32 packets from a peer arrive unanswered, so bursts are acked completely.
+     *
+     * To run it as part of SdlRuntime, install frame hooks, e.g. receive() at SdlRuntime::FramePhase::AfterInput
+     * and flush() at SdlRuntime::FramePhase::AfterFixedUpdate.
+     *
+     * Not thread-safe.
+     */
+    class Transport
+    {
+    public:
+        using MessageHandler = std::function<void(PeerId, Channel, std::span<const std::byte>)>;
+
+        explicit Transport(const TransportSettings& settings = TransportSettings{});
+        ~Transport();
+
+        /**
+         * Opens the socket.
+         *
+         * @param port Local port, 0 lets the OS pick one.
+         * @param loopbackOnly Bind to 127.0.0.1 only.
+         * @return true on success.
+         */
+        bool open(Uint16 port = 0, bool loopbackOnly = false);
+
+        /// Closes the socket and forgets all peers.
+        void close();
+
+        /// @return The bound local port, or 0 when not open.
+        [[nodiscard]] Uint16 localPort() const noexcept
+        {
+            return socket_.localPort();
+        }
+
+        /// Registers a peer, or returns the existing id if the endpoint is known.
+        PeerId addPeer(const Endpoint& endpoint);
+
+        /// Forgets a peer and drops its pending reliable messages.
+        void removePeer(PeerId peer);
+
+        /// @return The endpoint of a peer, nullopt if unknown.
+        [[nodiscard]] std::optional<Endpoint> peerEndpoint(PeerId peer) const;
+
+        /// @return Smoothed round-trip time to a peer in seconds, 0 if unknown.
+        [[nodiscard]] double roundTripTime(PeerId peer) const;
+
+        /// Sets the callback receiving every delivered message. Messages are delivered from receive().
+        void setMessageHandler(MessageHandler handler);
+
+        /**
+         * Queues a message for the next flush().
+         *
+         * @return false if the peer is unknown, the message is larger than packetSize minus the header, or no
+         *         buffer or reliable slot is free.
+         */
+        bool send(PeerId peer, Channel channel, std::span<const std::byte> message);
+
+        /// Drains the socket in batches, processes acknowledgements and delivers messages.
+        /// Does nothing when called from a message handler.
+        /// @return Number of datagrams received.
+        size_t receive();
+
+        /// Queues due retransmissions and acks, then sends everything queued in batches. Called from a message
+        /// handler, it is deferred until receive() has delivered the whole batch.
+        /// @return Number of datagrams sent, 0 when deferred.
+        size_t flush();
+
+        /// receive() followed by flush().
+        void pump();
+
+        [[nodiscard]] const TransportStats& stats() const noexcept
+        {
+            return stats_;
+        }
+
+        [[nodiscard]] const TransportSettings& settings() const noexcept
+        {
+            return settings_;
+        }
+
+        /// @return Free buffers left in the packet pool.
+        [[nodiscard]] size_t availablePackets() const noexcept
+        {
+            return pool_.available();
+        }
+
+        Transport(const Transport& other) = delete;
+        Transport& operator=(const Transport& other) = delete;
+        Transport(Transport&& other) = delete;
+        Transport& operator=(Transport&& other) = delete;
+
+    private:
+        static constexpr size_t SENT_WINDOW = 256;
+
+        struct SentRecord
+        {
+            Uint16 sequence = 0;
+            bool valid = false;
+            bool reliable = false;
+            Uint16 reliableId = 0;
+            time::TimePoint sentAt = 0;
+        };
+
+        struct ReliableMessage
+        {
+            Uint16 id = 0;
+            PacketPool::Index packet = 0;
+            size_t size = 0;
+            time::TimePoint lastSent = 0;
+            bool queued = false;
+        };
+
+        struct Peer
+        {
+            bool active = false;
+            Endpoint endpoint{};
+
+            Uint16 localSequence = 0;
+            Uint16 remoteSequence = 0;
+            Uint32 receivedBits = 0; ///< Bit n set: remoteSequence - 1 - n was received.
+            bool hasRemote = false;
+            Uint32 unacknowledged = 0; ///< Packets received since anything was last sent to the peer.
+            double roundTripTime = 0.1;
+
+            std::array<SentRecord, SENT_WINDOW> sent{};
+
+            Uint16 nextReliableId = 0;
+            std::vector<ReliableMessage> pendingReliable;
+
+            Uint16 expectedReliableId = 0;
+            std::unordered_map<Uint16, std::vector<std::byte>> outOfOrder;
+        };
+
+        struct Outgoing
+        {
+            PeerId peer;
+            PacketPool::Index packet;
+            size_t size; ///< Total datagram size, header included.
+            Channel channel;
+            Uint16 reliableId;
+            bool ackOnly;
+        };
+
+        [[nodiscard]] static Uint64 EndpointKey(const Endpoint& endpoint) noexcept;
+        Peer* findPeer(PeerId peer) noexcept;
+        [[nodiscard]] const Peer* findPeer(PeerId peer) const noexcept;
+        void releasePeer(Peer& peer);
+
+        void handleDatagram(const Datagram& datagram, time::TimePoint now);
+        void processAcks(Peer& peer, Uint16 ack, Uint32 ackBits, time::TimePoint now);
+        void acknowledgePacket(Peer& peer, Uint16 sequence, time::TimePoint now);
+        void deliverReliable(PeerId id, Peer& peer, Uint16 reliableId, std::span<const std::byte> payload);
+        void deliver(PeerId peer, Channel channel, std::span<const std::byte> payload);
+        void writeHeader(Peer& peer, std::span<std::byte> buffer, const Outgoing& outgoing, time::TimePoint now);
+        void sendAckNow(Peer& peer, time::TimePoint now);
+        void queueRetransmissions(time::TimePoint now);
+        void queueAcks();
+
+        TransportSettings settings_;
+        UdpSocket socket_;
+        PacketPool pool_;
+
+        std::vector<Peer> peers_;
+        std::unordered_map<Uint64, PeerId> peersByEndpoint_;
+
+        std::vector<Outgoing> queue_;
+        std::vector<Datagram> datagrams_; ///< Scratch array for batched calls.
+        std::vector<PacketPool::Index> receiveBuffers_;
+        bool receiving_ = false; ///< datagrams_ holds the batch being delivered.
+        bool flushDeferred_ = false;
+
+        MessageHandler handler_;
+        TransportStats stats_{};
+    };
+}
+
+#endif //PSYENGINE_TRANSPORT_HPP
@@ -0,0 +1,157 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_UDP_SOCKET_HPP
+#define PSYENGINE_UDP_SOCKET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+
+#include <SDL3/SDL_stdinc.h>
+
+namespace psyengine::net
+{
+    /**
+     * @struct Endpoint
+     * @brief IPv4 address and port, both in host byte order.
+     */
+    struct Endpoint
+    {
+        Uint32 address = 0;
+        Uint16 port = 0;
+
+        /// @return 127.0.0.1 with the given port.
+        [[nodiscard]] static constexpr Endpoint Loopback(const Uint16 port) noexcept
+        {
+            return {.address = 0x7F000001U, .port = port};
+        }
+
+        /**
+         * Parses "a.b.c.d:port".
+         *
+         * @return The endpoint, or nullopt if the text is not a valid IPv4 address with a port.
+         */
+        [[nodiscard]] static std::optional<Endpoint> Parse(const std::string& text);
+
+        /// @return The endpoint formatted as "a.b.c.d:port".
+        [[nodiscard]] std::string toString() const;
+
+        friend constexpr bool operator==(const Endpoint&, const Endpoint&) noexcept = default;
+    };
+
+    /**
+     * @struct Datagram
+     * @brief One slot of a batched send or receive.
+     */
+    struct Datagram
+    {
+        Endpoint endpoint{}; ///< Destination when sending, sender when receiving.
+        std::span<std::byte> buffer{}; ///< Payload storage; received datagrams longer than it are truncated.
+        size_t size = 0; ///< Bytes of buffer to send, or bytes received.
+    };
+
+    /**
+     * @class UdpSocket
+     * @brief Minimal non-blocking IPv4 UDP socket over BSD sockets or Winsock.
+     *
+     * SDL3 has no networking, so this talks to the OS directly. Errors are logged with SDL_LogError and
+     * reported as false/nullopt; "would block" is not an error.
+     */
+    class UdpSocket
+    {
+    public:
+        UdpSocket() = default;
+        ~UdpSocket();
+
+        /**
+         * Creates the socket, makes it non-blocking and binds it.
+         *
+         * @param port Local port, 0 lets the OS pick one (see localPort()).
+         * @param loopbackOnly Bind to 127.0.0.1 instead of all interfaces.
+         * @return true on success.
+         */
+        bool open(Uint16 port = 0, bool loopbackOnly = false);
+
+        /// Closes the socket. Safe to call when not open.
+        void close() noexcept;
+
+        [[nodiscard]] bool isOpen() const noexcept
+        {
+            return handle_ != INVALID_HANDLE;
+        }
+
+        /// @return The bound local port, or 0 when not open.
+        [[nodiscard]] Uint16 localPort() const noexcept
+        {
+            return localPort_;
+        }
+
+        /**
+         * Sends one datagram.
+         *
+         * @return false if the datagram could not be handed to the OS.
+         */
+        bool sendTo(const Endpoint& to, std::span<const std::byte> data) const;
+
+        /**
+         * Receives one pending datagram without blocking.
+         *
+         * @param from Receives the sender.
+         * @param buffer Destination; longer datagrams are truncated.
+         * @return The datagram size, or nullopt if nothing is pending or on error.
+         */
+        std::optional<size_t> receiveFrom(Endpoint& from, std::span<std::byte> buffer) const;
+
+        /**
+         * Sends several datagrams, with a single sendmmsg call per batch where the platform has it and one
+         * sendto per datagram otherwise.
+         *
+         * @param datagrams Datagrams to send, in order.
+         * @return How many leading datagrams were handed to the OS; fewer than requested when the send
+         *         buffer is full or on error.
+         */
+        size_t sendBatch(std::span<const Datagram> datagrams) const;
+
+        /**
+         * Receives pending datagrams without blocking, with a single recvmmsg call where the platform has it.
+         *
+         * @param datagrams Slots to fill; each slot's buffer must be set.
+         * @return How many leading slots were filled.
+         */
+        size_t receiveBatch(std::span<Datagram> datagrams) const;
+
+        /// @return true if sendBatch/receiveBatch use one system call per batch on this platform.
+        [[nodiscard]] static constexpr bool HasBatchSyscalls() noexcept
+        {
+#ifdef __linux__
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        /// @return The OS socket handle (int on POSIX, SOCKET on Windows) for platform-specific batching.
+        [[nodiscard]] std::uintptr_t nativeHandle() const noexcept
+        {
+            return handle_;
+        }
+
+        UdpSocket(const UdpSocket& other) = delete;
+        UdpSocket& operator=(const UdpSocket& other) = delete;
+
+        UdpSocket(UdpSocket&& other) noexcept;
+        UdpSocket& operator=(UdpSocket&& other) noexcept;
+
+    private:
+        static constexpr std::uintptr_t INVALID_HANDLE = ~std::uintptr_t{0};
+
+        std::uintptr_t handle_ = INVALID_HANDLE;
+        Uint16 localPort_ = 0;
+    };
+}
+
+#endif //PSYENGINE_UDP_SOCKET_HPP
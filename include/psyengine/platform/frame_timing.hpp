@@ -0,0 +1,61 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_FRAME_TIMING_HPP
+#define PSYENGINE_FRAME_TIMING_HPP
+
+#include <cstddef>
+
+#include "psyengine/graphics/render_context.hpp"
+
+namespace psyengine::platform
+{
+    /**
+     * @struct FrameTiming
+     * @brief Timing record of the most recent frame of SdlRuntime::run.
+     *
+     * All durations are in seconds and measured with the performance counter.
+     */
+    struct FrameTiming
+    {
+        double frameDelta = 0.0; ///< Time between the start of this frame and the previous one (unclamped).
+        double inputTime = 0.0; ///< Event pumping and InputManager::update.
+        double fixedUpdateTime = 0.0; ///< All fixed updates of the frame.
+        double updateTime = 0.0; ///< Variable-step update and lateUpdate.
+        double renderTime = 0.0; ///< Clear, state render and present.
+        double presentTime = 0.0; ///< Part of renderTime blocked in SDL_RenderPresent, mostly the vsync wait.
+        size_t fixedUpdates = 0; ///< Fixed steps run this frame, resimulated ones excluded.
+        size_t resimulatedTicks = 0; ///< Fixed steps replayed by a rollback this frame.
+        size_t stalledTicks = 0; ///< Fixed steps held back by SdlRuntime's tick gate this frame.
+        double snapshotTime = 0.0; ///< Part of fixedUpdateTime spent capturing and restoring snapshots.
+        float renderScale = 1.0F; ///< Dynamic resolution scale the frame was rendered at.
+
+        /// Time from the last input sample to present, i.e. how stale input is when the frame becomes visible.
+        double inputAge = 0.0;
+        /// How much later the late input latch sampled than the start of the frame; 0 when the latch is off.
+        double lateLatchGain = 0.0;
+        size_t lateLatchEvents = 0; ///< Events that arrived in time for the late latch instead of the next frame.
+
+        /// Renderer work of the frame, counted by the RenderContext the runtime and states draw through.
+        graphics::RenderStats renderStats{};
+
+        /// @return Time spent doing work this frame, excluding the idle yield at the end of the loop.
+        [[nodiscard]] double workTime() const noexcept
+        {
+            return inputTime + fixedUpdateTime + updateTime + renderTime;
+        }
+
+        /**
+         * @return workTime() without the present. The present blocks until vsync, so including it would make
+         *         every vsynced frame look like it used its whole budget. GPU work that falls behind still shows
+         *         up here, as the driver then stalls submission of the following frames.
+         */
+        [[nodiscard]] double activeTime() const noexcept
+        {
+            return workTime() - presentTime;
+        }
+    };
+}
+
+#endif //PSYENGINE_FRAME_TIMING_HPP
@@ -0,0 +1,81 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_RESOLUTION_SCALER_HPP
+#define PSYENGINE_RESOLUTION_SCALER_HPP
+
+#include <cstddef>
+
+namespace psyengine::platform
+{
+    /**
+     * @struct DynamicResolutionSettings
+     * @brief Budget and limits for the ResolutionScaler.
+     */
+    struct DynamicResolutionSettings
+    {
+        double frameBudget = 1.0 / 60.0; ///< Target frame work time in seconds.
+        float minScale = 0.5F; ///< Lowest allowed render scale.
+        float maxScale = 1.0F; ///< Highest allowed render scale.
+        float step = 0.05F; ///< Scale quantization; also the size of upward steps.
+        double headroom = 0.8; ///< Scale up only while below this fraction of the budget.
+        size_t cooldownFrames = 15; ///< Frames to wait after a change before changing again.
+    };
+
+    /**
+     * @class ResolutionScaler
+     * @brief Frame-time driven controller for dynamic resolution scaling.
+     *
+     * Tracks an exponential moving average of frame work time and compares it against a budget.
+     * Over budget, the scale drops in one go by the amount fill cost (proportional to scale squared) suggests;
+     * well under budget, it creeps back up one step at a time. A cooldown after every change gives the new
+     * resolution time to show up in the measurements, which keeps the controller from oscillating.
+     */
+    class ResolutionScaler
+    {
+    public:
+        using Settings = DynamicResolutionSettings;
+
+        explicit ResolutionScaler(const Settings& settings = Settings{});
+
+        /**
+         * Feeds the work time of the last frame and adjusts the scale.
+         *
+         * @param frameTime Work time of the last frame in seconds.
+         * @return The scale to use for the next frame.
+         */
+        float update(double frameTime) noexcept;
+
+        /// Restores the maximum scale and forgets the frame history.
+        void reset() noexcept;
+
+        /// @return The current render scale in [minScale, maxScale].
+        [[nodiscard]] float scale() const noexcept
+        {
+            return scale_;
+        }
+
+        /// @return The smoothed frame work time in seconds.
+        [[nodiscard]] double averageFrameTime() const noexcept
+        {
+            return averageFrameTime_;
+        }
+
+        [[nodiscard]] const Settings& settings() const noexcept
+        {
+            return settings_;
+        }
+
+    private:
+        [[nodiscard]] float quantize(float scale) const noexcept;
+
+        Settings settings_;
+        float scale_;
+        double averageFrameTime_ = 0.0;
+        size_t samples_ = 0;
+        size_t cooldown_ = 0;
+    };
+}
+
+#endif //PSYENGINE_RESOLUTION_SCALER_HPP
@@ -5,11 +5,27 @@
 #ifndef PSYENGINE_SDL_GAME_HPP
 #define PSYENGINE_SDL_GAME_HPP
 
+#include <array>
+#include <functional>
 #include <memory>
+#include <optional>
 #include <string>
 
+#include "frame_timing.hpp"
+#include "resolution_scaler.hpp"
 #include "sdl_raii.hpp"
+#include "psyengine/time/time.hpp"
 
+namespace psyengine::debug
+{
+    class LatencyHarness;
+    class TickHashLog;
+}
+
+namespace psyengine::state
+{
+    class SnapshotRing;
+}
 
 namespace psyengine::platform
 {
@@ -25,6 +41,8 @@ namespace psyengine::platform
      * - Coordination with a state manager that hosts game/application states.
      *   SdlRuntime calls into it for handleEvent, fixedUpdate, update, and render.
      * - Lag control: caps the number of fixed updates per frame and drops excess steps while preserving the interpolation phase.
+     * - Background throttling: while minimized, hidden or (opt-in) unfocused it stops rendering and sleeps in
+     *   SDL_WaitEventTimeout between ticks of a reduced simulation rate (see BackgroundPolicy).
      *
      * Typical usage:
      * 1) Construct SdlRuntime with make_shared.
@@ -56,6 +74,57 @@ namespace psyengine::platform
             size_t maxUpdates;
         };
 
+        /**
+         * @struct BackgroundPolicy
+         * @brief Controls how the runtime behaves while the window is minimized, hidden or unfocused.
+         *
+         * In the background the runtime stops rendering and blocks in SDL_WaitEventTimeout between
+         * simulation ticks instead of spinning.
+         */
+        struct BackgroundPolicy
+        {
+            size_t fixedUpdateFrequency = 10; ///< Fixed updates per second in the background; 0 pauses simulation.
+            bool throttleOnFocusLost = false; ///< Also throttle when the window merely loses focus; opt-in.
+        };
+
+        /**
+         * @struct BackgroundStats
+         * @brief Resource usage since the runtime last entered the background.
+         */
+        struct BackgroundStats
+        {
+            double wallTime = 0.0; ///< Seconds spent in the background.
+            double cpuTime = 0.0; ///< Process CPU seconds consumed meanwhile.
+            size_t fixedUpdates = 0; ///< Fixed updates run in the background.
+            size_t stalledTicks = 0; ///< Background ticks held back by the tick gate.
+            size_t wakeups = 0; ///< Times an event woke the runtime before the next tick.
+
+            /// @return Fraction of one core used while in the background.
+            [[nodiscard]] double cpuUsage() const noexcept
+            {
+                return wallTime > 0.0 ? cpuTime / wallTime : 0.0;
+            }
+        };
+
+        /**
+         * @enum FramePhase
+         * @brief Points in a frame of run() where a frame hook can be installed.
+         */
+        enum class FramePhase : Uint8
+        {
+            FrameBegin, ///< Before events are pumped.
+            AfterInput, ///< After events and InputManager::update, before the fixed updates.
+            AfterFixedUpdate, ///< After the fixed updates of the frame, before the variable-step update.
+            BeforeRender, ///< After lateUpdate, right before rendering.
+            AfterPresent, ///< After the frame was presented.
+        };
+
+        /// Callback run at a FramePhase.
+        using FrameHook = std::function<void()>;
+
+        /// Decides whether the tick about to be simulated may run.
+        using TickGate = std::function<bool(Uint64 tick)>;
+
         SdlRuntime() = default;
         ~SdlRuntime();
 
@@ -120,20 +189,185 @@ namespace psyengine::platform
         /// @return true if the runtime is dropping fixed steps due to lag.
         bool isLagging() const;
 
+        /**
+         * Changes the fixed update frequency while running.
+         *
+         * The change is applied at the start of the next frame, never in the middle of a batch of fixed updates.
+         * The accumulated time is rescaled to the new timestep so the interpolation phase carries over: a frame
+         * that was halfway to its next fixed update stays halfway. States are told through
+         * BaseState::onFixedUpdateFrequencyChanged. Called before run(), it overrides run's frequency.
+         *
+         * @param frequency Fixed updates per second; must be greater than 0.
+         * @return false if the frequency is 0.
+         */
+        bool setFixedUpdateFrequency(size_t frequency);
+
+        /// @return Fixed updates per second currently in effect.
+        size_t fixedUpdateFrequency() const;
+
+        /// @return Number of fixed updates run since run() started, background ticks included.
+        Uint64 fixedTick() const;
+
         /// @return Raw SDL window handle (owned by this runtime).
         SDL_Window* window() const;
 
         /// @return Raw SDL renderer handle (owned by this runtime).
         SDL_Renderer* renderer() const;
 
+        /// @return The instrumented context states render through; nullptr before init().
+        graphics::RenderContext* renderContext() const;
+
+        /// Sets how the runtime throttles itself while the window is in the background.
+        void setBackgroundPolicy(const BackgroundPolicy& policy);
+
+        /// @return The current background policy.
+        const BackgroundPolicy& backgroundPolicy() const;
+
+        /// @return true while the window is minimized, hidden, or unfocused (if the policy throttles on focus loss).
+        bool isInBackground() const;
+
+        /// @return Resource usage of the current, or most recent, background period.
+        const BackgroundStats& backgroundStats() const;
+
+        /**
+         * Enables dynamic resolution scaling.
+         *
+         * States are rendered into an intermediate render-target texture at a fraction of the output size,
+         * chosen each frame by a ResolutionScaler from recent frame work times (FrameTiming::activeTime, which
+         * leaves out the vsync wait in the present), and the result is upscaled to the window with linear
+         * filtering. States keep drawing in full-resolution output coordinates; the render scale is applied for
+         * them. At a scale of 1 the intermediate target is bypassed.
+         *
+         * @param settings Budget and limits for the scale controller.
+         */
+        void enableDynamicResolution(const DynamicResolutionSettings& settings = DynamicResolutionSettings{});
+
+        /// Disables dynamic resolution scaling and releases the intermediate target.
+        void disableDynamicResolution();
+
+        /// @return The render scale used for the last frame; 1 when dynamic resolution is disabled.
+        float renderScale() const;
+
+        /**
+         * Enables or disables late input sampling.
+         *
+         * When enabled, events are pumped again and InputManager::refresh() runs after the variable-step update
+         * and right before lateUpdate/render. States can then react to the freshest input for presentation
+         * (camera, cursor) without resimulating; presses seen by the late latch are still delivered as edges
+         * to the next frame's simulation. The effect is reported in frameTiming().
+         *
+         * @param enabled True to sample input a second time right before rendering.
+         */
+        void setLateInputLatch(bool enabled);
+
+        /// @return true if late input sampling is enabled.
+        bool lateInputLatch() const;
+
+        /// @return Timing record of the most recently completed frame.
+        const FrameTiming& frameTiming() const;
+
+        /**
+         * Shows the previous frame's render statistics in the top-left corner, in SDL's debug font. The overlay
+         * is drawn directly on the renderer, so it does not count towards the statistics it shows.
+         *
+         * @param enabled True to draw the overlay every frame.
+         */
+        void setRenderStatsOverlay(bool enabled);
+
+        /// @return true if the render statistics overlay is shown.
+        bool renderStatsOverlay() const;
+
+        /**
+         * Attaches an input latency harness that is notified of every frame phase.
+         * The harness is not owned and must outlive the runtime or be detached with nullptr.
+         *
+         * @param harness The harness to notify, or nullptr to detach.
+         */
+        void setLatencyHarness(debug::LatencyHarness* harness);
+
+        /**
+         * Installs a callback that runs at a fixed point of every frame, e.g. to pump a net::Transport.
+         * In the background, AfterInput runs after every wakeup and AfterFixedUpdate after each batch of
+         * background ticks, so networking keeps going while rendering is throttled; the other phases do not run.
+         * One hook per phase; installing a new one replaces the old.
+         *
+         * @param phase Where in the frame to run.
+         * @param hook The callback, or an empty function to remove it.
+         */
+        void setFrameHook(FramePhase phase, FrameHook hook);
+
+        /**
+         * Attaches a log that records a hash of the state stack after every fixed update, keyed by fixedTick().
+         * Feed two runs the same input and compare their logs with TickHashLog::FirstDivergence.
+         * The log is not owned and must outlive the runtime or be detached with nullptr.
+         *
+         * @param log The log to record into, or nullptr to detach.
+         */
+        void setTickHashLog(debug::TickHashLog* log);
+
+        /**
+         * Attaches a snapshot ring that captures the registered state after every fixed update, keyed by
+         * fixedTick(). The state before the first update is captured as tick 0 when run() starts.
+         * The ring is not owned and must outlive the runtime or be detached with nullptr.
+         *
+         * @param ring The ring to capture into, or nullptr to detach.
+         */
+        void setSnapshotRing(state::SnapshotRing* ring);
+
+        /**
+         * Requests a rollback: at the next fixed-update phase the snapshot of the tick is restored and every
+         * tick after it up to the current fixedTick() is resimulated right away with the current timestep.
+         * States see isResimulating() during the replay and should read per-tick input (e.g. from a rollback
+         * session) rather than the live InputManager.
+         *
+         * @param tick The tick to return to; must be stored in the attached ring and older than fixedTick().
+         * @return false if no ring is attached or the tick cannot be restored.
+         */
+        bool requestRollback(Uint64 tick);
+
+        /// @return true while fixed updates are being replayed after a rollback.
+        bool isResimulating() const;
+
+        /**
+         * Installs a predicate checked before every fixed update with the tick about to be simulated
+         * (fixedTick() + 1). While it returns false the tick stalls: states are not updated, fixedTick() does
+         * not advance, nothing is hashed or captured, and the frame's remaining fixed steps are dropped.
+         * Replays after a rollback are never gated. With a net::RollbackSession, gate on its canAdvance().
+         *
+         * @param gate The predicate, or an empty function to never stall.
+         */
+        void setTickGate(TickGate gate);
+
         SdlRuntime(const SdlRuntime& other) = delete;
 
         SdlRuntime(SdlRuntime&& other) noexcept :
             std::enable_shared_from_this<SdlRuntime>(other),
             running_(other.running_),
             lagging_(other.lagging_),
+            lateInputLatch_(other.lateInputLatch_),
+            renderStatsOverlay_(other.renderStatsOverlay_),
+            fixedUpdateFrequency_(other.fixedUpdateFrequency_),
+            pendingFixedUpdateFrequency_(other.pendingFixedUpdateFrequency_),
+            fixedTick_(other.fixedTick_),
+            pendingRollback_(other.pendingRollback_),
+            resimulating_(other.resimulating_),
+            snapshotTime_(other.snapshotTime_),
+            minimized_(other.minimized_),
+            hidden_(other.hidden_),
+            focused_(other.focused_),
+            backgroundPolicy_(other.backgroundPolicy_),
+            backgroundStats_(other.backgroundStats_),
+            frameTiming_(other.frameTiming_),
             window_(std::move(other.window_)),
-            renderer_(std::move(other.renderer_)) {}
+            renderer_(std::move(other.renderer_)),
+            renderContext_(std::move(other.renderContext_)),
+            resolutionScaler_(std::move(other.resolutionScaler_)),
+            sceneTarget_(std::move(other.sceneTarget_)),
+            latencyHarness_(other.latencyHarness_),
+            tickHashLog_(other.tickHashLog_),
+            snapshotRing_(other.snapshotRing_),
+            frameHooks_(std::move(other.frameHooks_)),
+            tickGate_(std::move(other.tickGate_)) {}
 
         SdlRuntime& operator=(const SdlRuntime& other) = delete;
 
@@ -146,29 +380,111 @@ namespace psyengine::platform
             std::enable_shared_from_this<SdlRuntime>::operator =(other);
             running_ = other.running_;
             lagging_ = other.lagging_;
+            lateInputLatch_ = other.lateInputLatch_;
+            renderStatsOverlay_ = other.renderStatsOverlay_;
+            fixedUpdateFrequency_ = other.fixedUpdateFrequency_;
+            pendingFixedUpdateFrequency_ = other.pendingFixedUpdateFrequency_;
+            fixedTick_ = other.fixedTick_;
+            pendingRollback_ = other.pendingRollback_;
+            resimulating_ = other.resimulating_;
+            snapshotTime_ = other.snapshotTime_;
+            minimized_ = other.minimized_;
+            hidden_ = other.hidden_;
+            focused_ = other.focused_;
+            backgroundPolicy_ = other.backgroundPolicy_;
+            backgroundStats_ = other.backgroundStats_;
+            frameTiming_ = other.frameTiming_;
             window_ = std::move(other.window_);
             renderer_ = std::move(other.renderer_);
+            renderContext_ = std::move(other.renderContext_);
+            resolutionScaler_ = std::move(other.resolutionScaler_);
+            sceneTarget_ = std::move(other.sceneTarget_);
+            latencyHarness_ = other.latencyHarness_;
+            tickHashLog_ = other.tickHashLog_;
+            snapshotRing_ = other.snapshotRing_;
+            frameHooks_ = std::move(other.frameHooks_);
+            tickGate_ = std::move(other.tickGate_);
             return *this;
         }
 
     private:
         /// Polls SDL events, forwards to input and state managers, and handles quit requests.
-        void handleEvents();
+        /// @return The number of events processed.
+        size_t handleEvents();
+
+        /// Dispatches a single event and tracks window visibility.
+        /// @return false if the event requested quitting.
+        bool dispatchEvent(const SDL_Event& event);
+
+        /// Waits for events or the next background tick, then runs due fixed updates without rendering.
+        void backgroundTick(time::TimePoint& lastTime, double& accumulatedTime, size_t maxUpdatesPerFrame,
+                            double maxFrameDeltaTime);
 
-        /// Forwards fixed-step update to the state manager.
-        static void fixedUpdate(double deltaTime);
+        /// Applies a pending frequency change, rescaling the accumulator to keep its phase.
+        void applyFixedUpdateFrequency(double& accumulatedTime);
+
+        /// Restores a requested snapshot and resimulates up to the current tick.
+        /// @return The number of resimulated ticks.
+        size_t applyRollback(double fixedTimeStep);
+
+        /// Runs the hook installed for a phase, if any.
+        void runFrameHook(FramePhase phase) const;
+
+        /// Forwards fixed-step update to the state manager, counts the tick, and hashes and snapshots it if attached.
+        /// @return false if the tick gate stalled the tick; nothing was run or counted then.
+        bool fixedUpdate(double deltaTime);
 
         /// Forwards variable-step update to the state manager.
         static void update(double deltaTime);
 
-        /// Renders the current state with an interpolation factor in [0, 1].
-        void render(float interpolationFactor) const;
+        /// Forwards the pre-render late update to the state manager.
+        static void lateUpdate(double deltaTime);
+
+        /// Renders the layers and the current state with an interpolation factor in [0, 1] and submits the
+        /// frame; run() presents it.
+        void render(float interpolationFactor);
+
+        /// Draws the previous frame's render statistics.
+        void drawRenderStatsOverlay(SDL_Renderer* renderer) const;
+
+        /// Makes sure the intermediate target matches the output size.
+        /// @return false if the target could not be created.
+        bool prepareSceneTarget(int outputWidth, int outputHeight);
 
         bool running_{}; ///< Main loop flag.
         bool lagging_{}; ///< Indicates we dropped fixed steps due to lag in the last frame.
+        bool lateInputLatch_{}; ///< Re-sample input right before rendering.
+        bool renderStatsOverlay_{}; ///< Draw the previous frame's render statistics.
+
+        size_t fixedUpdateFrequency_{60}; ///< Fixed updates per second in effect.
+        size_t pendingFixedUpdateFrequency_{}; ///< Requested frequency, applied next frame; 0 when none.
+        Uint64 fixedTick_{}; ///< Fixed updates since run() started.
+        std::optional<Uint64> pendingRollback_; ///< Tick to roll back to at the next fixed-update phase.
+        bool resimulating_{};
+        double snapshotTime_{}; ///< Snapshot time accumulated for the current frame.
+
+        bool minimized_{};
+        bool hidden_{};
+        bool focused_{true};
+        BackgroundPolicy backgroundPolicy_{};
+        BackgroundStats backgroundStats_{};
+
+        FrameTiming frameTiming_{};
 
         SdlWindowPtr window_ = nullptr;
         SdlRendererPtr renderer_ = nullptr;
+        std::unique_ptr<graphics::RenderContext> renderContext_; ///< Wraps renderer_; created with it.
+
+        std::optional<ResolutionScaler> resolutionScaler_;
+        SdlTexturePtr sceneTarget_ = nullptr; ///< Intermediate target for dynamic resolution.
+
+        debug::LatencyHarness* latencyHarness_ = nullptr; ///< Optional, not owned.
+        debug::TickHashLog* tickHashLog_ = nullptr; ///< Optional, not owned.
+        state::SnapshotRing* snapshotRing_ = nullptr; ///< Optional, not owned.
+
+        static constexpr size_t FRAME_PHASE_COUNT = static_cast<size_t>(FramePhase::AfterPresent) + 1;
+        std::array<FrameHook, FRAME_PHASE_COUNT> frameHooks_{};
+        TickGate tickGate_;
 
     };
 }
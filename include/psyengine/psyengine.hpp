@@ -6,21 +6,56 @@
 #define PSYENGINE_HPP
 
 #include "psyengine/debug/assert.hpp"
+#include "psyengine/debug/debug_draw.hpp"
+#include "psyengine/debug/latency_harness.hpp"
+#include "psyengine/debug/tick_hash_log.hpp"
+
+#include "psyengine/graphics/layer_compositor.hpp"
+#include "psyengine/graphics/pixels.hpp"
+#include "psyengine/graphics/render_context.hpp"
+#include "psyengine/graphics/sprite_batch.hpp"
+#include "psyengine/graphics/sprite_mesh.hpp"
 
 #include "psyengine/input/input_manager.hpp"
+#include "psyengine/input/input_sequence.hpp"
 
 #include "psyengine/math/vector.hpp"
 #include "psyengine/math/vector2.hpp"
 #include "psyengine/math/math_utils.hpp"
 
+#include "psyengine/net/bit_stream.hpp"
+#include "psyengine/net/packet_pool.hpp"
+#include "psyengine/net/replication.hpp"
+#include "psyengine/net/rollback_session.hpp"
+#include "psyengine/net/transport.hpp"
+#include "psyengine/net/udp_socket.hpp"
+
+#include "psyengine/platform/frame_timing.hpp"
+#include "psyengine/platform/resolution_scaler.hpp"
 #include "psyengine/platform/sdl_runtime.hpp"
 
+#include "psyengine/resources/asset_pack.hpp"
+#include "psyengine/resources/async_file_reader.hpp"
+#include "psyengine/resources/decoded_image_cache.hpp"
+#include "psyengine/resources/preload_pipeline.hpp"
+#include "psyengine/resources/resource_cache.hpp"
+#include "psyengine/resources/resource_loaders.hpp"
+#include "psyengine/resources/texture_manager.hpp"
+
+#include "psyengine/server/world_context.hpp"
+#include "psyengine/server/world_scheduler.hpp"
+
 #include "psyengine/state/base_state.hpp"
+#include "psyengine/state/loading_state.hpp"
+#include "psyengine/state/snapshot_ring.hpp"
 #include "psyengine/state/state_manager.hpp"
 
 #include "psyengine/time/clock.hpp"
 #include "psyengine/time/time.hpp"
 
+#include "psyengine/utils/hash.hpp"
 #include "psyengine/utils/random_utils.hpp"
+#include "psyengine/utils/slot_table.hpp"
+#include "psyengine/utils/thread_pool.hpp"
 
 #endif //PSYENGINE_HPP
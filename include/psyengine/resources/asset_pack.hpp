@@ -0,0 +1,178 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_ASSET_PACK_HPP
+#define PSYENGINE_ASSET_PACK_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <SDL3/SDL_surface.h>
+
+#include "psyengine/resources/async_file_reader.hpp"
+
+namespace psyengine::utils
+{
+    class ThreadPool;
+}
+
+namespace psyengine::resources
+{
+    /**
+     * @enum PackCompression
+     * @brief How the pixels of a pack entry are stored.
+     */
+    enum class PackCompression : Uint8
+    {
+        None = 0, ///< Raw pixels; the largest, and loading is a plain read.
+        Lz4 = 1, ///< Fast to decompress, moderate ratio. Needs PSYENGINE_WITH_LZ4.
+        Zstd = 2, ///< Better ratio, slower to decompress. Needs PSYENGINE_WITH_ZSTD.
+    };
+
+    /**
+     * @struct PackEntry
+     * @brief Table-of-contents record of one image in an asset pack.
+     */
+    struct PackEntry
+    {
+        std::string name;
+        Uint32 width = 0;
+        Uint32 height = 0;
+        SDL_PixelFormat format = SDL_PIXELFORMAT_UNKNOWN;
+        Uint32 pitch = 0;
+        PackCompression compression = PackCompression::None;
+        Uint64 offset = 0; ///< Byte offset of the stored data in the pack file.
+        Uint64 storedSize = 0; ///< Bytes stored in the pack.
+        Uint64 rawSize = 0; ///< Bytes of pixel data after decompression, pitch * height.
+    };
+
+    /**
+     * @class AssetPackWriter
+     * @brief Builds an asset pack from decoded images, e.g. in a content build step.
+     *
+     * Layout (little-endian): "PSYPACK\0", version u32, entry count u32, table offset u64, the stored entry data,
+     * then the table of contents.
+     */
+    class AssetPackWriter
+    {
+    public:
+        /**
+         * Adds an image, compressing it right away.
+         *
+         * @param name Key the entry is looked up by.
+         * @param surface Pixels to store; any format, stored as is.
+         * @param compression How to store the pixels.
+         * @param level Compression level; 0 picks the codec default, higher LZ4 levels use LZ4HC.
+         * @return false if the codec is not compiled in, the name is taken, or compression failed.
+         */
+        bool add(const std::string& name, SDL_Surface* surface, PackCompression compression, int level = 0);
+
+        /// Writes the pack. @return true on success.
+        [[nodiscard]] bool save(const std::string& path) const;
+
+        /// @return Stored bytes of all entries added so far.
+        [[nodiscard]] Uint64 storedBytes() const noexcept;
+
+        /// @return true if the codec is compiled in.
+        [[nodiscard]] static bool IsSupported(PackCompression compression) noexcept;
+
+    private:
+        struct Blob
+        {
+            PackEntry entry;
+            std::vector<std::byte> data;
+        };
+
+        std::vector<Blob> blobs_;
+        std::unordered_map<std::string, size_t> names_;
+    };
+
+    /**
+     * @struct LoadedSurface
+     * @brief A pack entry decoded into a surface.
+     *
+     * The surface was made with SDL_CreateSurfaceFrom over pixels, so it is only valid while pixels is alive.
+     * Upload it, destroy it, and let pixels go back to its pool.
+     */
+    struct LoadedSurface
+    {
+        size_t index = 0; ///< Entry index in the pack.
+        SDL_Surface* surface = nullptr;
+        FileBuffer pixels;
+    };
+
+    /**
+     * @struct PackLoadStats
+     * @brief Timing of the last AssetPack::loadSurfaces call.
+     */
+    struct PackLoadStats
+    {
+        size_t entries = 0;
+        Uint64 storedBytes = 0;
+        Uint64 rawBytes = 0;
+        double readTime = 0.0; ///< Summed over worker threads.
+        double decompressTime = 0.0; ///< Summed over worker threads.
+        double wallTime = 0.0; ///< From the call until the last surface was handed over.
+    };
+
+    /**
+     * @class AssetPack
+     * @brief Read side of an asset pack: entries hold pre-decoded pixels, raw or LZ4/zstd compressed.
+     *
+     * Loading skips image decoding entirely. loadSurfaces() spreads reading and decompression across a thread
+     * pool, one file handle per worker, and hands each surface to the calling thread as soon as it is ready,
+     * so texture uploads overlap with the remaining decompression.
+     */
+    class AssetPack
+    {
+    public:
+        AssetPack();
+
+        /**
+         * Opens a pack and reads its table of contents.
+         *
+         * @return false if the file is missing or malformed.
+         */
+        bool open(const std::string& path);
+
+        [[nodiscard]] const std::vector<PackEntry>& entries() const noexcept
+        {
+            return entries_;
+        }
+
+        /// @return Index of the entry with the name, nullopt if absent.
+        [[nodiscard]] std::optional<size_t> find(const std::string& name) const;
+
+        /// Reads and decompresses one entry on the calling thread. @return The surface, nullopt on failure.
+        [[nodiscard]] std::optional<LoadedSurface> loadSurface(size_t index) const;
+
+        /**
+         * Loads every entry in parallel.
+         *
+         * @param threads Pool to decompress on.
+         * @param onLoaded Called on this thread for every entry that loaded, in completion order; must not throw.
+         * @return Number of entries loaded.
+         */
+        size_t loadSurfaces(utils::ThreadPool& threads, const std::function<void(LoadedSurface&)>& onLoaded);
+
+        [[nodiscard]] const PackLoadStats& lastLoadStats() const noexcept
+        {
+            return stats_;
+        }
+
+    private:
+        std::string path_;
+        std::vector<PackEntry> entries_;
+        std::unordered_map<std::string, size_t> names_;
+        std::shared_ptr<BufferPool> pool_;
+        PackLoadStats stats_{};
+    };
+}
+
+#endif //PSYENGINE_ASSET_PACK_HPP
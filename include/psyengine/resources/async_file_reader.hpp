@@ -0,0 +1,223 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_ASYNC_FILE_READER_HPP
+#define PSYENGINE_ASYNC_FILE_READER_HPP
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <span>
+#include <stop_token>
+#include <string>
+
+#include <SDL3/SDL_iostream.h>
+
+namespace psyengine::utils
+{
+    class ThreadPool;
+}
+
+namespace psyengine::resources
+{
+    class BufferPool;
+
+    /**
+     * @class FileBuffer
+     * @brief Move-only handle to a pooled buffer holding a file's contents.
+     *
+     * The memory goes back to its BufferPool when the handle is destroyed, so hold on to it only as long as
+     * the decoder needs it.
+     */
+    class FileBuffer
+    {
+    public:
+        FileBuffer() = default;
+        ~FileBuffer();
+
+        [[nodiscard]] std::span<const std::byte> data() const noexcept
+        {
+            return {data_, size_};
+        }
+
+        /// @return The contents for writing, e.g. by a reader filling the buffer.
+        [[nodiscard]] std::span<std::byte> mutableData() noexcept
+        {
+            return {data_, size_};
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+
+        /**
+         * Wraps the contents in a read-only SDL_IOStream for decoders such as IMG_Load_IO.
+         * The stream does not own the memory; close it before the buffer is released.
+         *
+         * @return The stream, or nullptr on failure.
+         */
+        [[nodiscard]] SDL_IOStream* openIO() const;
+
+        FileBuffer(const FileBuffer& other) = delete;
+        FileBuffer& operator=(const FileBuffer& other) = delete;
+
+        FileBuffer(FileBuffer&& other) noexcept;
+        FileBuffer& operator=(FileBuffer&& other) noexcept;
+
+    private:
+        friend class BufferPool;
+
+        void release() noexcept;
+
+        std::shared_ptr<BufferPool> pool_;
+        std::byte* data_ = nullptr;
+        size_t size_ = 0;
+        size_t capacity_ = 0;
+    };
+
+    /**
+     * @class BufferPool
+     * @brief Thread-safe pool of read buffers in power-of-two size classes.
+     *
+     * Released buffers are kept for reuse, up to a per-class limit, so loading thousands of assets reuses a
+     * small working set of allocations.
+     */
+    class BufferPool : public std::enable_shared_from_this<BufferPool>
+    {
+    public:
+        /**
+         * @param maxCachedPerClass Released buffers kept per size class.
+         */
+        [[nodiscard]] static std::shared_ptr<BufferPool> Create(size_t maxCachedPerClass = 16);
+
+        ~BufferPool();
+
+        /// @return A buffer of at least size bytes whose size() is set to size.
+        [[nodiscard]] FileBuffer acquire(size_t size);
+
+        /// @return Bytes currently held in released buffers.
+        [[nodiscard]] size_t cachedBytes() const;
+
+        BufferPool(const BufferPool& other) = delete;
+        BufferPool(BufferPool&& other) noexcept = delete;
+        BufferPool& operator=(const BufferPool& other) = delete;
+        BufferPool& operator=(BufferPool&& other) noexcept = delete;
+
+    private:
+        friend class FileBuffer;
+
+        struct State;
+
+        explicit BufferPool(size_t maxCachedPerClass);
+
+        void release(std::byte* data, size_t capacity) noexcept;
+
+        std::unique_ptr<State> state_;
+    };
+
+    /**
+     * @struct AsyncReaderSettings
+     * @brief Configuration of an AsyncFileReader.
+     */
+    struct AsyncReaderSettings
+    {
+        size_t queueDepth = 128; ///< Reads in flight at once.
+        size_t threadCount = 0; ///< Workers of the fallback backend; 0 picks hardware_concurrency.
+        bool allowIoUring = true; ///< Use io_uring when compiled in and permitted by the kernel.
+    };
+
+    /**
+     * @struct FileReadResult
+     * @brief Completion of one read of AsyncFileReader::readBatch.
+     */
+    struct FileReadResult
+    {
+        size_t index = 0; ///< Position of the path in the batch.
+        bool ok = false; ///< false if the file could not be opened or read.
+        FileBuffer buffer; ///< The contents when ok.
+    };
+
+    /**
+     * @class AsyncFileReader
+     * @brief Reads many files concurrently into pooled buffers.
+     *
+     * On Linux with PSYENGINE_WITH_IO_URING the reads are batch-submitted to an io_uring: one io_uring_enter
+     * submits every queued read and reaps whatever finished, and the kernel overlaps the I/O. Files are still
+     * opened and sized on the calling thread. Where io_uring is not compiled in, or the kernel refuses it (old
+     * kernels, seccomp sandboxes), reads run on a thread pool through SDL's file I/O instead. Either way
+     * completions are handed to the caller's thread in completion order, so decoding one file overlaps with
+     * reading the next ones.
+     *
+     * If the ring fails mid-batch, the reads it had started fail once the kernel is done with them, and the
+     * reader switches to the thread pool for the rest of the batch and every batch after.
+     *
+     * Not thread-safe; use one reader per loading thread.
+     */
+    class AsyncFileReader
+    {
+    public:
+        enum class Backend
+        {
+            IoUring,
+            ThreadPool,
+        };
+
+        using CompletionHandler = std::function<void(FileReadResult&)>;
+
+        explicit AsyncFileReader(const AsyncReaderSettings& settings = AsyncReaderSettings{});
+        ~AsyncFileReader();
+
+        /**
+         * Reads all files and blocks until each has completed.
+         *
+         * @param paths Files to read.
+         * @param onComplete Called on this thread once per path, in completion order; must not throw. The
+         *                   result's buffer may be moved out to keep it.
+         * @param stopToken Once stop is requested no further files are opened; reads already issued still
+         *                  complete and are reported, paths never started are not.
+         * @return Number of files read successfully.
+         */
+        size_t readBatch(std::span<const std::string> paths, const CompletionHandler& onComplete,
+                         const std::stop_token& stopToken = {});
+
+        /// @return The backend in use.
+        [[nodiscard]] Backend backend() const noexcept
+        {
+            return backend_;
+        }
+
+        /// @return The pool the read buffers come from.
+        [[nodiscard]] const std::shared_ptr<BufferPool>& bufferPool() const noexcept
+        {
+            return pool_;
+        }
+
+        AsyncFileReader(const AsyncFileReader& other) = delete;
+        AsyncFileReader(AsyncFileReader&& other) noexcept = delete;
+        AsyncFileReader& operator=(const AsyncFileReader& other) = delete;
+        AsyncFileReader& operator=(AsyncFileReader&& other) noexcept = delete;
+
+    private:
+        struct Ring;
+
+        size_t readWithRing(std::span<const std::string> paths, const CompletionHandler& onComplete,
+                            const std::stop_token& stopToken);
+        size_t readWithThreads(std::span<const std::string> paths, const CompletionHandler& onComplete,
+                               const std::stop_token& stopToken);
+
+        AsyncReaderSettings settings_;
+        Backend backend_ = Backend::ThreadPool;
+        std::shared_ptr<BufferPool> pool_;
+        std::unique_ptr<Ring> ring_;
+        std::unique_ptr<utils::ThreadPool> threads_;
+    };
+}
+
+#endif //PSYENGINE_ASYNC_FILE_READER_HPP
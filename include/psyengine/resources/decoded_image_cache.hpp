@@ -0,0 +1,117 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_DECODED_IMAGE_CACHE_HPP
+#define PSYENGINE_DECODED_IMAGE_CACHE_HPP
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+#include <SDL3/SDL_render.h>
+
+namespace psyengine::resources
+{
+    /**
+     * @struct DecodedImageCacheStats
+     * @brief Counters of a DecodedImageCache since it was created.
+     */
+    struct DecodedImageCacheStats
+    {
+        size_t hits = 0; ///< Uploaded from the cache, including revalidated entries.
+        size_t revalidated = 0; ///< Hits whose source had a new modification time but the same contents.
+        size_t misses = 0;
+        size_t stores = 0;
+        Uint64 bytesUploaded = 0; ///< Pixel bytes uploaded straight from mapped cache files.
+    };
+
+    /**
+     * @class DecodedImageCache
+     * @brief On-disk cache of decoded images in the renderer's native pixel format.
+     *
+     * Each source image gets one cache file named after the hash of its path. The file records the source's
+     * size, modification time and content hash, followed by the pixels in the renderer's preferred texture
+     * format, with straight or premultiplied alpha as set by setPremultipliedAlpha(). A lookup stats the source
+     * first: if size and modification time match, the cache file is memory-mapped and uploaded without
+     * touching the source at all. If only the modification time differs (a checkout or copy touched the file),
+     * the source is hashed and the entry is still used when the contents are unchanged. Anything else is a
+     * miss and the caller decodes as usual, then stores the result.
+     *
+     * Cache files are written to a temporary name and renamed into place, so a crash never leaves a torn
+     * entry. They use native byte order and are meant for the machine that wrote them.
+     *
+     * Not thread-safe.
+     */
+    class DecodedImageCache
+    {
+    public:
+        /**
+         * @param directory Directory for the cache files; created if missing.
+         */
+        explicit DecodedImageCache(std::string directory);
+
+        [[nodiscard]] const std::string& directory() const noexcept
+        {
+            return directory_;
+        }
+
+        /**
+         * Creates a texture from the cached pixels of an image.
+         *
+         * @param path Source image path.
+         * @param renderer Renderer to create the texture for; its preferred format must match the cached one.
+         * @param contents Source file contents if already in memory; saves reading the file when it has to be
+         *                 revalidated by hash.
+         * @return The texture, or nullptr on a miss.
+         */
+        [[nodiscard]] SDL_Texture* loadTexture(const std::string& path, SDL_Renderer* renderer,
+                                               std::span<const std::byte> contents = {});
+
+        /**
+         * Writes an image prepared for upload to the cache.
+         *
+         * @param path Source image path.
+         * @param prepared The image in its renderer's preferred format, premultiplied if premultipliedAlpha(),
+         *                 as made by TextureLoader::prepare().
+         * @param contents The source file contents the image was decoded from, for the content hash.
+         * @return true if the entry was written.
+         */
+        bool store(const std::string& path, SDL_Surface* prepared, std::span<const std::byte> contents);
+
+        /**
+         * Sets which alpha the cached pixels hold. Entries written in the other mode are misses, and textures
+         * get SDL_BLENDMODE_BLEND_PREMULTIPLIED or SDL_BLENDMODE_BLEND to match. TextureLoader keeps its disk
+         * cache in its own mode.
+         */
+        void setPremultipliedAlpha(const bool premultiplied) noexcept
+        {
+            premultipliedAlpha_ = premultiplied;
+        }
+
+        [[nodiscard]] bool premultipliedAlpha() const noexcept
+        {
+            return premultipliedAlpha_;
+        }
+
+        /// Deletes the cache file of an image, if any.
+        void remove(const std::string& path);
+
+        [[nodiscard]] const DecodedImageCacheStats& stats() const noexcept
+        {
+            return stats_;
+        }
+
+        /// @return The format textures are cached in for a renderer.
+        [[nodiscard]] static SDL_PixelFormat PreferredFormat(SDL_Renderer* renderer);
+
+    private:
+        [[nodiscard]] std::string entryPath(const std::string& path) const;
+
+        std::string directory_;
+        bool premultipliedAlpha_ = false;
+        DecodedImageCacheStats stats_{};
+    };
+}
+
+#endif //PSYENGINE_DECODED_IMAGE_CACHE_HPP
@@ -0,0 +1,196 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_PRELOAD_PIPELINE_HPP
+#define PSYENGINE_PRELOAD_PIPELINE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <SDL3/SDL_render.h>
+
+#include "psyengine/resources/async_file_reader.hpp"
+#include "psyengine/time/time.hpp"
+
+namespace psyengine::utils
+{
+    class ThreadPool;
+}
+
+namespace psyengine::resources
+{
+    /**
+     * @struct AssetManifest
+     * @brief Everything a state needs loaded before it starts, declared up front.
+     */
+    struct AssetManifest
+    {
+        std::vector<std::string> textures; ///< Image paths, loaded into TextureManager keyed by path.
+
+        void addTexture(std::string path)
+        {
+            textures.push_back(std::move(path));
+        }
+
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return textures.size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return textures.empty();
+        }
+    };
+
+    /**
+     * @struct PreloadSettings
+     * @brief Configuration of a PreloadPipeline.
+     */
+    struct PreloadSettings
+    {
+        AsyncReaderSettings reader{}; ///< File reading stage.
+        size_t decodeThreads = 0; ///< Decoder workers; 0 uses every core but the main thread's.
+        size_t maxPending = 64; ///< Assets read but not yet uploaded before reading pauses; bounds memory.
+    };
+
+    /**
+     * @struct PreloadProgress
+     * @brief Snapshot of a PreloadPipeline's progress.
+     */
+    struct PreloadProgress
+    {
+        size_t total = 0;
+        size_t loaded = 0;
+        size_t failed = 0;
+        Uint64 bytesRead = 0; ///< Source file bytes read so far.
+        double elapsed = 0.0; ///< Seconds since start, frozen once finished.
+
+        [[nodiscard]] size_t completed() const noexcept
+        {
+            return loaded + failed;
+        }
+
+        /// @return Completed share of the assets in [0, 1]; 1 when there was nothing to load.
+        [[nodiscard]] float fraction() const noexcept
+        {
+            return total == 0 ? 1.0F : static_cast<float>(completed()) / static_cast<float>(total);
+        }
+
+        [[nodiscard]] double megabytesPerSecond() const noexcept
+        {
+            return elapsed > 0.0 ? static_cast<double>(bytesRead) / (1024.0 * 1024.0) / elapsed : 0.0;
+        }
+
+        [[nodiscard]] double assetsPerSecond() const noexcept
+        {
+            return elapsed > 0.0 ? static_cast<double>(completed()) / elapsed : 0.0;
+        }
+    };
+
+    /**
+     * @class PreloadPipeline
+     * @brief Loads an AssetManifest as a pipeline of reading, decoding and uploading.
+     *
+     * A reader thread streams the files through an AsyncFileReader and hands every completed read to a pool
+     * of decoder threads, which also prepare the images for upload: converted to the renderer's format and,
+     * if the loader is set to, alpha-premultiplied (see TextureLoader). Decoded surfaces queue up for the main
+     * thread, which uploads them in pump() within a time budget, so a loading screen keeps rendering while all
+     * three stages run at once. Reading pauses while maxPending assets wait to be uploaded, which bounds the
+     * memory held by decoded pixels.
+     *
+     * Textures already in TextureManager are skipped. pump() and wait() must be called on the thread that
+     * owns the renderer.
+     */
+    class PreloadPipeline
+    {
+    public:
+        using ProgressCallback = std::function<void(const PreloadProgress&)>;
+
+        explicit PreloadPipeline(const PreloadSettings& settings = PreloadSettings{});
+
+        /// Discards assets not uploaded yet and stops reading; waits for reads already issued to drain.
+        ~PreloadPipeline();
+
+        /**
+         * Starts loading a manifest in the background.
+         *
+         * @return false if a previous manifest is still loading.
+         */
+        bool start(const AssetManifest& manifest);
+
+        /**
+         * Uploads decoded assets until none are ready or the budget is spent, then reports progress.
+         *
+         * @param renderer Renderer to create the textures for.
+         * @param budgetSeconds Time to spend uploading; at least one ready asset is always uploaded.
+         * @return Number of assets completed by this call, including failures.
+         */
+        size_t pump(SDL_Renderer* renderer, double budgetSeconds);
+
+        /// Blocks, uploading as assets become ready, until everything is loaded.
+        void wait(SDL_Renderer* renderer);
+
+        /// @return true once every asset of the manifest was uploaded or failed.
+        [[nodiscard]] bool finished() const noexcept
+        {
+            return progress_.completed() == progress_.total;
+        }
+
+        [[nodiscard]] const PreloadProgress& progress() const noexcept
+        {
+            return progress_;
+        }
+
+        /// Called on the pumping thread after every pump() that completed assets.
+        void setProgressCallback(ProgressCallback callback)
+        {
+            progressCallback_ = std::move(callback);
+        }
+
+        PreloadPipeline(const PreloadPipeline& other) = delete;
+        PreloadPipeline(PreloadPipeline&& other) noexcept = delete;
+        PreloadPipeline& operator=(const PreloadPipeline& other) = delete;
+        PreloadPipeline& operator=(PreloadPipeline&& other) noexcept = delete;
+
+    private:
+        struct Decoded
+        {
+            size_t index = 0;
+            SDL_Surface* surface = nullptr; ///< nullptr if reading or decoding failed.
+            SDL_PixelFormat format = SDL_PIXELFORMAT_UNKNOWN; ///< Format it was prepared for, if any.
+        };
+
+        void onRead(FileReadResult& result);
+        void stop();
+
+        PreloadSettings settings_;
+        std::unique_ptr<AsyncFileReader> reader_;
+        std::unique_ptr<utils::ThreadPool> decoders_;
+        std::jthread readerThread_;
+
+        std::vector<std::string> paths_;
+        PreloadProgress progress_{};
+        time::TimePoint startTime_ = 0;
+        ProgressCallback progressCallback_;
+
+        std::mutex mutex_;
+        std::condition_variable changed_;
+        std::deque<Decoded> ready_;
+        size_t pending_ = 0; ///< Read but not yet taken by pump().
+        std::atomic<Uint64> bytesRead_{0};
+        std::atomic<SDL_PixelFormat> format_{SDL_PIXELFORMAT_UNKNOWN}; ///< Upload format decoders prepare for.
+        std::atomic<bool> cancelled_{false};
+    };
+}
+
+#endif //PSYENGINE_PRELOAD_PIPELINE_HPP
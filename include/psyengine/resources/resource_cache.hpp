@@ -0,0 +1,806 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_RESOURCE_CACHE_HPP
+#define PSYENGINE_RESOURCE_CACHE_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <future>
+#include <limits>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL_events.h>
+#include <SDL3/SDL_init.h>
+
+#include "psyengine/debug/assert.hpp"
+#include "psyengine/time/time.hpp"
+#include "psyengine/utils/slot_table.hpp"
+#include "psyengine/utils/thread_pool.hpp"
+
+namespace psyengine::resources
+{
+    /// 32-bit generational reference to a resource in a ResourceCache.
+    template <typename T>
+    using ResourceHandle = utils::SlotHandle<T>;
+
+    /**
+     * @concept ResourceLoader
+     * @brief What a ResourceCache needs from its loader.
+     *
+     * Besides these, a loader provides `T* load(const std::string& key, Args...)` for the arguments it is
+     * acquired with, returning nullptr on failure. load() and destroy() may be called from any thread and
+     * concurrently with each other.
+     */
+    template <typename Loader, typename T>
+    concept ResourceLoader = requires(Loader& loader, const Loader& constLoader, T* resource, const T& value)
+    {
+        loader.destroy(resource);
+        { constLoader.cost(value) } -> std::convertible_to<size_t>;
+    };
+
+    /**
+     * @struct ResourceCacheStats
+     * @brief Snapshot of a ResourceCache's contents and counters.
+     */
+    struct ResourceCacheStats
+    {
+        size_t resident = 0; ///< Loaded resources.
+        size_t referenced = 0; ///< Resources with at least one reference or pinned; the rest may be evicted.
+        size_t bytes = 0; ///< Estimated memory of the resident resources.
+        size_t budget = 0; ///< Byte budget; SIZE_MAX when unlimited.
+        Uint64 hits = 0; ///< Acquisitions by key that found the resource loaded or loading.
+        Uint64 misses = 0; ///< Acquisitions by key that had to load.
+        Uint64 failures = 0; ///< Loads that failed.
+        Uint64 evictions = 0; ///< Unreferenced resources destroyed to stay within the budget.
+        double loadSeconds = 0.0; ///< Time spent in the loader, summed over threads.
+
+        /// @return Share of acquisitions by key that did not load, in [0, 1].
+        [[nodiscard]] double hitRate() const noexcept
+        {
+            const Uint64 total = hits + misses;
+            return total == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(total);
+        }
+    };
+
+    /**
+     * @class ResourceCache
+     * @brief Thread-safe cache of resources keyed by string, referenced through generational handles.
+     *
+     * Resources are owned explicitly: acquire() hands out a handle and counts a reference, release() drops it.
+     * Handles are plain 32-bit values, and get() resolves one through a slot array without locks or reference
+     * counting; a handle whose resource was destroyed resolves to nullptr, even after its slot is reused.
+     *
+     * Released resources stay cached for the next acquire() of their key. They are destroyed roughly least
+     * recently released first when the estimated memory of everything resident exceeds the budget, and all at
+     * once by purgeUnused(). Referenced resources are never evicted, so the budget can be overshot while they
+     * are held. Resources stored with insert(), e.g. by a preload, are pinned until first acquired, so the
+     * budget cannot evict them before they are used.
+     *
+     * The key index is spread over shards, each guarded by its own reader-writer lock, so lookups from many
+     * threads only contend when they hit the same shard while it is being written. References are counted
+     * atomically per resource: acquiring a loaded key and releasing it take no lock beyond the shard's shared
+     * one, except when a resource becomes unreferenced for the first time, which puts it on the eviction list.
+     * Concurrent acquisitions of the same key coalesce into a single load that every caller waits for;
+     * acquireAsync() runs that load on a thread pool instead of the calling thread. If the loader throws, the
+     * exception reaches every caller waiting for that load.
+     *
+     * A resource may keep resources of other caches alive through addDependency(), e.g. a font atlas the font
+     * it was rendered from. Destroy caches before the caches their resources depend on.
+     *
+     * @tparam T Resource type; the cache stores T*.
+     * @tparam Loader Creates, destroys and sizes resources; see ResourceLoader.
+     */
+    template <typename T, ResourceLoader<T> Loader>
+    class ResourceCache
+    {
+    public:
+        using Handle = ResourceHandle<T>;
+
+        /// @param args Forwarded to the loader's constructor.
+        template <typename... LoaderArgs>
+        explicit ResourceCache(LoaderArgs&&... args) :
+            loader_(std::forward<LoaderArgs>(args)...) {}
+
+        /// Destroys every resource, referenced or not.
+        ~ResourceCache()
+        {
+            clear();
+        }
+
+        /**
+         * Returns a handle to the resource for a key, loading it if needed, and counts a reference to it.
+         * Safe to call from any thread. Waiting on the main thread for another thread's load of the same key
+         * pumps events, so loaders that hand work to the main thread can finish.
+         *
+         * @param key Identifies the resource; passed to the loader.
+         * @param args Passed to the loader after the key.
+         * @return The handle, or an invalid handle if loading failed.
+         */
+        template <typename... Args>
+        Handle acquire(const std::string& key, const Args&... args)
+        {
+            Shard& shard = shardFor(key);
+            if (const Handle handle = acquireLoaded(shard, key); handle.valid())
+            {
+                return handle;
+            }
+
+            // Either join a load already in flight or become the one that loads
+            std::promise<Handle> promise;
+            std::shared_future<Handle> future;
+            bool owner = false;
+            {
+                std::unique_lock lock(shard.mutex);
+                if (const auto it = shard.handles.find(key); it != std::end(shard.handles))
+                {
+                    reference(it->second);
+                    shard.hits.fetch_add(1, std::memory_order_relaxed);
+                    return it->second;
+                }
+
+                if (const auto it = shard.loading.find(key); it != std::end(shard.loading))
+                {
+                    future = it->second;
+                }
+                else
+                {
+                    future = promise.get_future().share();
+                    shard.loading.emplace(key, future);
+                    owner = true;
+                }
+            }
+
+            if (!owner)
+            {
+                if (SDL_IsMainThread())
+                {
+                    while (future.wait_for(std::chrono::milliseconds(1)) != std::future_status::ready)
+                    {
+                        SDL_PumpEvents();
+                    }
+                }
+
+                // The loader's reference may already be gone, so count ours through the key index again
+                return future.get().valid() ? acquire(key, args...) : Handle{};
+            }
+
+            const time::TimePoint start = time::Now();
+            T* resource = nullptr;
+            try
+            {
+                resource = loader_.load(key, args...);
+            }
+            catch (...)
+            {
+                // Waiters would otherwise block forever on a promise nobody sets
+                {
+                    std::unique_lock lock(shard.mutex);
+                    std::scoped_lock slotsLock(slotsMutex_);
+                    ++misses_;
+                    ++failures_;
+                    shard.loading.erase(key);
+                }
+                promise.set_exception(std::current_exception());
+                throw;
+            }
+            const double seconds = time::ElapsedSince(start);
+
+            Handle handle;
+            {
+                std::unique_lock lock(shard.mutex);
+                std::scoped_lock slotsLock(slotsMutex_);
+                ++misses_;
+                loadSeconds_ += seconds;
+                if (resource != nullptr)
+                {
+                    handle = insertEntry(key, resource, 1);
+                    shard.handles[key] = handle;
+                }
+                else
+                {
+                    ++failures_;
+                }
+                shard.loading.erase(key);
+            }
+            promise.set_value(handle);
+            trim();
+            return handle;
+        }
+
+        /**
+         * Acquires a resource on a thread pool. Resources already loaded are acquired right away. The load is
+         * shared with every other acquisition of the key, synchronous or not.
+         *
+         * @param pool Pool to load on.
+         * @param key Identifies the resource; passed to the loader.
+         * @param args Copied into the task and passed to the loader after the key.
+         * @return Future handle, invalid if loading failed; the reference is counted once it is ready.
+         */
+        template <typename... Args>
+        std::shared_future<Handle> acquireAsync(utils::ThreadPool& pool, std::string key, Args... args)
+        {
+            if (const Handle handle = acquireLoaded(shardFor(key), key); handle.valid())
+            {
+                std::promise<Handle> ready;
+                ready.set_value(handle);
+                return ready.get_future().share();
+            }
+
+            return pool.async([this, key = std::move(key), ... args = std::move(args)]
+            {
+                return acquire(key, args...);
+            }).share();
+        }
+
+        /**
+         * Counts another reference to a resource, e.g. for a second owner of the handle or a handle from find().
+         *
+         * @return false if the handle is stale.
+         */
+        bool acquire(const Handle handle)
+        {
+            // Locked, since without a reference held the resource may be evicted meanwhile
+            std::scoped_lock lock(slotsMutex_);
+            if (!slots_.contains(handle))
+            {
+                return false;
+            }
+            reference(handle);
+            return true;
+        }
+
+        /**
+         * Drops a reference; an unreferenced resource stays cached within the budget. Stale handles are ignored.
+         * Lock-free unless the last reference goes to a resource not on the eviction list or replaced by insert().
+         */
+        void release(const Handle handle)
+        {
+            Entry* entry = slots_.get(handle);
+            if (entry == nullptr || entry->pinned.load())
+            {
+                return;
+            }
+
+            // The flags share the word with the count, so a flag set meanwhile makes the exchange fail. Once the
+            // count reaches 0 the entry may be evicted at any time and must not be touched again.
+            Uint32 state = entry->state.load();
+            while (true)
+            {
+                if ((state & COUNT_MASK) == 0)
+                {
+                    return;
+                }
+                if ((state & COUNT_MASK) == 1 && (state & (LISTED | ORPHANED)) != LISTED)
+                {
+                    break;
+                }
+                if (entry->state.compare_exchange_weak(state, state - 1))
+                {
+                    if ((state & COUNT_MASK) == 1 && overBudget_.load(std::memory_order_relaxed))
+                    {
+                        trim();
+                    }
+                    return;
+                }
+            }
+
+            // Dropped under the lock, which eviction needs too, so the entry stays alive to be listed
+            bool orphaned = false;
+            {
+                std::scoped_lock lock(slotsMutex_);
+                entry = slots_.get(handle);
+                if (entry == nullptr || (entry->state.load() & COUNT_MASK) == 0)
+                {
+                    return;
+                }
+                state = entry->state.fetch_sub(1);
+                if ((state & COUNT_MASK) != 1)
+                {
+                    return;
+                }
+                list(handle, *entry);
+                orphaned = (state & ORPHANED) != 0;
+            }
+
+            // No key leads back to a replaced resource, so keeping it cached is pointless
+            if (orphaned)
+            {
+                destroyIfUnused(handle);
+                return;
+            }
+            trim();
+        }
+
+        /**
+         * Resolves a handle. Lock-free; safe concurrently with acquire() and release() of other resources.
+         *
+         * @return The resource, or nullptr if the handle is stale or invalid.
+         */
+        [[nodiscard]] T* get(const Handle handle) const noexcept
+        {
+            const Entry* entry = slots_.get(handle);
+            return entry != nullptr ? entry->resource : nullptr;
+        }
+
+        /// @return The handle of the resource loaded under the key without counting a reference, or an invalid
+        ///         handle. Safe to call from any thread.
+        [[nodiscard]] Handle find(const std::string& key) const
+        {
+            const Shard& shard = shardFor(key);
+            std::shared_lock lock(shard.mutex);
+            const auto it = shard.handles.find(key);
+            return it != std::end(shard.handles) ? it->second : Handle{};
+        }
+
+        /// @return true if a resource is loaded under the key.
+        [[nodiscard]] bool contains(const std::string& key) const
+        {
+            const Shard& shard = shardFor(key);
+            std::shared_lock lock(shard.mutex);
+            return shard.handles.contains(key);
+        }
+
+        /**
+         * Stores a resource created elsewhere, e.g. by a PreloadPipeline, without counting a reference for the
+         * caller. The resource is pinned: the budget does not evict it until it is acquired and released once,
+         * though purgeUnused() and clear() do. If the key is taken, it refers to the new resource from then on;
+         * the old one keeps resolving through its handles until its last reference is released, then it is
+         * destroyed. It is never swapped in place, since get() may be reading it.
+         *
+         * @param key Key to store the resource under.
+         * @param resource Resource to take ownership of.
+         * @return The handle of the stored resource.
+         */
+        Handle insert(const std::string& key, T* resource)
+        {
+            PSY_DEBUG_ASSERT(resource != nullptr, "Resource is null");
+
+            std::optional<Removed> replaced;
+            Handle handle;
+            {
+                Shard& shard = shardFor(key);
+                std::unique_lock lock(shard.mutex);
+                std::scoped_lock slotsLock(slotsMutex_);
+                if (const auto it = shard.handles.find(key); it != std::end(shard.handles))
+                {
+                    Entry* entry = slots_.get(it->second);
+                    PSY_ASSERT(entry != nullptr, "Key index holds a stale handle");
+
+                    // A release racing with the mark either sees it and destroys the old resource, or is seen here
+                    const Uint32 state = entry->state.fetch_or(ORPHANED);
+                    if (entry->pinned.load() || (state & COUNT_MASK) == 0)
+                    {
+                        replaced = detach(it->second, *entry);
+                    }
+                }
+
+                // Pinned by a reference the first acquire() takes over
+                handle = insertEntry(key, resource, 1);
+                slots_.get(handle)->pinned.store(true);
+                shard.handles[key] = handle;
+            }
+
+            if (replaced)
+            {
+                destroy(*replaced);
+            }
+            trim();
+            return handle;
+        }
+
+        /**
+         * Makes a resource keep a resource of another cache alive. The dependency's reference is released when
+         * the dependent resource is destroyed.
+         *
+         * @param dependent Resource that depends on the other.
+         * @param cache Cache holding the dependency; must outlive this cache's copy of the dependent.
+         * @param dependency Handle whose reference is handed over; the caller must have acquired it.
+         * @return false if the dependent handle is stale, in which case the caller keeps the reference.
+         */
+        template <typename Cache>
+        bool addDependency(const Handle dependent, Cache& cache, const typename Cache::Handle dependency)
+        {
+            std::scoped_lock lock(slotsMutex_);
+            Entry* entry = slots_.get(dependent);
+            if (entry == nullptr)
+            {
+                return false;
+            }
+            entry->dependencies.emplace_back([&cache, dependency] { cache.release(dependency); });
+            return true;
+        }
+
+        /**
+         * Sets the estimated memory the resident resources may use, evicting unreferenced ones beyond it.
+         *
+         * @param bytes The budget; SIZE_MAX, the default, keeps every released resource until purgeUnused().
+         */
+        void setBudget(const size_t bytes)
+        {
+            {
+                std::scoped_lock lock(slotsMutex_);
+                budget_ = bytes;
+                updateOverBudget();
+            }
+            trim();
+        }
+
+        /// Destroys every resource with no references, including pinned ones never acquired. @return The count.
+        size_t purgeUnused()
+        {
+            std::vector<Handle> unused;
+            {
+                std::scoped_lock lock(slotsMutex_);
+                slots_.forEach([&unused](const Handle handle, Entry& entry)
+                {
+                    // Exchanged, so an acquire() taking over the pin at the same time keeps it instead
+                    if (entry.pinned.exchange(false))
+                    {
+                        entry.state.fetch_sub(1);
+                    }
+                    if ((entry.state.load() & COUNT_MASK) == 0)
+                    {
+                        unused.push_back(handle);
+                    }
+                });
+            }
+
+            size_t purged = 0;
+            for (const Handle handle : unused)
+            {
+                purged += destroyIfUnused(handle) ? 1U : 0U;
+            }
+            return purged;
+        }
+
+        /// Destroys every resource, including ones replaced under their key but still referenced, invalidating
+        /// all handles.
+        void clear()
+        {
+            std::vector<Removed> removed;
+            {
+                const auto locks = lockAllShards();
+                std::scoped_lock slotsLock(slotsMutex_);
+                // Replaced resources are only reachable through the slots, not the key index
+                std::vector<Handle> handles;
+                handles.reserve(slots_.size());
+                slots_.forEach([&handles](const Handle handle, const Entry&)
+                {
+                    handles.push_back(handle);
+                });
+                removed.reserve(handles.size());
+                for (const Handle handle : handles)
+                {
+                    removed.push_back(detach(handle, *slots_.get(handle)));
+                }
+                for (Shard& shard : shards_)
+                {
+                    shard.handles.clear();
+                }
+            }
+
+            for (Removed& resource : removed)
+            {
+                destroy(resource);
+            }
+        }
+
+        [[nodiscard]] ResourceCacheStats stats() const
+        {
+            Uint64 hits = 0;
+            for (const Shard& shard : shards_)
+            {
+                hits += shard.hits.load(std::memory_order_relaxed);
+            }
+
+            std::scoped_lock lock(slotsMutex_);
+            size_t referenced = 0;
+            slots_.forEach([&referenced](Handle, const Entry& entry)
+            {
+                referenced += (entry.state.load(std::memory_order_relaxed) & COUNT_MASK) != 0 ? 1U : 0U;
+            });
+            return ResourceCacheStats{
+                .resident = slots_.size(),
+                .referenced = referenced,
+                .bytes = bytes_,
+                .budget = budget_,
+                .hits = hits,
+                .misses = misses_,
+                .failures = failures_,
+                .evictions = evictions_,
+                .loadSeconds = loadSeconds_
+            };
+        }
+
+        /// @return The loader, e.g. to configure it. It is called concurrently while loads run.
+        [[nodiscard]] Loader& loader() noexcept
+        {
+            return loader_;
+        }
+
+        [[nodiscard]] const Loader& loader() const noexcept
+        {
+            return loader_;
+        }
+
+        ResourceCache(const ResourceCache& other) = delete;
+        ResourceCache(ResourceCache&& other) noexcept = delete;
+        ResourceCache& operator=(const ResourceCache& other) = delete;
+        ResourceCache& operator=(ResourceCache&& other) noexcept = delete;
+
+    private:
+        static constexpr size_t SHARD_COUNT = 16;
+
+        /// Entry::state: the reference count in the low bits, flags that change how the last release goes above.
+        static constexpr Uint32 LISTED = 1U << 31; ///< On the eviction list.
+        static constexpr Uint32 ORPHANED = 1U << 30; ///< Replaced under its key by insert(); destroyed once unused.
+        static constexpr Uint32 COUNT_MASK = ORPHANED - 1;
+
+        /**
+         * The state is atomic so the hot paths can count references without slotsMutex_. Taking an unreferenced
+         * resource back to one reference needs its shard lock or slotsMutex_, both of which eviction holds, and
+         * the flags only change under slotsMutex_.
+         */
+        struct Entry
+        {
+            T* resource = nullptr;
+            std::string key;
+            std::atomic<Uint32> state{0};
+            std::atomic<bool> pinned{false}; ///< Inserted and not yet acquired; holds the only reference.
+            std::atomic<bool> recent{false}; ///< Referenced again since it was listed; gets a second chance.
+            size_t cost = 0;
+            typename std::list<Handle>::iterator unusedPosition{}; ///< Valid while listed.
+            std::vector<std::function<void()>> dependencies; ///< Release the resources this one depends on.
+
+            Entry() = default;
+            ~Entry() = default;
+
+            // Only moved into its slot, before any other thread can see it
+            Entry(Entry&& other) noexcept :
+                resource(other.resource), key(std::move(other.key)), state(other.state.load()),
+                pinned(other.pinned.load()), recent(other.recent.load()), cost(other.cost),
+                unusedPosition(other.unusedPosition), dependencies(std::move(other.dependencies)) {}
+
+            Entry(const Entry& other) = delete;
+            Entry& operator=(const Entry& other) = delete;
+            Entry& operator=(Entry&& other) noexcept = delete;
+        };
+
+        /// A resource taken out of the cache, destroyed once no lock is held.
+        struct Removed
+        {
+            T* resource = nullptr;
+            std::vector<std::function<void()>> dependencies;
+        };
+
+        /// Aligned to a cache line so threads locking neighbouring shards do not false-share.
+        struct alignas(64) Shard
+        {
+            mutable std::shared_mutex mutex;
+            std::unordered_map<std::string, Handle> handles;
+            std::unordered_map<std::string, std::shared_future<Handle>> loading; ///< Single-flight loads.
+            std::atomic<Uint64> hits{0}; ///< Per shard, so counting hits does not bounce one cache line.
+        };
+
+        [[nodiscard]] Shard& shardFor(const std::string& key) const
+        {
+            return shards_[std::hash<std::string>{}(key) % SHARD_COUNT];
+        }
+
+        /// Locks every shard in order, e.g. to walk the whole index.
+        [[nodiscard]] std::array<std::unique_lock<std::shared_mutex>, SHARD_COUNT> lockAllShards() const
+        {
+            std::array<std::unique_lock<std::shared_mutex>, SHARD_COUNT> locks;
+            for (size_t i = 0; i < SHARD_COUNT; ++i)
+            {
+                locks[i] = std::unique_lock(shards_[i].mutex);
+            }
+            return locks;
+        }
+
+        // A handle in the key index cannot be destroyed while its shard is locked, so counting never fails here
+        Handle acquireLoaded(Shard& shard, const std::string& key)
+        {
+            std::shared_lock lock(shard.mutex);
+            if (const auto it = shard.handles.find(key); it != std::end(shard.handles))
+            {
+                reference(it->second);
+                shard.hits.fetch_add(1, std::memory_order_relaxed);
+                return it->second;
+            }
+            return Handle{};
+        }
+
+        /// Counts a reference to a live resource. Requires its shard lock or slotsMutex_.
+        void reference(const Handle handle)
+        {
+            Entry* entry = slots_.get(handle);
+
+            // The first owner of an inserted resource takes over its pin
+            if (entry->pinned.exchange(false))
+            {
+                return;
+            }
+            if ((entry->state.fetch_add(1) & COUNT_MASK) == 0)
+            {
+                entry->recent.store(true, std::memory_order_relaxed);
+            }
+        }
+
+        /// Puts an entry on the eviction list unless it is there already. Requires slotsMutex_.
+        void list(const Handle handle, Entry& entry)
+        {
+            if ((entry.state.load() & LISTED) == 0)
+            {
+                entry.unusedPosition = unused_.insert(std::end(unused_), handle);
+                entry.state.fetch_or(LISTED);
+            }
+        }
+
+        /// Takes an entry off the eviction list. Requires slotsMutex_.
+        void unlist(Entry& entry)
+        {
+            if ((entry.state.fetch_and(~LISTED) & LISTED) != 0)
+            {
+                unused_.erase(entry.unusedPosition);
+            }
+        }
+
+        /// Requires slotsMutex_.
+        void updateOverBudget() noexcept
+        {
+            overBudget_.store(bytes_ > budget_, std::memory_order_relaxed);
+        }
+
+        /// Requires the shard and slot locks.
+        Handle insertEntry(const std::string& key, T* resource, const Uint32 references)
+        {
+            Entry entry;
+            entry.resource = resource;
+            entry.key = key;
+            entry.state.store(references);
+            entry.cost = loader_.cost(*resource);
+            bytes_ += entry.cost;
+            updateOverBudget();
+            const Handle handle = slots_.insert(std::move(entry));
+            if (references == 0)
+            {
+                list(handle, *slots_.get(handle));
+            }
+            return handle;
+        }
+
+        /// Requires the shard and slot locks; leaves the key index to the caller.
+        Removed detach(const Handle handle, Entry& entry)
+        {
+            unlist(entry);
+            bytes_ -= entry.cost;
+            updateOverBudget();
+
+            Removed removed{.resource = entry.resource, .dependencies = std::move(entry.dependencies)};
+            slots_.remove(handle);
+            return removed;
+        }
+
+        void destroy(Removed& removed)
+        {
+            loader_.destroy(removed.resource);
+            for (const auto& releaseDependency : removed.dependencies)
+            {
+                releaseDependency();
+            }
+        }
+
+        bool destroyIfUnused(const Handle handle)
+        {
+            std::string key;
+            {
+                std::scoped_lock lock(slotsMutex_);
+                const Entry* entry = slots_.get(handle);
+                if (entry == nullptr || (entry->state.load() & COUNT_MASK) != 0)
+                {
+                    return false;
+                }
+                key = entry->key;
+            }
+
+            // Someone may have acquired it again between the two locks, so re-check in lock order
+            Removed removed;
+            {
+                Shard& shard = shardFor(key);
+                std::unique_lock lock(shard.mutex);
+                std::scoped_lock slotsLock(slotsMutex_);
+                Entry* entry = slots_.get(handle);
+                if (entry == nullptr || (entry->state.load() & COUNT_MASK) != 0)
+                {
+                    return false;
+                }
+
+                removed = detach(handle, *entry);
+                if (const auto it = shard.handles.find(key); it != std::end(shard.handles) && it->second == handle)
+                {
+                    shard.handles.erase(it);
+                }
+            }
+            destroy(removed);
+            return true;
+        }
+
+        /// Evicts unreferenced resources, roughly least recently released first, until the cache fits its budget.
+        void trim()
+        {
+            std::vector<Handle> victims;
+            {
+                std::scoped_lock lock(slotsMutex_);
+                size_t bytes = bytes_;
+                for (size_t visits = unused_.size(); visits > 0 && bytes > budget_ && !unused_.empty(); --visits)
+                {
+                    const Handle handle = unused_.front();
+                    Entry& entry = *slots_.get(handle);
+                    if ((entry.state.load() & COUNT_MASK) != 0)
+                    {
+                        // Referenced again: off the list, so its last release puts it back at the end. Once
+                        // unlisted that release takes the lock, so the count cannot drop to 0 meanwhile
+                        unlist(entry);
+                        if ((entry.state.load() & COUNT_MASK) == 0)
+                        {
+                            list(handle, entry);
+                        }
+                        continue;
+                    }
+                    if (entry.recent.exchange(false, std::memory_order_relaxed))
+                    {
+                        // Used since it was listed: move it behind the resources released less recently
+                        unused_.splice(std::end(unused_), unused_, std::begin(unused_));
+                        continue;
+                    }
+
+                    unused_.splice(std::end(unused_), unused_, std::begin(unused_));
+                    victims.push_back(handle);
+                    bytes -= entry.cost;
+                }
+            }
+
+            for (const Handle handle : victims)
+            {
+                if (destroyIfUnused(handle))
+                {
+                    std::scoped_lock lock(slotsMutex_);
+                    ++evictions_;
+                }
+            }
+        }
+
+        Loader loader_;
+        mutable std::array<Shard, SHARD_COUNT> shards_;
+
+        /// Serializes writers of slots_ and guards everything below; always taken after a shard lock.
+        /// get() and the reference counts read slots_ without it.
+        mutable std::mutex slotsMutex_;
+        utils::SlotTable<Entry, T> slots_;
+        std::list<Handle> unused_; ///< Eviction candidates, roughly least recently released first.
+        size_t bytes_ = 0;
+        size_t budget_ = std::numeric_limits<size_t>::max();
+        Uint64 misses_ = 0;
+        Uint64 failures_ = 0;
+        Uint64 evictions_ = 0;
+        double loadSeconds_ = 0.0;
+        std::atomic<bool> overBudget_{false}; ///< bytes_ > budget_, for release() to check without the lock.
+    };
+}
+
+#endif //PSYENGINE_RESOURCE_CACHE_HPP
@@ -0,0 +1,113 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_RESOURCE_LOADERS_HPP
+#define PSYENGINE_RESOURCE_LOADERS_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#ifdef PSYENGINE_WITH_MIXER
+#include <SDL3_mixer/SDL_mixer.h>
+#endif
+
+#ifdef PSYENGINE_WITH_TTF
+#include <SDL3_ttf/SDL_ttf.h>
+#endif
+
+#include "psyengine/resources/resource_cache.hpp"
+
+namespace psyengine::resources
+{
+    /**
+     * @class DataLoader
+     * @brief ResourceCache loader that reads whole files into memory, e.g. for level or config data.
+     */
+    class DataLoader
+    {
+    public:
+        /// @return The file's bytes, or nullptr if it could not be read.
+        std::vector<std::byte>* load(const std::string& path);
+
+        void destroy(const std::vector<std::byte>* data);
+
+        [[nodiscard]] size_t cost(const std::vector<std::byte>& data) const noexcept
+        {
+            return data.size();
+        }
+    };
+
+    using DataCache = ResourceCache<std::vector<std::byte>, DataLoader>;
+
+#ifdef PSYENGINE_WITH_TTF
+    /**
+     * @class FontLoader
+     * @brief ResourceCache loader for TTF fonts.
+     *
+     * A font is opened at one point size, so the key names both: build it with key(). A key without a size
+     * opens the font at the default size.
+     */
+    class FontLoader
+    {
+    public:
+        explicit FontLoader(const float defaultPointSize = 16.0F) :
+            defaultPointSize_(defaultPointSize) {}
+
+        /// @return The key of a font file at a point size, e.g. "fonts/ui.ttf@24".
+        [[nodiscard]] static std::string key(const std::string& path, float pointSize);
+
+        /// @return The font, or nullptr if it could not be opened.
+        TTF_Font* load(const std::string& key);
+
+        void destroy(TTF_Font* font);
+
+        /// Fonts stream from their files and are not counted toward the budget.
+        [[nodiscard]] size_t cost([[maybe_unused]] const TTF_Font& font) const noexcept
+        {
+            return 0;
+        }
+
+    private:
+        float defaultPointSize_;
+    };
+
+    using FontCache = ResourceCache<TTF_Font, FontLoader>;
+#endif
+
+#ifdef PSYENGINE_WITH_MIXER
+    /**
+     * @class SoundLoader
+     * @brief ResourceCache loader for SDL_mixer audio.
+     *
+     * Predecoded audio is costed at its decoded size; streamed audio decodes while it plays and costs nothing.
+     */
+    class SoundLoader
+    {
+    public:
+        /**
+         * @param mixer Mixer whose format predecoded audio is converted to, or nullptr for the file's own.
+         * @param predecode Decode whole files at load time instead of while playing.
+         */
+        explicit SoundLoader(MIX_Mixer* mixer = nullptr, const bool predecode = true) :
+            mixer_(mixer),
+            predecode_(predecode) {}
+
+        /// @return The audio, or nullptr if it could not be loaded.
+        MIX_Audio* load(const std::string& path);
+
+        void destroy(MIX_Audio* audio);
+
+        [[nodiscard]] size_t cost(const MIX_Audio& audio) const;
+
+    private:
+        MIX_Mixer* mixer_;
+        bool predecode_;
+    };
+
+    using SoundCache = ResourceCache<MIX_Audio, SoundLoader>;
+#endif
+}
+
+#endif //PSYENGINE_RESOURCE_LOADERS_HPP
@@ -5,20 +5,218 @@
 #ifndef PSYENGINE_TEXTURE_MANAGER_HPP
 #define PSYENGINE_TEXTURE_MANAGER_HPP
 
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <span>
 #include <string>
-#include <unordered_map>
 #include <SDL3/SDL_render.h>
 
+#include "psyengine/resources/decoded_image_cache.hpp"
+#include "psyengine/resources/resource_cache.hpp"
+#include "psyengine/time/time.hpp"
+
+namespace psyengine::utils
+{
+    class ThreadPool;
+}
+
 namespace psyengine::resources
 {
+    class AssetPack;
+    class AsyncFileReader;
+
+    /// 32-bit generational reference to a texture in TextureManager.
+    using TextureHandle = ResourceHandle<SDL_Texture>;
+
+    /**
+     * @struct TextureUploadStats
+     * @brief Cumulative cost of preparing and uploading textures in a TextureLoader.
+     */
+    struct TextureUploadStats
+    {
+        Uint64 prepared = 0; ///< Surfaces converted, and premultiplied if enabled.
+        Uint64 uploads = 0; ///< Textures created from prepared surfaces.
+        Uint64 bytes = 0; ///< Pixel bytes uploaded.
+        double prepareSeconds = 0.0; ///< Conversion and any premultiplication, summed over threads.
+        double uploadSeconds = 0.0; ///< Texture creation and upload, on the main thread.
+
+        [[nodiscard]] double uploadMegabytesPerSecond() const noexcept
+        {
+            return uploadSeconds > 0.0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) / uploadSeconds : 0.0;
+        }
+    };
+
+    /**
+     * @class TextureLoader
+     * @brief ResourceCache loader that decodes images into textures, optionally through a disk cache.
+     *
+     * Decoded images are prepared for upload on the decoding thread: converted once to the renderer's
+     * preferred texture format. The main thread then only creates the texture and copies the pixels in,
+     * without the renderer converting them or keeping a copy in another format.
+     *
+     * Textures keep straight alpha and SDL_BLENDMODE_BLEND by default, as SDL would load them. With
+     * setPremultiplyAlpha(true) they are also alpha-premultiplied while being prepared and get
+     * SDL_BLENDMODE_BLEND_PREMULTIPLIED, which blends like straight alpha but filters without dark fringes;
+     * code that reads texture pixels or sets its own blend modes must then expect premultiplied colors.
+     *
+     * load() may run on any thread: the image is decoded and prepared on the calling thread and the texture
+     * created on the main thread through SDL_RunOnMainThread, which blocks until the main thread pumps events.
+     * destroy() also runs on the main thread, but off it only queues the destruction for the next event pump
+     * without waiting, so releasing or evicting textures on a worker cannot deadlock against a main thread
+     * that waits for that worker.
+     */
+    class TextureLoader
+    {
+    public:
+        /**
+         * @param path Image file to load.
+         * @param renderer Renderer to create the texture for.
+         * @return The texture, or nullptr on failure.
+         */
+        SDL_Texture* load(const std::string& path, SDL_Renderer* renderer);
+
+        void destroy(SDL_Texture* texture);
+
+        /// @return Estimated GPU memory of the texture in bytes.
+        [[nodiscard]] size_t cost(const SDL_Texture& texture) const noexcept;
+
+        /// @return The format textures are uploaded in for a renderer. Safe to call from any thread.
+        [[nodiscard]] SDL_PixelFormat uploadFormat(SDL_Renderer* renderer);
+
+        /// @return The format of the last uploadFormat() query, or SDL_PIXELFORMAT_UNKNOWN before any.
+        [[nodiscard]] SDL_PixelFormat lastUploadFormat() const noexcept
+        {
+            return lastFormat_.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * Converts a decoded surface to the upload format and, if enabled, premultiplies its alpha. Safe to call
+         * from any thread.
+         *
+         * @param decoded Surface to prepare; consumed.
+         * @param format The uploadFormat() of the renderer the texture is for.
+         * @return The prepared surface, or nullptr on failure.
+         */
+        [[nodiscard]] SDL_Surface* prepare(SDL_Surface* decoded, SDL_PixelFormat format);
+
+        /**
+         * Creates a texture from a prepared surface, a straight copy of its pixels. Main thread only.
+         *
+         * @param renderer Renderer to create the texture for.
+         * @param prepared Surface from prepare(); not consumed.
+         * @return The texture, or nullptr on failure.
+         */
+        [[nodiscard]] SDL_Texture* upload(SDL_Renderer* renderer, SDL_Surface* prepared);
 
-    class TextureManager
+        /// Decodes an image from memory, stores it in the disk cache and creates its texture on this thread.
+        SDL_Texture* decodeAndUpload(const std::string& path, SDL_Renderer* renderer,
+                                     std::span<const std::byte> contents);
+
+        /// @return The cached texture for an unchanged source, or nullptr. Creates it on this thread.
+        SDL_Texture* loadCached(const std::string& path, SDL_Renderer* renderer);
+
+        /// Keeps the disk cache in this loader's alpha mode.
+        void setDiskCache(std::unique_ptr<DecodedImageCache> cache);
+
+        /**
+         * Chooses premultiplied alpha for textures loaded from now on; off by default. Set it before loading:
+         * textures already loaded keep their pixels and blend mode.
+         */
+        void setPremultiplyAlpha(bool premultiply);
+
+        [[nodiscard]] bool premultipliesAlpha() const noexcept
+        {
+            return premultiply_.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] DecodedImageCache* diskCache() const noexcept
+        {
+            return diskCache_.get();
+        }
+
+        [[nodiscard]] bool hasDiskCache() const;
+
+        [[nodiscard]] TextureUploadStats uploadStats() const noexcept;
+
+    private:
+        /// Decodes and prepares an image from memory and stores it in the disk cache, if one is set.
+        SDL_Surface* decodeAndStore(const std::string& path, SDL_PixelFormat format,
+                                    std::span<const std::byte> contents);
+
+        mutable std::mutex diskMutex_; ///< Guards diskCache_, which is not thread-safe itself.
+        std::unique_ptr<DecodedImageCache> diskCache_;
+
+        std::atomic<bool> premultiply_{false};
+        std::atomic<SDL_PixelFormat> lastFormat_{SDL_PIXELFORMAT_UNKNOWN};
+        std::atomic<Uint64> prepared_{0};
+        std::atomic<Uint64> uploads_{0};
+        std::atomic<Uint64> uploadBytes_{0};
+        std::atomic<time::TimePoint> prepareTicks_{0};
+        std::atomic<time::TimePoint> uploadTicks_{0};
+    };
+
+    /**
+     * @class TextureManager
+     * @brief The engine's texture cache: a ResourceCache of textures keyed by path, plus bulk loaders.
+     *
+     * acquire(path, renderer) may be called from any thread; see TextureLoader. Off the main thread it blocks
+     * until the main thread has created the texture, so the main thread must not wait on the caller meanwhile.
+     * release() may be called from any thread; textures it evicts off the main thread are destroyed on the
+     * main thread's next event pump.
+     *
+     * The bulk loaders loadTextures() and loadPack(), insert(), purgeUnused() and clear() upload or destroy
+     * on the calling thread and must run on the main thread.
+     */
+    class TextureManager final : public ResourceCache<SDL_Texture, TextureLoader>
     {
     public:
         static TextureManager& instance();
 
-        std::shared_ptr<SDL_Texture> loadTexture(const std::string& path, SDL_Renderer* renderer);
+        /**
+         * Loads many textures, reading the files concurrently through an AsyncFileReader and decoding each from
+         * memory as soon as its read completes. Paths that are already loaded are skipped.
+         *
+         * @param paths Image files to load.
+         * @param renderer Renderer to create the textures for.
+         * @param reader Reader to do the file I/O with.
+         * @return Number of paths that are loaded afterwards, including ones that already were.
+         */
+        size_t loadTextures(std::span<const std::string> paths, SDL_Renderer* renderer, AsyncFileReader& reader);
+
+        /**
+         * Loads every entry of an asset pack, keyed by entry name. Entries are decompressed in parallel and each
+         * texture is uploaded on this thread as soon as its pixels are ready. Names already loaded are replaced.
+         *
+         * @param pack An opened pack.
+         * @param renderer Renderer to create the textures for.
+         * @param threads Pool to decompress on.
+         * @return Number of entries loaded.
+         */
+        size_t loadPack(AssetPack& pack, SDL_Renderer* renderer, utils::ThreadPool& threads);
+
+        /**
+         * Keeps decoded images in a disk cache so later runs skip decoding. With a cache set, acquire() and
+         * loadTextures() upload cached pixels when the source is unchanged and store every image they decode.
+         *
+         * @param cache The cache to use, or nullptr to decode every time.
+         */
+        void setDiskCache(std::unique_ptr<DecodedImageCache> cache)
+        {
+            loader().setDiskCache(std::move(cache));
+        }
+
+        /// @return The disk cache, or nullptr if none is set. Not synchronized; inspect it while no loads run.
+        [[nodiscard]] DecodedImageCache* diskCache() const noexcept
+        {
+            return loader().diskCache();
+        }
+
+        /// @return Time spent converting and uploading textures, e.g. to compare against the frame budget.
+        [[nodiscard]] TextureUploadStats uploadStats() const noexcept
+        {
+            return loader().uploadStats();
+        }
 
         TextureManager(const TextureManager& other) = delete;
         TextureManager(TextureManager&& other) noexcept = delete;
@@ -28,8 +226,6 @@ namespace psyengine::resources
     private:
         TextureManager() = default;
         ~TextureManager() = default;
-
-        std::unordered_map<std::string, std::shared_ptr<SDL_Texture>> textures_;
     };
 }
 
@@ -0,0 +1,193 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_WORLD_CONTEXT_HPP
+#define PSYENGINE_WORLD_CONTEXT_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <SDL3/SDL_events.h>
+
+#include "psyengine/debug/latency_harness.hpp"
+#include "psyengine/debug/tick_hash_log.hpp"
+#include "psyengine/input/input_manager.hpp"
+#include "psyengine/state/state_manager.hpp"
+#include "psyengine/time/clock.hpp"
+
+namespace psyengine::server
+{
+    /**
+     * @struct WorldStats
+     * @brief Tick timing of one world, as observed by whoever drives it.
+     *
+     * Latency is how late a tick started compared to its scheduled time; duration is how long it ran.
+     * All values are in seconds.
+     */
+    struct WorldStats
+    {
+        Uint64 ticks = 0;
+        Uint64 droppedTicks = 0; ///< Ticks skipped because the world fell too far behind.
+        double lastLatency = 0.0;
+        double meanLatency = 0.0;
+        double p99Latency = 0.0;
+        double maxLatency = 0.0;
+        double lastDuration = 0.0;
+        double meanDuration = 0.0;
+    };
+
+    /**
+     * @class WorldContext
+     * @brief One independent simulation: its own state stack, input manager and clock, without SDL video.
+     *
+     * A dedicated server process hosts many of these, typically ticked by a WorldScheduler. States running
+     * inside a world must use WorldContext::current() instead of the process-wide InputManager and
+     * StateManager singletons, which belong to the windowed SdlRuntime.
+     *
+     * Threading: tick() must not run concurrently with itself, but any thread may call postEvent() and stats().
+     * The state stack and input manager are only touched from the thread currently ticking the world.
+     */
+    class WorldContext
+    {
+    public:
+        /**
+         * @param name Name used in logs and statistics.
+         * @param tickRate Fixed updates per second.
+         */
+        explicit WorldContext(std::string name, size_t tickRate = 60);
+        ~WorldContext();
+
+        /**
+         * @return The world currently being ticked on this thread, or nullptr outside of tick().
+         */
+        [[nodiscard]] static WorldContext* current() noexcept;
+
+        /// @return The world's own state stack.
+        [[nodiscard]] state::StateManager& states() noexcept
+        {
+            return states_;
+        }
+
+        /// @return The world's own input manager.
+        [[nodiscard]] input::InputManager& input() noexcept
+        {
+            return input_;
+        }
+
+        /// @return Clock started when the world was created.
+        [[nodiscard]] const time::Clock& clock() const noexcept
+        {
+            return clock_;
+        }
+
+        [[nodiscard]] const std::string& name() const noexcept
+        {
+            return name_;
+        }
+
+        /// @return Fixed updates per second currently in effect. Read it from the ticking thread.
+        [[nodiscard]] size_t tickRate() const noexcept
+        {
+            return tickRate_;
+        }
+
+        /**
+         * Changes the tick rate, e.g. to idle a world without players. Thread-safe.
+         *
+         * Takes effect at the start of the next tick, which notifies the states through
+         * BaseState::onFixedUpdateFrequencyChanged before running at the new rate.
+         *
+         * @param tickRate Fixed updates per second; 0 is treated as 1.
+         */
+        void setTickRate(size_t tickRate) noexcept
+        {
+            pendingTickRate_.store(std::max<size_t>(1, tickRate), std::memory_order_relaxed);
+        }
+
+        /// @return The fixed timestep in seconds.
+        [[nodiscard]] double tickStep() const noexcept
+        {
+            return 1.0 / static_cast<double>(tickRate_);
+        }
+
+        /// @return The timestep the next tick runs at, including a rate change that is still pending.
+        [[nodiscard]] double nextTickStep() const noexcept
+        {
+            return 1.0 / static_cast<double>(pendingTickRate_.load(std::memory_order_relaxed));
+        }
+
+        /// @return Number of fixed updates run so far.
+        [[nodiscard]] Uint64 tickCount() const noexcept
+        {
+            return tickCount_;
+        }
+
+        /**
+         * Queues an event (e.g. decoded player input) for the next tick. Thread-safe.
+         *
+         * @param event The event to deliver to the world's input manager and state stack.
+         */
+        void postEvent(const SDL_Event& event);
+
+        /**
+         * Runs one fixed step: delivers queued events, updates input and calls fixedUpdate on the state stack.
+         */
+        void tick();
+
+        /**
+         * Attaches a log that records a hash of the world's state stack after every tick, keyed by tickCount().
+         * Not owned; must outlive the world or be detached with nullptr. Only change it between ticks.
+         *
+         * @param log The log to record into, or nullptr to detach.
+         */
+        void setTickHashLog(debug::TickHashLog* log) noexcept
+        {
+            tickHashLog_ = log;
+        }
+
+        /**
+         * Records timing of a tick. Called by the driver of the world.
+         *
+         * @param latency Seconds the tick started after its scheduled time.
+         * @param duration Seconds the tick took.
+         */
+        void recordTick(double latency, double duration);
+
+        /// Records ticks that were skipped to catch up with the schedule.
+        void recordDroppedTicks(Uint64 count);
+
+        /// @return A consistent snapshot of the tick statistics. Thread-safe.
+        [[nodiscard]] WorldStats stats() const;
+
+        WorldContext(const WorldContext& other) = delete;
+        WorldContext(WorldContext&& other) noexcept = delete;
+        WorldContext& operator=(const WorldContext& other) = delete;
+        WorldContext& operator=(WorldContext&& other) noexcept = delete;
+
+    private:
+        std::string name_;
+        size_t tickRate_;
+        std::atomic<size_t> pendingTickRate_;
+        Uint64 tickCount_ = 0;
+        debug::TickHashLog* tickHashLog_ = nullptr;
+
+        state::StateManager states_;
+        input::InputManager input_;
+        time::Clock clock_;
+
+        std::mutex inboxMutex_;
+        std::vector<SDL_Event> inbox_;
+        std::vector<SDL_Event> processing_;
+
+        mutable std::mutex statsMutex_;
+        WorldStats stats_{};
+        debug::LatencyHistogram latencyHistogram_{};
+        double totalDuration_ = 0.0;
+    };
+}
+
+#endif //PSYENGINE_WORLD_CONTEXT_HPP
@@ -0,0 +1,118 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_WORLD_SCHEDULER_HPP
+#define PSYENGINE_WORLD_SCHEDULER_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "psyengine/server/world_context.hpp"
+#include "psyengine/utils/thread_pool.hpp"
+
+namespace psyengine::server
+{
+    /**
+     * @class WorldScheduler
+     * @brief Ticks many independent WorldContexts at their own fixed rates across a thread pool.
+     *
+     * A single dispatcher thread keeps the worlds ordered by their next deadline and hands due worlds to the
+     * pool. A world is never ticked on two threads at once: it is only rescheduled once its tick has finished,
+     * and a world added back while a tick from its previous registration is in flight waits for that tick.
+     * When a world falls more than maxCatchUpTicks behind, the missed ticks are dropped and counted instead of
+     * being run back to back.
+     */
+    class WorldScheduler
+    {
+        using ClockType = std::chrono::steady_clock;
+
+    public:
+        /**
+         * @param threadCount Worker threads; 0 uses std::thread::hardware_concurrency().
+         * @param maxCatchUpTicks How many ticks a world may lag before missed ticks are dropped.
+         */
+        explicit WorldScheduler(size_t threadCount = 0, size_t maxCatchUpTicks = 4);
+        ~WorldScheduler();
+
+        /**
+         * Adds a world; its first tick is due immediately if the scheduler is running.
+         *
+         * @param world The world to tick. Shared so that stats stay readable after removal.
+         */
+        void addWorld(std::shared_ptr<WorldContext> world);
+
+        /**
+         * Removes a world. A tick already in flight finishes, but no further ticks are started.
+         *
+         * @return true if the world was registered.
+         */
+        bool removeWorld(const WorldContext* world);
+
+        /// Starts the dispatcher thread. Does nothing if already running.
+        void start();
+
+        /// Stops dispatching and waits for in-flight ticks to finish.
+        void stop();
+
+        [[nodiscard]] bool isRunning() const noexcept
+        {
+            return dispatcher_.joinable();
+        }
+
+        /// @return Number of registered worlds.
+        [[nodiscard]] size_t worldCount() const;
+
+        /// @return The registered worlds, e.g. to collect WorldContext::stats().
+        [[nodiscard]] std::vector<std::shared_ptr<WorldContext>> worlds() const;
+
+        WorldScheduler(const WorldScheduler& other) = delete;
+        WorldScheduler(WorldScheduler&& other) noexcept = delete;
+        WorldScheduler& operator=(const WorldScheduler& other) = delete;
+        WorldScheduler& operator=(WorldScheduler&& other) noexcept = delete;
+
+    private:
+        struct Entry
+        {
+            ClockType::time_point deadline;
+            std::shared_ptr<WorldContext> world;
+            Uint64 generation = 0; ///< Registration the entry belongs to; stale after removal or re-adding.
+
+            bool operator>(const Entry& other) const noexcept
+            {
+                return deadline > other.deadline;
+            }
+        };
+
+        void dispatchLoop(const std::stop_token& stopToken);
+        struct Registration
+        {
+            std::shared_ptr<WorldContext> world;
+            Uint64 generation;
+        };
+
+        void runTick(Entry entry);
+        [[nodiscard]] const Registration* findRegistration(const WorldContext* world) const;
+        [[nodiscard]] bool isCurrent(const Entry& entry) const;
+
+        size_t maxCatchUpTicks_;
+
+        mutable std::mutex mutex_;
+        std::condition_variable_any wakeup_;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue_;
+        std::vector<Registration> worlds_;
+        std::vector<const WorldContext*> ticking_; ///< Worlds with a tick in flight, current or stale.
+        Uint64 nextGeneration_ = 0;
+
+        // Declared last: the pool and dispatcher are torn down before the state they use
+        utils::ThreadPool pool_;
+        std::jthread dispatcher_;
+    };
+}
+
+#endif //PSYENGINE_WORLD_SCHEDULER_HPP
@@ -5,9 +5,27 @@
 #ifndef PSYENGINE_BASE_STATE_HPP
 #define PSYENGINE_BASE_STATE_HPP
 
-// ReSharper disable twice CppInconsistentNaming
+#include <cstddef>
+
+#include <SDL3/SDL_stdinc.h>
+
+// ReSharper disable once CppInconsistentNaming
 union SDL_Event;
-struct SDL_Renderer;
+
+namespace psyengine::graphics
+{
+    class RenderContext;
+}
+
+namespace psyengine::resources
+{
+    struct AssetManifest;
+}
+
+namespace psyengine::utils
+{
+    class Hasher;
+}
 
 namespace psyengine::state
 {
@@ -32,6 +50,8 @@ namespace psyengine::state
          */
         virtual ~BaseState() = default;
 
+        BaseState() = default;
+
         BaseState(const BaseState& other) = delete;
         BaseState& operator=(const BaseState& other) = delete;
 
@@ -57,6 +77,17 @@ namespace psyengine::state
          * of the states, forwarding events, updates, and rendering operations to the active state.
          */
         friend class StateManager;
+        friend class LoadingState;
+
+        /**
+         * Declares the assets the state needs, so a LoadingState can preload them all before onEnter.
+         *
+         * Override this instead of loading one texture at a time in onEnter; the preloaded textures are then
+         * already in TextureManager when onEnter runs. The default implementation declares nothing.
+         *
+         * @param manifest The manifest to add assets to.
+         */
+        virtual void declareAssets([[maybe_unused]] resources::AssetManifest& manifest) const {}
 
         /**
          * Called when the state is entered.
@@ -110,16 +141,62 @@ namespace psyengine::state
          *                  Maybe unused in some implementations.
          */
         virtual void update([[maybe_unused]] double deltaTime) = 0;
+
+        /**
+         * Called right before render, after the runtime's optional late input sampling.
+         *
+         * Override this to apply presentation-only reactions to the freshest input, such as moving a camera
+         * or a cursor, without touching the simulation. When late input sampling is disabled it runs directly
+         * after update. The default implementation does nothing.
+         *
+         * @param deltaTime The same frame delta that was passed to update, in seconds.
+         */
+        virtual void lateUpdate([[maybe_unused]] double deltaTime) {}
+
+        /**
+         * Called when the fixed update frequency changes at runtime, before the first fixedUpdate at the new rate.
+         *
+         * Override this to rescale anything counted in ticks rather than seconds. The default implementation
+         * does nothing.
+         *
+         * @param oldFrequency Fixed updates per second before the change.
+         * @param newFrequency Fixed updates per second from now on.
+         */
+        virtual void onFixedUpdateFrequencyChanged([[maybe_unused]] size_t oldFrequency,
+                                                   [[maybe_unused]] size_t newFrequency) {}
+
+        /**
+         * Called after a snapshot was restored into the registered regions, before resimulation starts.
+         *
+         * Override this to rebuild anything derived from snapshot data that is not itself in a region, such as
+         * lookup tables or pointers. The default implementation does nothing.
+         *
+         * @param tick The tick whose end state was restored.
+         */
+        virtual void onSnapshotRestored([[maybe_unused]] Uint64 tick) {}
+
+        /**
+         * Feeds the state's simulation data into a hasher for determinism checks.
+         *
+         * Called after fixed updates while a debug::TickHashLog is attached. Hash only what fixedUpdate
+         * computes, never pointers or presentation state, and keep the order stable. The default
+         * implementation contributes nothing.
+         *
+         * @param hasher The hasher to append to.
+         */
+        virtual void hashSimulation([[maybe_unused]] utils::Hasher& hasher) const {}
+
         /**
-         * Renders the current state using the specified SDL renderer.
+         * Renders the current state through the specified render context.
          * This method must be implemented by derived classes, and it is called
          * to draw the contents of the state with optional interpolation for smooth rendering.
          *
-         * @param renderer The SDL_Renderer used for drawing graphics.
+         * @param context Wraps the SDL_Renderer and counts the frame's draw calls; context.renderer() gives
+         *        direct access for calls it does not cover.
          * @param interpolationFactor The interpolation factor used to smooth rendering between updates.
          *        This parameter is optional and may not be used depending on the implementation.
          */
-        virtual void render(SDL_Renderer* renderer, [[maybe_unused]] float interpolationFactor) = 0;
+        virtual void render(graphics::RenderContext& context, [[maybe_unused]] float interpolationFactor) = 0;
     };
 }
 
@@ -0,0 +1,78 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_LOADING_STATE_HPP
+#define PSYENGINE_LOADING_STATE_HPP
+
+#include <memory>
+
+#include "psyengine/resources/preload_pipeline.hpp"
+#include "psyengine/state/base_state.hpp"
+
+namespace psyengine::state
+{
+    /**
+     * @class LoadingState
+     * @brief Loading screen that preloads the next state's assets, then replaces itself with that state.
+     *
+     * On enter it collects the next state's declareAssets() manifest and starts a PreloadPipeline. Every frame
+     * it uploads decoded textures within a time budget and draws a progress bar, so the screen stays
+     * responsive while files are read and decoded on the other cores. Once everything is loaded it logs the
+     * throughput and replaces itself with the next state, whose onEnter then finds its textures in
+     * TextureManager.
+     *
+     * Override renderProgress() to draw a custom loading screen.
+     */
+    class LoadingState : public BaseState
+    {
+    public:
+        /**
+         * @param next The state to load assets for and switch to.
+         * @param settings Pipeline configuration.
+         */
+        explicit LoadingState(std::unique_ptr<BaseState> next,
+                              const resources::PreloadSettings& settings = resources::PreloadSettings{});
+
+        /// Called on the main thread whenever assets completed, e.g. to drive a custom progress display.
+        void setProgressCallback(resources::PreloadPipeline::ProgressCallback callback)
+        {
+            pipeline_.setProgressCallback(std::move(callback));
+        }
+
+        /// Sets the time spent uploading textures per frame, in seconds. Defaults to 4 ms.
+        void setUploadBudget(const double seconds) noexcept
+        {
+            uploadBudget_ = seconds;
+        }
+
+        [[nodiscard]] const resources::PreloadProgress& progress() const noexcept
+        {
+            return pipeline_.progress();
+        }
+
+    protected:
+        bool onEnter() override;
+        void onExit() override {}
+        void handleEvent([[maybe_unused]] const SDL_Event& event) override {}
+        void fixedUpdate([[maybe_unused]] double deltaTime) override {}
+        void update(double deltaTime) override;
+        void render(graphics::RenderContext& context, float interpolationFactor) override;
+
+        /**
+         * Draws the loading screen. The default clears to black and draws a progress bar across the middle of
+         * the render output.
+         *
+         * @param context The render context to draw with.
+         * @param progress The current progress.
+         */
+        virtual void renderProgress(graphics::RenderContext& context, const resources::PreloadProgress& progress);
+
+    private:
+        std::unique_ptr<BaseState> next_;
+        resources::PreloadPipeline pipeline_;
+        double uploadBudget_ = 0.004;
+    };
+}
+
+#endif //PSYENGINE_LOADING_STATE_HPP
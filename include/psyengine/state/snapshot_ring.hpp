@@ -0,0 +1,150 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_SNAPSHOT_RING_HPP
+#define PSYENGINE_SNAPSHOT_RING_HPP
+
+#include <cstddef>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#include <SDL3/SDL_stdinc.h>
+
+namespace psyengine::state
+{
+    /**
+     * @class SnapshotRing
+     * @brief Ring of binary simulation snapshots built from registered plain-data memory regions.
+     *
+     * States register the memory their fixedUpdate owns, such as component arrays or a struct of scalars, and
+     * a snapshot is one memcpy per region into a preallocated frame. The ring keeps the last N ticks, which is
+     * what rollback networking and instant rewind need. Keep simulation data in few large regions: the cost is
+     * dominated by bytes copied, not by bookkeeping.
+     *
+     * Regions must stay at the same address and size while registered; registering or removing a region
+     * invalidates all stored frames. Anything that is not plain data (pointers into the heap, containers) has
+     * to be rebuilt from the regions in BaseState::onSnapshotRestored.
+     */
+    class SnapshotRing
+    {
+    public:
+        using RegionId = Uint32;
+
+        /**
+         * @param frameCount Number of ticks kept; the oldest is overwritten first. At least 1.
+         */
+        explicit SnapshotRing(size_t frameCount = 16);
+
+        /**
+         * Registers a memory region to be included in every snapshot.
+         *
+         * @param data Start of the region. Must remain valid until removed.
+         * @param size Size in bytes.
+         * @return Identifier for removeRegion().
+         */
+        RegionId addRegion(void* data, size_t size);
+
+        /// Registers a trivially copyable object.
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        RegionId addObject(T& object)
+        {
+            return addRegion(&object, sizeof(T));
+        }
+
+        /// Registers a contiguous array of trivially copyable values, e.g. std::vector data that never reallocates.
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        RegionId addArray(T* data, const size_t count)
+        {
+            return addRegion(data, count * sizeof(T));
+        }
+
+        /// Removes a region. @return false if the id is unknown.
+        bool removeRegion(RegionId id);
+
+        /// Removes all regions and frames.
+        void clear();
+
+        /**
+         * Copies all regions into the frame for a tick, replacing the oldest frame.
+         *
+         * @param tick The tick whose end state is captured.
+         */
+        void capture(Uint64 tick);
+
+        /**
+         * Copies a stored frame back into the registered regions.
+         *
+         * @param tick The tick to restore.
+         * @return false if the tick is not in the ring.
+         */
+        bool restore(Uint64 tick);
+
+        /// @return true if a frame for the tick is stored.
+        [[nodiscard]] bool contains(Uint64 tick) const noexcept;
+
+        /// @return The oldest stored tick, if any.
+        [[nodiscard]] std::optional<Uint64> oldestTick() const noexcept;
+
+        /// @return The newest stored tick, if any.
+        [[nodiscard]] std::optional<Uint64> newestTick() const noexcept;
+
+        /// Forgets every frame newer than the tick, e.g. after restoring it.
+        void discardAfter(Uint64 tick) noexcept;
+
+        /// @return Number of frames the ring holds.
+        [[nodiscard]] size_t frameCount() const noexcept
+        {
+            return frames_.size();
+        }
+
+        /// @return Bytes copied per snapshot.
+        [[nodiscard]] size_t snapshotSize() const noexcept
+        {
+            return totalSize_;
+        }
+
+        /// @return Seconds the last capture took.
+        [[nodiscard]] double lastCaptureTime() const noexcept
+        {
+            return lastCaptureTime_;
+        }
+
+        /// @return Seconds the last restore took.
+        [[nodiscard]] double lastRestoreTime() const noexcept
+        {
+            return lastRestoreTime_;
+        }
+
+    private:
+        struct Region
+        {
+            RegionId id;
+            std::byte* data;
+            size_t size;
+            size_t offset;
+        };
+
+        struct Frame
+        {
+            std::optional<Uint64> tick;
+            std::vector<std::byte> bytes;
+        };
+
+        void relayout();
+        [[nodiscard]] Frame* find(Uint64 tick) noexcept;
+
+        std::vector<Region> regions_;
+        std::vector<Frame> frames_;
+        size_t totalSize_ = 0;
+        RegionId nextId_ = 1;
+
+        double lastCaptureTime_ = 0.0;
+        double lastRestoreTime_ = 0.0;
+    };
+}
+
+#endif //PSYENGINE_SNAPSHOT_RING_HPP
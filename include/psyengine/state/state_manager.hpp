@@ -26,6 +26,16 @@ namespace psyengine::state
          */
         static StateManager& instance();
 
+        /**
+         * Creates an independent state stack.
+         * Used by contexts that host their own simulation, such as server::WorldContext; windowed applications
+         * use the instance() driven by SdlRuntime.
+         */
+        StateManager() = default;
+
+        /// Exits all remaining states.
+        ~StateManager();
+
         /**
          * Handles an event by delegating it to the top-most state in the stack.
          * If no states are present in the stack, this method will return without processing the event.
@@ -52,14 +62,44 @@ namespace psyengine::state
          */
         void update(double deltaTime) const;
 
+        /**
+         * Forwards the pre-render late update to the top-most state, if any.
+         *
+         * @param deltaTime Time elapsed since the last frame, in seconds.
+         */
+        void lateUpdate(double deltaTime) const;
+
+        /**
+         * Notifies every state in the stack, bottom to top, that the fixed update frequency changed.
+         * Paused states are included so they resume with the right expectations.
+         *
+         * @param oldFrequency Fixed updates per second before the change.
+         * @param newFrequency Fixed updates per second from now on.
+         */
+        void fixedUpdateFrequencyChanged(size_t oldFrequency, size_t newFrequency) const;
 
         /**
-         * Renders the current state by delegating the rendering operation with the given renderer and interpolation factor.
+         * Hashes the simulation data of every state in the stack, bottom to top.
          *
-         * @param renderer The SDL renderer to be used for drawing operations.
+         * @param hasher The hasher each state appends to.
+         */
+        void hashSimulation(utils::Hasher& hasher) const;
+
+        /**
+         * Notifies every state in the stack, bottom to top, that a snapshot was restored.
+         *
+         * @param tick The tick whose end state was restored.
+         */
+        void snapshotRestored(Uint64 tick) const;
+
+
+        /**
+         * Renders the current state by delegating the rendering operation with the given context and interpolation factor.
+         *
+         * @param context The render context to be used for drawing operations.
          * @param interpolationFactor A float value used to determine the interpolation between frames for smooth rendering.
          */
-        void render(SDL_Renderer* renderer, float interpolationFactor) const;
+        void render(graphics::RenderContext& context, float interpolationFactor) const;
 
         /**
          * Pushes a new state onto the state stack. The state is moved into the stack,
@@ -152,9 +192,6 @@ namespace psyengine::state
         StateManager& operator=(StateManager&&) = delete;
 
     private:
-        StateManager() = default;
-        ~StateManager() = default;
-
         std::vector<std::unique_ptr<BaseState>> states_;
     };
 }
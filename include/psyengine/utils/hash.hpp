@@ -0,0 +1,87 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_HASH_HPP
+#define PSYENGINE_HASH_HPP
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include <SDL3/SDL_stdinc.h>
+
+namespace psyengine::utils
+{
+    /**
+     * @class Hasher
+     * @brief Streaming, non-cryptographic 64-bit hash for large blocks of plain data.
+     *
+     * Follows the XXH3 long-input design: eight 64-bit lanes consume 64-byte stripes with a 32x32->64 bit
+     * multiply each, and are scrambled every 1 KiB. On x86-64 an AVX2 kernel is picked at runtime, elsewhere
+     * the lane loop is left to the compiler's auto-vectorizer. The output is stable across platforms and
+     * kernels, but it is not bit-compatible with XXH3 and must not be used for security.
+     *
+     * Feeding the same bytes in different chunk sizes gives the same digest.
+     */
+    class Hasher
+    {
+    public:
+        static constexpr size_t LANE_COUNT = 8;
+        static constexpr size_t STRIPE_SIZE = LANE_COUNT * sizeof(Uint64);
+
+        explicit Hasher(Uint64 seed = 0) noexcept;
+
+        /// Appends raw bytes.
+        void update(const void* data, size_t size) noexcept;
+
+        /// Appends the object representation of a trivially copyable value. Padding bytes must be deterministic.
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        void add(const T& value) noexcept
+        {
+            update(&value, sizeof(T));
+        }
+
+        /// Appends a contiguous range of trivially copyable values.
+        template <typename T>
+            requires std::is_trivially_copyable_v<T>
+        void add(const std::span<const T> values) noexcept
+        {
+            update(values.data(), values.size_bytes());
+        }
+
+        /// Appends the characters of a string.
+        void add(const std::string_view text) noexcept
+        {
+            update(text.data(), text.size());
+        }
+
+        /// @return The hash of everything appended so far. Does not modify the state.
+        [[nodiscard]] Uint64 digest() const noexcept;
+
+        /// Starts over with the given seed.
+        void reset(Uint64 seed = 0) noexcept;
+
+    private:
+        void consumeStripes(const Uint8* data, size_t stripeCount) noexcept;
+
+        std::array<Uint64, LANE_COUNT> lanes_{};
+        std::array<Uint8, STRIPE_SIZE> buffer_{};
+        size_t buffered_ = 0;
+        size_t stripesInBlock_ = 0;
+        Uint64 totalSize_ = 0;
+        Uint64 seed_ = 0;
+    };
+
+    /**
+     * One-shot convenience for Hasher.
+     *
+     * @return The 64-bit hash of the given bytes.
+     */
+    [[nodiscard]] Uint64 Hash64(const void* data, size_t size, Uint64 seed = 0) noexcept;
+}
+
+#endif //PSYENGINE_HASH_HPP
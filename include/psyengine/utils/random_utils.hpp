@@ -397,7 +397,7 @@ namespace psyengine::utils
 
     [[nodiscard]] bool RandomBool(auto& rng, const double probability = 0.5)
     {
-        std::bernoulli_distribution const dist(probability);
+        std::bernoulli_distribution dist(probability);
         return dist(rng);
     }
 
@@ -0,0 +1,269 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_SLOT_TABLE_HPP
+#define PSYENGINE_SLOT_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include <SDL3/SDL_stdinc.h>
+
+#include "psyengine/debug/assert.hpp"
+
+namespace psyengine::utils
+{
+    /**
+     * @class SlotHandle
+     * @brief 32-bit generational reference into a SlotTable: a 20-bit slot index and a 12-bit generation.
+     *
+     * The generation of a slot changes whenever its value is removed, so a handle to a removed value resolves
+     * to nothing even after the slot is reused. Generations never wrap: a slot is retired once it has used all
+     * 4095, so no stale handle can validate again. A default-constructed handle is invalid; generation 0 is
+     * never handed out. The Tag only keeps handles of different tables from mixing.
+     */
+    template <typename Tag>
+    class SlotHandle
+    {
+    public:
+        static constexpr unsigned INDEX_BITS = 20;
+        static constexpr unsigned GENERATION_BITS = 32 - INDEX_BITS;
+        static constexpr Uint32 INDEX_MASK = (1U << INDEX_BITS) - 1U;
+        static constexpr Uint32 GENERATION_MASK = (1U << GENERATION_BITS) - 1U;
+
+        constexpr SlotHandle() noexcept = default;
+
+        constexpr SlotHandle(const Uint32 index, const Uint32 generation) noexcept :
+            value_(((generation & GENERATION_MASK) << INDEX_BITS) | (index & INDEX_MASK)) {}
+
+        [[nodiscard]] constexpr Uint32 index() const noexcept
+        {
+            return value_ & INDEX_MASK;
+        }
+
+        [[nodiscard]] constexpr Uint32 generation() const noexcept
+        {
+            return value_ >> INDEX_BITS;
+        }
+
+        /// @return false for a default-constructed handle. A valid handle may still be stale.
+        [[nodiscard]] constexpr bool valid() const noexcept
+        {
+            return generation() != 0;
+        }
+
+        /// @return The packed 32-bit representation.
+        [[nodiscard]] constexpr Uint32 value() const noexcept
+        {
+            return value_;
+        }
+
+        constexpr bool operator==(const SlotHandle& other) const noexcept = default;
+
+    private:
+        Uint32 value_ = 0;
+    };
+
+    /**
+     * @class SlotTable
+     * @brief Slot array addressed by generational handles, with O(1) insert, remove and lookup.
+     *
+     * Slots live in fixed-size pages that are never moved or freed while the table exists, so a pointer
+     * returned by get() stays valid until that value is removed, and get() may run concurrently with insert()
+     * and remove() of other slots as long as the writers are serialized externally. Removed slots are reused
+     * last-in first-out with their generation bumped, which makes stale handles resolve to nullptr. A slot
+     * whose generation is used up is retired instead of reused, so the table holds MAX_SLOTS values at once
+     * and over four billion insertions in total.
+     *
+     * Not thread-safe otherwise.
+     */
+    template <typename T, typename Tag = T>
+    class SlotTable
+    {
+    public:
+        using Handle = SlotHandle<Tag>;
+
+        static constexpr size_t PAGE_SIZE = 1024;
+        static constexpr size_t MAX_SLOTS = size_t{1} << Handle::INDEX_BITS;
+
+        SlotTable() = default;
+
+        /**
+         * Stores a value in a free slot.
+         *
+         * @return The handle of the value.
+         */
+        Handle insert(T value)
+        {
+            Uint32 index = freeHead_;
+            if (index != NO_SLOT)
+            {
+                freeHead_ = slot(index).nextFree;
+            }
+            else
+            {
+                PSY_ASSERT(slotCount_ < MAX_SLOTS, "SlotTable is full");
+                index = static_cast<Uint32>(slotCount_++);
+                auto& page = pages_[index / PAGE_SIZE];
+                if (!page)
+                {
+                    page = std::make_unique<Page>();
+                }
+            }
+
+            Slot& target = slot(index);
+            target.value.emplace(std::move(value));
+            ++size_;
+            return Handle(index, target.generation);
+        }
+
+        /**
+         * Destroys the value of a handle and frees its slot.
+         *
+         * @return false if the handle was stale or invalid.
+         */
+        bool remove(const Handle handle)
+        {
+            Slot* target = find(handle);
+            if (target == nullptr)
+            {
+                return false;
+            }
+
+            target->value.reset();
+            --size_;
+
+            // Wrapping would let handles from the slot's first use validate again
+            if (target->generation == Handle::GENERATION_MASK)
+            {
+                ++retired_;
+                return true;
+            }
+            ++target->generation;
+            target->nextFree = freeHead_;
+            freeHead_ = handle.index();
+            return true;
+        }
+
+        /// @return The value of a handle, or nullptr if the handle is stale or invalid.
+        [[nodiscard]] T* get(const Handle handle) noexcept
+        {
+            Slot* target = find(handle);
+            return target != nullptr ? &*target->value : nullptr;
+        }
+
+        /// @return The value of a handle, or nullptr if the handle is stale or invalid.
+        [[nodiscard]] const T* get(const Handle handle) const noexcept
+        {
+            const Slot* target = find(handle);
+            return target != nullptr ? &*target->value : nullptr;
+        }
+
+        [[nodiscard]] bool contains(const Handle handle) const noexcept
+        {
+            return get(handle) != nullptr;
+        }
+
+        /// @return Number of stored values.
+        [[nodiscard]] size_t size() const noexcept
+        {
+            return size_;
+        }
+
+        [[nodiscard]] bool empty() const noexcept
+        {
+            return size_ == 0;
+        }
+
+        /// @return Number of slots retired because their generations were used up.
+        [[nodiscard]] size_t retiredSlots() const noexcept
+        {
+            return retired_;
+        }
+
+        /// Calls func(handle, value) for every stored value, in slot order.
+        template <typename Func>
+        void forEach(Func&& func)
+        {
+            for (size_t index = 0; index < slotCount_; ++index)
+            {
+                Slot& target = slot(static_cast<Uint32>(index));
+                if (target.value)
+                {
+                    func(Handle(static_cast<Uint32>(index), target.generation), *target.value);
+                }
+            }
+        }
+
+        /// Calls func(handle, value) for every stored value, in slot order.
+        template <typename Func>
+        void forEach(Func&& func) const
+        {
+            for (size_t index = 0; index < slotCount_; ++index)
+            {
+                const Slot& target = (*pages_[index / PAGE_SIZE])[index % PAGE_SIZE];
+                if (target.value)
+                {
+                    func(Handle(static_cast<Uint32>(index), target.generation), *target.value);
+                }
+            }
+        }
+
+        SlotTable(const SlotTable& other) = delete;
+        SlotTable& operator=(const SlotTable& other) = delete;
+        SlotTable(SlotTable&& other) noexcept = default;
+        SlotTable& operator=(SlotTable&& other) noexcept = default;
+
+    private:
+        static constexpr Uint32 NO_SLOT = ~Uint32{0};
+
+        struct Slot
+        {
+            std::optional<T> value;
+            Uint32 generation = 1;
+            Uint32 nextFree = NO_SLOT;
+        };
+
+        using Page = std::array<Slot, PAGE_SIZE>;
+
+        [[nodiscard]] Slot& slot(const Uint32 index) noexcept
+        {
+            return (*pages_[index / PAGE_SIZE])[index % PAGE_SIZE];
+        }
+
+        // Lookups only read the handle's own page and slot, never the writer's bookkeeping
+        [[nodiscard]] const Slot* find(const Handle handle) const noexcept
+        {
+            const auto& page = pages_[handle.index() / PAGE_SIZE];
+            if (!handle.valid() || !page)
+            {
+                return nullptr;
+            }
+            const Slot& target = (*page)[handle.index() % PAGE_SIZE];
+            return target.generation == handle.generation() && target.value ? &target : nullptr;
+        }
+
+        [[nodiscard]] Slot* find(const Handle handle) noexcept
+        {
+            const auto& page = pages_[handle.index() / PAGE_SIZE];
+            if (!handle.valid() || !page)
+            {
+                return nullptr;
+            }
+            Slot& target = (*page)[handle.index() % PAGE_SIZE];
+            return target.generation == handle.generation() && target.value ? &target : nullptr;
+        }
+
+        std::array<std::unique_ptr<Page>, MAX_SLOTS / PAGE_SIZE> pages_{};
+        size_t slotCount_ = 0; ///< Slots ever used; the free list links the empty ones among them.
+        size_t size_ = 0;
+        size_t retired_ = 0;
+        Uint32 freeHead_ = NO_SLOT;
+    };
+}
+
+#endif //PSYENGINE_SLOT_TABLE_HPP
@@ -0,0 +1,82 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#ifndef PSYENGINE_THREAD_POOL_HPP
+#define PSYENGINE_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace psyengine::utils
+{
+    /**
+     * @class ThreadPool
+     * @brief Fixed-size pool of worker threads executing tasks from a shared FIFO queue.
+     *
+     * Tasks must not throw; an escaping exception terminates the process like it would on any std::thread.
+     * Use async() to get results, or exceptions, back through a std::future.
+     *
+     * The destructor finishes every queued task before joining the workers.
+     */
+    class ThreadPool
+    {
+    public:
+        /**
+         * @param threadCount Number of workers; 0 uses std::thread::hardware_concurrency().
+         */
+        explicit ThreadPool(size_t threadCount = 0);
+        ~ThreadPool();
+
+        /// Queues a task for execution on a worker thread.
+        void submit(std::function<void()> task);
+
+        /**
+         * Queues a callable and returns a future for its result.
+         * Exceptions thrown by the callable are stored in the future.
+         */
+        template <typename Func>
+        auto async(Func&& func) -> std::future<std::invoke_result_t<std::decay_t<Func>>>
+        {
+            using Result = std::invoke_result_t<std::decay_t<Func>>;
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Func>(func));
+            auto future = task->get_future();
+            submit([task] { (*task)(); });
+            return future;
+        }
+
+        /// Blocks until the queue is empty and no task is running.
+        void waitIdle();
+
+        /// @return Number of worker threads.
+        [[nodiscard]] size_t threadCount() const noexcept
+        {
+            return workers_.size();
+        }
+
+        ThreadPool(const ThreadPool& other) = delete;
+        ThreadPool(ThreadPool&& other) noexcept = delete;
+        ThreadPool& operator=(const ThreadPool& other) = delete;
+        ThreadPool& operator=(ThreadPool&& other) noexcept = delete;
+
+    private:
+        void workerLoop(const std::stop_token& stopToken);
+
+        std::mutex mutex_;
+        std::condition_variable_any taskAvailable_;
+        std::condition_variable idle_;
+        std::deque<std::function<void()>> tasks_;
+        size_t activeTasks_ = 0;
+
+        std::vector<std::jthread> workers_;
+    };
+}
+
+#endif //PSYENGINE_THREAD_POOL_HPP
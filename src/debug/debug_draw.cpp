@@ -0,0 +1,240 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/debug/debug_draw.hpp"
+
+#ifndef NDEBUG
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include <SDL3/SDL_log.h>
+
+#include "psyengine/debug/assert.hpp"
+
+namespace psyengine::debug
+{
+    namespace
+    {
+        SDL_FPoint Offset(const SDL_FPoint point, const float x, const float y) noexcept
+        {
+            return SDL_FPoint{point.x + x, point.y + y};
+        }
+
+        /// Enough edges that the polygon stays within about half a pixel of the circle.
+        int SegmentsFor(const float radius, const int requested) noexcept
+        {
+            if (requested >= 3)
+            {
+                return requested;
+            }
+            return std::clamp(static_cast<int>(std::sqrt(std::max(radius, 0.0F)) * 4.0F), 8, 64);
+        }
+    }
+
+    DebugDraw& DebugDraw::instance()
+    {
+        static DebugDraw draw;
+        return draw;
+    }
+
+    void DebugDraw::quad(const SDL_FPoint a, const SDL_FPoint b, const SDL_FPoint c, const SDL_FPoint d,
+                         const SDL_FColor color)
+    {
+        const auto first = static_cast<int>(vertices_.size());
+        for (const SDL_FPoint& corner : {a, b, c, d})
+        {
+            vertices_.push_back(SDL_Vertex{corner, color, SDL_FPoint{0.0F, 0.0F}});
+        }
+        indices_.insert(indices_.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+    }
+
+    void DebugDraw::line(const SDL_FPoint from, const SDL_FPoint to, const SDL_FColor color, const float thickness)
+    {
+        if (!enabled_)
+        {
+            return;
+        }
+
+        // Widen the segment sideways by half the thickness each way
+        const float dx = to.x - from.x;
+        const float dy = to.y - from.y;
+        const float length = std::sqrt(dx * dx + dy * dy);
+        const float half = thickness * 0.5F;
+        const float nx = length > 0.0F ? -dy / length * half : 0.0F;
+        const float ny = length > 0.0F ? dx / length * half : half;
+
+        quad(Offset(from, nx, ny), Offset(to, nx, ny), Offset(to, -nx, -ny), Offset(from, -nx, -ny), color);
+        ++primitives_;
+    }
+
+    void DebugDraw::rect(const SDL_FRect& rect, const SDL_FColor color, const float thickness)
+    {
+        if (!enabled_)
+        {
+            return;
+        }
+
+        // A frame of four quads between the outer edge and an inset copy of it, sharing eight vertices
+        const float inset = std::min({thickness, rect.w * 0.5F, rect.h * 0.5F});
+        const auto first = static_cast<int>(vertices_.size());
+        const float left = rect.x;
+        const float top = rect.y;
+        const float right = rect.x + rect.w;
+        const float bottom = rect.y + rect.h;
+        for (const SDL_FPoint& corner : {
+                 SDL_FPoint{left, top}, SDL_FPoint{right, top}, SDL_FPoint{right, bottom}, SDL_FPoint{left, bottom},
+                 SDL_FPoint{left + inset, top + inset}, SDL_FPoint{right - inset, top + inset},
+                 SDL_FPoint{right - inset, bottom - inset}, SDL_FPoint{left + inset, bottom - inset}
+             })
+        {
+            vertices_.push_back(SDL_Vertex{corner, color, SDL_FPoint{0.0F, 0.0F}});
+        }
+        for (int side = 0; side < 4; ++side)
+        {
+            const int outer = first + side;
+            const int outerNext = first + (side + 1) % 4;
+            indices_.insert(indices_.end(), {outer, outerNext, outerNext + 4, outer, outerNext + 4, outer + 4});
+        }
+        ++primitives_;
+    }
+
+    void DebugDraw::fillRect(const SDL_FRect& rect, const SDL_FColor color)
+    {
+        if (!enabled_)
+        {
+            return;
+        }
+
+        quad(SDL_FPoint{rect.x, rect.y}, SDL_FPoint{rect.x + rect.w, rect.y},
+             SDL_FPoint{rect.x + rect.w, rect.y + rect.h}, SDL_FPoint{rect.x, rect.y + rect.h}, color);
+        ++primitives_;
+    }
+
+    void DebugDraw::circle(const SDL_FPoint center, const float radius, const SDL_FColor color, const float thickness,
+                           const int segments)
+    {
+        if (!enabled_)
+        {
+            return;
+        }
+
+        // A ring of alternating outer and inner vertices; the unit vector is rotated rather than recomputed
+        const int count = SegmentsFor(radius, segments);
+        const float step = 2.0F * std::numbers::pi_v<float> / static_cast<float>(count);
+        const float cosStep = std::cos(step);
+        const float sinStep = std::sin(step);
+        const float outer = radius + thickness * 0.5F;
+        const float inner = std::max(radius - thickness * 0.5F, 0.0F);
+
+        const auto first = static_cast<int>(vertices_.size());
+        float x = 1.0F;
+        float y = 0.0F;
+        for (int i = 0; i < count; ++i)
+        {
+            vertices_.push_back(SDL_Vertex{Offset(center, x * outer, y * outer), color, SDL_FPoint{0.0F, 0.0F}});
+            vertices_.push_back(SDL_Vertex{Offset(center, x * inner, y * inner), color, SDL_FPoint{0.0F, 0.0F}});
+            const float rotated = x * cosStep - y * sinStep;
+            y = x * sinStep + y * cosStep;
+            x = rotated;
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            const int current = first + i * 2;
+            const int next = first + (i + 1) % count * 2;
+            indices_.insert(indices_.end(), {current, next, next + 1, current, next + 1, current + 1});
+        }
+        ++primitives_;
+    }
+
+    void DebugDraw::fillCircle(const SDL_FPoint center, const float radius, const SDL_FColor color, const int segments)
+    {
+        if (!enabled_)
+        {
+            return;
+        }
+
+        const int count = SegmentsFor(radius, segments);
+        const float step = 2.0F * std::numbers::pi_v<float> / static_cast<float>(count);
+        const float cosStep = std::cos(step);
+        const float sinStep = std::sin(step);
+
+        const auto first = static_cast<int>(vertices_.size());
+        vertices_.push_back(SDL_Vertex{center, color, SDL_FPoint{0.0F, 0.0F}});
+        float x = radius;
+        float y = 0.0F;
+        for (int i = 0; i < count; ++i)
+        {
+            vertices_.push_back(SDL_Vertex{Offset(center, x, y), color, SDL_FPoint{0.0F, 0.0F}});
+            const float rotated = x * cosStep - y * sinStep;
+            y = x * sinStep + y * cosStep;
+            x = rotated;
+        }
+        for (int i = 0; i < count; ++i)
+        {
+            indices_.insert(indices_.end(), {first, first + 1 + i, first + 1 + (i + 1) % count});
+        }
+        ++primitives_;
+    }
+
+    void DebugDraw::text(const SDL_FPoint position, const std::string_view text, const SDL_FColor color)
+    {
+        if (!enabled_)
+        {
+            return;
+        }
+
+        texts_.push_back(Text{position, color, text_.size()});
+        text_.append(text);
+        text_.push_back('\0');
+        ++primitives_;
+    }
+
+    void DebugDraw::flush(graphics::RenderContext& context)
+    {
+        SDL_Renderer* renderer = context.renderer();
+        lastFlush_ = DebugDrawStats{primitives_, vertices_.size(), indices_.size(), texts_.size()};
+
+        if (!indices_.empty())
+        {
+            // Untextured geometry blends with the draw blend mode, which states may have left at anything
+            SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+            SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+            context.setDrawBlendMode(SDL_BLENDMODE_BLEND);
+            if (!context.renderGeometry(nullptr, vertices_.data(), static_cast<int>(vertices_.size()),
+                                        indices_.data(), static_cast<int>(indices_.size())))
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Debug draw failed: %s", SDL_GetError());
+            }
+            context.setDrawBlendMode(blendMode);
+        }
+
+        if (!texts_.empty())
+        {
+            SDL_FColor drawColor{};
+            SDL_GetRenderDrawColorFloat(renderer, &drawColor.r, &drawColor.g, &drawColor.b, &drawColor.a);
+            for (const Text& entry : texts_)
+            {
+                context.setDrawColorFloat(entry.color.r, entry.color.g, entry.color.b, entry.color.a);
+                context.renderDebugText(entry.position.x, entry.position.y, text_.c_str() + entry.offset);
+            }
+            context.setDrawColorFloat(drawColor.r, drawColor.g, drawColor.b, drawColor.a);
+        }
+
+        clear();
+    }
+
+    void DebugDraw::clear() noexcept
+    {
+        vertices_.clear();
+        indices_.clear();
+        texts_.clear();
+        text_.clear();
+        primitives_ = 0;
+    }
+}
+
+#endif
@@ -0,0 +1,256 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/debug/latency_harness.hpp"
+
+#include <algorithm>
+
+namespace psyengine::debug
+{
+    namespace
+    {
+        constexpr double NS_PER_MS = 1'000'000.0;
+    }
+
+    void LatencyHistogram::record(const Uint64 nanoseconds) noexcept
+    {
+        const size_t bucket = std::min<Uint64>(nanoseconds / BUCKET_WIDTH_NS, BUCKET_COUNT);
+        ++buckets_[bucket];
+        ++count_;
+        sumNs_ += nanoseconds;
+        maxNs_ = std::max(maxNs_, nanoseconds);
+    }
+
+    void LatencyHistogram::reset() noexcept
+    {
+        buckets_.fill(0);
+        count_ = 0;
+        sumNs_ = 0;
+        maxNs_ = 0;
+    }
+
+    double LatencyHistogram::meanMs() const noexcept
+    {
+        if (count_ == 0)
+        {
+            return 0.0;
+        }
+        return static_cast<double>(sumNs_) / static_cast<double>(count_) / NS_PER_MS;
+    }
+
+    double LatencyHistogram::maxMs() const noexcept
+    {
+        return static_cast<double>(maxNs_) / NS_PER_MS;
+    }
+
+    double LatencyHistogram::percentileMs(const double percentile) const noexcept
+    {
+        if (count_ == 0)
+        {
+            return 0.0;
+        }
+
+        const auto target = static_cast<Uint64>(std::clamp(percentile, 0.0, 100.0) / 100.0 *
+            static_cast<double>(count_));
+        Uint64 seen = 0;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i)
+        {
+            seen += buckets_[i];
+            if (seen > target)
+            {
+                return static_cast<double>((i + 1) * BUCKET_WIDTH_NS) / NS_PER_MS;
+            }
+        }
+
+        // Percentile falls into the overflow bucket
+        return maxMs();
+    }
+
+    LatencyHarness::LatencyHarness(const SDL_Keycode probeKey, const double injectionInterval) :
+        probeKey_(probeKey), intervalNs_(static_cast<Uint64>(injectionInterval * 1e9)) {}
+
+    void LatencyHarness::configureHeadless()
+    {
+        SDL_SetHint(SDL_HINT_VIDEO_DRIVER, "offscreen");
+        SDL_SetHint(SDL_HINT_RENDER_DRIVER, "software");
+    }
+
+    void LatencyHarness::setInjectionInterval(const double seconds) noexcept
+    {
+        intervalNs_ = static_cast<Uint64>(seconds * 1e9);
+    }
+
+    void LatencyHarness::inject()
+    {
+        const Uint64 now = SDL_GetTicksNS();
+        if (keyDown_)
+        {
+            // A second press without a release would be filtered as a repeat by the input path
+            pushKey(false, now);
+        }
+
+        pushKey(true, now);
+        keyDown_ = true;
+        lastInjectNs_ = now;
+        pending_.push_back(Probe{.injectedNs = now, .stageNs = {}});
+    }
+
+    void LatencyHarness::onFrameBegin()
+    {
+        const Uint64 now = SDL_GetTicksNS();
+
+        // Release once the press has been presented, so the input manager sees a normal press/release pair
+        if (keyDown_ && (pending_.empty() || reached(pending_.back(), Stage::Presented)))
+        {
+            pushKey(false, now);
+            keyDown_ = false;
+        }
+
+        if (now - lastInjectNs_ >= intervalNs_)
+        {
+            inject();
+        }
+    }
+
+    void LatencyHarness::onEventDispatched(const SDL_Event& event)
+    {
+        if (event.type != SDL_EVENT_KEY_DOWN || event.key.which != SYNTHETIC_KEYBOARD_ID)
+        {
+            return;
+        }
+
+        const Uint64 now = SDL_GetTicksNS();
+        for (auto& probe : pending_)
+        {
+            if (probe.injectedNs == event.common.timestamp && !reached(probe, Stage::Dispatched))
+            {
+                mark(probe, Stage::Dispatched, now);
+                return;
+            }
+        }
+    }
+
+    void LatencyHarness::onInputUpdated()
+    {
+        const Uint64 now = SDL_GetTicksNS();
+        for (auto& probe : pending_)
+        {
+            if (reached(probe, Stage::Dispatched) && !reached(probe, Stage::InputUpdated))
+            {
+                mark(probe, Stage::InputUpdated, now);
+            }
+        }
+    }
+
+    void LatencyHarness::onFixedUpdate()
+    {
+        const Uint64 now = SDL_GetTicksNS();
+        for (auto& probe : pending_)
+        {
+            if (reached(probe, Stage::InputUpdated) && !reached(probe, Stage::FixedUpdate))
+            {
+                mark(probe, Stage::FixedUpdate, now);
+            }
+        }
+    }
+
+    void LatencyHarness::onPresented()
+    {
+        const Uint64 now = SDL_GetTicksNS();
+        for (auto& probe : pending_)
+        {
+            if (reached(probe, Stage::InputUpdated) && !reached(probe, Stage::Presented))
+            {
+                mark(probe, Stage::Presented, now);
+            }
+        }
+
+        // Retire probes that have been seen by both simulation and presentation
+        while (!pending_.empty() && reached(pending_.front(), Stage::FixedUpdate) &&
+            reached(pending_.front(), Stage::Presented))
+        {
+            pending_.pop_front();
+        }
+    }
+
+    const LatencyHistogram& LatencyHarness::histogram(const Stage stage) const noexcept
+    {
+        return histograms_[static_cast<size_t>(stage)];
+    }
+
+    LatencyHarness::Summary LatencyHarness::summary(const Stage stage) const noexcept
+    {
+        const auto& h = histogram(stage);
+        return Summary{
+            .count = h.count(),
+            .meanMs = h.meanMs(),
+            .p50Ms = h.percentileMs(50.0),
+            .p90Ms = h.percentileMs(90.0),
+            .p99Ms = h.percentileMs(99.0),
+            .maxMs = h.maxMs()
+        };
+    }
+
+    void LatencyHarness::logReport() const
+    {
+        for (size_t i = 0; i < STAGE_COUNT; ++i)
+        {
+            const auto stage = static_cast<Stage>(i);
+            const auto [count, meanMs, p50Ms, p90Ms, p99Ms, maxMs] = summary(stage);
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_Log("Latency %-12s n=%llu mean=%.2fms p50=%.2fms p90=%.2fms p99=%.2fms max=%.2fms",
+                    stageName(stage), static_cast<unsigned long long>(count), meanMs, p50Ms, p90Ms, p99Ms, maxMs);
+        }
+    }
+
+    void LatencyHarness::reset()
+    {
+        pending_.clear();
+        for (auto& h : histograms_)
+        {
+            h.reset();
+        }
+    }
+
+    const char* LatencyHarness::stageName(const Stage stage) noexcept
+    {
+        switch (stage)
+        {
+        case Stage::Dispatched:
+            return "dispatched";
+        case Stage::InputUpdated:
+            return "input";
+        case Stage::FixedUpdate:
+            return "fixedUpdate";
+        case Stage::Presented:
+            return "present";
+        default:
+            return "unknown";
+        }
+    }
+
+    bool LatencyHarness::reached(const Probe& probe, const Stage stage) noexcept
+    {
+        return probe.stageNs[static_cast<size_t>(stage)] != 0;
+    }
+
+    void LatencyHarness::mark(Probe& probe, const Stage stage, const Uint64 nowNs)
+    {
+        // Never store 0, it means "not reached yet"
+        probe.stageNs[static_cast<size_t>(stage)] = std::max<Uint64>(nowNs, 1);
+        histograms_[static_cast<size_t>(stage)].record(nowNs - probe.injectedNs);
+    }
+
+    void LatencyHarness::pushKey(const bool down, const Uint64 timestampNs) const
+    {
+        SDL_Event event{};
+        event.type = down ? SDL_EVENT_KEY_DOWN : SDL_EVENT_KEY_UP;
+        event.key.timestamp = timestampNs;
+        event.key.which = SYNTHETIC_KEYBOARD_ID;
+        event.key.key = probeKey_;
+        event.key.down = down;
+        event.key.repeat = false;
+        SDL_PushEvent(&event);
+    }
+}
@@ -0,0 +1,173 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/debug/tick_hash_log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <utility>
+
+#include <SDL3/SDL_iostream.h>
+#include <SDL3/SDL_log.h>
+
+#include "psyengine/state/state_manager.hpp"
+#include "psyengine/time/time.hpp"
+#include "psyengine/utils/hash.hpp"
+
+namespace psyengine::debug
+{
+    void TickHashLog::record(const Uint64 tick, const Uint64 hash)
+    {
+        if (!entries_.empty() && entries_.back().tick >= tick)
+        {
+            const auto it = std::ranges::lower_bound(entries_, tick, {}, &Entry::tick);
+            entries_.erase(it, entries_.end());
+        }
+        entries_.push_back({.tick = tick, .hash = hash});
+    }
+
+    void TickHashLog::recordStates(const Uint64 tick, const state::StateManager& states)
+    {
+        const time::TimePoint start = time::Now();
+
+        utils::Hasher hasher;
+        states.hashSimulation(hasher);
+        record(tick, hasher.digest());
+
+        hashTime_ += time::ElapsedSince(start);
+    }
+
+    std::optional<Uint64> TickHashLog::hashAt(const Uint64 tick) const
+    {
+        const auto it = std::ranges::lower_bound(entries_, tick, {}, &Entry::tick);
+        if (it == entries_.end() || it->tick != tick)
+        {
+            return std::nullopt;
+        }
+        return it->hash;
+    }
+
+    void TickHashLog::clear() noexcept
+    {
+        entries_.clear();
+        hashTime_ = 0.0;
+    }
+
+    bool TickHashLog::saveToFile(const std::string& path) const
+    {
+        std::string text;
+        text.reserve(entries_.size() * 32);
+
+        // "<tick> <16 hex digits>\n"
+        std::array<char, 48> line{};
+        char* const lineEnd = line.data() + line.size();
+        for (const auto& [tick, hash] : entries_)
+        {
+            char* end = std::to_chars(line.data(), lineEnd, tick).ptr;
+            *end++ = ' ';
+            const char* hexEnd = std::to_chars(end, lineEnd, hash, 16).ptr;
+            const auto digits = static_cast<size_t>(hexEnd - end);
+            text.append(line.data(), end);
+            text.append(16 - digits, '0');
+            text.append(end, digits);
+            text.push_back('\n');
+        }
+
+        if (!SDL_SaveFile(path.c_str(), text.data(), text.size()))
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to save tick hash log '%s': %s", path.c_str(),
+                         SDL_GetError());
+            return false;
+        }
+        return true;
+    }
+
+    bool TickHashLog::loadFromFile(const std::string& path)
+    {
+        size_t size = 0;
+        void* data = SDL_LoadFile(path.c_str(), &size);
+        if (data == nullptr)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load tick hash log '%s': %s", path.c_str(),
+                         SDL_GetError());
+            return false;
+        }
+
+        std::vector<Entry> entries;
+        const char* cursor = static_cast<const char*>(data);
+        const char* const end = cursor + size;
+        bool ok = true;
+        while (cursor < end)
+        {
+            Entry entry{};
+            const auto [tickEnd, tickError] = std::from_chars(cursor, end, entry.tick);
+            if (tickError != std::errc{} || tickEnd == end || *tickEnd != ' ')
+            {
+                ok = false;
+                break;
+            }
+
+            const auto [hashEnd, hashError] = std::from_chars(tickEnd + 1, end, entry.hash, 16);
+            if (hashError != std::errc{})
+            {
+                ok = false;
+                break;
+            }
+
+            entries.push_back(entry);
+            cursor = std::find(hashEnd, end, '\n');
+            if (cursor != end)
+            {
+                ++cursor;
+            }
+        }
+        SDL_free(data);
+
+        if (!ok)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Malformed tick hash log '%s'", path.c_str());
+            return false;
+        }
+
+        entries_ = std::move(entries);
+        hashTime_ = 0.0;
+        return true;
+    }
+
+    std::optional<TickHashLog::Divergence> TickHashLog::FirstDivergence(const TickHashLog& expected,
+                                                                        const TickHashLog& actual)
+    {
+        const auto& a = expected.entries_;
+        const auto& b = actual.entries_;
+
+        size_t i = 0;
+        size_t j = 0;
+        while (i < a.size() && j < b.size())
+        {
+            if (a[i].tick == b[j].tick)
+            {
+                if (a[i].hash != b[j].hash)
+                {
+                    return Divergence{.tick = a[i].tick, .expected = a[i].hash, .actual = b[j].hash};
+                }
+                ++i;
+                ++j;
+            }
+            else if (a[i].tick < b[j].tick)
+            {
+                return Divergence{.tick = a[i].tick, .expected = a[i].hash, .actual = std::nullopt};
+            }
+            else
+            {
+                return Divergence{.tick = b[j].tick, .expected = std::nullopt, .actual = b[j].hash};
+            }
+        }
+
+        return std::nullopt;
+    }
+}
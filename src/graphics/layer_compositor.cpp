@@ -0,0 +1,224 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/graphics/layer_compositor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <SDL3/SDL_log.h>
+
+namespace psyengine::graphics
+{
+    namespace
+    {
+        bool InPass(const LayerSettings& settings, const LayerPass pass) noexcept
+        {
+            return (settings.depth < 0) == (pass == LayerPass::Below);
+        }
+    }
+
+    LayerCompositor& LayerCompositor::instance()
+    {
+        static LayerCompositor compositor;
+        return compositor;
+    }
+
+    void LayerCompositor::addLayer(std::string name, const LayerSettings& settings, LayerDrawFunction draw)
+    {
+        removeLayer(name);
+
+        // After every layer of the same depth, so ties composite in the order they were added
+        const auto position = std::ranges::upper_bound(layers_, settings.depth, {},
+                                                       [](const Layer& layer) { return layer.settings.depth; });
+        Layer layer;
+        layer.name = std::move(name);
+        layer.settings = settings;
+        layer.settings.margin = std::max(settings.margin, 0);
+        layer.draw = std::move(draw);
+        layers_.insert(position, std::move(layer));
+    }
+
+    bool LayerCompositor::removeLayer(const std::string_view name)
+    {
+        return std::erase_if(layers_, [name](const Layer& layer) { return layer.name == name; }) > 0;
+    }
+
+    bool LayerCompositor::contains(const std::string_view name) const
+    {
+        return find(name) != nullptr;
+    }
+
+    void LayerCompositor::invalidate(const std::string_view name)
+    {
+        if (Layer* layer = find(name))
+        {
+            layer->dirty = true;
+            layer->targetFailed = false;
+        }
+    }
+
+    void LayerCompositor::invalidateAll() noexcept
+    {
+        for (Layer& layer : layers_)
+        {
+            layer.dirty = true;
+            layer.targetFailed = false;
+        }
+    }
+
+    void LayerCompositor::setVisible(const std::string_view name, const bool visible)
+    {
+        if (Layer* layer = find(name))
+        {
+            layer->visible = visible;
+        }
+    }
+
+    void LayerCompositor::prepare(RenderContext& context, const int width, const int height)
+    {
+        stats_ = LayerStats{};
+        width_ = width;
+        height_ = height;
+
+        bool redrawn = false;
+        for (Layer& layer : layers_)
+        {
+            if (!layer.visible || !layer.settings.cached || layer.targetFailed || !stale(layer))
+            {
+                continue;
+            }
+            if (redraw(context, layer))
+            {
+                ++stats_.redrawn;
+            }
+            redrawn = true;
+        }
+
+        if (redrawn)
+        {
+            context.setTarget(nullptr);
+        }
+    }
+
+    void LayerCompositor::composite(RenderContext& context, const LayerPass pass)
+    {
+        const auto width = static_cast<float>(width_);
+        const auto height = static_cast<float>(height_);
+        const SDL_FRect screen{0.0F, 0.0F, width, height};
+
+        for (Layer& layer : layers_)
+        {
+            if (!layer.visible || !InPass(layer.settings, pass))
+            {
+                continue;
+            }
+
+            const SDL_FPoint scroll = scrollOf(layer);
+            if (layer.settings.cached && layer.target)
+            {
+                // Scrolling within the margin only moves the window into the cached texture
+                const SDL_FRect source{scroll.x - layer.area.x, scroll.y - layer.area.y, width, height};
+                context.renderTexture(layer.target.get(), &source, &screen);
+                ++stats_.composited;
+            }
+            else if (layer.draw)
+            {
+                context.setDrawColorFloat(1.0F, 1.0F, 1.0F, 1.0F);
+                layer.draw(context, SDL_FRect{scroll.x, scroll.y, width, height});
+                ++stats_.direct;
+            }
+        }
+    }
+
+    void LayerCompositor::releaseTargets() noexcept
+    {
+        for (Layer& layer : layers_)
+        {
+            layer.target.reset();
+            layer.dirty = true;
+            layer.targetFailed = false;
+        }
+    }
+
+    void LayerCompositor::clear() noexcept
+    {
+        layers_.clear();
+    }
+
+    LayerCompositor::Layer* LayerCompositor::find(const std::string_view name)
+    {
+        const auto it = std::ranges::find(layers_, name, &Layer::name);
+        return it != layers_.end() ? &*it : nullptr;
+    }
+
+    const LayerCompositor::Layer* LayerCompositor::find(const std::string_view name) const
+    {
+        const auto it = std::ranges::find(layers_, name, &Layer::name);
+        return it != layers_.end() ? &*it : nullptr;
+    }
+
+    SDL_FPoint LayerCompositor::scrollOf(const Layer& layer) const noexcept
+    {
+        return SDL_FPoint{camera_.x * layer.settings.parallax.x, camera_.y * layer.settings.parallax.y};
+    }
+
+    bool LayerCompositor::stale(const Layer& layer) const noexcept
+    {
+        const int margin = layer.settings.margin;
+        if (layer.dirty || !layer.target || layer.target->w != width_ + margin * 2 ||
+            layer.target->h != height_ + margin * 2)
+        {
+            return true;
+        }
+
+        const SDL_FPoint scroll = scrollOf(layer);
+        return scroll.x < layer.area.x || scroll.y < layer.area.y ||
+            scroll.x + static_cast<float>(width_) > layer.area.x + layer.area.w ||
+            scroll.y + static_cast<float>(height_) > layer.area.y + layer.area.h;
+    }
+
+    bool LayerCompositor::redraw(RenderContext& context, Layer& layer)
+    {
+        const int margin = layer.settings.margin;
+        const int targetWidth = width_ + margin * 2;
+        const int targetHeight = height_ + margin * 2;
+
+        if (!layer.target || layer.target->w != targetWidth || layer.target->h != targetHeight)
+        {
+            layer.target.reset(SDL_CreateTexture(context.renderer(), SDL_PIXELFORMAT_ARGB8888,
+                                                 SDL_TEXTUREACCESS_TARGET, targetWidth, targetHeight));
+            if (!layer.target)
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Layer '%s' target creation failed, drawing it uncached: %s",
+                             layer.name.c_str(), SDL_GetError());
+                // Keeps the layer's setting, so it is cached again once a retry succeeds
+                layer.targetFailed = true;
+                return false;
+            }
+            SDL_SetTextureBlendMode(layer.target.get(), SDL_BLENDMODE_BLEND_PREMULTIPLIED);
+            SDL_SetTextureScaleMode(layer.target.get(), layer.settings.scaleMode);
+        }
+
+        // Snapped to whole pixels so content lands on the same texels however the camera moves
+        const SDL_FPoint scroll = scrollOf(layer);
+        layer.area = SDL_FRect{
+            std::floor(scroll.x) - static_cast<float>(margin), std::floor(scroll.y) - static_cast<float>(margin),
+            static_cast<float>(targetWidth), static_cast<float>(targetHeight)
+        };
+
+        context.setTarget(layer.target.get());
+        context.setDrawColorFloat(0.0F, 0.0F, 0.0F, 0.0F);
+        context.clear();
+        context.setDrawColorFloat(1.0F, 1.0F, 1.0F, 1.0F);
+        if (layer.draw)
+        {
+            layer.draw(context, layer.area);
+        }
+        layer.dirty = false;
+        return true;
+    }
+}
@@ -0,0 +1,1145 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/graphics/pixels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <vector>
+
+#include <SDL3/SDL_cpuinfo.h>
+#include <SDL3/SDL_endian.h>
+
+#include "psyengine/debug/assert.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define PSY_PIXELS_AVX2 1
+#if defined(__GNUC__) || defined(__clang__)
+#define PSY_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PSY_TARGET_AVX2
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define PSY_PIXELS_NEON 1
+#endif
+
+namespace psyengine::graphics::pixels
+{
+    namespace
+    {
+        constexpr size_t BYTES_PER_PIXEL = 4;
+        constexpr Uint8 NO_BYTE = 0xFF;
+
+        enum Channel : size_t
+        {
+            RED,
+            GREEN,
+            BLUE,
+            ALPHA, ///< Or the unused byte of formats without alpha.
+        };
+
+        /// Where the channels of a supported format sit within the four bytes of a pixel in memory.
+        struct Layout
+        {
+            std::array<Uint8, 4> offset{};
+            bool alpha = false;
+        };
+
+        bool GetLayout(const SDL_PixelFormat format, Layout& layout)
+        {
+            const SDL_PixelFormatDetails* details = SDL_GetPixelFormatDetails(format);
+            if (details == nullptr || SDL_ISPIXELFORMAT_FOURCC(format) || details->bytes_per_pixel != 4 ||
+                details->Rbits != 8 || details->Gbits != 8 || details->Bbits != 8 ||
+                (details->Abits != 0 && details->Abits != 8))
+            {
+                return false;
+            }
+
+            // Packed formats are defined on the 32-bit value, so the byte a shift lands on depends on endianness
+            const auto byteOf = [](const Uint8 shift)
+            {
+                return static_cast<Uint8>(SDL_BYTEORDER == SDL_LIL_ENDIAN ? shift / 8 : 3 - shift / 8);
+            };
+
+            layout.offset[RED] = byteOf(details->Rshift);
+            layout.offset[GREEN] = byteOf(details->Gshift);
+            layout.offset[BLUE] = byteOf(details->Bshift);
+            layout.alpha = details->Abits == 8;
+            layout.offset[ALPHA] = layout.alpha
+                                       ? byteOf(details->Ashift)
+                                       : static_cast<Uint8>(6 - layout.offset[RED] - layout.offset[GREEN] -
+                                                            layout.offset[BLUE]);
+            return true;
+        }
+
+        Uint32 ToWord(const std::array<Uint8, 4>& bytes) noexcept
+        {
+            Uint32 word;
+            std::memcpy(&word, bytes.data(), sizeof(word));
+            return word;
+        }
+
+        // ---- Kernels -------------------------------------------------------------------------------------------
+        // Every kernel has a scalar reference; the SIMD versions handle whole blocks and must match it bit for bit.
+
+        using MultiplyFn = void (*)(Uint8* pixels, size_t count, const std::array<Uint8, 4>& factors);
+        using AlphaFn = void (*)(Uint8* pixels, size_t count, size_t alpha);
+        using ShuffleFn = void (*)(const Uint8* source, Uint8* destination, size_t count,
+                                   const std::array<Uint8, 4>& order, Uint32 fill);
+        using ColorKeyFn = void (*)(Uint8* pixels, size_t count, Uint32 key, Uint32 keyMask, Uint32 alphaMask);
+        using HalveFn = void (*)(const Uint8* top, const Uint8* bottom, Uint8* destination, size_t count);
+        using LerpFn = void (*)(const Uint8* top, const Uint8* bottom, Uint8* destination, size_t bytes,
+                                unsigned weight);
+        using FindFn = size_t (*)(const Uint8* pixels, size_t count, size_t alpha, Uint8 threshold);
+
+        struct Kernels
+        {
+            SimdLevel level;
+            MultiplyFn multiply; ///< Channel i times factors[i] / 255.
+            AlphaFn premultiply;
+            AlphaFn unpremultiply;
+            ShuffleFn shuffle; ///< Destination byte i is source byte order[i], or 0 for NO_BYTE; then ORs fill.
+            ColorKeyFn colorKey; ///< Clears alphaMask where pixel & keyMask equals key.
+            HalveFn halve; ///< Averages 2x2 blocks of two rows into count pixels.
+            LerpFn lerp; ///< Blends two rows, weight / 256 of the bottom one; weight in [1, 255].
+            FindFn findFirst; ///< Index of the first pixel with alpha above threshold, or count.
+            FindFn findLast; ///< One past the last pixel with alpha above threshold, or 0.
+        };
+
+        /// round(value * factor / 255) for 8-bit inputs, exactly.
+        constexpr Uint8 MulDiv255(const unsigned value, const unsigned factor) noexcept
+        {
+            const unsigned t = value * factor + 128;
+            return static_cast<Uint8>((t + (t >> 8)) >> 8);
+        }
+
+        void MultiplyScalar(Uint8* pixels, const size_t count, const std::array<Uint8, 4>& factors)
+        {
+            for (size_t i = 0; i < count * BYTES_PER_PIXEL; ++i)
+            {
+                pixels[i] = MulDiv255(pixels[i], factors[i % BYTES_PER_PIXEL]);
+            }
+        }
+
+        void PremultiplyScalar(Uint8* pixels, const size_t count, const size_t alpha)
+        {
+            for (Uint8* pixel = pixels; pixel != pixels + count * BYTES_PER_PIXEL; pixel += BYTES_PER_PIXEL)
+            {
+                const unsigned a = pixel[alpha];
+                for (size_t c = 0; c < BYTES_PER_PIXEL; ++c)
+                {
+                    pixel[c] = c == alpha ? pixel[c] : MulDiv255(pixel[c], a);
+                }
+            }
+        }
+
+        void UnpremultiplyScalar(Uint8* pixels, const size_t count, const size_t alpha)
+        {
+            for (Uint8* pixel = pixels; pixel != pixels + count * BYTES_PER_PIXEL; pixel += BYTES_PER_PIXEL)
+            {
+                const unsigned a = pixel[alpha];
+                if (a == 0)
+                {
+                    std::memset(pixel, 0, BYTES_PER_PIXEL);
+                    continue;
+                }
+                for (size_t c = 0; c < BYTES_PER_PIXEL; ++c)
+                {
+                    if (c != alpha)
+                    {
+                        pixel[c] = static_cast<Uint8>(std::min((pixel[c] * 255U + a / 2) / a, 255U));
+                    }
+                }
+            }
+        }
+
+        void ShuffleScalar(const Uint8* source, Uint8* destination, const size_t count,
+                           const std::array<Uint8, 4>& order, const Uint32 fill)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Uint8* from = source + i * BYTES_PER_PIXEL;
+                std::array<Uint8, 4> bytes{};
+                for (size_t c = 0; c < BYTES_PER_PIXEL; ++c)
+                {
+                    bytes[c] = order[c] == NO_BYTE ? 0 : from[order[c]];
+                }
+                const Uint32 word = ToWord(bytes) | fill;
+                std::memcpy(destination + i * BYTES_PER_PIXEL, &word, sizeof(word));
+            }
+        }
+
+        void ColorKeyScalar(Uint8* pixels, const size_t count, const Uint32 key, const Uint32 keyMask,
+                            const Uint32 alphaMask)
+        {
+            for (Uint8* pixel = pixels; pixel != pixels + count * BYTES_PER_PIXEL; pixel += BYTES_PER_PIXEL)
+            {
+                Uint32 word;
+                std::memcpy(&word, pixel, sizeof(word));
+                if ((word & keyMask) == key)
+                {
+                    word &= ~alphaMask;
+                    std::memcpy(pixel, &word, sizeof(word));
+                }
+            }
+        }
+
+        void HalveScalar(const Uint8* top, const Uint8* bottom, Uint8* destination, const size_t count)
+        {
+            for (size_t i = 0; i < count * BYTES_PER_PIXEL; ++i)
+            {
+                const size_t left = (i / BYTES_PER_PIXEL) * 2 * BYTES_PER_PIXEL + i % BYTES_PER_PIXEL;
+                const size_t right = left + BYTES_PER_PIXEL;
+                const unsigned sum = 2U + top[left] + top[right] + bottom[left] + bottom[right];
+                destination[i] = static_cast<Uint8>(sum >> 2);
+            }
+        }
+
+        void LerpScalar(const Uint8* top, const Uint8* bottom, Uint8* destination, const size_t bytes,
+                        const unsigned weight)
+        {
+            for (size_t i = 0; i < bytes; ++i)
+            {
+                destination[i] = static_cast<Uint8>((top[i] * (256 - weight) + bottom[i] * weight + 128) >> 8);
+            }
+        }
+
+        size_t FindFirstScalar(const Uint8* pixels, const size_t count, const size_t alpha, const Uint8 threshold)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (pixels[i * BYTES_PER_PIXEL + alpha] > threshold)
+                {
+                    return i;
+                }
+            }
+            return count;
+        }
+
+        size_t FindLastScalar(const Uint8* pixels, const size_t count, const size_t alpha, const Uint8 threshold)
+        {
+            for (size_t i = count; i > 0; --i)
+            {
+                if (pixels[(i - 1) * BYTES_PER_PIXEL + alpha] > threshold)
+                {
+                    return i;
+                }
+            }
+            return 0;
+        }
+
+        constexpr Kernels SCALAR_KERNELS{
+            SimdLevel::Scalar, &MultiplyScalar, &PremultiplyScalar, &UnpremultiplyScalar, &ShuffleScalar,
+            &ColorKeyScalar, &HalveScalar, &LerpScalar, &FindFirstScalar, &FindLastScalar
+        };
+
+#ifdef PSY_PIXELS_AVX2
+        /// Repeats a per-pixel byte pattern across a register, e.g. a shuffle mask or channel factors.
+        PSY_TARGET_AVX2
+        __m256i RepeatPixelPattern(const std::array<Uint8, 4>& pattern, const bool offsetByPixel)
+        {
+            std::array<Uint8, 32> bytes{};
+            for (size_t i = 0; i < bytes.size(); ++i)
+            {
+                const Uint8 value = pattern[i % BYTES_PER_PIXEL];
+                const auto pixelBase = static_cast<Uint8>((i % 16) / BYTES_PER_PIXEL * BYTES_PER_PIXEL);
+                bytes[i] = offsetByPixel && value != NO_BYTE ? static_cast<Uint8>(pixelBase + value) : value;
+            }
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bytes.data()));
+        }
+
+        PSY_TARGET_AVX2
+        __m256i MulDiv255Avx2(const __m256i value, const __m256i factor)
+        {
+            const __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(value, factor), _mm256_set1_epi16(128));
+            return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+        }
+
+        /// Multiplies 32 bytes by 32 byte factors, each over 255.
+        PSY_TARGET_AVX2
+        __m256i MulDiv255Bytes(const __m256i value, const __m256i factors)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i low = MulDiv255Avx2(_mm256_unpacklo_epi8(value, zero), _mm256_unpacklo_epi8(factors, zero));
+            const __m256i high = MulDiv255Avx2(_mm256_unpackhi_epi8(value, zero),
+                                               _mm256_unpackhi_epi8(factors, zero));
+            return _mm256_packus_epi16(low, high);
+        }
+
+        PSY_TARGET_AVX2
+        void MultiplyAvx2(Uint8* pixels, const size_t count, const std::array<Uint8, 4>& factors)
+        {
+            const __m256i factor = RepeatPixelPattern(factors, false);
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                auto* block = reinterpret_cast<__m256i*>(pixels + i * BYTES_PER_PIXEL);
+                _mm256_storeu_si256(block, MulDiv255Bytes(_mm256_loadu_si256(block), factor));
+            }
+            MultiplyScalar(pixels + i * BYTES_PER_PIXEL, count - i, factors);
+        }
+
+        PSY_TARGET_AVX2
+        void PremultiplyAvx2(Uint8* pixels, const size_t count, const size_t alpha)
+        {
+            // Every byte of a pixel is multiplied by its alpha, except alpha itself, which is multiplied by 255
+            const auto a = static_cast<Uint8>(alpha);
+            const __m256i broadcastAlpha = RepeatPixelPattern({a, a, a, a}, true);
+            std::array<Uint8, 4> alphaBytes{};
+            alphaBytes[alpha] = 0xFF;
+            const __m256i alphaFactor = RepeatPixelPattern(alphaBytes, false);
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                auto* block = reinterpret_cast<__m256i*>(pixels + i * BYTES_PER_PIXEL);
+                const __m256i value = _mm256_loadu_si256(block);
+                const __m256i factors = _mm256_or_si256(_mm256_shuffle_epi8(value, broadcastAlpha), alphaFactor);
+                _mm256_storeu_si256(block, MulDiv255Bytes(value, factors));
+            }
+            PremultiplyScalar(pixels + i * BYTES_PER_PIXEL, count - i, alpha);
+        }
+
+        PSY_TARGET_AVX2
+        void UnpremultiplyAvx2(Uint8* pixels, const size_t count, const size_t alpha)
+        {
+            // (c * 255 + a / 2) / a in float: the numerator is exact and the quotient is never close enough to
+            // the next integer for the single rounding of the division to reach it, so truncating matches the
+            // integer division of the scalar kernel
+            const __m256i byteMask = _mm256_set1_epi32(0xFF);
+            const __m256i maximum = _mm256_set1_epi32(255);
+            const __m128i alphaShift = _mm_cvtsi32_si128(static_cast<int>(alpha * 8));
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                auto* block = reinterpret_cast<__m256i*>(pixels + i * BYTES_PER_PIXEL);
+                const __m256i value = _mm256_loadu_si256(block);
+                const __m256i a = _mm256_and_si256(_mm256_srl_epi32(value, alphaShift), byteMask);
+                const __m256 divisor = _mm256_cvtepi32_ps(a);
+                const __m256i half = _mm256_srli_epi32(a, 1);
+
+                __m256i result = _mm256_sll_epi32(a, alphaShift);
+                for (size_t c = 0; c < BYTES_PER_PIXEL; ++c)
+                {
+                    if (c == alpha)
+                    {
+                        continue;
+                    }
+                    const __m128i shift = _mm_cvtsi32_si128(static_cast<int>(c * 8));
+                    const __m256i channel = _mm256_and_si256(_mm256_srl_epi32(value, shift), byteMask);
+                    const __m256i numerator = _mm256_add_epi32(_mm256_sub_epi32(_mm256_slli_epi32(channel, 8),
+                                                                                channel), half);
+                    __m256i quotient = _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(numerator), divisor));
+                    quotient = _mm256_min_epi32(quotient, maximum);
+                    result = _mm256_or_si256(result, _mm256_sll_epi32(quotient, shift));
+                }
+
+                // Transparent pixels divided by zero; they become zero altogether
+                const __m256i transparent = _mm256_cmpeq_epi32(a, _mm256_setzero_si256());
+                _mm256_storeu_si256(block, _mm256_andnot_si256(transparent, result));
+            }
+            UnpremultiplyScalar(pixels + i * BYTES_PER_PIXEL, count - i, alpha);
+        }
+
+        PSY_TARGET_AVX2
+        void ShuffleAvx2(const Uint8* source, Uint8* destination, const size_t count,
+                         const std::array<Uint8, 4>& order, const Uint32 fill)
+        {
+            // pshufb zeroes bytes whose index has the top bit set, which NO_BYTE has
+            const __m256i mask = RepeatPixelPattern(order, true);
+            const __m256i fillBytes = _mm256_set1_epi32(static_cast<int>(fill));
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256i value = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(source + i * BYTES_PER_PIXEL));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i * BYTES_PER_PIXEL),
+                                    _mm256_or_si256(_mm256_shuffle_epi8(value, mask), fillBytes));
+            }
+            ShuffleScalar(source + i * BYTES_PER_PIXEL, destination + i * BYTES_PER_PIXEL, count - i, order, fill);
+        }
+
+        PSY_TARGET_AVX2
+        void ColorKeyAvx2(Uint8* pixels, const size_t count, const Uint32 key, const Uint32 keyMask,
+                          const Uint32 alphaMask)
+        {
+            const __m256i keyValue = _mm256_set1_epi32(static_cast<int>(key));
+            const __m256i keyBits = _mm256_set1_epi32(static_cast<int>(keyMask));
+            const __m256i alphaBits = _mm256_set1_epi32(static_cast<int>(alphaMask));
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                auto* block = reinterpret_cast<__m256i*>(pixels + i * BYTES_PER_PIXEL);
+                const __m256i value = _mm256_loadu_si256(block);
+                const __m256i match = _mm256_cmpeq_epi32(_mm256_and_si256(value, keyBits), keyValue);
+                _mm256_storeu_si256(block, _mm256_andnot_si256(_mm256_and_si256(match, alphaBits), value));
+            }
+            ColorKeyScalar(pixels + i * BYTES_PER_PIXEL, count - i, key, keyMask, alphaMask);
+        }
+
+        PSY_TARGET_AVX2
+        void HalveAvx2(const Uint8* top, const Uint8* bottom, Uint8* destination, const size_t count)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i rounding = _mm256_set1_epi16(2);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                // Eight source pixels per row make four destination pixels
+                const __m256i upper = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + i * 8));
+                const __m256i lower = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + i * 8));
+
+                // Column sums as 16-bit channels; per 128-bit lane, low holds pixels 0 and 1, high pixels 2 and 3
+                __m256i low = _mm256_add_epi16(_mm256_unpacklo_epi8(upper, zero), _mm256_unpacklo_epi8(lower, zero));
+                __m256i high = _mm256_add_epi16(_mm256_unpackhi_epi8(upper, zero),
+                                                _mm256_unpackhi_epi8(lower, zero));
+
+                // Add each pixel to its neighbour, then take one pair sum from each to get the four blocks in order
+                low = _mm256_add_epi16(low, _mm256_shuffle_epi32(low, _MM_SHUFFLE(1, 0, 3, 2)));
+                high = _mm256_add_epi16(high, _mm256_shuffle_epi32(high, _MM_SHUFFLE(1, 0, 3, 2)));
+                __m256i sum = _mm256_blend_epi32(low, high, 0b11001100);
+                sum = _mm256_srli_epi16(_mm256_add_epi16(sum, rounding), 2);
+
+                const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(sum, sum),
+                                                                _MM_SHUFFLE(3, 1, 2, 0));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i * BYTES_PER_PIXEL),
+                                 _mm256_castsi256_si128(packed));
+            }
+            HalveScalar(top + i * 8, bottom + i * 8, destination + i * BYTES_PER_PIXEL, count - i);
+        }
+
+        PSY_TARGET_AVX2
+        __m256i LerpWords(const __m256i top, const __m256i bottom, const __m256i topWeight, const __m256i bottomWeight)
+        {
+            const __m256i sum = _mm256_add_epi16(_mm256_mullo_epi16(top, topWeight),
+                                                 _mm256_mullo_epi16(bottom, bottomWeight));
+            return _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(128)), 8);
+        }
+
+        PSY_TARGET_AVX2
+        void LerpAvx2(const Uint8* top, const Uint8* bottom, Uint8* destination, const size_t bytes,
+                      const unsigned weight)
+        {
+            const __m256i zero = _mm256_setzero_si256();
+            const __m256i topWeight = _mm256_set1_epi16(static_cast<short>(256 - weight));
+            const __m256i bottomWeight = _mm256_set1_epi16(static_cast<short>(weight));
+
+            size_t i = 0;
+            for (; i + 32 <= bytes; i += 32)
+            {
+                const __m256i upper = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(top + i));
+                const __m256i lower = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bottom + i));
+                const __m256i low = LerpWords(_mm256_unpacklo_epi8(upper, zero), _mm256_unpacklo_epi8(lower, zero),
+                                              topWeight, bottomWeight);
+                const __m256i high = LerpWords(_mm256_unpackhi_epi8(upper, zero), _mm256_unpackhi_epi8(lower, zero),
+                                               topWeight, bottomWeight);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), _mm256_packus_epi16(low, high));
+            }
+            LerpScalar(top + i, bottom + i, destination + i, bytes - i, weight);
+        }
+
+        /// Bit i is set if pixel i of the eight has alpha above the threshold.
+        PSY_TARGET_AVX2
+        unsigned OpaqueMaskAvx2(const Uint8* pixels, const __m128i alphaShift, const __m256i threshold)
+        {
+            const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels));
+            const __m256i a = _mm256_and_si256(_mm256_srl_epi32(value, alphaShift), _mm256_set1_epi32(0xFF));
+            return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, threshold))));
+        }
+
+        PSY_TARGET_AVX2
+        size_t FindFirstAvx2(const Uint8* pixels, const size_t count, const size_t alpha, const Uint8 threshold)
+        {
+            const __m128i alphaShift = _mm_cvtsi32_si128(static_cast<int>(alpha * 8));
+            const __m256i limit = _mm256_set1_epi32(threshold);
+
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                if (const unsigned mask = OpaqueMaskAvx2(pixels + i * BYTES_PER_PIXEL, alphaShift, limit); mask != 0)
+                {
+                    return i + static_cast<size_t>(std::countr_zero(mask));
+                }
+            }
+            return i + FindFirstScalar(pixels + i * BYTES_PER_PIXEL, count - i, alpha, threshold);
+        }
+
+        PSY_TARGET_AVX2
+        size_t FindLastAvx2(const Uint8* pixels, const size_t count, const size_t alpha, const Uint8 threshold)
+        {
+            const __m128i alphaShift = _mm_cvtsi32_si128(static_cast<int>(alpha * 8));
+            const __m256i limit = _mm256_set1_epi32(threshold);
+
+            size_t i = count;
+            for (; i >= 8; i -= 8)
+            {
+                if (const unsigned mask = OpaqueMaskAvx2(pixels + (i - 8) * BYTES_PER_PIXEL, alphaShift, limit);
+                    mask != 0)
+                {
+                    return i - 8 + static_cast<size_t>(std::bit_width(mask));
+                }
+            }
+            return FindLastScalar(pixels, i, alpha, threshold);
+        }
+
+        constexpr Kernels AVX2_KERNELS{
+            SimdLevel::Avx2, &MultiplyAvx2, &PremultiplyAvx2, &UnpremultiplyAvx2, &ShuffleAvx2, &ColorKeyAvx2,
+            &HalveAvx2, &LerpAvx2, &FindFirstAvx2, &FindLastAvx2
+        };
+#endif
+
+#ifdef PSY_PIXELS_NEON
+        uint8x16_t RepeatPixelPatternNeon(const std::array<Uint8, 4>& pattern, const bool offsetByPixel)
+        {
+            std::array<Uint8, 16> bytes{};
+            for (size_t i = 0; i < bytes.size(); ++i)
+            {
+                const Uint8 value = pattern[i % BYTES_PER_PIXEL];
+                const auto pixelBase = static_cast<Uint8>(i / BYTES_PER_PIXEL * BYTES_PER_PIXEL);
+                bytes[i] = offsetByPixel && value != NO_BYTE ? static_cast<Uint8>(pixelBase + value) : value;
+            }
+            return vld1q_u8(bytes.data());
+        }
+
+        uint8x8_t MulDiv255Neon(const uint16x8_t product)
+        {
+            const uint16x8_t t = vaddq_u16(product, vdupq_n_u16(128));
+            return vshrn_n_u16(vaddq_u16(t, vshrq_n_u16(t, 8)), 8);
+        }
+
+        uint8x16_t MulDiv255Bytes(const uint8x16_t value, const uint8x16_t factors)
+        {
+            return vcombine_u8(MulDiv255Neon(vmull_u8(vget_low_u8(value), vget_low_u8(factors))),
+                               MulDiv255Neon(vmull_high_u8(value, factors)));
+        }
+
+        void MultiplyNeon(Uint8* pixels, const size_t count, const std::array<Uint8, 4>& factors)
+        {
+            const uint8x16_t factor = RepeatPixelPatternNeon(factors, false);
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                Uint8* block = pixels + i * BYTES_PER_PIXEL;
+                vst1q_u8(block, MulDiv255Bytes(vld1q_u8(block), factor));
+            }
+            MultiplyScalar(pixels + i * BYTES_PER_PIXEL, count - i, factors);
+        }
+
+        void PremultiplyNeon(Uint8* pixels, const size_t count, const size_t alpha)
+        {
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                // Deinterleaved, each register holds one channel of sixteen pixels
+                Uint8* block = pixels + i * BYTES_PER_PIXEL;
+                uint8x16x4_t channels = vld4q_u8(block);
+                for (size_t c = 0; c < BYTES_PER_PIXEL; ++c)
+                {
+                    if (c != alpha)
+                    {
+                        channels.val[c] = MulDiv255Bytes(channels.val[c], channels.val[alpha]);
+                    }
+                }
+                vst4q_u8(block, channels);
+            }
+            PremultiplyScalar(pixels + i * BYTES_PER_PIXEL, count - i, alpha);
+        }
+
+        /// Divides four channel values by four alphas like the scalar kernel; see UnpremultiplyAvx2.
+        uint32x4_t DivideByAlphaNeon(const uint32x4_t channel, const uint32x4_t a)
+        {
+            const uint32x4_t numerator = vmlaq_n_u32(vshrq_n_u32(a, 1), channel, 255);
+            const uint32x4_t quotient = vcvtq_u32_f32(vdivq_f32(vcvtq_f32_u32(numerator), vcvtq_f32_u32(a)));
+            return vandq_u32(vminq_u32(quotient, vdupq_n_u32(255)), vtstq_u32(a, a));
+        }
+
+        void UnpremultiplyNeon(Uint8* pixels, const size_t count, const size_t alpha)
+        {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                Uint8* block = pixels + i * BYTES_PER_PIXEL;
+                uint8x8x4_t channels = vld4_u8(block);
+                const uint16x8_t a = vmovl_u8(channels.val[alpha]);
+                const uint32x4_t aLow = vmovl_u16(vget_low_u16(a));
+                const uint32x4_t aHigh = vmovl_high_u16(a);
+                for (size_t c = 0; c < BYTES_PER_PIXEL; ++c)
+                {
+                    if (c == alpha)
+                    {
+                        continue;
+                    }
+                    const uint16x8_t value = vmovl_u8(channels.val[c]);
+                    const uint32x4_t low = DivideByAlphaNeon(vmovl_u16(vget_low_u16(value)), aLow);
+                    const uint32x4_t high = DivideByAlphaNeon(vmovl_high_u16(value), aHigh);
+                    channels.val[c] = vmovn_u16(vcombine_u16(vmovn_u32(low), vmovn_u32(high)));
+                }
+                vst4_u8(block, channels);
+            }
+            UnpremultiplyScalar(pixels + i * BYTES_PER_PIXEL, count - i, alpha);
+        }
+
+        void ShuffleNeon(const Uint8* source, Uint8* destination, const size_t count,
+                         const std::array<Uint8, 4>& order, const Uint32 fill)
+        {
+            // Table lookups yield zero for out-of-range indices, which NO_BYTE is
+            const uint8x16_t mask = RepeatPixelPatternNeon(order, true);
+            const uint8x16_t fillBytes = vreinterpretq_u8_u32(vdupq_n_u32(fill));
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const uint8x16_t value = vld1q_u8(source + i * BYTES_PER_PIXEL);
+                vst1q_u8(destination + i * BYTES_PER_PIXEL, vorrq_u8(vqtbl1q_u8(value, mask), fillBytes));
+            }
+            ShuffleScalar(source + i * BYTES_PER_PIXEL, destination + i * BYTES_PER_PIXEL, count - i, order, fill);
+        }
+
+        void ColorKeyNeon(Uint8* pixels, const size_t count, const Uint32 key, const Uint32 keyMask,
+                          const Uint32 alphaMask)
+        {
+            const uint32x4_t keyValue = vdupq_n_u32(key);
+            const uint32x4_t keyBits = vdupq_n_u32(keyMask);
+            const uint32x4_t alphaBits = vdupq_n_u32(alphaMask);
+
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                Uint8* block = pixels + i * BYTES_PER_PIXEL;
+                const uint32x4_t value = vreinterpretq_u32_u8(vld1q_u8(block));
+                const uint32x4_t match = vceqq_u32(vandq_u32(value, keyBits), keyValue);
+                vst1q_u8(block, vreinterpretq_u8_u32(vbicq_u32(value, vandq_u32(match, alphaBits))));
+            }
+            ColorKeyScalar(pixels + i * BYTES_PER_PIXEL, count - i, key, keyMask, alphaMask);
+        }
+
+        void HalveNeon(const Uint8* top, const Uint8* bottom, Uint8* destination, const size_t count)
+        {
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                // Deinterleaving whole pixels splits eight source pixels into the left and right of each block
+                const uint32x4x2_t upper = vld2q_u32(reinterpret_cast<const uint32_t*>(top + i * 8));
+                const uint32x4x2_t lower = vld2q_u32(reinterpret_cast<const uint32_t*>(bottom + i * 8));
+                const uint8x16_t upperLeft = vreinterpretq_u8_u32(upper.val[0]);
+                const uint8x16_t upperRight = vreinterpretq_u8_u32(upper.val[1]);
+                const uint8x16_t lowerLeft = vreinterpretq_u8_u32(lower.val[0]);
+                const uint8x16_t lowerRight = vreinterpretq_u8_u32(lower.val[1]);
+
+                const uint16x8_t low = vaddq_u16(vaddl_u8(vget_low_u8(upperLeft), vget_low_u8(upperRight)),
+                                                 vaddl_u8(vget_low_u8(lowerLeft), vget_low_u8(lowerRight)));
+                const uint16x8_t high = vaddq_u16(vaddl_high_u8(upperLeft, upperRight),
+                                                  vaddl_high_u8(lowerLeft, lowerRight));
+                vst1q_u8(destination + i * BYTES_PER_PIXEL, vcombine_u8(vrshrn_n_u16(low, 2), vrshrn_n_u16(high, 2)));
+            }
+            HalveScalar(top + i * 8, bottom + i * 8, destination + i * BYTES_PER_PIXEL, count - i);
+        }
+
+        void LerpNeon(const Uint8* top, const Uint8* bottom, Uint8* destination, const size_t bytes,
+                      const unsigned weight)
+        {
+            const uint8x16_t topWeight = vdupq_n_u8(static_cast<Uint8>(256 - weight));
+            const uint8x16_t bottomWeight = vdupq_n_u8(static_cast<Uint8>(weight));
+
+            size_t i = 0;
+            for (; i + 16 <= bytes; i += 16)
+            {
+                const uint8x16_t upper = vld1q_u8(top + i);
+                const uint8x16_t lower = vld1q_u8(bottom + i);
+                const uint16x8_t low = vmlal_u8(vmull_u8(vget_low_u8(upper), vget_low_u8(topWeight)),
+                                                vget_low_u8(lower), vget_low_u8(bottomWeight));
+                const uint16x8_t high = vmlal_high_u8(vmull_high_u8(upper, topWeight), lower, bottomWeight);
+                vst1q_u8(destination + i, vcombine_u8(vrshrn_n_u16(low, 8), vrshrn_n_u16(high, 8)));
+            }
+            LerpScalar(top + i, bottom + i, destination + i, bytes - i, weight);
+        }
+
+        bool AnyOpaqueNeon(const Uint8* pixels, const size_t alpha, const uint8x16_t threshold)
+        {
+            const uint8x16x4_t channels = vld4q_u8(pixels);
+            return vmaxvq_u8(vcgtq_u8(channels.val[alpha], threshold)) != 0;
+        }
+
+        size_t FindFirstNeon(const Uint8* pixels, const size_t count, const size_t alpha, const Uint8 threshold)
+        {
+            const uint8x16_t limit = vdupq_n_u8(threshold);
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16)
+            {
+                if (AnyOpaqueNeon(pixels + i * BYTES_PER_PIXEL, alpha, limit))
+                {
+                    return i + FindFirstScalar(pixels + i * BYTES_PER_PIXEL, 16, alpha, threshold);
+                }
+            }
+            return i + FindFirstScalar(pixels + i * BYTES_PER_PIXEL, count - i, alpha, threshold);
+        }
+
+        size_t FindLastNeon(const Uint8* pixels, const size_t count, const size_t alpha, const Uint8 threshold)
+        {
+            const uint8x16_t limit = vdupq_n_u8(threshold);
+            size_t i = count;
+            for (; i >= 16; i -= 16)
+            {
+                if (AnyOpaqueNeon(pixels + (i - 16) * BYTES_PER_PIXEL, alpha, limit))
+                {
+                    return i - 16 + FindLastScalar(pixels + (i - 16) * BYTES_PER_PIXEL, 16, alpha, threshold);
+                }
+            }
+            return FindLastScalar(pixels, i, alpha, threshold);
+        }
+
+        constexpr Kernels NEON_KERNELS{
+            SimdLevel::Neon, &MultiplyNeon, &PremultiplyNeon, &UnpremultiplyNeon, &ShuffleNeon, &ColorKeyNeon,
+            &HalveNeon, &LerpNeon, &FindFirstNeon, &FindLastNeon
+        };
+#endif
+
+        const Kernels* KernelsFor(const SimdLevel level) noexcept
+        {
+            switch (level)
+            {
+#ifdef PSY_PIXELS_AVX2
+            case SimdLevel::Avx2:
+                return SDL_HasAVX2() ? &AVX2_KERNELS : nullptr;
+#endif
+#ifdef PSY_PIXELS_NEON
+            case SimdLevel::Neon:
+                return &NEON_KERNELS;
+#endif
+            case SimdLevel::Scalar:
+                return &SCALAR_KERNELS;
+            default:
+                return nullptr;
+            }
+        }
+
+        std::atomic<const Kernels*>& ActiveKernels() noexcept
+        {
+            static std::atomic<const Kernels*> kernels = []
+            {
+                for (const SimdLevel level : {SimdLevel::Avx2, SimdLevel::Neon})
+                {
+                    if (const Kernels* supported = KernelsFor(level))
+                    {
+                        return supported;
+                    }
+                }
+                return &SCALAR_KERNELS;
+            }();
+            return kernels;
+        }
+
+        const Kernels& Active() noexcept
+        {
+            return *ActiveKernels().load(std::memory_order_relaxed);
+        }
+
+        // ---- Surface plumbing ----------------------------------------------------------------------------------
+
+        /// Locks a surface for direct pixel access where SDL requires it.
+        class SurfaceLock
+        {
+        public:
+            explicit SurfaceLock(SDL_Surface* surface) :
+                surface_(surface),
+                locked_(!SDL_MUSTLOCK(surface) || SDL_LockSurface(surface)) {}
+
+            ~SurfaceLock()
+            {
+                if (locked_ && SDL_MUSTLOCK(surface_))
+                {
+                    SDL_UnlockSurface(surface_);
+                }
+            }
+
+            [[nodiscard]] bool locked() const noexcept
+            {
+                return locked_;
+            }
+
+            SurfaceLock(const SurfaceLock& other) = delete;
+            SurfaceLock(SurfaceLock&& other) noexcept = delete;
+            SurfaceLock& operator=(const SurfaceLock& other) = delete;
+            SurfaceLock& operator=(SurfaceLock&& other) noexcept = delete;
+
+        private:
+            SDL_Surface* surface_;
+            bool locked_;
+        };
+
+        Uint8* Row(const SDL_Surface* surface, const int y) noexcept
+        {
+            return static_cast<Uint8*>(surface->pixels) + static_cast<ptrdiff_t>(y) * surface->pitch;
+        }
+
+        /// Runs an in-place kernel over every row, or over all pixels at once when rows are contiguous.
+        template <typename Func>
+        bool ForEachRow(SDL_Surface* surface, Func&& func)
+        {
+            const SurfaceLock lock(surface);
+            if (!lock.locked())
+            {
+                return false;
+            }
+
+            const auto width = static_cast<size_t>(surface->w);
+            if (static_cast<size_t>(surface->pitch) == width * BYTES_PER_PIXEL)
+            {
+                func(Row(surface, 0), width * static_cast<size_t>(surface->h));
+                return true;
+            }
+            for (int y = 0; y < surface->h; ++y)
+            {
+                func(Row(surface, y), width);
+            }
+            return true;
+        }
+    }
+
+    SimdLevel ActiveSimdLevel() noexcept
+    {
+        return Active().level;
+    }
+
+    bool SetSimdLevel(const SimdLevel level) noexcept
+    {
+        const Kernels* kernels = KernelsFor(level);
+        if (kernels == nullptr)
+        {
+            return false;
+        }
+        ActiveKernels().store(kernels, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool IsSupported(const SDL_PixelFormat format) noexcept
+    {
+        Layout layout;
+        return GetLayout(format, layout);
+    }
+
+    platform::SdlSurfacePtr Convert(SDL_Surface* surface, const SDL_PixelFormat format)
+    {
+        PSY_DEBUG_ASSERT(surface != nullptr, "Surface is null");
+
+        // Color keys become alpha in SDL's conversion, which a byte shuffle cannot do
+        Layout from;
+        Layout to;
+        if (!GetLayout(surface->format, from) || !GetLayout(format, to) || SDL_SurfaceHasColorKey(surface))
+        {
+            return platform::SdlSurfacePtr(SDL_ConvertSurface(surface, format));
+        }
+
+        platform::SdlSurfacePtr converted(SDL_CreateSurface(surface->w, surface->h, format));
+        const SurfaceLock lock(surface);
+        if (!converted || !lock.locked())
+        {
+            return nullptr;
+        }
+
+        std::array<Uint8, 4> order{};
+        std::array<Uint8, 4> fill{};
+        for (const Channel channel : {RED, GREEN, BLUE, ALPHA})
+        {
+            order[to.offset[channel]] = from.offset[channel];
+        }
+        if (!from.alpha)
+        {
+            order[to.offset[ALPHA]] = NO_BYTE;
+            fill[to.offset[ALPHA]] = 0xFF;
+        }
+
+        const Kernels& kernels = Active();
+        for (int y = 0; y < surface->h; ++y)
+        {
+            kernels.shuffle(Row(surface, y), Row(converted.get(), y), static_cast<size_t>(surface->w), order,
+                            ToWord(fill));
+        }
+        return converted;
+    }
+
+    bool Premultiply(SDL_Surface* surface)
+    {
+        PSY_DEBUG_ASSERT(surface != nullptr, "Surface is null");
+
+        Layout layout;
+        if (!GetLayout(surface->format, layout) || !layout.alpha)
+        {
+            return false;
+        }
+
+        const Kernels& kernels = Active();
+        return ForEachRow(surface, [&](Uint8* pixels, const size_t count)
+        {
+            kernels.premultiply(pixels, count, layout.offset[ALPHA]);
+        });
+    }
+
+    bool Unpremultiply(SDL_Surface* surface)
+    {
+        PSY_DEBUG_ASSERT(surface != nullptr, "Surface is null");
+
+        Layout layout;
+        if (!GetLayout(surface->format, layout) || !layout.alpha)
+        {
+            return false;
+        }
+
+        const Kernels& kernels = Active();
+        return ForEachRow(surface, [&](Uint8* pixels, const size_t count)
+        {
+            kernels.unpremultiply(pixels, count, layout.offset[ALPHA]);
+        });
+    }
+
+    bool Multiply(SDL_Surface* surface, const SDL_Color color)
+    {
+        PSY_DEBUG_ASSERT(surface != nullptr, "Surface is null");
+
+        Layout layout;
+        if (!GetLayout(surface->format, layout))
+        {
+            return false;
+        }
+
+        std::array<Uint8, 4> factors{};
+        factors[layout.offset[RED]] = color.r;
+        factors[layout.offset[GREEN]] = color.g;
+        factors[layout.offset[BLUE]] = color.b;
+        factors[layout.offset[ALPHA]] = layout.alpha ? color.a : 0xFF;
+
+        const Kernels& kernels = Active();
+        return ForEachRow(surface, [&](Uint8* pixels, const size_t count)
+        {
+            kernels.multiply(pixels, count, factors);
+        });
+    }
+
+    bool ColorKey(SDL_Surface* surface, const SDL_Color key)
+    {
+        PSY_DEBUG_ASSERT(surface != nullptr, "Surface is null");
+
+        Layout layout;
+        if (!GetLayout(surface->format, layout) || !layout.alpha)
+        {
+            return false;
+        }
+
+        std::array<Uint8, 4> keyBytes{};
+        keyBytes[layout.offset[RED]] = key.r;
+        keyBytes[layout.offset[GREEN]] = key.g;
+        keyBytes[layout.offset[BLUE]] = key.b;
+        std::array<Uint8, 4> keyMask{0xFF, 0xFF, 0xFF, 0xFF};
+        keyMask[layout.offset[ALPHA]] = 0;
+        std::array<Uint8, 4> alphaMask{};
+        alphaMask[layout.offset[ALPHA]] = 0xFF;
+
+        const Kernels& kernels = Active();
+        return ForEachRow(surface, [&](Uint8* pixels, const size_t count)
+        {
+            kernels.colorKey(pixels, count, ToWord(keyBytes), ToWord(keyMask), ToWord(alphaMask));
+        });
+    }
+
+    platform::SdlSurfacePtr DownscaleBox(SDL_Surface* surface, const int factor)
+    {
+        PSY_DEBUG_ASSERT(surface != nullptr, "Surface is null");
+        PSY_DEBUG_ASSERT(factor > 0, "Factor must be positive");
+
+        Layout layout;
+        const int width = surface->w / factor;
+        const int height = surface->h / factor;
+        if (!GetLayout(surface->format, layout) || width == 0 || height == 0)
+        {
+            return nullptr;
+        }
+
+        platform::SdlSurfacePtr scaled(SDL_CreateSurface(width, height, surface->format));
+        const SurfaceLock lock(surface);
+        if (!scaled || !lock.locked())
+        {
+            return nullptr;
+        }
+
+        const Kernels& kernels = Active();
+        const auto count = static_cast<size_t>(width);
+        const auto step = static_cast<size_t>(factor) * BYTES_PER_PIXEL;
+        const auto area = static_cast<unsigned>(factor * factor);
+        for (int y = 0; y < height; ++y)
+        {
+            Uint8* destination = Row(scaled.get(), y);
+            if (factor == 2)
+            {
+                kernels.halve(Row(surface, y * 2), Row(surface, y * 2 + 1), destination, count);
+                continue;
+            }
+
+            // Other factors are rare enough to leave to the scalar loop
+            for (size_t x = 0; x < count; ++x)
+            {
+                std::array<unsigned, 4> sums{};
+                for (int row = 0; row < factor; ++row)
+                {
+                    const Uint8* block = Row(surface, y * factor + row) + x * step;
+                    for (size_t i = 0; i < step; ++i)
+                    {
+                        sums[i % BYTES_PER_PIXEL] += block[i];
+                    }
+                }
+                for (size_t c = 0; c < BYTES_PER_PIXEL; ++c)
+                {
+                    destination[x * BYTES_PER_PIXEL + c] = static_cast<Uint8>((sums[c] + area / 2) / area);
+                }
+            }
+        }
+        return scaled;
+    }
+
+    platform::SdlSurfacePtr DownscaleBilinear(SDL_Surface* surface, const int width, const int height)
+    {
+        PSY_DEBUG_ASSERT(surface != nullptr, "Surface is null");
+
+        Layout layout;
+        if (!GetLayout(surface->format, layout) || width <= 0 || height <= 0 || surface->w == 0 || surface->h == 0)
+        {
+            return nullptr;
+        }
+
+        platform::SdlSurfacePtr scaled(SDL_CreateSurface(width, height, surface->format));
+        const SurfaceLock lock(surface);
+        if (!scaled || !lock.locked())
+        {
+            return nullptr;
+        }
+
+        // Sample positions of destination pixel centers in 16.16 fixed point, clamped to the edge pixels
+        const auto samplePositions = [](const int source, const int destination)
+        {
+            std::vector<Sint64> positions(static_cast<size_t>(destination));
+            const Sint64 maximum = static_cast<Sint64>(source - 1) << 16;
+            for (int i = 0; i < destination; ++i)
+            {
+                const Sint64 center = (static_cast<Sint64>(2 * i + 1) * source << 16) / (2 * destination) - 0x8000;
+                positions[static_cast<size_t>(i)] = std::clamp<Sint64>(center, 0, maximum);
+            }
+            return positions;
+        };
+        const std::vector<Sint64> columns = samplePositions(surface->w, width);
+        const std::vector<Sint64> rows = samplePositions(surface->h, height);
+
+        // Rows are blended with the kernel first; the columns of the blended row then need a gather per pixel
+        const Kernels& kernels = Active();
+        const size_t rowBytes = static_cast<size_t>(surface->w) * BYTES_PER_PIXEL;
+        std::vector<Uint8> blended(rowBytes);
+        for (int y = 0; y < height; ++y)
+        {
+            const Sint64 position = rows[static_cast<size_t>(y)];
+            const auto top = static_cast<int>(position >> 16);
+            const auto weight = static_cast<unsigned>((position >> 8) & 0xFF);
+            const Uint8* source = Row(surface, top);
+            if (weight != 0)
+            {
+                kernels.lerp(source, Row(surface, std::min(top + 1, surface->h - 1)), blended.data(), rowBytes,
+                             weight);
+                source = blended.data();
+            }
+
+            Uint8* destination = Row(scaled.get(), y);
+            for (int x = 0; x < width; ++x)
+            {
+                const Sint64 column = columns[static_cast<size_t>(x)];
+                const auto left = static_cast<size_t>(column >> 16);
+                const size_t right = std::min(left + 1, static_cast<size_t>(surface->w - 1));
+                const auto rightWeight = static_cast<unsigned>((column >> 8) & 0xFF);
+                for (size_t c = 0; c < BYTES_PER_PIXEL; ++c)
+                {
+                    destination[static_cast<size_t>(x) * BYTES_PER_PIXEL + c] = static_cast<Uint8>(
+                        (source[left * BYTES_PER_PIXEL + c] * (256 - rightWeight) +
+                            source[right * BYTES_PER_PIXEL + c] * rightWeight + 128) >> 8);
+                }
+            }
+        }
+        return scaled;
+    }
+
+    SDL_Rect TrimBounds(SDL_Surface* surface, const Uint8 threshold)
+    {
+        PSY_DEBUG_ASSERT(surface != nullptr, "Surface is null");
+
+        Layout layout;
+        const SurfaceLock lock(surface);
+        if (!GetLayout(surface->format, layout) || !layout.alpha || !lock.locked())
+        {
+            return SDL_Rect{0, 0, 0, 0};
+        }
+
+        const Kernels& kernels = Active();
+        const auto width = static_cast<size_t>(surface->w);
+        const size_t alpha = layout.offset[ALPHA];
+        size_t left = width;
+        size_t right = 0;
+        int top = -1;
+        int bottom = -1;
+        for (int y = 0; y < surface->h; ++y)
+        {
+            const Uint8* row = Row(surface, y);
+            const size_t first = kernels.findFirst(row, width, alpha, threshold);
+            if (first == width)
+            {
+                continue;
+            }
+
+            const size_t last = first + kernels.findLast(row + first * BYTES_PER_PIXEL, width - first, alpha,
+                                                         threshold);
+            left = std::min(left, first);
+            right = std::max(right, last);
+            top = top < 0 ? y : top;
+            bottom = y;
+        }
+
+        if (top < 0)
+        {
+            return SDL_Rect{0, 0, 0, 0};
+        }
+        return SDL_Rect{static_cast<int>(left), top, static_cast<int>(right - left), bottom - top + 1};
+    }
+
+    std::vector<Span> OpaqueSpans(SDL_Surface* surface, const Uint8 threshold)
+    {
+        PSY_DEBUG_ASSERT(surface != nullptr, "Surface is null");
+
+        Layout layout;
+        const SurfaceLock lock(surface);
+        if (!GetLayout(surface->format, layout) || !layout.alpha || !lock.locked())
+        {
+            return {};
+        }
+
+        const Kernels& kernels = Active();
+        const auto width = static_cast<size_t>(surface->w);
+        const size_t alpha = layout.offset[ALPHA];
+        std::vector<Span> spans(static_cast<size_t>(surface->h));
+        for (int y = 0; y < surface->h; ++y)
+        {
+            const Uint8* row = Row(surface, y);
+            const size_t first = kernels.findFirst(row, width, alpha, threshold);
+            if (first != width)
+            {
+                const size_t last = first + kernels.findLast(row + first * BYTES_PER_PIXEL, width - first, alpha,
+                                                             threshold);
+                spans[static_cast<size_t>(y)] = Span{static_cast<int>(first), static_cast<int>(last)};
+            }
+        }
+        return spans;
+    }
+}
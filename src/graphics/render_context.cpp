@@ -0,0 +1,231 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/graphics/render_context.hpp"
+
+#include <cstring>
+
+namespace psyengine::graphics
+{
+    namespace
+    {
+        size_t Count(const int count) noexcept
+        {
+            return count > 0 ? static_cast<size_t>(count) : 0;
+        }
+    }
+
+    void RenderContext::beginFrame() noexcept
+    {
+        stats_ = RenderStats{};
+        lastTexture_ = nullptr;
+        lastBoundTexture_ = nullptr;
+        stateChanged_ = false;
+
+        // Anything may have happened to the renderer between frames
+        knownState_ = false;
+    }
+
+    void RenderContext::countDraw(const SDL_Texture* texture, const size_t vertices) noexcept
+    {
+        if (stats_.drawCalls > 0 && (texture != lastTexture_ || stateChanged_))
+        {
+            ++stats_.batchBreaks;
+        }
+        if (texture != nullptr)
+        {
+            if (lastBoundTexture_ != nullptr && texture != lastBoundTexture_)
+            {
+                ++stats_.textureSwitches;
+            }
+            lastBoundTexture_ = texture;
+        }
+
+        ++stats_.drawCalls;
+        stats_.vertices += vertices;
+        lastTexture_ = texture;
+        stateChanged_ = false;
+    }
+
+    void RenderContext::syncState() noexcept
+    {
+        if (knownState_)
+        {
+            return;
+        }
+        SDL_GetRenderDrawColorFloat(renderer_, &drawColor_.r, &drawColor_.g, &drawColor_.b, &drawColor_.a);
+        SDL_GetRenderDrawBlendMode(renderer_, &blendMode_);
+        target_ = SDL_GetRenderTarget(renderer_);
+        SDL_GetRenderScale(renderer_, &scale_.x, &scale_.y);
+        knownState_ = true;
+    }
+
+    void RenderContext::countStateChange() noexcept
+    {
+        ++stats_.stateChanges;
+        stateChanged_ = true;
+    }
+
+    bool RenderContext::clear()
+    {
+        countDraw(nullptr, 0);
+        return SDL_RenderClear(renderer_);
+    }
+
+    bool RenderContext::renderTexture(SDL_Texture* texture, const SDL_FRect* source, const SDL_FRect* destination)
+    {
+        countDraw(texture, 4);
+        return SDL_RenderTexture(renderer_, texture, source, destination);
+    }
+
+    bool RenderContext::renderTextureRotated(SDL_Texture* texture, const SDL_FRect* source,
+                                             const SDL_FRect* destination, const double angle,
+                                             const SDL_FPoint* center, const SDL_FlipMode flip)
+    {
+        countDraw(texture, 4);
+        return SDL_RenderTextureRotated(renderer_, texture, source, destination, angle, center, flip);
+    }
+
+    bool RenderContext::renderGeometry(SDL_Texture* texture, const SDL_Vertex* vertices, const int vertexCount,
+                                       const int* indices, const int indexCount)
+    {
+        countDraw(texture, Count(vertexCount));
+        return SDL_RenderGeometry(renderer_, texture, vertices, vertexCount, indices, indexCount);
+    }
+
+    bool RenderContext::renderFillRect(const SDL_FRect* rect)
+    {
+        countDraw(nullptr, 4);
+        return SDL_RenderFillRect(renderer_, rect);
+    }
+
+    bool RenderContext::renderFillRects(const SDL_FRect* rects, const int count)
+    {
+        countDraw(nullptr, Count(count) * 4);
+        return SDL_RenderFillRects(renderer_, rects, count);
+    }
+
+    bool RenderContext::renderRect(const SDL_FRect* rect)
+    {
+        countDraw(nullptr, 4);
+        return SDL_RenderRect(renderer_, rect);
+    }
+
+    bool RenderContext::renderRects(const SDL_FRect* rects, const int count)
+    {
+        countDraw(nullptr, Count(count) * 4);
+        return SDL_RenderRects(renderer_, rects, count);
+    }
+
+    bool RenderContext::renderLine(const float x1, const float y1, const float x2, const float y2)
+    {
+        countDraw(nullptr, 2);
+        return SDL_RenderLine(renderer_, x1, y1, x2, y2);
+    }
+
+    bool RenderContext::renderLines(const SDL_FPoint* points, const int count)
+    {
+        countDraw(nullptr, Count(count));
+        return SDL_RenderLines(renderer_, points, count);
+    }
+
+    bool RenderContext::renderPoint(const float x, const float y)
+    {
+        countDraw(nullptr, 1);
+        return SDL_RenderPoint(renderer_, x, y);
+    }
+
+    bool RenderContext::renderPoints(const SDL_FPoint* points, const int count)
+    {
+        countDraw(nullptr, Count(count));
+        return SDL_RenderPoints(renderer_, points, count);
+    }
+
+    bool RenderContext::renderDebugText(const float x, const float y, const char* text)
+    {
+        // The debug font is a texture SDL owns; count it as one of its own
+        countDraw(nullptr, text != nullptr ? std::strlen(text) * 4 : 0);
+        return SDL_RenderDebugText(renderer_, x, y, text);
+    }
+
+    bool RenderContext::setDrawColor(const Uint8 r, const Uint8 g, const Uint8 b, const Uint8 a)
+    {
+        constexpr float SCALE = 1.0F / 255.0F;
+        return setDrawColorFloat(static_cast<float>(r) * SCALE, static_cast<float>(g) * SCALE,
+                                 static_cast<float>(b) * SCALE, static_cast<float>(a) * SCALE);
+    }
+
+    bool RenderContext::setDrawColorFloat(const float r, const float g, const float b, const float a)
+    {
+        syncState();
+        if (drawColor_.r != r || drawColor_.g != g || drawColor_.b != b || drawColor_.a != a)
+        {
+            drawColor_ = SDL_FColor{r, g, b, a};
+            countStateChange();
+        }
+        return SDL_SetRenderDrawColorFloat(renderer_, r, g, b, a);
+    }
+
+    bool RenderContext::setDrawBlendMode(const SDL_BlendMode blendMode)
+    {
+        syncState();
+        if (blendMode_ != blendMode)
+        {
+            blendMode_ = blendMode;
+            countStateChange();
+        }
+        return SDL_SetRenderDrawBlendMode(renderer_, blendMode);
+    }
+
+    bool RenderContext::setTarget(SDL_Texture* texture)
+    {
+        syncState();
+        if (target_ != texture)
+        {
+            target_ = texture;
+            countStateChange();
+        }
+        return SDL_SetRenderTarget(renderer_, texture);
+    }
+
+    bool RenderContext::setScale(const float scaleX, const float scaleY)
+    {
+        syncState();
+        if (scale_.x != scaleX || scale_.y != scaleY)
+        {
+            scale_ = SDL_FPoint{scaleX, scaleY};
+            countStateChange();
+        }
+        return SDL_SetRenderScale(renderer_, scaleX, scaleY);
+    }
+
+    bool RenderContext::setViewport(const SDL_Rect* rect)
+    {
+        countStateChange();
+        return SDL_SetRenderViewport(renderer_, rect);
+    }
+
+    bool RenderContext::setClipRect(const SDL_Rect* rect)
+    {
+        countStateChange();
+        return SDL_SetRenderClipRect(renderer_, rect);
+    }
+
+    bool RenderContext::updateTexture(SDL_Texture* texture, const SDL_Rect* rect, const void* pixels, const int pitch)
+    {
+        const bool ok = SDL_UpdateTexture(texture, rect, pixels, pitch);
+        if (ok)
+        {
+            const int rows = rect != nullptr ? rect->h : texture->h;
+            recordUpload(static_cast<Uint64>(Count(rows)) * static_cast<Uint64>(Count(pitch)));
+        }
+        return ok;
+    }
+
+    void RenderContext::recordUpload(const Uint64 bytes, const size_t count) noexcept
+    {
+        stats_.uploads += count;
+        stats_.uploadedBytes += bytes;
+    }
+}
@@ -0,0 +1,85 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/graphics/sprite_batch.hpp"
+
+#include <SDL3/SDL_log.h>
+
+#include "psyengine/debug/assert.hpp"
+
+namespace psyengine::graphics
+{
+    void SpriteBatch::draw(SDL_Texture* texture, const SpriteMesh& mesh, const SDL_FRect* source,
+                           const SDL_FRect& destination, const SDL_FColor color)
+    {
+        PSY_DEBUG_ASSERT(texture != nullptr, "Texture is null");
+
+        if (mesh.empty())
+        {
+            return;
+        }
+
+        if (texture != texture_)
+        {
+            flush();
+            texture_ = texture;
+            if (!SDL_GetTextureSize(texture, &textureWidth_, &textureHeight_))
+            {
+                textureWidth_ = 1.0F;
+                textureHeight_ = 1.0F;
+            }
+        }
+
+        const SDL_FRect region = source != nullptr ? *source : SDL_FRect{0.0F, 0.0F, textureWidth_, textureHeight_};
+        const float width = static_cast<float>(mesh.width);
+        const float height = static_cast<float>(mesh.height);
+        const float scaleX = destination.w / width;
+        const float scaleY = destination.h / height;
+        const float u = region.w / (width * textureWidth_);
+        const float v = region.h / (height * textureHeight_);
+
+        const auto first = static_cast<int>(vertices_.size());
+        for (const SDL_FPoint& position : mesh.positions)
+        {
+            SDL_Vertex vertex;
+            vertex.position = SDL_FPoint{destination.x + position.x * scaleX, destination.y + position.y * scaleY};
+            vertex.color = color;
+            vertex.tex_coord = SDL_FPoint{region.x / textureWidth_ + position.x * u,
+                                          region.y / textureHeight_ + position.y * v};
+            vertices_.push_back(vertex);
+        }
+        for (const int index : mesh.indices)
+        {
+            indices_.push_back(first + index);
+        }
+
+        ++stats_.sprites;
+        stats_.vertices += mesh.positions.size();
+        stats_.indices += mesh.indices.size();
+        stats_.pixels += static_cast<double>(mesh.area) * static_cast<double>(scaleX * scaleY);
+        stats_.quadPixels += static_cast<double>(destination.w) * static_cast<double>(destination.h);
+    }
+
+    bool SpriteBatch::flush()
+    {
+        if (indices_.empty())
+        {
+            return true;
+        }
+
+        const bool ok = context_.renderGeometry(texture_, vertices_.data(), static_cast<int>(vertices_.size()),
+                                                indices_.data(), static_cast<int>(indices_.size()));
+        if (!ok)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to draw sprite batch: %s", SDL_GetError());
+        }
+
+        ++stats_.batches;
+        texture_ = nullptr;
+        vertices_.clear();
+        indices_.clear();
+        return ok;
+    }
+}
@@ -0,0 +1,305 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/graphics/sprite_mesh.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#include "psyengine/debug/assert.hpp"
+#include "psyengine/graphics/pixels.hpp"
+
+namespace psyengine::graphics
+{
+    namespace
+    {
+        struct Point
+        {
+            double x;
+            double y;
+        };
+
+        double Cross(const Point a, const Point b) noexcept
+        {
+            return a.x * b.y - a.y * b.x;
+        }
+
+        Point Sub(const Point a, const Point b) noexcept
+        {
+            return Point{a.x - b.x, a.y - b.y};
+        }
+
+        void AddRect(SpriteMesh& mesh, const float left, const float top, const float right, const float bottom)
+        {
+            const auto first = static_cast<int>(mesh.positions.size());
+            mesh.positions.push_back(SDL_FPoint{left, top});
+            mesh.positions.push_back(SDL_FPoint{right, top});
+            mesh.positions.push_back(SDL_FPoint{right, bottom});
+            mesh.positions.push_back(SDL_FPoint{left, bottom});
+            mesh.indices.insert(mesh.indices.end(), {first, first + 1, first + 2, first, first + 2, first + 3});
+            mesh.area += (right - left) * (bottom - top);
+        }
+
+        /**
+         * Convex hull of the corners of every visible span, by monotone chain: it contains every visible pixel.
+         * Counter-clockwise in the math sense, i.e. every turn has a positive cross product.
+         */
+        std::vector<Point> Hull(const std::vector<pixels::Span>& spans)
+        {
+            std::vector<Point> points;
+            for (size_t y = 0; y < spans.size(); ++y)
+            {
+                if (spans[y].empty())
+                {
+                    continue;
+                }
+                const auto top = static_cast<double>(y);
+                for (const int x : {spans[y].begin, spans[y].end})
+                {
+                    points.push_back(Point{static_cast<double>(x), top});
+                    points.push_back(Point{static_cast<double>(x), top + 1.0});
+                }
+            }
+            std::ranges::sort(points, [](const Point a, const Point b)
+            {
+                return a.x < b.x || (a.x == b.x && a.y < b.y);
+            });
+
+            std::vector<Point> hull(points.size() * 2);
+            size_t size = 0;
+            const auto push = [&](const Point point, const size_t floor)
+            {
+                while (size >= floor && Cross(Sub(hull[size - 1], hull[size - 2]), Sub(point, hull[size - 1])) <= 0.0)
+                {
+                    --size;
+                }
+                hull[size++] = point;
+            };
+            for (const Point point : points)
+            {
+                push(point, 2);
+            }
+            const size_t lower = size + 1;
+            for (size_t i = points.size() - 1; i-- > 0;)
+            {
+                push(points[i], lower);
+            }
+            hull.resize(size - 1);
+            return hull;
+        }
+
+        /**
+         * Removes hull edges until at most maxVertices corners remain. An edge is removed by extending its
+         * neighbours until they meet, which only grows the polygon; the edge adding the least area goes first, and
+         * corners may not leave the sprite's bounds so texture coordinates stay within it.
+         */
+        void ReduceHull(std::vector<Point>& hull, const size_t maxVertices, const SDL_Rect& bounds)
+        {
+            constexpr double EPSILON = 1e-9;
+            while (hull.size() > std::max<size_t>(maxVertices, 3))
+            {
+                const size_t count = hull.size();
+                double bestArea = std::numeric_limits<double>::infinity();
+                size_t bestEdge = count;
+                Point bestCorner{};
+                for (size_t i = 0; i < count; ++i)
+                {
+                    const Point previous = hull[(i + count - 1) % count];
+                    const Point start = hull[i];
+                    const Point end = hull[(i + 1) % count];
+                    const Point next = hull[(i + 2) % count];
+                    const Point incoming = Sub(start, previous);
+                    const Point outgoing = Sub(next, end);
+
+                    // Neighbours turning through half a circle or more never meet on this side
+                    const double turn = Cross(incoming, outgoing);
+                    if (turn <= EPSILON)
+                    {
+                        continue;
+                    }
+                    const double t = Cross(Sub(end, start), outgoing) / turn;
+                    const Point corner{start.x + incoming.x * t, start.y + incoming.y * t};
+                    if (corner.x < bounds.x - EPSILON || corner.y < bounds.y - EPSILON ||
+                        corner.x > bounds.x + bounds.w + EPSILON || corner.y > bounds.y + bounds.h + EPSILON)
+                    {
+                        continue;
+                    }
+
+                    if (const double area = std::abs(Cross(Sub(end, start), Sub(corner, start))) * 0.5;
+                        area < bestArea)
+                    {
+                        bestArea = area;
+                        bestEdge = i;
+                        bestCorner = corner;
+                    }
+                }
+                if (bestEdge == count)
+                {
+                    return;
+                }
+
+                hull[bestEdge] = bestCorner;
+                hull.erase(hull.begin() + static_cast<ptrdiff_t>((bestEdge + 1) % count));
+            }
+        }
+
+        SpriteMesh ConvexMesh(const std::vector<pixels::Span>& spans, const SpriteMeshOptions& options,
+                              const SDL_Rect& bounds)
+        {
+            std::vector<Point> hull = Hull(spans);
+            ReduceHull(hull, static_cast<size_t>(options.maxVertices), bounds);
+
+            SpriteMesh mesh;
+            double area = 0.0;
+            for (size_t i = 0; i < hull.size(); ++i)
+            {
+                mesh.positions.push_back(SDL_FPoint{static_cast<float>(hull[i].x), static_cast<float>(hull[i].y)});
+                area += Cross(hull[i], hull[(i + 1) % hull.size()]);
+            }
+            for (int i = 1; i + 1 < static_cast<int>(hull.size()); ++i)
+            {
+                mesh.indices.insert(mesh.indices.end(), {0, i, i + 1});
+            }
+            mesh.area = static_cast<float>(area * 0.5);
+            return mesh;
+        }
+
+        SpriteMesh ConcaveMesh(const std::vector<pixels::Span>& spans, const SpriteMeshOptions& options)
+        {
+            struct Band
+            {
+                int top;
+                int bottom;
+                int begin;
+                int end;
+
+                [[nodiscard]] Sint64 area() const noexcept
+                {
+                    return static_cast<Sint64>(bottom - top) * (end - begin);
+                }
+            };
+
+            const auto merged = [](const Band& a, const Band& b)
+            {
+                return Band{a.top, b.bottom, std::min(a.begin, b.begin), std::max(a.end, b.end)};
+            };
+
+            // One band per visible row, rows with identical spans joined right away
+            std::vector<Band> bands;
+            for (int y = 0; y < static_cast<int>(spans.size()); ++y)
+            {
+                const pixels::Span& span = spans[static_cast<size_t>(y)];
+                if (span.empty())
+                {
+                    continue;
+                }
+                if (!bands.empty() && bands.back().bottom == y && bands.back().begin == span.begin &&
+                    bands.back().end == span.end)
+                {
+                    ++bands.back().bottom;
+                    continue;
+                }
+                bands.push_back(Band{y, y + 1, span.begin, span.end});
+            }
+
+            // Merge the neighbours whose joint rectangle adds the fewest pixels until few enough remain
+            const size_t maxBands = std::max<size_t>(static_cast<size_t>(options.maxVertices) / 4, 1);
+            while (bands.size() > maxBands)
+            {
+                size_t best = 0;
+                Sint64 bestCost = std::numeric_limits<Sint64>::max();
+                for (size_t i = 0; i + 1 < bands.size(); ++i)
+                {
+                    if (const Sint64 cost = merged(bands[i], bands[i + 1]).area() - bands[i].area() -
+                                            bands[i + 1].area();
+                        cost < bestCost)
+                    {
+                        bestCost = cost;
+                        best = i;
+                    }
+                }
+                bands[best] = merged(bands[best], bands[best + 1]);
+                bands.erase(bands.begin() + static_cast<ptrdiff_t>(best) + 1);
+            }
+
+            SpriteMesh mesh;
+            for (const Band& band : bands)
+            {
+                AddRect(mesh, static_cast<float>(band.begin), static_cast<float>(band.top),
+                        static_cast<float>(band.end), static_cast<float>(band.bottom));
+            }
+            return mesh;
+        }
+    }
+
+    SpriteMesh MakeQuadMesh(const int width, const int height)
+    {
+        SpriteMesh mesh;
+        mesh.width = width;
+        mesh.height = height;
+        mesh.bounds = SDL_Rect{0, 0, width, height};
+        if (width > 0 && height > 0)
+        {
+            AddRect(mesh, 0.0F, 0.0F, static_cast<float>(width), static_cast<float>(height));
+        }
+        return mesh;
+    }
+
+    SpriteMesh BuildSpriteMesh(SDL_Surface* sprite, const SpriteMeshOptions& options)
+    {
+        PSY_DEBUG_ASSERT(sprite != nullptr, "Sprite is null");
+        PSY_DEBUG_ASSERT(options.maxVertices >= 3, "A mesh needs at least three vertices");
+
+        const std::vector<pixels::Span> spans = pixels::OpaqueSpans(sprite, options.alphaThreshold);
+        if (spans.empty())
+        {
+            return MakeQuadMesh(sprite->w, sprite->h);
+        }
+
+        SDL_Rect bounds{sprite->w, 0, 0, 0};
+        int right = 0;
+        int top = -1;
+        int bottom = 0;
+        for (int y = 0; y < static_cast<int>(spans.size()); ++y)
+        {
+            if (const pixels::Span& span = spans[static_cast<size_t>(y)]; !span.empty())
+            {
+                bounds.x = std::min(bounds.x, span.begin);
+                right = std::max(right, span.end);
+                top = top < 0 ? y : top;
+                bottom = y + 1;
+            }
+        }
+
+        SpriteMesh mesh;
+        if (top >= 0)
+        {
+            bounds = SDL_Rect{bounds.x, top, right - bounds.x, bottom - top};
+            AddRect(mesh, static_cast<float>(bounds.x), static_cast<float>(bounds.y), static_cast<float>(right),
+                    static_cast<float>(bottom));
+
+            if (options.shape != SpriteMeshShape::Quad && bounds.w * bounds.h >= options.minMeshArea)
+            {
+                SpriteMesh fitted = options.shape == SpriteMeshShape::Convex
+                                        ? ConvexMesh(spans, options, bounds)
+                                        : ConcaveMesh(spans, options);
+                if (fitted.area <= mesh.area * (1.0F - options.minSavings))
+                {
+                    mesh = std::move(fitted);
+                }
+            }
+        }
+        else
+        {
+            bounds = SDL_Rect{0, 0, 0, 0};
+        }
+
+        mesh.width = sprite->w;
+        mesh.height = sprite->h;
+        mesh.bounds = bounds;
+        return mesh;
+    }
+}
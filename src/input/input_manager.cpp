@@ -5,6 +5,8 @@
 #include "psyengine/input/input_manager.hpp"
 #include "psyengine/input/input_manager.ipp"
 
+#include <algorithm>
+
 namespace psyengine::input
 {
     InputManager& InputManager::instance()
@@ -137,6 +139,45 @@ namespace psyengine::input
         });
     }
 
+    void InputManager::registerSequence(const std::string& sequenceName, const std::vector<SequenceStep>& steps)
+    {
+        std::vector<SequenceRecognizer::Step> compiled;
+        compiled.reserve(steps.size());
+        for (const auto& [binding, maxTicks] : steps)
+        {
+            compiled.push_back(SequenceRecognizer::Step{.input = encodeInput(binding), .maxTicks = maxTicks});
+        }
+
+        const SequenceRecognizer::SequenceId id = sequences_.add(compiled);
+        sequenceIds_[sequenceName].push_back(id);
+        sequenceTriggered_.resize(static_cast<size_t>(id) + 1, false);
+    }
+
+    bool InputManager::isSequenceTriggered(const std::string& sequenceName) const
+    {
+        if (const auto it = sequenceIds_.find(sequenceName); it != std::end(sequenceIds_))
+        {
+            return std::ranges::any_of(it->second, [this](const SequenceRecognizer::SequenceId id)
+            {
+                return sequenceTriggered_[id];
+            });
+        }
+        return false;
+    }
+
+    void InputManager::resetSequences()
+    {
+        sequences_.reset();
+    }
+
+    void InputManager::clearSequences()
+    {
+        sequences_.clear();
+        sequenceIds_.clear();
+        sequenceTriggered_.clear();
+        triggeredSequences_.clear();
+    }
+
     void InputManager::handleEvent(const SDL_Event& e)
     {
         switch (e.type)
@@ -152,6 +193,7 @@ namespace psyengine::input
             break;
 
         case SDL_EVENT_MOUSE_BUTTON_DOWN:
+            mousePosition_ = SDL_FPoint{e.button.x, e.button.y};
             onButtonPress(e.button.button, time::Now());
             break;
         case SDL_EVENT_MOUSE_BUTTON_UP:
@@ -165,6 +207,10 @@ namespace psyengine::input
             onButtonRelease(static_cast<SDL_GamepadButton>(e.gbutton.button), e.gbutton.which);
             break;
 
+        case SDL_EVENT_MOUSE_MOTION:
+            mousePosition_ = SDL_FPoint{e.motion.x, e.motion.y};
+            break;
+
         case SDL_EVENT_GAMEPAD_AXIS_MOTION:
             {
                 auto& axis = axes_[e.gaxis.which][static_cast<SDL_GamepadAxis>(e.gaxis.axis)];
@@ -190,9 +236,21 @@ namespace psyengine::input
     {
         const auto now = time::Now();
 
-        updateGamepads(now);
-        updateMouseButtons(now);
-        updateKeyboardButtons(now);
+        updateGamepads(now, true);
+        updateMouseButtons(now, true);
+        updateKeyboardButtons(now, true);
+        updateSequences();
+    }
+
+    void InputManager::refresh()
+    {
+        const auto now = time::Now();
+
+        // Same evaluation as update(), but the previous-frame snapshot is kept so that the next update()
+        // still reports the edges to the simulation, and this frame's Clicked/Released states are kept
+        updateGamepads(now, false);
+        updateMouseButtons(now, false);
+        updateKeyboardButtons(now, false);
     }
 
     bool InputManager::isClicked(const SDL_Keycode key) const
@@ -296,6 +354,7 @@ namespace psyengine::input
         auto& btn = keyboardButtons_[key];
         btn.isDown = true;
         btn.pressTime = now;
+        sequences_.onInput(encodeInput(KeyBinding{key}), inputTick_);
     }
 
     void InputManager::onButtonRelease(const SDL_Keycode key)
@@ -310,6 +369,14 @@ namespace psyengine::input
         auto& btn = gamepadButtons_[joystickId][gamepadButton];
         btn.isDown = true;
         btn.pressTime = now;
+
+        // Sequences bound to "any" gamepad see every pad, specific ones only their own
+        sequences_.onInput(encodeInput(GamepadBinding{.button = gamepadButton, .joystickId = 0}), inputTick_);
+        if (joystickId != 0)
+        {
+            sequences_.onInput(encodeInput(GamepadBinding{.button = gamepadButton, .joystickId = joystickId}),
+                               inputTick_);
+        }
     }
 
     void InputManager::onButtonRelease(const SDL_GamepadButton gamepadButton,
@@ -324,6 +391,7 @@ namespace psyengine::input
         auto& btn = mouseButtons_[mouseButton];
         btn.isDown = true;
         btn.pressTime = now;
+        sequences_.onInput(encodeInput(MouseBinding{mouseButton}), inputTick_);
     }
 
     void InputManager::onButtonRelease(const Uint8 mouseButton)
@@ -363,6 +431,49 @@ namespace psyengine::input
         return ButtonState::Up;
     }
 
+    SequenceRecognizer::InputCode InputManager::encodeInput(const Binding& binding) noexcept
+    {
+        // Device kind in the top bits, joystick id and button/key below, so codes never collide across devices
+        return std::visit([]<typename TBinding>(const TBinding& bind) -> SequenceRecognizer::InputCode
+        {
+            using T = std::decay_t<TBinding>;
+            if constexpr (std::is_same_v<T, KeyBinding>)
+            {
+                return (1ULL << 60) | static_cast<Uint64>(bind.key);
+            }
+            else if constexpr (std::is_same_v<T, MouseBinding>)
+            {
+                return (2ULL << 60) | static_cast<Uint64>(bind.button);
+            }
+            else
+            {
+                return (3ULL << 60) | (static_cast<Uint64>(bind.joystickId) << 16) |
+                    static_cast<Uint64>(static_cast<Uint16>(bind.button));
+            }
+        }, binding);
+    }
+
+    void InputManager::updateSequences()
+    {
+        for (const SequenceRecognizer::SequenceId id : triggeredSequences_)
+        {
+            sequenceTriggered_[id] = false;
+        }
+        triggeredSequences_.clear();
+
+        for (const SequenceRecognizer::SequenceId id : sequences_.completed())
+        {
+            if (!sequenceTriggered_[id])
+            {
+                sequenceTriggered_[id] = true;
+                triggeredSequences_.push_back(id);
+            }
+        }
+        sequences_.clearCompleted();
+
+        ++inputTick_;
+    }
+
     std::string InputManager::getKeyName(const SDL_Keycode key)
     {
         return SDL_GetKeyName(key);
@@ -378,7 +489,7 @@ namespace psyengine::input
         return {SDL_GetGamepadStringForAxis(axis)};
     }
 
-    void InputManager::updateGamepads(const time::TimePoint& now)
+    void InputManager::updateGamepads(const time::TimePoint& now, const bool commit)
     {
         // ReSharper disable once CppUseElementsView
         for (auto& [jid, buttonsMap] : gamepadButtons_)
@@ -386,6 +497,13 @@ namespace psyengine::input
             // ReSharper disable once CppUseElementsView
             for (auto& [btn, gamepadButton] : buttonsMap)
             {
+                // A late refresh only adds what newer events changed; edges update() reported stay for this frame
+                if (!commit && (gamepadButton.state == ButtonState::Clicked ||
+                    gamepadButton.state == ButtonState::Released))
+                {
+                    continue;
+                }
+
                 gamepadButton.state = ButtonState::Up;
 
                 if (gamepadButton.isDown)
@@ -415,16 +533,26 @@ namespace psyengine::input
                         }
                     }
                 }
-                gamepadButton.wasDown = gamepadButton.isDown;
+                if (commit)
+                {
+                    gamepadButton.wasDown = gamepadButton.isDown;
+                }
             }
         }
     }
 
-    void InputManager::updateMouseButtons(const time::TimePoint& now)
+    void InputManager::updateMouseButtons(const time::TimePoint& now, const bool commit)
     {
         // ReSharper disable once CppUseElementsView
         for (auto& [_, mouseButton] : mouseButtons_)
         {
+            // A late refresh only adds what newer events changed; edges update() reported stay for this frame
+            if (!commit && (mouseButton.state == ButtonState::Clicked ||
+                mouseButton.state == ButtonState::Released))
+            {
+                continue;
+            }
+
             mouseButton.state = ButtonState::Up;
 
             if (mouseButton.isDown)
@@ -454,15 +582,25 @@ namespace psyengine::input
                     }
                 }
             }
-            mouseButton.wasDown = mouseButton.isDown;
+            if (commit)
+            {
+                mouseButton.wasDown = mouseButton.isDown;
+            }
         }
     }
 
-    void InputManager::updateKeyboardButtons(const time::TimePoint& now)
+    void InputManager::updateKeyboardButtons(const time::TimePoint& now, const bool commit)
     {
         // ReSharper disable once CppUseElementsView
         for (auto& [_, keyboardButton] : keyboardButtons_)
         {
+            // A late refresh only adds what newer events changed; edges update() reported stay for this frame
+            if (!commit && (keyboardButton.state == ButtonState::Clicked ||
+                keyboardButton.state == ButtonState::Released))
+            {
+                continue;
+            }
+
             keyboardButton.state = ButtonState::Up;
 
             if (keyboardButton.isDown)
@@ -492,7 +630,10 @@ namespace psyengine::input
                     }
                 }
             }
-            keyboardButton.wasDown = keyboardButton.isDown;
+            if (commit)
+            {
+                keyboardButton.wasDown = keyboardButton.isDown;
+            }
         }
     }
 }
\ No newline at end of file
@@ -0,0 +1,150 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/input/input_sequence.hpp"
+
+#include <algorithm>
+
+#include "psyengine/debug/assert.hpp"
+
+namespace psyengine::input
+{
+    size_t SequenceRecognizer::EdgeKeyHash::operator()(const EdgeKey& key) const noexcept
+    {
+        Uint64 h = key.input ^ (static_cast<Uint64>(key.node) * 0x9E3779B97F4A7C15ULL);
+        h = (h ^ (h >> 31)) * 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 29;
+        return static_cast<size_t>(h);
+    }
+
+    SequenceRecognizer::SequenceId SequenceRecognizer::add(const std::span<const Step> steps)
+    {
+        PSY_ASSERT(!steps.empty(), "Input sequence has no steps");
+
+        Uint32 node = ROOT;
+        for (size_t i = 0; i < steps.size(); ++i)
+        {
+            // The first step starts a match at any time, so its window is meaningless
+            const Step step{.input = steps[i].input, .maxTicks = i == 0 ? 0 : steps[i].maxTicks};
+            node = findOrAddChild(node, step);
+        }
+
+        const SequenceId id = nextId_++;
+        nodes_[node].accepts.push_back(id);
+        return id;
+    }
+
+    void SequenceRecognizer::onInput(const InputCode input, const Uint64 tick)
+    {
+        reached_.clear();
+
+        // Every input may start a new match
+        if (const auto it = edges_.find(EdgeKey{.node = ROOT, .input = input}); it != std::end(edges_))
+        {
+            for (const Uint32 child : it->second)
+            {
+                reached_.push_back(Cursor{.node = child, .tick = tick});
+            }
+        }
+
+        // Advance live partial matches, compacting away the ones whose windows have all expired
+        size_t keep = 0;
+        for (size_t i = 0; i < live_.size(); ++i)
+        {
+            const Cursor cursor = live_[i];
+            const Uint64 elapsed = tick - cursor.tick;
+            if (elapsed > nodes_[cursor.node].maxChildTicks)
+            {
+                liveIndex_[cursor.node] = NOT_LIVE;
+                continue;
+            }
+
+            if (const auto it = edges_.find(EdgeKey{.node = cursor.node, .input = input}); it != std::end(edges_))
+            {
+                for (const Uint32 child : it->second)
+                {
+                    if (elapsed <= nodes_[child].maxTicks)
+                    {
+                        reached_.push_back(Cursor{.node = child, .tick = tick});
+                    }
+                }
+            }
+
+            live_[keep] = cursor;
+            liveIndex_[cursor.node] = static_cast<Uint32>(keep);
+            ++keep;
+        }
+        live_.resize(keep);
+
+        for (const auto& [node, reachedTick] : reached_)
+        {
+            reach(node, reachedTick);
+        }
+    }
+
+    void SequenceRecognizer::reset() noexcept
+    {
+        for (const auto& cursor : live_)
+        {
+            liveIndex_[cursor.node] = NOT_LIVE;
+        }
+        live_.clear();
+        reached_.clear();
+        completed_.clear();
+    }
+
+    void SequenceRecognizer::clear()
+    {
+        nodes_.assign(1, Node{});
+        edges_.clear();
+        live_.clear();
+        reached_.clear();
+        liveIndex_.assign(1, NOT_LIVE);
+        completed_.clear();
+        nextId_ = 0;
+    }
+
+    Uint32 SequenceRecognizer::findOrAddChild(const Uint32 parent, const Step& step)
+    {
+        auto& children = edges_[EdgeKey{.node = parent, .input = step.input}];
+        if (const auto it = std::ranges::find_if(children, [&](const Uint32 child)
+        {
+            return nodes_[child].maxTicks == step.maxTicks;
+        }); it != std::end(children))
+        {
+            return *it;
+        }
+
+        const auto child = static_cast<Uint32>(nodes_.size());
+        nodes_.push_back(Node{.maxTicks = step.maxTicks, .maxChildTicks = 0, .hasChildren = false, .accepts = {}});
+        liveIndex_.push_back(NOT_LIVE);
+        children.push_back(child);
+
+        Node& parentNode = nodes_[parent];
+        parentNode.hasChildren = true;
+        parentNode.maxChildTicks = std::max(parentNode.maxChildTicks, step.maxTicks);
+        return child;
+    }
+
+    void SequenceRecognizer::reach(const Uint32 node, const Uint64 tick)
+    {
+        const Node& target = nodes_[node];
+        completed_.insert(std::end(completed_), std::begin(target.accepts), std::end(target.accepts));
+
+        if (!target.hasChildren)
+        {
+            return;
+        }
+
+        // One cursor per node is enough: the most recent arrival always has the most window left
+        if (const Uint32 index = liveIndex_[node]; index != NOT_LIVE)
+        {
+            live_[index].tick = tick;
+            return;
+        }
+
+        liveIndex_[node] = static_cast<Uint32>(live_.size());
+        live_.push_back(Cursor{.node = node, .tick = tick});
+    }
+}
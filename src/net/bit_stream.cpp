@@ -0,0 +1,107 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/net/bit_stream.hpp"
+
+#include <algorithm>
+#include <bit>
+
+#include "psyengine/debug/assert.hpp"
+
+namespace psyengine::net
+{
+    namespace
+    {
+        constexpr unsigned LENGTH_BITS = 5;
+
+        constexpr Uint32 ZigZag(const Sint32 value) noexcept
+        {
+            return (static_cast<Uint32>(value) << 1) ^ static_cast<Uint32>(value >> 31);
+        }
+
+        constexpr Sint32 UnZigZag(const Uint32 value) noexcept
+        {
+            return static_cast<Sint32>((value >> 1) ^ (0U - (value & 1U)));
+        }
+    }
+
+    void BitWriter::write(Uint32 value, unsigned bitCount)
+    {
+        PSY_DEBUG_ASSERT(bitCount <= 32, "BitWriter writes at most 32 bits at a time");
+
+        bits_ += bitCount;
+        while (bitCount > 0)
+        {
+            if (used_ == 8)
+            {
+                out_.push_back(std::byte{0});
+                used_ = 0;
+            }
+
+            const unsigned take = std::min(bitCount, 8 - used_);
+            const auto chunk = static_cast<unsigned>(value & ((1U << take) - 1U));
+            out_.back() |= static_cast<std::byte>(chunk << used_);
+
+            used_ += take;
+            bitCount -= take;
+            value = take < 32 ? value >> take : 0;
+        }
+    }
+
+    void BitWriter::writeSigned(const Sint32 value)
+    {
+        writeVarBits(ZigZag(value));
+    }
+
+    void BitWriter::writeVarBits(const Uint32 value)
+    {
+        // Length 0 encodes 0; lengths 1..31 carry that many bits, 31 also stands in for 32
+        const auto length = std::min(static_cast<unsigned>(std::bit_width(value)), 31U);
+        write(length, LENGTH_BITS);
+        if (length == 31)
+        {
+            write(value, 32);
+        }
+        else
+        {
+            write(value, length);
+        }
+    }
+
+    Uint32 BitReader::read(const unsigned bitCount) noexcept
+    {
+        if (position_ + bitCount > in_.size() * 8)
+        {
+            ok_ = false;
+            position_ = in_.size() * 8;
+            return 0;
+        }
+
+        Uint32 value = 0;
+        unsigned written = 0;
+        while (written < bitCount)
+        {
+            const size_t byteIndex = position_ / 8;
+            const auto offset = static_cast<unsigned>(position_ % 8);
+            const unsigned take = std::min(bitCount - written, 8 - offset);
+            const auto chunk = (std::to_integer<Uint32>(in_[byteIndex]) >> offset) & ((1U << take) - 1U);
+            value |= chunk << written;
+
+            written += take;
+            position_ += take;
+        }
+        return value;
+    }
+
+    Sint32 BitReader::readSigned() noexcept
+    {
+        return UnZigZag(readVarBits());
+    }
+
+    Uint32 BitReader::readVarBits() noexcept
+    {
+        const Uint32 length = read(LENGTH_BITS);
+        return read(length == 31 ? 32 : length);
+    }
+}
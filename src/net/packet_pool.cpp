@@ -0,0 +1,43 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/net/packet_pool.hpp"
+
+#include "psyengine/debug/assert.hpp"
+
+namespace psyengine::net
+{
+    PacketPool::PacketPool(const size_t packetCount, const size_t packetSize) :
+        packetSize_(packetSize), storage_(packetCount * packetSize), inUse_(packetCount, false)
+    {
+        PSY_ASSERT(packetCount > 0 && packetSize > 0, "Packet pool needs at least one non-empty packet");
+
+        // Hand out low indices first so a lightly used pool stays in few cache lines
+        free_.reserve(packetCount);
+        for (size_t i = packetCount; i > 0; --i)
+        {
+            free_.push_back(static_cast<Index>(i - 1));
+        }
+    }
+
+    std::optional<PacketPool::Index> PacketPool::acquire()
+    {
+        if (free_.empty())
+        {
+            return std::nullopt;
+        }
+
+        const Index index = free_.back();
+        free_.pop_back();
+        inUse_[index] = true;
+        return index;
+    }
+
+    void PacketPool::release(const Index index)
+    {
+        PSY_DEBUG_ASSERT(index < inUse_.size() && inUse_[index], "Releasing a packet that is not in use");
+        inUse_[index] = false;
+        free_.push_back(index);
+    }
+}
@@ -0,0 +1,558 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/net/replication.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <ranges>
+#include <utility>
+
+#include "psyengine/debug/assert.hpp"
+#include "psyengine/net/bit_stream.hpp"
+
+namespace psyengine::net
+{
+    namespace
+    {
+        enum class EntryOp : Uint8
+        {
+            Removed = 0,
+            Full = 1,
+            Changed = 2,
+        };
+
+        constexpr unsigned OP_BITS = 2;
+
+        constexpr Uint32 MaxValue(const unsigned bits) noexcept
+        {
+            return bits >= 32 ? 0xFFFFFFFFU : (1U << bits) - 1U;
+        }
+
+        Uint32 Quantize(const float value, const float min, const float precision, const unsigned bits) noexcept
+        {
+            const double steps = std::round((static_cast<double>(value) - min) / precision);
+            return static_cast<Uint32>(std::clamp(steps, 0.0, static_cast<double>(MaxValue(bits))));
+        }
+
+        float Dequantize(const Uint32 value, const float min, const float precision) noexcept
+        {
+            return static_cast<float>(min + static_cast<double>(value) * precision);
+        }
+
+        size_t FieldCount(const ReplicationSchema& schema) noexcept
+        {
+            return std::min(schema.fieldBits.size(), MAX_REPLICATED_FIELDS);
+        }
+
+        void WriteFull(BitWriter& writer, const ReplicationSchema& schema, const detail::QuantizedEntity& entity)
+        {
+            writer.write(entity.x, schema.positionBits(0));
+            writer.write(entity.y, schema.positionBits(1));
+            for (size_t i = 0; i < FieldCount(schema); ++i)
+            {
+                writer.write(entity.fields[i], schema.fieldBits[i]);
+            }
+        }
+
+        /// @return false if nothing changed and the entity need not be written.
+        bool HasChanged(const detail::QuantizedEntity& current, const detail::QuantizedEntity& base) noexcept
+        {
+            return current.x != base.x || current.y != base.y || current.fields != base.fields;
+        }
+
+        void WriteChanged(BitWriter& writer,
+                          const ReplicationSchema& schema,
+                          const detail::QuantizedEntity& current,
+                          const detail::QuantizedEntity& base)
+        {
+            const bool moved = current.x != base.x || current.y != base.y;
+            writer.writeBool(moved);
+            if (moved)
+            {
+                // Wrapping differences round-trip through the client's wrapping addition
+                writer.writeSigned(static_cast<Sint32>(current.x - base.x));
+                writer.writeSigned(static_cast<Sint32>(current.y - base.y));
+            }
+
+            const bool fieldsChanged = current.fields != base.fields;
+            writer.writeBool(fieldsChanged);
+            if (!fieldsChanged)
+            {
+                return;
+            }
+            for (size_t i = 0; i < FieldCount(schema); ++i)
+            {
+                const bool changed = current.fields[i] != base.fields[i];
+                writer.writeBool(changed);
+                if (changed)
+                {
+                    writer.write(current.fields[i], schema.fieldBits[i]);
+                }
+            }
+        }
+
+        void ReadFull(BitReader& reader, const ReplicationSchema& schema, detail::QuantizedEntity& entity)
+        {
+            entity.x = reader.read(schema.positionBits(0));
+            entity.y = reader.read(schema.positionBits(1));
+            entity.fields = {};
+            for (size_t i = 0; i < FieldCount(schema); ++i)
+            {
+                entity.fields[i] = reader.read(schema.fieldBits[i]);
+            }
+        }
+
+        void ReadChanged(BitReader& reader, const ReplicationSchema& schema, detail::QuantizedEntity& entity)
+        {
+            if (reader.readBool())
+            {
+                entity.x += static_cast<Uint32>(reader.readSigned());
+                entity.y += static_cast<Uint32>(reader.readSigned());
+            }
+
+            if (!reader.readBool())
+            {
+                return;
+            }
+            for (size_t i = 0; i < FieldCount(schema); ++i)
+            {
+                if (reader.readBool())
+                {
+                    entity.fields[i] = reader.read(schema.fieldBits[i]);
+                }
+            }
+        }
+
+        void WriteEntry(BitWriter& writer, EntityId& previousId, const EntityId id, const EntryOp op)
+        {
+            writer.writeBool(true);
+            writer.writeVarBits(id - previousId);
+            writer.write(static_cast<Uint32>(op), OP_BITS);
+            previousId = id;
+        }
+    }
+
+    unsigned ReplicationSchema::positionBits(const int axis) const noexcept
+    {
+        const float range = axis == 0 ? worldMax.x - worldMin.x : worldMax.y - worldMin.y;
+        const double steps = std::ceil(static_cast<double>(range) / precision);
+        if (!(steps >= 1.0))
+        {
+            return 1;
+        }
+        if (steps >= static_cast<double>(MaxValue(32)))
+        {
+            return 32;
+        }
+        return static_cast<unsigned>(std::bit_width(static_cast<Uint32>(steps)));
+    }
+
+    namespace detail
+    {
+        SnapshotHistory::SnapshotHistory(const size_t size) :
+            ring_(std::max<size_t>(size, 1)), valid_(ring_.size(), false) {}
+
+        Snapshot& SnapshotHistory::store(const Uint32 tick)
+        {
+            const size_t slot = tick % ring_.size();
+            valid_[slot] = true;
+            ring_[slot].tick = tick;
+            ring_[slot].entities.clear();
+            return ring_[slot];
+        }
+
+        const Snapshot* SnapshotHistory::find(const Uint32 tick) const noexcept
+        {
+            const size_t slot = tick % ring_.size();
+            return valid_[slot] && ring_[slot].tick == tick ? &ring_[slot] : nullptr;
+        }
+
+        void SnapshotHistory::clear() noexcept
+        {
+            std::fill(valid_.begin(), valid_.end(), false);
+        }
+    }
+
+    ReplicationServer::ReplicationServer(ReplicationSchema schema, const float gridCellSize, const size_t historySize) :
+        schema_(std::move(schema)), cellSize_(gridCellSize), historySize_(historySize)
+    {
+        PSY_ASSERT(schema_.precision > 0.0F, "Replication precision must be positive");
+        PSY_ASSERT(cellSize_ > 0.0F, "Replication grid cell size must be positive");
+        PSY_ASSERT(schema_.fieldBits.size() <= MAX_REPLICATED_FIELDS, "Too many replicated fields");
+    }
+
+    void ReplicationServer::setEntity(const EntityState& state)
+    {
+        if (const auto it = entityIndex_.find(state.id); it != entityIndex_.end())
+        {
+            entities_[it->second] = state;
+            return;
+        }
+
+        entityIndex_.emplace(state.id, entities_.size());
+        entities_.push_back(state);
+    }
+
+    bool ReplicationServer::removeEntity(const EntityId id)
+    {
+        const auto it = entityIndex_.find(id);
+        if (it == entityIndex_.end())
+        {
+            return false;
+        }
+
+        // Swap with the last entity to keep the table dense
+        const size_t index = it->second;
+        entityIndex_.erase(it);
+        if (index != entities_.size() - 1)
+        {
+            entities_[index] = entities_.back();
+            entityIndex_[entities_[index].id] = index;
+        }
+        entities_.pop_back();
+        return true;
+    }
+
+    ClientId ReplicationServer::addClient()
+    {
+        const ClientId id = nextClient_++;
+        clients_.emplace(id, Client(historySize_));
+        return id;
+    }
+
+    bool ReplicationServer::removeClient(const ClientId client)
+    {
+        return clients_.erase(client) > 0;
+    }
+
+    void ReplicationServer::setClientView(const ClientId client, const math::Vector2F center, const float radius)
+    {
+        if (const auto it = clients_.find(client); it != clients_.end())
+        {
+            it->second.center = center;
+            it->second.radius = radius;
+        }
+    }
+
+    void ReplicationServer::acknowledge(const ClientId client, const Uint32 tick)
+    {
+        const auto it = clients_.find(client);
+        if (it == clients_.end())
+        {
+            return;
+        }
+
+        // Acks can arrive out of order; only move forward
+        auto& acked = it->second.acked;
+        if (!acked || static_cast<Sint32>(tick - *acked) > 0)
+        {
+            acked = tick;
+        }
+    }
+
+    void ReplicationServer::update(const Uint32 tick)
+    {
+        tick_ = tick;
+
+        const unsigned xBits = schema_.positionBits(0);
+        const unsigned yBits = schema_.positionBits(1);
+        const size_t fieldCount = FieldCount(schema_);
+
+        for (auto& cell : grid_ | std::views::values)
+        {
+            cell.clear();
+        }
+
+        quantized_.resize(entities_.size());
+        for (size_t i = 0; i < entities_.size(); ++i)
+        {
+            const EntityState& state = entities_[i];
+            auto& [id, x, y, fields] = quantized_[i];
+            id = state.id;
+            x = Quantize(state.position.x, schema_.worldMin.x, schema_.precision, xBits);
+            y = Quantize(state.position.y, schema_.worldMin.y, schema_.precision, yBits);
+            fields = {};
+            for (size_t f = 0; f < fieldCount; ++f)
+            {
+                fields[f] = state.fields[f] & MaxValue(schema_.fieldBits[f]);
+            }
+
+            const auto cx = static_cast<Sint32>(std::floor(state.position.x / cellSize_));
+            const auto cy = static_cast<Sint32>(std::floor(state.position.y / cellSize_));
+            grid_[cellKey(cx, cy)].push_back(static_cast<Uint32>(i));
+        }
+
+        for (auto& client : clients_ | std::views::values)
+        {
+            client.lastBytes = 0;
+            client.lastEntities = 0;
+            client.lastFull = false;
+        }
+    }
+
+    Sint64 ReplicationServer::cellKey(const Sint32 cx, const Sint32 cy) const noexcept
+    {
+        return static_cast<Sint64>((static_cast<Uint64>(static_cast<Uint32>(cx)) << 32) | static_cast<Uint32>(cy));
+    }
+
+    void ReplicationServer::gatherVisible(const Client& client, std::vector<Uint32>& indices) const
+    {
+        indices.clear();
+        if (client.radius <= 0.0F)
+        {
+            indices.resize(quantized_.size());
+            for (size_t i = 0; i < indices.size(); ++i)
+            {
+                indices[i] = static_cast<Uint32>(i);
+            }
+            return;
+        }
+
+        const auto minX = static_cast<Sint32>(std::floor((client.center.x - client.radius) / cellSize_));
+        const auto maxX = static_cast<Sint32>(std::floor((client.center.x + client.radius) / cellSize_));
+        const auto minY = static_cast<Sint32>(std::floor((client.center.y - client.radius) / cellSize_));
+        const auto maxY = static_cast<Sint32>(std::floor((client.center.y + client.radius) / cellSize_));
+        const float radiusSquared = client.radius * client.radius;
+
+        for (Sint32 cy = minY; cy <= maxY; ++cy)
+        {
+            for (Sint32 cx = minX; cx <= maxX; ++cx)
+            {
+                const auto it = grid_.find(cellKey(cx, cy));
+                if (it == grid_.end())
+                {
+                    continue;
+                }
+                for (const Uint32 index : it->second)
+                {
+                    const float dx = entities_[index].position.x - client.center.x;
+                    const float dy = entities_[index].position.y - client.center.y;
+                    if (dx * dx + dy * dy <= radiusSquared)
+                    {
+                        indices.push_back(index);
+                    }
+                }
+            }
+        }
+    }
+
+    size_t ReplicationServer::writeSnapshot(const ClientId client, std::vector<std::byte>& out)
+    {
+        const auto it = clients_.find(client);
+        if (it == clients_.end())
+        {
+            return 0;
+        }
+        Client& state = it->second;
+
+        thread_local std::vector<Uint32> visible;
+        thread_local detail::Snapshot current;
+        gatherVisible(state, visible);
+
+        current.tick = tick_;
+        current.entities.clear();
+        current.entities.reserve(visible.size());
+        for (const Uint32 index : visible)
+        {
+            current.entities.push_back(quantized_[index]);
+        }
+        std::ranges::sort(current.entities, {}, &detail::QuantizedEntity::id);
+
+        const detail::Snapshot* baseline = state.acked ? state.history.find(*state.acked) : nullptr;
+        if (baseline && baseline->tick == tick_)
+        {
+            baseline = nullptr;
+        }
+
+        const size_t start = out.size();
+        BitWriter writer(out);
+        writer.write(tick_, 32);
+        writer.writeBool(baseline != nullptr);
+        if (baseline)
+        {
+            writer.writeVarBits(tick_ - baseline->tick);
+        }
+
+        EntityId previousId = 0;
+        const std::vector<detail::QuantizedEntity> none;
+        const auto& base = baseline ? baseline->entities : none;
+        auto b = base.begin();
+        auto c = current.entities.begin();
+        while (b != base.end() || c != current.entities.end())
+        {
+            if (c == current.entities.end() || (b != base.end() && b->id < c->id))
+            {
+                WriteEntry(writer, previousId, b->id, EntryOp::Removed);
+                ++b;
+            }
+            else if (b == base.end() || c->id < b->id)
+            {
+                WriteEntry(writer, previousId, c->id, EntryOp::Full);
+                WriteFull(writer, schema_, *c);
+                ++c;
+            }
+            else
+            {
+                if (HasChanged(*c, *b))
+                {
+                    WriteEntry(writer, previousId, c->id, EntryOp::Changed);
+                    WriteChanged(writer, schema_, *c, *b);
+                }
+                ++b;
+                ++c;
+            }
+        }
+        writer.writeBool(false);
+
+        // Stored after encoding; the new slot may be the one the baseline lives in
+        state.history.store(tick_).entities = current.entities;
+
+        state.lastBytes = out.size() - start;
+        state.lastEntities = current.entities.size();
+        state.lastFull = baseline == nullptr;
+        return state.lastBytes;
+    }
+
+    void ReplicationServer::endTick()
+    {
+        size_t bytes = 0;
+        size_t entities = 0;
+        size_t written = 0;
+        for (const auto& client : clients_ | std::views::values)
+        {
+            if (client.lastBytes == 0)
+            {
+                continue;
+            }
+            bytes += client.lastBytes;
+            entities += client.lastEntities;
+            ++written;
+            if (client.lastFull)
+            {
+                ++stats_.fullSnapshots;
+            }
+        }
+
+        ++stats_.ticks;
+        stats_.clients = clients_.size();
+        stats_.lastTickBytes = bytes;
+        stats_.lastTickBytesPerClient = written > 0 ? static_cast<double>(bytes) / static_cast<double>(written) : 0.0;
+        stats_.lastTickEntitiesPerClient =
+            written > 0 ? static_cast<double>(entities) / static_cast<double>(written) : 0.0;
+
+        totalBytes_ += bytes;
+        totalClientTicks_ += written;
+        stats_.meanBytesPerClientPerTick = totalClientTicks_ > 0
+            ? static_cast<double>(totalBytes_) / static_cast<double>(totalClientTicks_)
+            : 0.0;
+    }
+
+    ReplicationClient::ReplicationClient(ReplicationSchema schema, const size_t historySize) :
+        schema_(std::move(schema)), history_(historySize) {}
+
+    bool ReplicationClient::readSnapshot(const std::span<const std::byte> data)
+    {
+        BitReader reader(data);
+        const Uint32 tick = reader.read(32);
+
+        const detail::Snapshot* baseline = nullptr;
+        if (reader.readBool())
+        {
+            baseline = history_.find(tick - reader.readVarBits());
+            if (!baseline)
+            {
+                return false;
+            }
+        }
+        if (!reader.ok())
+        {
+            return false;
+        }
+
+        thread_local detail::Snapshot decoded;
+        decoded.tick = tick;
+        decoded.entities.clear();
+
+        const std::vector<detail::QuantizedEntity> none;
+        const auto& base = baseline ? baseline->entities : none;
+        auto b = base.begin();
+        EntityId id = 0;
+
+        while (reader.readBool())
+        {
+            id += reader.readVarBits();
+            const auto op = static_cast<EntryOp>(reader.read(OP_BITS));
+            if (!reader.ok())
+            {
+                return false;
+            }
+
+            // Entities the server skipped are unchanged from the baseline
+            while (b != base.end() && b->id < id)
+            {
+                decoded.entities.push_back(*b++);
+            }
+
+            const bool inBaseline = b != base.end() && b->id == id;
+            switch (op)
+            {
+            case EntryOp::Removed:
+                if (!inBaseline)
+                {
+                    return false;
+                }
+                ++b;
+                break;
+            case EntryOp::Full:
+            {
+                auto& entity = decoded.entities.emplace_back();
+                entity.id = id;
+                ReadFull(reader, schema_, entity);
+                if (inBaseline)
+                {
+                    ++b;
+                }
+                break;
+            }
+            case EntryOp::Changed:
+                if (!inBaseline)
+                {
+                    return false;
+                }
+                decoded.entities.push_back(*b++);
+                ReadChanged(reader, schema_, decoded.entities.back());
+                break;
+            default:
+                return false;
+            }
+        }
+        if (!reader.ok())
+        {
+            return false;
+        }
+        decoded.entities.insert(decoded.entities.end(), b, base.end());
+
+        // Only newer snapshots replace the visible entity set; older ones may still serve as baselines
+        const bool newest = !latest_ || static_cast<Sint32>(tick - *latest_) > 0;
+        history_.store(tick).entities = decoded.entities;
+        if (!newest)
+        {
+            return true;
+        }
+        latest_ = tick;
+
+        entities_.resize(decoded.entities.size());
+        for (size_t i = 0; i < decoded.entities.size(); ++i)
+        {
+            const auto& [entityId, x, y, fields] = decoded.entities[i];
+            entities_[i].id = entityId;
+            entities_[i].position = math::Vector2F(Dequantize(x, schema_.worldMin.x, schema_.precision),
+                                                   Dequantize(y, schema_.worldMin.y, schema_.precision));
+            entities_[i].fields = fields;
+        }
+        return true;
+    }
+}
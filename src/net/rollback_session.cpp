@@ -0,0 +1,415 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/net/rollback_session.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include <SDL3/SDL_log.h>
+
+#include "psyengine/debug/assert.hpp"
+#include "psyengine/input/input_manager.hpp"
+#include "psyengine/utils/random_utils.hpp"
+
+namespace psyengine::net
+{
+    namespace
+    {
+        // Packet: magic u16, kind u8, player u8, ack u32, first u32, count u8, then count LEB128 inputs where
+        // every input after the first is XORed with its predecessor. Little-endian.
+        constexpr Uint16 PACKET_MAGIC = 0x5052;
+        constexpr Uint8 PACKET_INPUT = 1;
+        constexpr size_t HEADER_SIZE = 2 + 1 + 1 + 4 + 4 + 1;
+        constexpr size_t MAX_PACKET_SIZE = 1200;
+
+        class Writer
+        {
+        public:
+            explicit Writer(std::vector<std::byte>& out) :
+                out_(out) {}
+
+            template <typename T>
+            void fixed(T value)
+            {
+                for (size_t i = 0; i < sizeof(T); ++i)
+                {
+                    out_.push_back(static_cast<std::byte>(value & 0xFFU));
+                    value = static_cast<T>(value >> 8);
+                }
+            }
+
+            void varint(Uint32 value)
+            {
+                while (value >= 0x80U)
+                {
+                    out_.push_back(static_cast<std::byte>((value & 0x7FU) | 0x80U));
+                    value >>= 7;
+                }
+                out_.push_back(static_cast<std::byte>(value));
+            }
+
+        private:
+            std::vector<std::byte>& out_;
+        };
+
+        class Reader
+        {
+        public:
+            explicit Reader(const std::span<const std::byte> in) :
+                in_(in) {}
+
+            template <typename T>
+            bool fixed(T& value)
+            {
+                if (in_.size() - pos_ < sizeof(T))
+                {
+                    return false;
+                }
+                value = 0;
+                for (size_t i = 0; i < sizeof(T); ++i)
+                {
+                    value = static_cast<T>(value | static_cast<T>(std::to_integer<T>(in_[pos_++]) << (8 * i)));
+                }
+                return true;
+            }
+
+            bool varint(Uint32& value)
+            {
+                value = 0;
+                for (unsigned shift = 0; shift < 35; shift += 7)
+                {
+                    if (pos_ >= in_.size())
+                    {
+                        return false;
+                    }
+                    const auto byte = std::to_integer<Uint32>(in_[pos_++]);
+                    value |= (byte & 0x7FU) << shift;
+                    if ((byte & 0x80U) == 0)
+                    {
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+        private:
+            std::span<const std::byte> in_;
+            size_t pos_ = 0;
+        };
+    }
+
+    RollbackSession::RollbackSession(const RollbackSettings& settings) :
+        settings_(settings), rng_(utils::MakeMersenne32())
+    {
+        PSY_ASSERT(settings_.localPlayer < settings_.playerCount, "Local player index out of range");
+        PSY_ASSERT(settings_.historySize > settings_.inputDelay + settings_.maxPredictionTicks,
+                   "Rollback history must exceed input delay plus prediction");
+
+        settings_.maxInputsPerPacket = std::clamp<size_t>(settings_.maxInputsPerPacket, 1, 255);
+        players_.resize(settings_.playerCount);
+        for (auto& player : players_)
+        {
+            player.slots.resize(settings_.historySize);
+        }
+    }
+
+    bool RollbackSession::open(const Uint16 port, const bool loopbackOnly)
+    {
+        return socket_.open(port, loopbackOnly);
+    }
+
+    void RollbackSession::addPeer(const size_t player, const Endpoint& endpoint)
+    {
+        PSY_ASSERT(player < settings_.playerCount && player != settings_.localPlayer, "Invalid remote player");
+        peers_.push_back({.player = player, .endpoint = endpoint, .acked = 0});
+    }
+
+    void RollbackSession::setRollbackHandler(RollbackHandler handler)
+    {
+        rollbackHandler_ = std::move(handler);
+    }
+
+    void RollbackSession::setNetworkConditions(const NetworkConditions& conditions)
+    {
+        conditions_ = conditions;
+    }
+
+    void RollbackSession::poll(const Uint64 simulatedTick)
+    {
+        std::optional<Uint64> firstMiss;
+        receive(firstMiss);
+        sendInputs();
+        flushDelayed();
+
+        if (!firstMiss || *firstMiss > simulatedTick)
+        {
+            return;
+        }
+
+        // Restore the end of the last correctly predicted tick and replay from the miss
+        const Uint64 target = *firstMiss - 1;
+        ++stats_.rollbacks;
+        stats_.maxRollbackTicks = std::max(stats_.maxRollbackTicks, simulatedTick - target);
+
+        if (!rollbackHandler_ || !rollbackHandler_(target))
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Rollback to tick %llu failed; peers will desync",
+                         static_cast<unsigned long long>(target));
+        }
+    }
+
+    bool RollbackSession::canAdvance(const Uint64 tick)
+    {
+        for (size_t p = 0; p < players_.size(); ++p)
+        {
+            if (p == settings_.localPlayer)
+            {
+                continue;
+            }
+
+            const Uint64 confirmed = players_[p].confirmedUpTo;
+            if (tick > confirmed + settings_.maxPredictionTicks || tick >= confirmed + settings_.historySize)
+            {
+                ++stats_.stalls;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void RollbackSession::addLocalInput(const Uint64 tick, const InputBits bits)
+    {
+        const Uint64 target = tick + settings_.inputDelay;
+        if (target <= localNewest_)
+        {
+            return;
+        }
+
+        // Ticks skipped since the last call, including the delay at the start, repeat the previous input
+        Player& local = players_[settings_.localPlayer];
+        for (Uint64 t = localNewest_ + 1; t <= target; ++t)
+        {
+            Slot& s = slot(settings_.localPlayer, t);
+            s.bits = t == target ? bits : local.lastConfirmed;
+            s.confirmed = true;
+            s.predicted = false;
+        }
+
+        local.confirmedUpTo = target;
+        local.lastConfirmed = bits;
+        localNewest_ = target;
+    }
+
+    InputBits RollbackSession::input(const Uint64 tick, const size_t player)
+    {
+        PSY_DEBUG_ASSERT(player < players_.size(), "Player index out of range");
+
+        Slot& s = slot(player, tick);
+        if (!s.confirmed)
+        {
+            s.bits = players_[player].lastConfirmed;
+            s.predicted = true;
+        }
+        return s.bits;
+    }
+
+    bool RollbackSession::isConfirmed(const Uint64 tick, const size_t player) const
+    {
+        const Slot* s = findSlot(player, tick);
+        return s != nullptr && s->confirmed;
+    }
+
+    Uint64 RollbackSession::confirmedTick() const noexcept
+    {
+        Uint64 confirmed = NO_TICK;
+        for (const auto& player : players_)
+        {
+            confirmed = std::min(confirmed, player.confirmedUpTo);
+        }
+        return confirmed;
+    }
+
+    InputBits RollbackSession::SampleActions(const input::InputManager& input, const std::span<const std::string> actions)
+    {
+        PSY_DEBUG_ASSERT(actions.size() <= 32, "At most 32 actions fit in InputBits");
+
+        InputBits bits = 0;
+        const size_t count = std::min<size_t>(actions.size(), 32);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (input.isActionDown(actions[i]))
+            {
+                bits |= InputBits{1} << i;
+            }
+        }
+        return bits;
+    }
+
+    RollbackSession::Slot& RollbackSession::slot(const size_t player, const Uint64 tick)
+    {
+        Slot& s = players_[player].slots[tick % settings_.historySize];
+        if (s.tick != tick)
+        {
+            s = Slot{.tick = tick, .bits = 0, .confirmed = false, .predicted = false};
+        }
+        return s;
+    }
+
+    const RollbackSession::Slot* RollbackSession::findSlot(const size_t player, const Uint64 tick) const
+    {
+        const Slot& s = players_[player].slots[tick % settings_.historySize];
+        return s.tick == tick ? &s : nullptr;
+    }
+
+    void RollbackSession::confirm(const size_t player, const Uint64 tick, const InputBits bits,
+                                  std::optional<Uint64>& firstMiss)
+    {
+        Player& p = players_[player];
+        if (tick <= p.confirmedUpTo || tick >= p.confirmedUpTo + settings_.historySize)
+        {
+            return;
+        }
+
+        Slot& s = slot(player, tick);
+        if (s.confirmed)
+        {
+            return;
+        }
+
+        if (s.predicted && s.bits != bits)
+        {
+            ++stats_.predictionMisses;
+            firstMiss = firstMiss ? std::min(*firstMiss, tick) : tick;
+        }
+        s.bits = bits;
+        s.confirmed = true;
+        s.predicted = false;
+
+        while (const Slot* next = findSlot(player, p.confirmedUpTo + 1))
+        {
+            if (!next->confirmed)
+            {
+                break;
+            }
+            ++p.confirmedUpTo;
+            p.lastConfirmed = next->bits;
+        }
+    }
+
+    void RollbackSession::sendInputs()
+    {
+        const Player& local = players_[settings_.localPlayer];
+        for (const auto& peer : peers_)
+        {
+            // Everything the peer has not acknowledged yet, oldest first so gaps always close
+            const Uint64 first = peer.acked + 1;
+            const size_t count = localNewest_ >= first
+                                     ? static_cast<size_t>(std::min<Uint64>(localNewest_ - first + 1,
+                                                                            settings_.maxInputsPerPacket))
+                                     : 0;
+
+            std::vector<std::byte> packet;
+            packet.reserve(HEADER_SIZE + count * 2);
+            Writer writer(packet);
+            writer.fixed(PACKET_MAGIC);
+            writer.fixed(PACKET_INPUT);
+            writer.fixed(static_cast<Uint8>(settings_.localPlayer));
+            writer.fixed(static_cast<Uint32>(players_[peer.player].confirmedUpTo));
+            writer.fixed(static_cast<Uint32>(first));
+            writer.fixed(static_cast<Uint8>(count));
+
+            InputBits previous = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Slot* s = findSlot(settings_.localPlayer, first + i);
+                const InputBits bits = s != nullptr ? s->bits : local.lastConfirmed;
+                writer.varint(i == 0 ? bits : bits ^ previous);
+                previous = bits;
+            }
+
+            send(peer.endpoint, std::move(packet));
+        }
+    }
+
+    void RollbackSession::send(const Endpoint& to, std::vector<std::byte> data)
+    {
+        if (conditions_.lossRate > 0.0 && utils::RandomBool(rng_, std::min(conditions_.lossRate, 1.0)))
+        {
+            ++stats_.packetsDropped;
+            return;
+        }
+
+        double delay = conditions_.latency;
+        if (conditions_.jitter > 0.0)
+        {
+            delay += utils::RandomFloat<double>(rng_, 0.0, conditions_.jitter);
+        }
+
+        delayed_.push_back({.release = time::Now() + time::SecondsToTicks(delay), .to = to, .data = std::move(data)});
+    }
+
+    void RollbackSession::flushDelayed()
+    {
+        const time::TimePoint now = time::Now();
+        std::erase_if(delayed_, [this, now](const DelayedPacket& packet)
+        {
+            if (packet.release > now)
+            {
+                return false;
+            }
+
+            if (socket_.sendTo(packet.to, packet.data))
+            {
+                ++stats_.packetsSent;
+                stats_.bytesSent += packet.data.size();
+            }
+            return true;
+        });
+    }
+
+    void RollbackSession::receive(std::optional<Uint64>& firstMiss)
+    {
+        std::array<std::byte, MAX_PACKET_SIZE> buffer{};
+        Endpoint from;
+        while (const auto size = socket_.receiveFrom(from, buffer))
+        {
+            Reader reader(std::span(buffer.data(), *size));
+            Uint16 magic = 0;
+            Uint8 kind = 0;
+            Uint8 player = 0;
+            Uint32 ack = 0;
+            Uint32 first = 0;
+            Uint8 count = 0;
+            if (!reader.fixed(magic) || magic != PACKET_MAGIC || !reader.fixed(kind) || kind != PACKET_INPUT ||
+                !reader.fixed(player) || !reader.fixed(ack) || !reader.fixed(first) || !reader.fixed(count))
+            {
+                continue;
+            }
+
+            const auto peer = std::ranges::find(peers_, static_cast<size_t>(player), &Peer::player);
+            if (peer == peers_.end() || peer->endpoint != from)
+            {
+                continue;
+            }
+
+            ++stats_.packetsReceived;
+            peer->acked = std::max<Uint64>(peer->acked, ack);
+
+            InputBits bits = 0;
+            for (Uint8 i = 0; i < count; ++i)
+            {
+                Uint32 value = 0;
+                if (!reader.varint(value))
+                {
+                    break;
+                }
+                bits = i == 0 ? value : bits ^ value;
+                confirm(player, Uint64{first} + i, bits, firstMiss);
+            }
+        }
+    }
+}
@@ -0,0 +1,628 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/net/transport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+
+#include <SDL3/SDL_log.h>
+
+#include "psyengine/debug/assert.hpp"
+
+namespace psyengine::net
+{
+    namespace
+    {
+        constexpr Uint16 MAGIC = 0x5054;
+
+        constexpr unsigned FLAG_RELIABLE = 1U << 0U;
+        constexpr unsigned FLAG_ACK_ONLY = 1U << 1U;
+
+        // magic u16, sequence u16, ack u16, ack bits u32, flags u8, reliable id u16; all little-endian
+        constexpr size_t HEADER_SIZE = 13;
+
+        /// Weight of a new sample in the smoothed round-trip time.
+        constexpr double RTT_SMOOTHING = 0.125;
+
+        void Put16(std::byte* out, const Uint16 value) noexcept
+        {
+            out[0] = static_cast<std::byte>(value & 0xFFU);
+            out[1] = static_cast<std::byte>(value >> 8U);
+        }
+
+        void Put32(std::byte* out, const Uint32 value) noexcept
+        {
+            Put16(out, static_cast<Uint16>(value & 0xFFFFU));
+            Put16(out + 2, static_cast<Uint16>(value >> 16U));
+        }
+
+        Uint16 Get16(const std::byte* in) noexcept
+        {
+            return static_cast<Uint16>(std::to_integer<Uint16>(in[0]) | (std::to_integer<Uint16>(in[1]) << 8U));
+        }
+
+        Uint32 Get32(const std::byte* in) noexcept
+        {
+            return static_cast<Uint32>(Get16(in)) | (static_cast<Uint32>(Get16(in + 2)) << 16U);
+        }
+
+        /// @return true if a is newer than b, allowing for wrap-around.
+        constexpr bool SequenceGreater(const Uint16 a, const Uint16 b) noexcept
+        {
+            return a != b && static_cast<Uint16>(a - b) < 0x8000U;
+        }
+    }
+
+    Transport::Transport(const TransportSettings& settings) :
+        settings_(settings), pool_(settings.packetCount, settings.packetSize)
+    {
+        PSY_ASSERT(settings_.packetSize > HEADER_SIZE, "Transport packet size must exceed the header size");
+        PSY_ASSERT(settings_.batchSize > 0, "Transport batch size must be positive");
+
+        queue_.reserve(settings_.packetCount);
+        datagrams_.reserve(std::max(settings_.packetCount, settings_.batchSize));
+        receiveBuffers_.reserve(settings_.batchSize);
+    }
+
+    Transport::~Transport()
+    {
+        close();
+    }
+
+    bool Transport::open(const Uint16 port, const bool loopbackOnly)
+    {
+        close();
+        stats_ = TransportStats{};
+        return socket_.open(port, loopbackOnly);
+    }
+
+    void Transport::close()
+    {
+        // Queued unreliable packets own their buffers; reliable ones are released with their peer below
+        for (const Outgoing& outgoing : queue_)
+        {
+            if (outgoing.channel == Channel::Unreliable)
+            {
+                pool_.release(outgoing.packet);
+            }
+        }
+        queue_.clear();
+
+        for (Peer& peer : peers_)
+        {
+            releasePeer(peer);
+        }
+        peers_.clear();
+        peersByEndpoint_.clear();
+        socket_.close();
+    }
+
+    Uint64 Transport::EndpointKey(const Endpoint& endpoint) noexcept
+    {
+        return (static_cast<Uint64>(endpoint.address) << 16U) | endpoint.port;
+    }
+
+    PeerId Transport::addPeer(const Endpoint& endpoint)
+    {
+        if (const auto it = peersByEndpoint_.find(EndpointKey(endpoint)); it != peersByEndpoint_.end())
+        {
+            return it->second;
+        }
+
+        // Reuse a removed slot before growing
+        auto slot = std::ranges::find_if(peers_, [](const Peer& peer) { return !peer.active; });
+        if (slot == peers_.end())
+        {
+            slot = peers_.emplace(peers_.end());
+        }
+        *slot = Peer{};
+        slot->active = true;
+        slot->endpoint = endpoint;
+
+        const auto id = static_cast<PeerId>(slot - peers_.begin());
+        peersByEndpoint_.emplace(EndpointKey(endpoint), id);
+        return id;
+    }
+
+    void Transport::removePeer(const PeerId peer)
+    {
+        Peer* state = findPeer(peer);
+        if (state == nullptr)
+        {
+            return;
+        }
+
+        // Queued unreliable packets own their buffers; reliable ones are released with the peer below
+        std::erase_if(queue_, [&](const Outgoing& outgoing)
+        {
+            if (outgoing.peer != peer)
+            {
+                return false;
+            }
+            if (outgoing.channel == Channel::Unreliable)
+            {
+                pool_.release(outgoing.packet);
+            }
+            return true;
+        });
+
+        peersByEndpoint_.erase(EndpointKey(state->endpoint));
+        releasePeer(*state);
+        state->active = false;
+    }
+
+    void Transport::releasePeer(Peer& peer)
+    {
+        for (const ReliableMessage& message : peer.pendingReliable)
+        {
+            pool_.release(message.packet);
+        }
+        peer.pendingReliable.clear();
+        peer.outOfOrder.clear();
+    }
+
+    Transport::Peer* Transport::findPeer(const PeerId peer) noexcept
+    {
+        return peer < peers_.size() && peers_[peer].active ? &peers_[peer] : nullptr;
+    }
+
+    const Transport::Peer* Transport::findPeer(const PeerId peer) const noexcept
+    {
+        return peer < peers_.size() && peers_[peer].active ? &peers_[peer] : nullptr;
+    }
+
+    std::optional<Endpoint> Transport::peerEndpoint(const PeerId peer) const
+    {
+        const Peer* state = findPeer(peer);
+        return state != nullptr ? std::optional(state->endpoint) : std::nullopt;
+    }
+
+    double Transport::roundTripTime(const PeerId peer) const
+    {
+        const Peer* state = findPeer(peer);
+        return state != nullptr ? state->roundTripTime : 0.0;
+    }
+
+    void Transport::setMessageHandler(MessageHandler handler)
+    {
+        handler_ = std::move(handler);
+    }
+
+    bool Transport::send(const PeerId peer, const Channel channel, const std::span<const std::byte> message)
+    {
+        Peer* state = findPeer(peer);
+        if (state == nullptr)
+        {
+            return false;
+        }
+
+        if (message.size() > settings_.packetSize - HEADER_SIZE)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Transport message of %zu bytes exceeds the packet size",
+                         message.size());
+            return false;
+        }
+
+        if (channel == Channel::Reliable && state->pendingReliable.size() >= settings_.maxPendingReliable)
+        {
+            return false;
+        }
+
+        const auto packet = pool_.acquire();
+        if (!packet)
+        {
+            ++stats_.poolExhausted;
+            return false;
+        }
+
+        const std::span<std::byte> buffer = pool_.buffer(*packet);
+        std::ranges::copy(message, buffer.begin() + HEADER_SIZE);
+        const size_t size = HEADER_SIZE + message.size();
+
+        Uint16 reliableId = 0;
+        if (channel == Channel::Reliable)
+        {
+            reliableId = state->nextReliableId++;
+            state->pendingReliable.push_back({.id = reliableId, .packet = *packet, .size = size, .queued = true});
+        }
+
+        queue_.push_back({
+            .peer = peer, .packet = *packet, .size = size, .channel = channel, .reliableId = reliableId,
+            .ackOnly = false
+        });
+        return true;
+    }
+
+    size_t Transport::receive()
+    {
+        if (!socket_.isOpen() || receiving_)
+        {
+            return 0;
+        }
+
+        // Borrow a batch of buffers from the pool for the duration of the call
+        receiveBuffers_.clear();
+        datagrams_.clear();
+        while (receiveBuffers_.size() < settings_.batchSize)
+        {
+            const auto packet = pool_.acquire();
+            if (!packet)
+            {
+                break;
+            }
+            receiveBuffers_.push_back(*packet);
+            datagrams_.push_back({.buffer = pool_.buffer(*packet)});
+        }
+        if (datagrams_.empty())
+        {
+            ++stats_.poolExhausted;
+            return 0;
+        }
+
+        // Handlers may send and flush; flushing reuses datagrams_, so it waits until the batch is delivered
+        receiving_ = true;
+        size_t total = 0;
+        while (true)
+        {
+            const size_t received = socket_.receiveBatch(datagrams_);
+            ++stats_.receiveBatches;
+
+            const time::TimePoint now = time::Now();
+            for (size_t i = 0; i < received; ++i)
+            {
+                handleDatagram(datagrams_[i], now);
+            }
+            total += received;
+
+            if (received < datagrams_.size())
+            {
+                break;
+            }
+        }
+
+        receiving_ = false;
+
+        for (const PacketPool::Index packet : receiveBuffers_)
+        {
+            pool_.release(packet);
+        }
+
+        if (flushDeferred_)
+        {
+            flushDeferred_ = false;
+            flush();
+        }
+        return total;
+    }
+
+    void Transport::handleDatagram(const Datagram& datagram, const time::TimePoint now)
+    {
+        const std::byte* data = datagram.buffer.data();
+        if (datagram.size < HEADER_SIZE || Get16(data) != MAGIC)
+        {
+            ++stats_.invalidPackets;
+            return;
+        }
+
+        PeerId id = 0;
+        if (const auto it = peersByEndpoint_.find(EndpointKey(datagram.endpoint)); it != peersByEndpoint_.end())
+        {
+            id = it->second;
+        }
+        else if (settings_.acceptUnknownPeers)
+        {
+            id = addPeer(datagram.endpoint);
+        }
+        else
+        {
+            ++stats_.invalidPackets;
+            return;
+        }
+
+        ++stats_.packetsReceived;
+        stats_.bytesReceived += datagram.size;
+
+        Peer& peer = peers_[id];
+        const Uint16 sequence = Get16(data + 2);
+        const auto flags = std::to_integer<Uint8>(data[10]);
+
+        // Acks are valid even on duplicates and stale packets
+        processAcks(peer, Get16(data + 4), Get32(data + 6), now);
+
+        if (!peer.hasRemote || SequenceGreater(sequence, peer.remoteSequence))
+        {
+            const auto shift = peer.hasRemote ? static_cast<Uint16>(sequence - peer.remoteSequence) : 0U;
+            if (peer.hasRemote)
+            {
+                peer.receivedBits = shift >= 32 ? 0U : peer.receivedBits << shift;
+                if (shift <= 32)
+                {
+                    peer.receivedBits |= 1U << (shift - 1U);
+                }
+            }
+            peer.remoteSequence = sequence;
+            peer.hasRemote = true;
+        }
+        else
+        {
+            const auto age = static_cast<Uint16>(peer.remoteSequence - sequence);
+            if (age == 0 || age > 32 || (peer.receivedBits & (1U << (age - 1U))) != 0)
+            {
+                // Duplicate or too old to tell
+                return;
+            }
+            peer.receivedBits |= 1U << (age - 1U);
+        }
+
+        if ((flags & FLAG_ACK_ONLY) != 0)
+        {
+            return;
+        }
+        // The ack field only reaches 32 packets back; answer long bursts before they slide out of it
+        if (++peer.unacknowledged >= 32)
+        {
+            sendAckNow(peer, now);
+        }
+
+        const std::span payload(data + HEADER_SIZE, datagram.size - HEADER_SIZE);
+        if ((flags & FLAG_RELIABLE) != 0)
+        {
+            deliverReliable(id, peer, Get16(data + 11), payload);
+        }
+        else
+        {
+            deliver(id, Channel::Unreliable, payload);
+        }
+    }
+
+    void Transport::processAcks(Peer& peer, const Uint16 ack, const Uint32 ackBits, const time::TimePoint now)
+    {
+        acknowledgePacket(peer, ack, now);
+        for (Uint32 bit = 0; bit < 32; ++bit)
+        {
+            if ((ackBits & (1U << bit)) != 0)
+            {
+                acknowledgePacket(peer, static_cast<Uint16>(ack - 1U - bit), now);
+            }
+        }
+    }
+
+    void Transport::acknowledgePacket(Peer& peer, const Uint16 sequence, const time::TimePoint now)
+    {
+        SentRecord& record = peer.sent[sequence % SENT_WINDOW];
+        if (!record.valid || record.sequence != sequence)
+        {
+            return;
+        }
+        record.valid = false;
+
+        const double sample = time::Elapsed(record.sentAt, now);
+        peer.roundTripTime += (sample - peer.roundTripTime) * RTT_SMOOTHING;
+
+        if (!record.reliable)
+        {
+            return;
+        }
+
+        // Any copy of a reliable message arriving completes it
+        const auto it = std::ranges::find(peer.pendingReliable, record.reliableId, &ReliableMessage::id);
+        if (it != peer.pendingReliable.end() && !it->queued)
+        {
+            pool_.release(it->packet);
+            peer.pendingReliable.erase(it);
+        }
+    }
+
+    void Transport::deliverReliable(const PeerId id, Peer& peer, const Uint16 reliableId,
+                                    const std::span<const std::byte> payload)
+    {
+        if (reliableId != peer.expectedReliableId)
+        {
+            // Hold messages that arrive early; ignore ones already delivered
+            if (SequenceGreater(reliableId, peer.expectedReliableId) &&
+                static_cast<Uint16>(reliableId - peer.expectedReliableId) <= settings_.maxPendingReliable)
+            {
+                peer.outOfOrder.try_emplace(reliableId, payload.begin(), payload.end());
+            }
+            return;
+        }
+
+        ++peer.expectedReliableId;
+        deliver(id, Channel::Reliable, payload);
+
+        // The handler may add or remove peers, so look the peer up again after every delivery
+        for (Peer* state = findPeer(id); state != nullptr; state = findPeer(id))
+        {
+            const auto it = state->outOfOrder.find(state->expectedReliableId);
+            if (it == state->outOfOrder.end())
+            {
+                break;
+            }
+
+            const std::vector<std::byte> message = std::move(it->second);
+            state->outOfOrder.erase(it);
+            ++state->expectedReliableId;
+            deliver(id, Channel::Reliable, message);
+        }
+    }
+
+    void Transport::deliver(const PeerId peer, const Channel channel, const std::span<const std::byte> payload)
+    {
+        ++stats_.messagesDelivered;
+        if (handler_)
+        {
+            handler_(peer, channel, payload);
+        }
+    }
+
+    void Transport::writeHeader(Peer& peer, const std::span<std::byte> buffer, const Outgoing& outgoing,
+                                const time::TimePoint now)
+    {
+        const Uint16 sequence = peer.localSequence++;
+        const bool reliable = outgoing.channel == Channel::Reliable;
+
+        Put16(buffer.data(), MAGIC);
+        Put16(buffer.data() + 2, sequence);
+        Put16(buffer.data() + 4, peer.remoteSequence);
+        Put32(buffer.data() + 6, peer.receivedBits);
+        buffer[10] = static_cast<std::byte>((reliable ? FLAG_RELIABLE : 0U) | (outgoing.ackOnly ? FLAG_ACK_ONLY : 0U));
+        Put16(buffer.data() + 11, outgoing.reliableId);
+
+        peer.sent[sequence % SENT_WINDOW] = {
+            .sequence = sequence, .valid = true, .reliable = reliable, .reliableId = outgoing.reliableId,
+            .sentAt = now
+        };
+    }
+
+    void Transport::sendAckNow(Peer& peer, const time::TimePoint now)
+    {
+        std::array<std::byte, HEADER_SIZE> buffer{};
+        const Outgoing ack{
+            .peer = 0, .packet = 0, .size = HEADER_SIZE, .channel = Channel::Unreliable, .reliableId = 0,
+            .ackOnly = true
+        };
+        writeHeader(peer, buffer, ack, now);
+
+        if (socket_.sendTo(peer.endpoint, buffer))
+        {
+            ++stats_.packetsSent;
+            stats_.bytesSent += HEADER_SIZE;
+        }
+        ++stats_.ackOnlyPackets;
+        peer.unacknowledged = 0;
+    }
+
+    void Transport::queueRetransmissions(const time::TimePoint now)
+    {
+        for (PeerId id = 0; id < peers_.size(); ++id)
+        {
+            Peer& peer = peers_[id];
+            if (!peer.active)
+            {
+                continue;
+            }
+
+            const double delay = std::max(settings_.minResendDelay, 2.0 * peer.roundTripTime);
+            for (ReliableMessage& message : peer.pendingReliable)
+            {
+                if (message.queued || time::Elapsed(message.lastSent, now) < delay)
+                {
+                    continue;
+                }
+
+                message.queued = true;
+                ++stats_.retransmits;
+                queue_.push_back({
+                    .peer = id, .packet = message.packet, .size = message.size, .channel = Channel::Reliable,
+                    .reliableId = message.id, .ackOnly = false
+                });
+            }
+        }
+    }
+
+    void Transport::queueAcks()
+    {
+        for (const Outgoing& outgoing : queue_)
+        {
+            peers_[outgoing.peer].unacknowledged = 0;
+        }
+
+        for (PeerId id = 0; id < peers_.size(); ++id)
+        {
+            Peer& peer = peers_[id];
+            if (!peer.active || peer.unacknowledged == 0)
+            {
+                continue;
+            }
+
+            const auto packet = pool_.acquire();
+            if (!packet)
+            {
+                ++stats_.poolExhausted;
+                return;
+            }
+
+            peer.unacknowledged = 0;
+            ++stats_.ackOnlyPackets;
+            queue_.push_back({
+                .peer = id, .packet = *packet, .size = HEADER_SIZE, .channel = Channel::Unreliable, .reliableId = 0,
+                .ackOnly = true
+            });
+        }
+    }
+
+    size_t Transport::flush()
+    {
+        if (!socket_.isOpen())
+        {
+            return 0;
+        }
+        if (receiving_)
+        {
+            flushDeferred_ = true;
+            return 0;
+        }
+
+        const time::TimePoint now = time::Now();
+        queueRetransmissions(now);
+        queueAcks();
+        if (queue_.empty())
+        {
+            return 0;
+        }
+
+        // Headers are written last so every packet carries the newest acks
+        datagrams_.clear();
+        for (const Outgoing& outgoing : queue_)
+        {
+            Peer& peer = peers_[outgoing.peer];
+            const std::span<std::byte> buffer = pool_.buffer(outgoing.packet);
+            writeHeader(peer, buffer, outgoing, now);
+            datagrams_.push_back({.endpoint = peer.endpoint, .buffer = buffer, .size = outgoing.size});
+        }
+
+        const size_t sent = socket_.sendBatch(datagrams_);
+        ++stats_.sendBatches;
+
+        for (size_t i = 0; i < queue_.size(); ++i)
+        {
+            const Outgoing& outgoing = queue_[i];
+            if (i < sent)
+            {
+                ++stats_.packetsSent;
+                stats_.bytesSent += outgoing.size;
+            }
+            else
+            {
+                // Reliable messages are picked up again by the resend timer
+                ++stats_.sendDropped;
+            }
+
+            if (outgoing.channel == Channel::Unreliable)
+            {
+                pool_.release(outgoing.packet);
+                continue;
+            }
+
+            Peer& peer = peers_[outgoing.peer];
+            const auto it = std::ranges::find(peer.pendingReliable, outgoing.reliableId, &ReliableMessage::id);
+            if (it != peer.pendingReliable.end())
+            {
+                it->queued = false;
+                it->lastSent = now;
+            }
+        }
+        queue_.clear();
+        return sent;
+    }
+
+    void Transport::pump()
+    {
+        receive();
+        flush();
+    }
+}
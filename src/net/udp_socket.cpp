@@ -0,0 +1,457 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/net/udp_socket.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <utility>
+
+#include <SDL3/SDL_log.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mutex>
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace psyengine::net
+{
+    namespace
+    {
+#ifdef _WIN32
+        using NativeSocket = SOCKET;
+        using SocketLength = int;
+        using BufferLength = int;
+
+        bool IsValid(const NativeSocket socket) noexcept
+        {
+            return socket != INVALID_SOCKET;
+        }
+
+        bool EnsureNetworkInit()
+        {
+            static std::once_flag once;
+            static bool ok = false;
+            std::call_once(once, []
+            {
+                WSADATA data;
+                ok = WSAStartup(MAKEWORD(2, 2), &data) == 0;
+            });
+            return ok;
+        }
+
+        int LastError() noexcept
+        {
+            return WSAGetLastError();
+        }
+
+        bool WouldBlock(const int error) noexcept
+        {
+            // WSAECONNRESET reports an ICMP port unreachable from an earlier send; not fatal for UDP
+            return error == WSAEWOULDBLOCK || error == WSAECONNRESET;
+        }
+
+        void CloseNative(const NativeSocket socket) noexcept
+        {
+            closesocket(socket);
+        }
+
+        bool SetNonBlocking(const NativeSocket socket) noexcept
+        {
+            u_long mode = 1;
+            return ioctlsocket(socket, FIONBIO, &mode) == 0;
+        }
+#else
+        using NativeSocket = int;
+        using SocketLength = socklen_t;
+        using BufferLength = size_t;
+
+        bool IsValid(const NativeSocket socket) noexcept
+        {
+            return socket >= 0;
+        }
+
+        bool EnsureNetworkInit()
+        {
+            return true;
+        }
+
+        int LastError() noexcept
+        {
+            return errno;
+        }
+
+        bool WouldBlock(const int error) noexcept
+        {
+            return error == EAGAIN || error == EWOULDBLOCK || error == ECONNREFUSED || error == EINTR;
+        }
+
+        void CloseNative(const NativeSocket socket) noexcept
+        {
+            ::close(socket);
+        }
+
+        bool SetNonBlocking(const NativeSocket socket) noexcept
+        {
+            const int flags = fcntl(socket, F_GETFL, 0);
+            return flags != -1 && fcntl(socket, F_SETFL, flags | O_NONBLOCK) == 0;
+        }
+#endif
+
+        NativeSocket ToNative(const std::uintptr_t handle) noexcept
+        {
+            return static_cast<NativeSocket>(handle);
+        }
+
+        sockaddr_in ToSockaddr(const Endpoint& endpoint) noexcept
+        {
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(endpoint.address);
+            address.sin_port = htons(endpoint.port);
+            return address;
+        }
+
+        Endpoint FromSockaddr(const sockaddr_in& address) noexcept
+        {
+            return {.address = ntohl(address.sin_addr.s_addr), .port = ntohs(address.sin_port)};
+        }
+
+        enum class SendResult : Uint8
+        {
+            Sent,
+            Full,
+            Failed,
+        };
+
+        bool SendBufferFull(const int error) noexcept
+        {
+#ifdef _WIN32
+            return error == WSAEWOULDBLOCK;
+#else
+            return error == EAGAIN || error == EWOULDBLOCK;
+#endif
+        }
+
+        SendResult SendOne(const NativeSocket socket, const Endpoint& to, const std::span<const std::byte> data)
+        {
+            const sockaddr_in address = ToSockaddr(to);
+            const auto sent = ::sendto(socket, reinterpret_cast<const char*>(data.data()),
+                                       static_cast<BufferLength>(data.size()), 0,
+                                       reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+            if (sent >= 0)
+            {
+                return SendResult::Sent;
+            }
+
+            const int error = LastError();
+            if (SendBufferFull(error))
+            {
+                return SendResult::Full;
+            }
+            if (!WouldBlock(error))
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "UDP send to %s failed: %d", to.toString().c_str(), error);
+            }
+            return SendResult::Failed;
+        }
+
+#ifdef __linux__
+        /// Datagrams per sendmmsg/recvmmsg call; bounds the stack arrays below.
+        constexpr size_t MAX_SYSCALL_BATCH = 64;
+#endif
+    }
+
+    std::optional<Endpoint> Endpoint::Parse(const std::string& text)
+    {
+        Endpoint endpoint;
+        const char* cursor = text.data();
+        const char* const end = text.data() + text.size();
+
+        for (int octet = 0; octet < 4; ++octet)
+        {
+            unsigned value = 0;
+            const auto [next, error] = std::from_chars(cursor, end, value);
+            if (error != std::errc{} || value > 255 || next == end || *next != (octet < 3 ? '.' : ':'))
+            {
+                return std::nullopt;
+            }
+            endpoint.address = (endpoint.address << 8) | value;
+            cursor = next + 1;
+        }
+
+        const auto [next, error] = std::from_chars(cursor, end, endpoint.port);
+        if (error != std::errc{} || next != end)
+        {
+            return std::nullopt;
+        }
+        return endpoint;
+    }
+
+    std::string Endpoint::toString() const
+    {
+        return std::to_string(address >> 24) + '.' + std::to_string((address >> 16) & 0xFFU) + '.' +
+               std::to_string((address >> 8) & 0xFFU) + '.' + std::to_string(address & 0xFFU) + ':' +
+               std::to_string(port);
+    }
+
+    UdpSocket::~UdpSocket()
+    {
+        close();
+    }
+
+    UdpSocket::UdpSocket(UdpSocket&& other) noexcept :
+        handle_(std::exchange(other.handle_, INVALID_HANDLE)),
+        localPort_(std::exchange(other.localPort_, 0)) {}
+
+    UdpSocket& UdpSocket::operator=(UdpSocket&& other) noexcept
+    {
+        if (this != &other)
+        {
+            close();
+            handle_ = std::exchange(other.handle_, INVALID_HANDLE);
+            localPort_ = std::exchange(other.localPort_, 0);
+        }
+        return *this;
+    }
+
+    bool UdpSocket::open(const Uint16 port, const bool loopbackOnly)
+    {
+        close();
+
+        if (!EnsureNetworkInit())
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Network initialization failed");
+            return false;
+        }
+
+        const NativeSocket socket = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (!IsValid(socket))
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "UDP socket creation failed: %d", LastError());
+            return false;
+        }
+
+        const Endpoint local{.address = loopbackOnly ? Endpoint::Loopback(0).address : 0U, .port = port};
+        const sockaddr_in address = ToSockaddr(local);
+        if (bind(socket, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+            !SetNonBlocking(socket))
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "UDP socket bind to port %u failed: %d",
+                         static_cast<unsigned>(port), LastError());
+            CloseNative(socket);
+            return false;
+        }
+
+        sockaddr_in bound{};
+        SocketLength length = sizeof(bound);
+        getsockname(socket, reinterpret_cast<sockaddr*>(&bound), &length);
+
+        handle_ = static_cast<std::uintptr_t>(socket);
+        localPort_ = ntohs(bound.sin_port);
+        return true;
+    }
+
+    void UdpSocket::close() noexcept
+    {
+        if (isOpen())
+        {
+            CloseNative(ToNative(handle_));
+            handle_ = INVALID_HANDLE;
+            localPort_ = 0;
+        }
+    }
+
+    bool UdpSocket::sendTo(const Endpoint& to, const std::span<const std::byte> data) const
+    {
+        if (!isOpen())
+        {
+            return false;
+        }
+
+        return SendOne(ToNative(handle_), to, data) == SendResult::Sent;
+    }
+
+    std::optional<size_t> UdpSocket::receiveFrom(Endpoint& from, const std::span<std::byte> buffer) const
+    {
+        if (!isOpen())
+        {
+            return std::nullopt;
+        }
+
+        while (true)
+        {
+            sockaddr_in address{};
+            SocketLength length = sizeof(address);
+            const auto received = ::recvfrom(ToNative(handle_), reinterpret_cast<char*>(buffer.data()),
+                                             static_cast<BufferLength>(buffer.size()), 0,
+                                             reinterpret_cast<sockaddr*>(&address), &length);
+            if (received >= 0)
+            {
+                from = FromSockaddr(address);
+                return static_cast<size_t>(received);
+            }
+
+            const int error = LastError();
+#ifdef _WIN32
+            if (error == WSAECONNRESET || error == WSAEMSGSIZE)
+            {
+                // Stale ICMP error or a truncated datagram; look at the next one
+                continue;
+            }
+#endif
+            if (!WouldBlock(error))
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "UDP receive failed: %d", error);
+            }
+            return std::nullopt;
+        }
+    }
+
+    size_t UdpSocket::sendBatch(const std::span<const Datagram> datagrams) const
+    {
+        if (!isOpen())
+        {
+            return 0;
+        }
+
+        size_t consumed = 0;
+#ifdef __linux__
+        std::array<mmsghdr, MAX_SYSCALL_BATCH> messages{};
+        std::array<iovec, MAX_SYSCALL_BATCH> vectors{};
+        std::array<sockaddr_in, MAX_SYSCALL_BATCH> addresses{};
+
+        while (consumed < datagrams.size())
+        {
+            const size_t count = std::min(datagrams.size() - consumed, MAX_SYSCALL_BATCH);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Datagram& datagram = datagrams[consumed + i];
+                addresses[i] = ToSockaddr(datagram.endpoint);
+                vectors[i] = {.iov_base = datagram.buffer.data(), .iov_len = datagram.size};
+                messages[i] = {};
+                messages[i].msg_hdr.msg_name = &addresses[i];
+                messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                messages[i].msg_hdr.msg_iov = &vectors[i];
+                messages[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            const int sent = sendmmsg(ToNative(handle_), messages.data(), static_cast<unsigned>(count), 0);
+            if (sent < 0)
+            {
+                const int error = LastError();
+                if (SendBufferFull(error))
+                {
+                    break;
+                }
+
+                // The first datagram failed for good; log it, drop it and carry on with the rest
+                if (!WouldBlock(error))
+                {
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "UDP send to %s failed: %d",
+                                 datagrams[consumed].endpoint.toString().c_str(), error);
+                }
+                ++consumed;
+                continue;
+            }
+
+            consumed += static_cast<size_t>(sent);
+        }
+#else
+        for (; consumed < datagrams.size(); ++consumed)
+        {
+            const Datagram& datagram = datagrams[consumed];
+            if (SendOne(ToNative(handle_), datagram.endpoint, datagram.buffer.first(datagram.size)) ==
+                SendResult::Full)
+            {
+                break;
+            }
+        }
+#endif
+        return consumed;
+    }
+
+    size_t UdpSocket::receiveBatch(const std::span<Datagram> datagrams) const
+    {
+        if (!isOpen())
+        {
+            return 0;
+        }
+
+        size_t received = 0;
+#ifdef __linux__
+        std::array<mmsghdr, MAX_SYSCALL_BATCH> messages{};
+        std::array<iovec, MAX_SYSCALL_BATCH> vectors{};
+        std::array<sockaddr_in, MAX_SYSCALL_BATCH> addresses{};
+
+        while (received < datagrams.size())
+        {
+            const size_t count = std::min(datagrams.size() - received, MAX_SYSCALL_BATCH);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Datagram& datagram = datagrams[received + i];
+                vectors[i] = {.iov_base = datagram.buffer.data(), .iov_len = datagram.buffer.size()};
+                messages[i] = {};
+                messages[i].msg_hdr.msg_name = &addresses[i];
+                messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                messages[i].msg_hdr.msg_iov = &vectors[i];
+                messages[i].msg_hdr.msg_iovlen = 1;
+            }
+
+            const int result = recvmmsg(ToNative(handle_), messages.data(), static_cast<unsigned>(count),
+                                        MSG_DONTWAIT, nullptr);
+            if (result < 0)
+            {
+                if (const int error = LastError(); !WouldBlock(error))
+                {
+                    // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "UDP receive failed: %d", error);
+                }
+                break;
+            }
+
+            const auto filled = static_cast<size_t>(result);
+            for (size_t i = 0; i < filled; ++i)
+            {
+                Datagram& datagram = datagrams[received + i];
+                datagram.endpoint = FromSockaddr(addresses[i]);
+                datagram.size = std::min<size_t>(messages[i].msg_len, datagram.buffer.size());
+            }
+            received += filled;
+
+            if (filled < count)
+            {
+                break;
+            }
+        }
+#else
+        for (; received < datagrams.size(); ++received)
+        {
+            Datagram& datagram = datagrams[received];
+            const auto size = receiveFrom(datagram.endpoint, datagram.buffer);
+            if (!size)
+            {
+                break;
+            }
+            datagram.size = *size;
+        }
+#endif
+        return received;
+    }
+}
@@ -0,0 +1,71 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/platform/resolution_scaler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace psyengine::platform
+{
+    namespace
+    {
+        constexpr double SMOOTHING = 0.1;
+    }
+
+    ResolutionScaler::ResolutionScaler(const Settings& settings) :
+        settings_(settings), scale_(settings.maxScale) {}
+
+    float ResolutionScaler::update(const double frameTime) noexcept
+    {
+        averageFrameTime_ = samples_ == 0
+                                ? frameTime
+                                : averageFrameTime_ + (frameTime - averageFrameTime_) * SMOOTHING;
+        ++samples_;
+
+        if (cooldown_ > 0)
+        {
+            --cooldown_;
+            return scale_;
+        }
+
+        float target = scale_;
+        if (averageFrameTime_ > settings_.frameBudget)
+        {
+            // Fill cost grows with the pixel count, so scale by the square root of the overshoot
+            const double ratio = std::sqrt(settings_.frameBudget / averageFrameTime_);
+            target = std::min(quantize(static_cast<float>(scale_ * ratio)), scale_ - settings_.step);
+        }
+        else if (averageFrameTime_ < settings_.frameBudget * settings_.headroom)
+        {
+            target = scale_ + settings_.step;
+        }
+
+        target = std::clamp(quantize(target), settings_.minScale, settings_.maxScale);
+        if (target != scale_)
+        {
+            scale_ = target;
+            cooldown_ = settings_.cooldownFrames;
+        }
+
+        return scale_;
+    }
+
+    void ResolutionScaler::reset() noexcept
+    {
+        scale_ = settings_.maxScale;
+        averageFrameTime_ = 0.0;
+        samples_ = 0;
+        cooldown_ = 0;
+    }
+
+    float ResolutionScaler::quantize(const float scale) const noexcept
+    {
+        if (settings_.step <= 0.0F)
+        {
+            return scale;
+        }
+        return std::round(scale / settings_.step) * settings_.step;
+    }
+}
@@ -12,19 +12,73 @@
 #include <SDL3_ttf/SDL_ttf.h>
 #endif
 
+#include <array>
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <ctime>
+#endif
 
+#include "psyengine/debug/debug_draw.hpp"
+#include "psyengine/debug/latency_harness.hpp"
+#include "psyengine/debug/tick_hash_log.hpp"
+#include "psyengine/graphics/layer_compositor.hpp"
+#include "psyengine/graphics/render_context.hpp"
+#include "psyengine/state/snapshot_ring.hpp"
 #include "psyengine/input/input_manager.hpp"
 #include "psyengine/state//state_manager.hpp"
 #include "psyengine/time/time.hpp"
 
 namespace psyengine::platform
 {
+    namespace
+    {
+        /// Longest single wait in the background when the simulation is paused, so quit requests stay responsive.
+        constexpr double MAX_BACKGROUND_WAIT = 0.25;
+
+        /// CPU time consumed by the whole process, in seconds.
+        double ProcessCpuSeconds()
+        {
+#ifdef _WIN32
+            // std::clock() is wall time on MSVC
+            FILETIME creation{};
+            FILETIME exit{};
+            FILETIME kernel{};
+            FILETIME user{};
+            if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user))
+            {
+                return 0.0;
+            }
+            const auto ticks = [](const FILETIME& time)
+            {
+                return static_cast<double>((static_cast<Uint64>(time.dwHighDateTime) << 32) | time.dwLowDateTime);
+            };
+            // FILETIME counts 100 ns intervals
+            return (ticks(kernel) + ticks(user)) * 1e-7;
+#else
+            timespec now{};
+            if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now) != 0)
+            {
+                return 0.0;
+            }
+            return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) * 1e-9;
+#endif
+        }
+    }
+
     SdlRuntime::~SdlRuntime()
     {
         state::StateManager::instance().clear();
 
         // Ensure SDL objects are destroyed before SDL_Quit
+        graphics::LayerCompositor::instance().clear();
+        sceneTarget_.reset();
+        renderContext_.reset();
         renderer_.reset();
         window_.reset();
 
@@ -84,6 +138,7 @@ namespace psyengine::platform
 
         window_ = SdlWindowPtr(window);
         renderer_ = SdlRendererPtr(renderer);
+        renderContext_ = std::make_unique<graphics::RenderContext>(renderer);
 
         return true;
     }
@@ -95,7 +150,17 @@ namespace psyengine::platform
         assert(maxFixedUpdatesPerTick.maxUpdates > 0);
 
         const size_t maxUpdatesPerFrame = std::max<size_t>(1, maxFixedUpdatesPerTick.maxUpdates);
-        const double fixedTimeStep = 1.0 / static_cast<double>(fixedUpdateFrequency.frequency);
+        fixedTick_ = 0;
+        pendingRollback_.reset();
+        if (snapshotRing_ != nullptr)
+        {
+            snapshotRing_->capture(fixedTick_);
+        }
+
+        // A frequency requested before the loop started wins over the argument
+        fixedUpdateFrequency_ = pendingFixedUpdateFrequency_ != 0
+                                    ? std::exchange(pendingFixedUpdateFrequency_, 0)
+                                    : std::max<size_t>(1, fixedUpdateFrequency.frequency);
         const double maxFrameDeltaTime = maxFrameTime;
 
         double accumulatedTime = 0.0;
@@ -104,25 +169,93 @@ namespace psyengine::platform
         time::TimePoint lastTime = time::Now();
         time::TimePoint lastLagWarnTime = time::Min();
 
+        double backgroundAccumulatedTime = 0.0;
+        bool wasInBackground = false;
+        time::TimePoint backgroundStart = 0;
+        double backgroundCpuStart = 0.0;
+
         running_ = true;
         while (running_)
         {
+            applyFixedUpdateFrequency(accumulatedTime);
+            const double fixedTimeStep = 1.0 / static_cast<double>(fixedUpdateFrequency_);
+
+            if (isInBackground())
+            {
+                if (!wasInBackground)
+                {
+                    wasInBackground = true;
+                    backgroundStats_ = BackgroundStats{};
+                    backgroundStart = time::Now();
+                    backgroundCpuStart = ProcessCpuSeconds();
+                    backgroundAccumulatedTime = accumulatedTime;
+                }
+
+                backgroundTick(lastTime, backgroundAccumulatedTime, maxUpdatesPerFrame, maxFrameDeltaTime);
+                // Nothing renders in the background, so drop what the ticks queued instead of letting it pile up
+                debug::DebugDraw::instance().clear();
+
+                backgroundStats_.wallTime = time::ElapsedSince(backgroundStart);
+                backgroundStats_.cpuTime = ProcessCpuSeconds() - backgroundCpuStart;
+                continue;
+            }
+
+            if (wasInBackground)
+            {
+                // Background ticks already consumed the time spent away; resume without a catch-up burst
+                wasInBackground = false;
+                lastTime = time::Now();
+            }
+
             const time::TimePoint now = time::Now();
             const double frameDelta = std::min(time::Elapsed(lastTime, now), maxFrameDeltaTime);
 
+            FrameTiming timing;
+            timing.frameDelta = time::Elapsed(lastTime, now);
+
             lastTime = now;
             accumulatedTime += frameDelta;
 
+            if (latencyHarness_ != nullptr)
+            {
+                latencyHarness_->onFrameBegin();
+            }
+            runFrameHook(FramePhase::FrameBegin);
+
             // Events first, then update input for this frame
             handleEvents();
             input::InputManager::instance().update();
 
+            if (latencyHarness_ != nullptr)
+            {
+                latencyHarness_->onInputUpdated();
+            }
+            runFrameHook(FramePhase::AfterInput);
+
+            time::TimePoint inputSampleTime = time::Now();
+            timing.inputTime = time::Elapsed(now, inputSampleTime);
+
+            // Rollback replays count as fixed-update work but not as this frame's fixed steps
+            snapshotTime_ = 0.0;
+            timing.resimulatedTicks = applyRollback(fixedTimeStep);
+
             // Fixed updates
             while (accumulatedTime >= fixedTimeStep && accumulatedUpdates < maxUpdatesPerFrame)
             {
                 accumulatedTime -= fixedTimeStep;
+                if (!fixedUpdate(fixedTimeStep))
+                {
+                    // Waiting, e.g. for a peer's input; the time is dropped rather than caught up in a burst
+                    ++timing.stalledTicks;
+                    accumulatedTime = std::fmod(accumulatedTime, fixedTimeStep);
+                    break;
+                }
                 ++accumulatedUpdates;
-                fixedUpdate(fixedTimeStep);
+
+                if (latencyHarness_ != nullptr)
+                {
+                    latencyHarness_->onFixedUpdate();
+                }
             }
 
             // Check for lag
@@ -148,20 +281,197 @@ namespace psyengine::platform
                 lagging_ = false;
             }
 
+            timing.fixedUpdates = accumulatedUpdates;
+            timing.snapshotTime = snapshotTime_;
             accumulatedUpdates = 0;
 
+            runFrameHook(FramePhase::AfterFixedUpdate);
+
+            const time::TimePoint fixedUpdatesDone = time::Now();
+            timing.fixedUpdateTime = time::Elapsed(inputSampleTime, fixedUpdatesDone);
+
             // Variable-step update for render-side logic
             update(frameDelta);
 
+            time::TimePoint updateDone = time::Now();
+            timing.updateTime = time::Elapsed(fixedUpdatesDone, updateDone);
+
+            // Late latch: pick up events that arrived while simulating, without consuming their edges
+            if (lateInputLatch_)
+            {
+                timing.lateLatchEvents = handleEvents();
+                input::InputManager::instance().refresh();
+
+                if (latencyHarness_ != nullptr)
+                {
+                    latencyHarness_->onInputUpdated();
+                }
+
+                const time::TimePoint lateSampleTime = time::Now();
+                timing.inputTime += time::Elapsed(updateDone, lateSampleTime);
+                timing.lateLatchGain = time::Elapsed(inputSampleTime, lateSampleTime);
+                inputSampleTime = lateSampleTime;
+                updateDone = lateSampleTime;
+            }
+
+            lateUpdate(frameDelta);
+            runFrameHook(FramePhase::BeforeRender);
+
+            const time::TimePoint renderStart = time::Now();
+            timing.updateTime += time::Elapsed(updateDone, renderStart);
+
             // Interpolation factor for smooth rendering
             const auto interpolationFactor = static_cast<float>(accumulatedTime / fixedTimeStep);
             render(interpolationFactor);
 
+            // Presented separately, so the time blocked in it (mostly the vsync wait) can be told apart
+            const time::TimePoint submitted = time::Now();
+            SDL_RenderPresent(renderer_.get());
+
+            const time::TimePoint presented = time::Now();
+            timing.renderStats = renderContext_->stats();
+            timing.renderTime = time::Elapsed(renderStart, presented);
+            timing.presentTime = time::Elapsed(submitted, presented);
+            timing.inputAge = time::Elapsed(inputSampleTime, presented);
+            timing.renderScale = renderScale();
+            frameTiming_ = timing;
+
+            if (resolutionScaler_)
+            {
+                // With vsync on, the present wait pads every frame to the full budget
+                resolutionScaler_->update(timing.activeTime());
+            }
+
+            if (latencyHarness_ != nullptr)
+            {
+                latencyHarness_->onPresented();
+            }
+            runFrameHook(FramePhase::AfterPresent);
+
             // Yield a bit to reduce cpu usage
             SDL_Delay(1);
         }
     }
 
+    void SdlRuntime::applyFixedUpdateFrequency(double& accumulatedTime)
+    {
+        if (pendingFixedUpdateFrequency_ == 0)
+        {
+            return;
+        }
+
+        const size_t oldFrequency = std::exchange(fixedUpdateFrequency_, pendingFixedUpdateFrequency_);
+        pendingFixedUpdateFrequency_ = 0;
+        if (oldFrequency == fixedUpdateFrequency_)
+        {
+            return;
+        }
+
+        // Same fraction of a step, expressed in the new step length
+        accumulatedTime *= static_cast<double>(oldFrequency) / static_cast<double>(fixedUpdateFrequency_);
+
+        state::StateManager::instance().fixedUpdateFrequencyChanged(oldFrequency, fixedUpdateFrequency_);
+    }
+
+    size_t SdlRuntime::applyRollback(const double fixedTimeStep)
+    {
+        if (!pendingRollback_)
+        {
+            return 0;
+        }
+
+        const Uint64 tick = *pendingRollback_;
+        pendingRollback_.reset();
+
+        // The ring may have moved on or been detached since the request
+        if (snapshotRing_ == nullptr || tick >= fixedTick_ || !snapshotRing_->restore(tick))
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Rollback to tick %llu failed: snapshot not available",
+                         static_cast<unsigned long long>(tick));
+            return 0;
+        }
+        snapshotTime_ += snapshotRing_->lastRestoreTime();
+
+        const Uint64 targetTick = fixedTick_;
+        fixedTick_ = tick;
+        snapshotRing_->discardAfter(tick);
+        state::StateManager::instance().snapshotRestored(tick);
+
+        resimulating_ = true;
+        while (fixedTick_ < targetTick)
+        {
+            fixedUpdate(fixedTimeStep);
+        }
+        resimulating_ = false;
+
+        return static_cast<size_t>(targetTick - tick);
+    }
+
+    void SdlRuntime::backgroundTick(time::TimePoint& lastTime, double& accumulatedTime,
+                                    const size_t maxUpdatesPerFrame, const double maxFrameDeltaTime)
+    {
+        const size_t frequency = backgroundPolicy_.fixedUpdateFrequency;
+        const double step = frequency > 0 ? 1.0 / static_cast<double>(frequency) : 0.0;
+
+        // Sleep until the next background tick is due, waking early only for events
+        const double untilNextTick = step > 0.0 ? std::max(0.0, step - accumulatedTime) : MAX_BACKGROUND_WAIT;
+        const auto timeoutMs = static_cast<Sint32>(std::ceil(untilNextTick * 1000.0));
+
+        if (SDL_Event event; SDL_WaitEventTimeout(&event, timeoutMs))
+        {
+            ++backgroundStats_.wakeups;
+            if (dispatchEvent(event))
+            {
+                handleEvents();
+            }
+        }
+
+        runFrameHook(FramePhase::AfterInput);
+
+        const time::TimePoint now = time::Now();
+        const double elapsed = std::min(time::Elapsed(lastTime, now), maxFrameDeltaTime);
+        lastTime = now;
+
+        if (step <= 0.0)
+        {
+            // Simulation paused while in the background; a requested rollback waits until it resumes
+            return;
+        }
+
+        // Replayed at the background step, like the ticks it replaces
+        applyRollback(step);
+
+        accumulatedTime += elapsed;
+        if (accumulatedTime < step)
+        {
+            return;
+        }
+
+        input::InputManager::instance().update();
+
+        size_t updates = 0;
+        while (accumulatedTime >= step && updates < maxUpdatesPerFrame)
+        {
+            accumulatedTime -= step;
+            if (!fixedUpdate(step))
+            {
+                ++backgroundStats_.stalledTicks;
+                accumulatedTime = std::fmod(accumulatedTime, step);
+                break;
+            }
+            ++updates;
+        }
+
+        if (accumulatedTime >= step)
+        {
+            accumulatedTime = std::fmod(accumulatedTime, step);
+        }
+
+        backgroundStats_.fixedUpdates += updates;
+        runFrameHook(FramePhase::AfterFixedUpdate);
+    }
+
     bool SdlRuntime::setWindowTitle(const std::string& title) const
     {
         return SDL_SetWindowTitle(window_.get(), title.c_str());
@@ -197,6 +507,29 @@ namespace psyengine::platform
         return lagging_;
     }
 
+    bool SdlRuntime::setFixedUpdateFrequency(const size_t frequency)
+    {
+        if (frequency == 0)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Fixed update frequency must be greater than 0");
+            return false;
+        }
+
+        pendingFixedUpdateFrequency_ = frequency;
+        return true;
+    }
+
+    size_t SdlRuntime::fixedUpdateFrequency() const
+    {
+        return fixedUpdateFrequency_;
+    }
+
+    Uint64 SdlRuntime::fixedTick() const
+    {
+        return fixedTick_;
+    }
+
     SDL_Window* SdlRuntime::window() const
     {
         return window_.get();
@@ -207,41 +540,223 @@ namespace psyengine::platform
         return renderer_.get();
     }
 
-    void SdlRuntime::handleEvents()
+    graphics::RenderContext* SdlRuntime::renderContext() const
+    {
+        return renderContext_.get();
+    }
+
+    void SdlRuntime::setBackgroundPolicy(const BackgroundPolicy& policy)
+    {
+        backgroundPolicy_ = policy;
+    }
+
+    const SdlRuntime::BackgroundPolicy& SdlRuntime::backgroundPolicy() const
+    {
+        return backgroundPolicy_;
+    }
+
+    bool SdlRuntime::isInBackground() const
+    {
+        return minimized_ || hidden_ || (backgroundPolicy_.throttleOnFocusLost && !focused_);
+    }
+
+    const SdlRuntime::BackgroundStats& SdlRuntime::backgroundStats() const
+    {
+        return backgroundStats_;
+    }
+
+    void SdlRuntime::enableDynamicResolution(const DynamicResolutionSettings& settings)
+    {
+        resolutionScaler_.emplace(settings);
+    }
+
+    void SdlRuntime::disableDynamicResolution()
+    {
+        resolutionScaler_.reset();
+        sceneTarget_.reset();
+    }
+
+    float SdlRuntime::renderScale() const
+    {
+        return resolutionScaler_ ? resolutionScaler_->scale() : 1.0F;
+    }
+
+    void SdlRuntime::setLateInputLatch(const bool enabled)
+    {
+        lateInputLatch_ = enabled;
+    }
+
+    bool SdlRuntime::lateInputLatch() const
+    {
+        return lateInputLatch_;
+    }
+
+    const FrameTiming& SdlRuntime::frameTiming() const
+    {
+        return frameTiming_;
+    }
+
+    void SdlRuntime::setRenderStatsOverlay(const bool enabled)
+    {
+        renderStatsOverlay_ = enabled;
+    }
+
+    bool SdlRuntime::renderStatsOverlay() const
+    {
+        return renderStatsOverlay_;
+    }
+
+    void SdlRuntime::setLatencyHarness(debug::LatencyHarness* harness)
+    {
+        latencyHarness_ = harness;
+    }
+
+    void SdlRuntime::setFrameHook(const FramePhase phase, FrameHook hook)
+    {
+        frameHooks_[static_cast<size_t>(phase)] = std::move(hook);
+    }
+
+    void SdlRuntime::runFrameHook(const FramePhase phase) const
+    {
+        if (const FrameHook& hook = frameHooks_[static_cast<size_t>(phase)])
+        {
+            hook();
+        }
+    }
+
+    void SdlRuntime::setTickHashLog(debug::TickHashLog* log)
+    {
+        tickHashLog_ = log;
+    }
+
+    void SdlRuntime::setSnapshotRing(state::SnapshotRing* ring)
+    {
+        snapshotRing_ = ring;
+        pendingRollback_.reset();
+    }
+
+    bool SdlRuntime::requestRollback(const Uint64 tick)
+    {
+        if (snapshotRing_ == nullptr || tick >= fixedTick_ || !snapshotRing_->contains(tick))
+        {
+            return false;
+        }
+
+        // Several requests in one frame collapse into the oldest one
+        pendingRollback_ = pendingRollback_ ? std::min(*pendingRollback_, tick) : tick;
+        return true;
+    }
+
+    bool SdlRuntime::isResimulating() const
+    {
+        return resimulating_;
+    }
+
+    void SdlRuntime::setTickGate(TickGate gate)
+    {
+        tickGate_ = std::move(gate);
+    }
+
+    size_t SdlRuntime::handleEvents()
     {
         SDL_Event event;
+        size_t count = 0;
 
         while (SDL_PollEvent(&event))
         {
-            switch (event.type)
+            ++count;
+            if (!dispatchEvent(event))
             {
-            case SDL_EVENT_QUIT:
-                running_ = false;
-                return;
-
-            case SDL_EVENT_KEY_DOWN:
-            case SDL_EVENT_KEY_UP:
-            case SDL_EVENT_MOUSE_BUTTON_DOWN:
-            case SDL_EVENT_MOUSE_BUTTON_UP:
-            case SDL_EVENT_MOUSE_MOTION:
-            case SDL_EVENT_MOUSE_WHEEL:
-            case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
-            case SDL_EVENT_GAMEPAD_BUTTON_UP:
-            case SDL_EVENT_GAMEPAD_AXIS_MOTION:
-            case SDL_EVENT_GAMEPAD_REMOVED:
-                // Fall through in case people want to use these anyway
-                input::InputManager::instance().handleEvent(event);
-                [[fallthrough]];
-            default:
-                state::StateManager::instance().handleEvent(event);
                 break;
             }
         }
+
+        return count;
     }
 
-    void SdlRuntime::fixedUpdate(const double deltaTime)
+    bool SdlRuntime::dispatchEvent(const SDL_Event& event)
     {
-        state::StateManager::instance().fixedUpdate(deltaTime);
+        if (latencyHarness_ != nullptr)
+        {
+            latencyHarness_->onEventDispatched(event);
+        }
+
+        switch (event.type)
+        {
+        case SDL_EVENT_QUIT:
+            running_ = false;
+            return false;
+
+        case SDL_EVENT_WINDOW_MINIMIZED:
+            minimized_ = true;
+            break;
+        case SDL_EVENT_WINDOW_RESTORED:
+        case SDL_EVENT_WINDOW_MAXIMIZED:
+            minimized_ = false;
+            break;
+        case SDL_EVENT_WINDOW_HIDDEN:
+            hidden_ = true;
+            break;
+        case SDL_EVENT_WINDOW_SHOWN:
+            hidden_ = false;
+            break;
+        case SDL_EVENT_WINDOW_FOCUS_LOST:
+            focused_ = false;
+            break;
+        case SDL_EVENT_WINDOW_FOCUS_GAINED:
+            focused_ = true;
+            break;
+
+        case SDL_EVENT_RENDER_TARGETS_RESET:
+            graphics::LayerCompositor::instance().invalidateAll();
+            break;
+        case SDL_EVENT_RENDER_DEVICE_RESET:
+            graphics::LayerCompositor::instance().releaseTargets();
+            break;
+
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+        case SDL_EVENT_MOUSE_MOTION:
+        case SDL_EVENT_MOUSE_WHEEL:
+        case SDL_EVENT_GAMEPAD_BUTTON_DOWN:
+        case SDL_EVENT_GAMEPAD_BUTTON_UP:
+        case SDL_EVENT_GAMEPAD_AXIS_MOTION:
+        case SDL_EVENT_GAMEPAD_REMOVED:
+            input::InputManager::instance().handleEvent(event);
+            break;
+        default:
+            break;
+        }
+
+        // Every event reaches the states as well, in case people want to use these anyway
+        state::StateManager::instance().handleEvent(event);
+        return true;
+    }
+
+    bool SdlRuntime::fixedUpdate(const double deltaTime)
+    {
+        if (!resimulating_ && tickGate_ && !tickGate_(fixedTick_ + 1))
+        {
+            return false;
+        }
+
+        const auto& states = state::StateManager::instance();
+        states.fixedUpdate(deltaTime);
+        ++fixedTick_;
+
+        if (tickHashLog_ != nullptr)
+        {
+            tickHashLog_->recordStates(fixedTick_, states);
+        }
+
+        if (snapshotRing_ != nullptr)
+        {
+            snapshotRing_->capture(fixedTick_);
+            snapshotTime_ += snapshotRing_->lastCaptureTime();
+        }
+        return true;
     }
 
     void SdlRuntime::update(const double deltaTime)
@@ -249,15 +764,128 @@ namespace psyengine::platform
         state::StateManager::instance().update(deltaTime);
     }
 
-    void SdlRuntime::render(const float interpolationFactor) const
+    void SdlRuntime::lateUpdate(const double deltaTime)
+    {
+        state::StateManager::instance().lateUpdate(deltaTime);
+    }
+
+    void SdlRuntime::render(const float interpolationFactor)
     {
+        SDL_Renderer* renderer = renderer_.get();
+        graphics::RenderContext& context = *renderContext_;
+        context.beginFrame();
+
+        int outputWidth = 0;
+        int outputHeight = 0;
+        const bool hasOutputSize = SDL_GetRenderOutputSize(renderer, &outputWidth, &outputHeight);
+
+        // Stale layers are redrawn first, while no scene target is bound
+        graphics::LayerCompositor& layers = graphics::LayerCompositor::instance();
+        if (hasOutputSize)
+        {
+            layers.prepare(context, outputWidth, outputHeight);
+        }
+
+        const float scale = renderScale();
+        const bool scaled = scale < 1.0F && hasOutputSize && prepareSceneTarget(outputWidth, outputHeight);
+
+        if (scaled)
+        {
+            // States keep drawing in output coordinates; the scale shrinks it into the top-left of the target
+            context.setTarget(sceneTarget_.get());
+            context.setScale(scale, scale);
+        }
+
         // CornFlowerBlue
-        SDL_SetRenderDrawColorFloat(renderer_.get(), 0.392F, 0.584F, 0.929F, 1.0F);
-        SDL_RenderClear(renderer_.get());
-        SDL_SetRenderDrawColorFloat(renderer_.get(), 1.0F, 1.0F, 1.0F, 1.0F);
+        context.setDrawColorFloat(0.392F, 0.584F, 0.929F, 1.0F);
+        context.clear();
+        context.setDrawColorFloat(1.0F, 1.0F, 1.0F, 1.0F);
+
+        layers.composite(context, graphics::LayerPass::Below);
+        state::StateManager::instance().render(context, interpolationFactor);
+
+        if (scaled)
+        {
+            context.setScale(1.0F, 1.0F);
+            context.setTarget(nullptr);
+
+            const SDL_FRect source{
+                0.0F, 0.0F,
+                std::floor(static_cast<float>(outputWidth) * scale),
+                std::floor(static_cast<float>(outputHeight) * scale)
+            };
+            context.renderTexture(sceneTarget_.get(), &source, nullptr);
+        }
+
+        layers.composite(context, graphics::LayerPass::Above);
+
+        // After the upscale, so the overlay stays sharp at any render scale
+        debug::DebugDraw::instance().flush(context);
+
+        if (renderStatsOverlay_)
+        {
+            drawRenderStatsOverlay(renderer);
+        }
+
+        // Hands the batched commands to the driver here rather than inside the present
+        SDL_FlushRenderer(renderer);
+    }
+
+    void SdlRuntime::drawRenderStatsOverlay(SDL_Renderer* renderer) const
+    {
+        const graphics::RenderStats& stats = frameTiming_.renderStats;
+        std::array<std::array<char, 96>, 3> lines{};
+        std::snprintf(lines[0].data(), lines[0].size(), "draws %zu  breaks %zu  textures %zu  states %zu",
+                      stats.drawCalls, stats.batchBreaks, stats.textureSwitches, stats.stateChanges);
+        std::snprintf(lines[1].data(), lines[1].size(), "vertices %zu  uploads %zu (%.1f KB)", stats.vertices,
+                      stats.uploads, static_cast<double>(stats.uploadedBytes) / 1024.0);
+        std::snprintf(lines[2].data(), lines[2].size(), "render %.2f ms  frame %.2f ms",
+                      frameTiming_.renderTime * 1000.0, frameTiming_.frameDelta * 1000.0);
+
+        float red = 0.0F;
+        float green = 0.0F;
+        float blue = 0.0F;
+        float alpha = 0.0F;
+        SDL_BlendMode blendMode = SDL_BLENDMODE_NONE;
+        SDL_GetRenderDrawColorFloat(renderer, &red, &green, &blue, &alpha);
+        SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+
+        // Debug font glyphs are 8x8 pixels
+        constexpr float LINE_HEIGHT = 10.0F;
+        const SDL_FRect backdrop{0.0F, 0.0F, 8.0F * 52.0F, LINE_HEIGHT * static_cast<float>(lines.size()) + 4.0F};
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderDrawColorFloat(renderer, 0.0F, 0.0F, 0.0F, 0.6F);
+        SDL_RenderFillRect(renderer, &backdrop);
+        SDL_SetRenderDrawColorFloat(renderer, 1.0F, 1.0F, 1.0F, 1.0F);
+        for (size_t i = 0; i < lines.size(); ++i)
+        {
+            SDL_RenderDebugText(renderer, 2.0F, 2.0F + LINE_HEIGHT * static_cast<float>(i), lines[i].data());
+        }
+
+        SDL_SetRenderDrawBlendMode(renderer, blendMode);
+        SDL_SetRenderDrawColorFloat(renderer, red, green, blue, alpha);
+    }
+
+    bool SdlRuntime::prepareSceneTarget(const int outputWidth, const int outputHeight)
+    {
+        if (sceneTarget_ && sceneTarget_->w == outputWidth && sceneTarget_->h == outputHeight)
+        {
+            return true;
+        }
 
-        state::StateManager::instance().render(renderer_.get(), interpolationFactor);
+        // Allocated at full output size so scale changes never reallocate; only the used region is upscaled
+        sceneTarget_.reset(SDL_CreateTexture(renderer_.get(), SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET,
+                                             outputWidth, outputHeight));
+        if (!sceneTarget_)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Dynamic resolution target creation failed: %s",
+                         SDL_GetError());
+            resolutionScaler_.reset();
+            return false;
+        }
 
-        SDL_RenderPresent(renderer_.get());
+        SDL_SetTextureScaleMode(sceneTarget_.get(), SDL_SCALEMODE_LINEAR);
+        return true;
     }
 }
\ No newline at end of file
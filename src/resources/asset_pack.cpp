@@ -0,0 +1,560 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/resources/asset_pack.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <span>
+
+#include <SDL3/SDL_iostream.h>
+#include <SDL3/SDL_log.h>
+
+#include "psyengine/time/time.hpp"
+#include "psyengine/utils/thread_pool.hpp"
+
+#ifdef PSYENGINE_WITH_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+
+#ifdef PSYENGINE_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace psyengine::resources
+{
+    namespace
+    {
+        constexpr std::array<char, 8> MAGIC{'P', 'S', 'Y', 'P', 'A', 'C', 'K', '\0'};
+        constexpr Uint32 VERSION = 1;
+        constexpr size_t HEADER_SIZE = 24;
+
+        void Append(std::vector<std::byte>& out, Uint64 value, const size_t bytes)
+        {
+            for (size_t i = 0; i < bytes; ++i, value >>= 8U)
+            {
+                out.push_back(static_cast<std::byte>(value & 0xFFU));
+            }
+        }
+
+        /// Bounds-checked little-endian reader over a byte span.
+        class Cursor
+        {
+        public:
+            explicit Cursor(const std::span<const std::byte> data) noexcept :
+                data_(data) {}
+
+            Uint64 read(const size_t bytes) noexcept
+            {
+                if (position_ + bytes > data_.size())
+                {
+                    ok_ = false;
+                    return 0;
+                }
+                Uint64 value = 0;
+                for (size_t i = 0; i < bytes; ++i)
+                {
+                    value |= std::to_integer<Uint64>(data_[position_ + i]) << (8U * i);
+                }
+                position_ += bytes;
+                return value;
+            }
+
+            std::string readString(const size_t length)
+            {
+                if (position_ + length > data_.size())
+                {
+                    ok_ = false;
+                    return {};
+                }
+                std::string text(reinterpret_cast<const char*>(data_.data() + position_), length);
+                position_ += length;
+                return text;
+            }
+
+            [[nodiscard]] bool ok() const noexcept
+            {
+                return ok_;
+            }
+
+        private:
+            std::span<const std::byte> data_;
+            size_t position_ = 0;
+            bool ok_ = true;
+        };
+
+        bool ReadAt(SDL_IOStream* io, const Uint64 offset, const std::span<std::byte> out)
+        {
+            if (SDL_SeekIO(io, static_cast<Sint64>(offset), SDL_IO_SEEK_SET) < 0)
+            {
+                return false;
+            }
+            size_t done = 0;
+            while (done < out.size())
+            {
+                const size_t read = SDL_ReadIO(io, out.data() + done, out.size() - done);
+                if (read == 0)
+                {
+                    return false;
+                }
+                done += read;
+            }
+            return true;
+        }
+
+        bool WriteAll(SDL_IOStream* io, const std::span<const std::byte> data)
+        {
+            return data.empty() || SDL_WriteIO(io, data.data(), data.size()) == data.size();
+        }
+
+        /// Per-thread decompression state.
+        class Decompressor
+        {
+        public:
+            Decompressor() = default;
+
+            ~Decompressor()
+            {
+#ifdef PSYENGINE_WITH_ZSTD
+                ZSTD_freeDCtx(zstd_);
+#endif
+            }
+
+            bool decompress(const PackCompression compression, const std::span<const std::byte> in,
+                            const std::span<std::byte> out)
+            {
+                switch (compression)
+                {
+                case PackCompression::None:
+                    return in.size() == out.size();
+#ifdef PSYENGINE_WITH_LZ4
+                case PackCompression::Lz4:
+                    return LZ4_decompress_safe(reinterpret_cast<const char*>(in.data()),
+                                               reinterpret_cast<char*>(out.data()), static_cast<int>(in.size()),
+                                               static_cast<int>(out.size())) == static_cast<int>(out.size());
+#endif
+#ifdef PSYENGINE_WITH_ZSTD
+                case PackCompression::Zstd:
+                {
+                    if (zstd_ == nullptr)
+                    {
+                        zstd_ = ZSTD_createDCtx();
+                    }
+                    const size_t result = ZSTD_decompressDCtx(zstd_, out.data(), out.size(), in.data(), in.size());
+                    return ZSTD_isError(result) == 0 && result == out.size();
+                }
+#endif
+                default:
+                    return false;
+                }
+            }
+
+            Decompressor(const Decompressor& other) = delete;
+            Decompressor(Decompressor&& other) noexcept = delete;
+            Decompressor& operator=(const Decompressor& other) = delete;
+            Decompressor& operator=(Decompressor&& other) noexcept = delete;
+
+        private:
+#ifdef PSYENGINE_WITH_ZSTD
+            ZSTD_DCtx* zstd_ = nullptr;
+#endif
+        };
+
+        struct WorkerTimes
+        {
+            double read = 0.0;
+            double decompress = 0.0;
+        };
+
+        std::optional<LoadedSurface> LoadEntry(SDL_IOStream* io, const PackEntry& entry, const size_t index,
+                                               BufferPool& pool, std::vector<std::byte>& scratch,
+                                               Decompressor& decompressor, WorkerTimes& times)
+        {
+            FileBuffer pixels = pool.acquire(static_cast<size_t>(entry.rawSize));
+
+            // Raw entries are read straight into the pixel buffer
+            const time::TimePoint start = time::Now();
+            std::span<std::byte> stored = pixels.mutableData();
+            if (entry.compression != PackCompression::None)
+            {
+                scratch.resize(static_cast<size_t>(entry.storedSize));
+                stored = scratch;
+            }
+            if (!ReadAt(io, entry.offset, stored.first(static_cast<size_t>(entry.storedSize))))
+            {
+                return std::nullopt;
+            }
+
+            const time::TimePoint read = time::Now();
+            times.read += time::Elapsed(start, read);
+
+            if (entry.compression != PackCompression::None &&
+                !decompressor.decompress(entry.compression, scratch, pixels.mutableData()))
+            {
+                return std::nullopt;
+            }
+            times.decompress += time::ElapsedSince(read);
+
+            SDL_Surface* surface = SDL_CreateSurfaceFrom(static_cast<int>(entry.width), static_cast<int>(entry.height),
+                                                         entry.format, pixels.mutableData().data(),
+                                                         static_cast<int>(entry.pitch));
+            if (surface == nullptr)
+            {
+                return std::nullopt;
+            }
+            return LoadedSurface{.index = index, .surface = surface, .pixels = std::move(pixels)};
+        }
+    }
+
+    // --- AssetPackWriter ---
+
+    bool AssetPackWriter::IsSupported(const PackCompression compression) noexcept
+    {
+        switch (compression)
+        {
+        case PackCompression::None:
+            return true;
+        case PackCompression::Lz4:
+#ifdef PSYENGINE_WITH_LZ4
+            return true;
+#else
+            return false;
+#endif
+        case PackCompression::Zstd:
+#ifdef PSYENGINE_WITH_ZSTD
+            return true;
+#else
+            return false;
+#endif
+        }
+        return false;
+    }
+
+    bool AssetPackWriter::add(const std::string& name, SDL_Surface* surface, const PackCompression compression,
+                              [[maybe_unused]] const int level)
+    {
+        if (surface == nullptr || names_.contains(name) || !IsSupported(compression))
+        {
+            return false;
+        }
+
+        Blob blob;
+        blob.entry.name = name;
+        blob.entry.width = static_cast<Uint32>(surface->w);
+        blob.entry.height = static_cast<Uint32>(surface->h);
+        blob.entry.format = surface->format;
+        blob.entry.pitch = static_cast<Uint32>(surface->pitch);
+        blob.entry.compression = compression;
+        blob.entry.rawSize = static_cast<Uint64>(surface->pitch) * static_cast<Uint64>(surface->h);
+
+        if (!SDL_LockSurface(surface))
+        {
+            return false;
+        }
+        const std::span raw(static_cast<const std::byte*>(surface->pixels), static_cast<size_t>(blob.entry.rawSize));
+
+        bool ok = true;
+        switch (compression)
+        {
+        case PackCompression::None:
+            blob.data.assign(raw.begin(), raw.end());
+            break;
+#ifdef PSYENGINE_WITH_LZ4
+        case PackCompression::Lz4:
+        {
+            blob.data.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(raw.size()))));
+            const auto* src = reinterpret_cast<const char*>(raw.data());
+            auto* dst = reinterpret_cast<char*>(blob.data.data());
+            const int size = level > 0
+                                 ? LZ4_compress_HC(src, dst, static_cast<int>(raw.size()),
+                                                   static_cast<int>(blob.data.size()), level)
+                                 : LZ4_compress_default(src, dst, static_cast<int>(raw.size()),
+                                                        static_cast<int>(blob.data.size()));
+            ok = size > 0;
+            blob.data.resize(ok ? static_cast<size_t>(size) : 0);
+            break;
+        }
+#endif
+#ifdef PSYENGINE_WITH_ZSTD
+        case PackCompression::Zstd:
+        {
+            blob.data.resize(ZSTD_compressBound(raw.size()));
+            const size_t size = ZSTD_compress(blob.data.data(), blob.data.size(), raw.data(), raw.size(),
+                                              level > 0 ? level : ZSTD_CLEVEL_DEFAULT);
+            ok = ZSTD_isError(size) == 0;
+            blob.data.resize(ok ? size : 0);
+            break;
+        }
+#endif
+        default:
+            ok = false;
+            break;
+        }
+        SDL_UnlockSurface(surface);
+
+        if (!ok)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to compress pack entry %s", name.c_str());
+            return false;
+        }
+
+        blob.entry.storedSize = blob.data.size();
+        names_.emplace(name, blobs_.size());
+        blobs_.push_back(std::move(blob));
+        return true;
+    }
+
+    Uint64 AssetPackWriter::storedBytes() const noexcept
+    {
+        Uint64 total = 0;
+        for (const Blob& blob : blobs_)
+        {
+            total += blob.entry.storedSize;
+        }
+        return total;
+    }
+
+    bool AssetPackWriter::save(const std::string& path) const
+    {
+        // Entry data follows the header back to back, then the table
+        std::vector<std::byte> table;
+        Uint64 offset = HEADER_SIZE;
+        for (const Blob& blob : blobs_)
+        {
+            const PackEntry& entry = blob.entry;
+            Append(table, entry.name.size(), 2);
+            const auto* name = reinterpret_cast<const std::byte*>(entry.name.data());
+            table.insert(table.end(), name, name + entry.name.size());
+            Append(table, entry.width, 4);
+            Append(table, entry.height, 4);
+            Append(table, entry.format, 4);
+            Append(table, entry.pitch, 4);
+            Append(table, static_cast<Uint8>(entry.compression), 1);
+            Append(table, offset, 8);
+            Append(table, entry.storedSize, 8);
+            Append(table, entry.rawSize, 8);
+            offset += entry.storedSize;
+        }
+
+        std::vector<std::byte> header;
+        const auto* magic = reinterpret_cast<const std::byte*>(MAGIC.data());
+        header.insert(header.end(), magic, magic + MAGIC.size());
+        Append(header, VERSION, 4);
+        Append(header, blobs_.size(), 4);
+        Append(header, offset, 8);
+
+        SDL_IOStream* io = SDL_IOFromFile(path.c_str(), "wb");
+        if (io == nullptr)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create asset pack %s: %s", path.c_str(),
+                         SDL_GetError());
+            return false;
+        }
+
+        bool ok = WriteAll(io, header);
+        for (const Blob& blob : blobs_)
+        {
+            ok = ok && WriteAll(io, blob.data);
+        }
+        ok = ok && WriteAll(io, table);
+        ok = SDL_CloseIO(io) && ok;
+        return ok;
+    }
+
+    // --- AssetPack ---
+
+    AssetPack::AssetPack() :
+        pool_(BufferPool::Create()) {}
+
+    bool AssetPack::open(const std::string& path)
+    {
+        path_.clear();
+        entries_.clear();
+        names_.clear();
+
+        SDL_IOStream* io = SDL_IOFromFile(path.c_str(), "rb");
+        if (io == nullptr)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to open asset pack %s: %s", path.c_str(),
+                         SDL_GetError());
+            return false;
+        }
+
+        const Sint64 fileSize = SDL_GetIOSize(io);
+        std::array<std::byte, HEADER_SIZE> header{};
+        bool ok = fileSize >= static_cast<Sint64>(HEADER_SIZE) && ReadAt(io, 0, header) &&
+                  std::memcmp(header.data(), MAGIC.data(), MAGIC.size()) == 0;
+
+        Cursor headerCursor(std::span<const std::byte>(header).subspan(MAGIC.size()));
+        const auto version = static_cast<Uint32>(headerCursor.read(4));
+        const auto count = static_cast<size_t>(headerCursor.read(4));
+        const Uint64 tableOffset = headerCursor.read(8);
+        ok = ok && version == VERSION && tableOffset >= HEADER_SIZE && tableOffset <= static_cast<Uint64>(fileSize);
+
+        std::vector<std::byte> table;
+        if (ok)
+        {
+            table.resize(static_cast<size_t>(static_cast<Uint64>(fileSize) - tableOffset));
+            ok = ReadAt(io, tableOffset, table);
+        }
+        SDL_CloseIO(io);
+
+        Cursor cursor(table);
+        for (size_t i = 0; ok && i < count; ++i)
+        {
+            PackEntry entry;
+            entry.name = cursor.readString(static_cast<size_t>(cursor.read(2)));
+            entry.width = static_cast<Uint32>(cursor.read(4));
+            entry.height = static_cast<Uint32>(cursor.read(4));
+            entry.format = static_cast<SDL_PixelFormat>(cursor.read(4));
+            entry.pitch = static_cast<Uint32>(cursor.read(4));
+            entry.compression = static_cast<PackCompression>(cursor.read(1));
+            entry.offset = cursor.read(8);
+            entry.storedSize = cursor.read(8);
+            entry.rawSize = cursor.read(8);
+
+            ok = cursor.ok() && entry.rawSize == static_cast<Uint64>(entry.pitch) * entry.height &&
+                 entry.offset >= HEADER_SIZE && entry.offset + entry.storedSize <= tableOffset &&
+                 static_cast<Uint8>(entry.compression) <= static_cast<Uint8>(PackCompression::Zstd) &&
+                 (entry.compression != PackCompression::None || entry.storedSize == entry.rawSize);
+
+            names_.emplace(entry.name, entries_.size());
+            entries_.push_back(std::move(entry));
+        }
+
+        if (!ok)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Malformed asset pack %s", path.c_str());
+            entries_.clear();
+            names_.clear();
+            return false;
+        }
+
+        path_ = path;
+        return true;
+    }
+
+    std::optional<size_t> AssetPack::find(const std::string& name) const
+    {
+        const auto it = names_.find(name);
+        return it != names_.end() ? std::optional(it->second) : std::nullopt;
+    }
+
+    std::optional<LoadedSurface> AssetPack::loadSurface(const size_t index) const
+    {
+        if (index >= entries_.size())
+        {
+            return std::nullopt;
+        }
+
+        SDL_IOStream* io = SDL_IOFromFile(path_.c_str(), "rb");
+        if (io == nullptr)
+        {
+            return std::nullopt;
+        }
+
+        std::vector<std::byte> scratch;
+        Decompressor decompressor;
+        WorkerTimes times;
+        auto loaded = LoadEntry(io, entries_[index], index, *pool_, scratch, decompressor, times);
+        SDL_CloseIO(io);
+        return loaded;
+    }
+
+    size_t AssetPack::loadSurfaces(utils::ThreadPool& threads, const std::function<void(LoadedSurface&)>& onLoaded)
+    {
+        const time::TimePoint start = time::Now();
+        stats_ = PackLoadStats{};
+        if (entries_.empty())
+        {
+            return 0;
+        }
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::deque<std::optional<LoadedSurface>> ready;
+        std::atomic<size_t> next{0};
+        WorkerTimes totalTimes;
+
+        // One task per worker, each with its own file handle, pulling entries until none are left
+        const size_t workerCount = std::clamp<size_t>(threads.threadCount(), 1, entries_.size());
+        size_t runningWorkers = workerCount;
+        for (size_t worker = 0; worker < workerCount; ++worker)
+        {
+            threads.submit([&]
+            {
+                SDL_IOStream* io = SDL_IOFromFile(path_.c_str(), "rb");
+                std::vector<std::byte> scratch;
+                Decompressor decompressor;
+                WorkerTimes times;
+
+                for (size_t index = next++; index < entries_.size(); index = next++)
+                {
+                    auto loaded = io != nullptr
+                                      ? LoadEntry(io, entries_[index], index, *pool_, scratch, decompressor, times)
+                                      : std::nullopt;
+
+                    std::scoped_lock lock(mutex);
+                    ready.push_back(std::move(loaded));
+                    changed.notify_one();
+                }
+
+                if (io != nullptr)
+                {
+                    SDL_CloseIO(io);
+                }
+
+                std::scoped_lock lock(mutex);
+                totalTimes.read += times.read;
+                totalTimes.decompress += times.decompress;
+                --runningWorkers;
+                changed.notify_one();
+            });
+        }
+
+        size_t loaded = 0;
+        while (true)
+        {
+            std::deque<std::optional<LoadedSurface>> batch;
+            {
+                std::unique_lock lock(mutex);
+                changed.wait(lock, [&] { return !ready.empty() || runningWorkers == 0; });
+                if (ready.empty())
+                {
+                    break;
+                }
+                batch.swap(ready);
+            }
+
+            for (auto& result : batch)
+            {
+                if (!result)
+                {
+                    continue;
+                }
+
+                ++loaded;
+                stats_.storedBytes += entries_[result->index].storedSize;
+                stats_.rawBytes += entries_[result->index].rawSize;
+                onLoaded(*result);
+            }
+        }
+
+        stats_.entries = loaded;
+        stats_.readTime = totalTimes.read;
+        stats_.decompressTime = totalTimes.decompress;
+        stats_.wallTime = time::ElapsedSince(start);
+        return loaded;
+    }
+}
@@ -0,0 +1,648 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/resources/async_file_reader.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <SDL3/SDL_log.h>
+
+#include "psyengine/utils/thread_pool.hpp"
+
+#if defined(PSYENGINE_WITH_IO_URING) && defined(__linux__)
+#define PSY_HAS_IO_URING 1
+#include <atomic>
+#include <cerrno>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace psyengine::resources
+{
+    namespace
+    {
+        constexpr unsigned MIN_CLASS = 12; ///< Smallest buffer is 4 KiB.
+        constexpr unsigned CLASS_COUNT = 48;
+
+        unsigned SizeClass(const size_t size) noexcept
+        {
+            const size_t capacity = std::bit_ceil(std::max(size, size_t{1} << MIN_CLASS));
+            return static_cast<unsigned>(std::countr_zero(capacity));
+        }
+    }
+
+    // --- FileBuffer ---
+
+    FileBuffer::~FileBuffer()
+    {
+        release();
+    }
+
+    FileBuffer::FileBuffer(FileBuffer&& other) noexcept :
+        pool_(std::move(other.pool_)),
+        data_(std::exchange(other.data_, nullptr)),
+        size_(std::exchange(other.size_, 0)),
+        capacity_(std::exchange(other.capacity_, 0)) {}
+
+    FileBuffer& FileBuffer::operator=(FileBuffer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            pool_ = std::move(other.pool_);
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            capacity_ = std::exchange(other.capacity_, 0);
+        }
+        return *this;
+    }
+
+    void FileBuffer::release() noexcept
+    {
+        if (data_ != nullptr && pool_)
+        {
+            pool_->release(data_, capacity_);
+        }
+        pool_.reset();
+        data_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+    }
+
+    SDL_IOStream* FileBuffer::openIO() const
+    {
+        return SDL_IOFromConstMem(data_, size_);
+    }
+
+    // --- BufferPool ---
+
+    struct BufferPool::State
+    {
+        mutable std::mutex mutex;
+        std::array<std::vector<std::byte*>, CLASS_COUNT> free{};
+        size_t maxCachedPerClass = 0;
+        size_t cachedBytes = 0;
+    };
+
+    BufferPool::BufferPool(const size_t maxCachedPerClass) :
+        state_(std::make_unique<State>())
+    {
+        state_->maxCachedPerClass = maxCachedPerClass;
+    }
+
+    std::shared_ptr<BufferPool> BufferPool::Create(const size_t maxCachedPerClass)
+    {
+        // The constructor is private; buffers keep the pool alive through shared_from_this
+        return std::shared_ptr<BufferPool>(new BufferPool(maxCachedPerClass));
+    }
+
+    BufferPool::~BufferPool()
+    {
+        for (const auto& list : state_->free)
+        {
+            for (std::byte* data : list)
+            {
+                delete[] data;
+            }
+        }
+    }
+
+    FileBuffer BufferPool::acquire(const size_t size)
+    {
+        const unsigned sizeClass = SizeClass(size);
+        const size_t capacity = size_t{1} << sizeClass;
+
+        std::byte* data = nullptr;
+        {
+            std::scoped_lock lock(state_->mutex);
+            if (auto& list = state_->free[sizeClass]; !list.empty())
+            {
+                data = list.back();
+                list.pop_back();
+                state_->cachedBytes -= capacity;
+            }
+        }
+        if (data == nullptr)
+        {
+            data = new std::byte[capacity];
+        }
+
+        FileBuffer buffer;
+        buffer.pool_ = shared_from_this();
+        buffer.data_ = data;
+        buffer.size_ = size;
+        buffer.capacity_ = capacity;
+        return buffer;
+    }
+
+    void BufferPool::release(std::byte* data, const size_t capacity) noexcept
+    {
+        const unsigned sizeClass = SizeClass(capacity);
+        {
+            std::scoped_lock lock(state_->mutex);
+            if (auto& list = state_->free[sizeClass]; list.size() < state_->maxCachedPerClass)
+            {
+                list.push_back(data);
+                state_->cachedBytes += capacity;
+                return;
+            }
+        }
+        delete[] data;
+    }
+
+    size_t BufferPool::cachedBytes() const
+    {
+        std::scoped_lock lock(state_->mutex);
+        return state_->cachedBytes;
+    }
+
+    // --- io_uring backend ---
+
+#ifdef PSY_HAS_IO_URING
+    struct AsyncFileReader::Ring
+    {
+        int fd = -1;
+        void* sqMap = MAP_FAILED;
+        size_t sqMapSize = 0;
+        void* cqMap = MAP_FAILED;
+        size_t cqMapSize = 0;
+        io_uring_sqe* sqes = nullptr;
+        size_t sqesSize = 0;
+
+        unsigned* sqTail = nullptr;
+        unsigned sqMask = 0;
+        unsigned* sqArray = nullptr;
+        unsigned sqEntries = 0;
+
+        unsigned* cqHead = nullptr;
+        unsigned* cqTail = nullptr;
+        unsigned cqMask = 0;
+        io_uring_cqe* cqes = nullptr;
+
+        static std::unique_ptr<Ring> Create(unsigned entries);
+
+        ~Ring()
+        {
+            if (sqes != nullptr)
+            {
+                munmap(sqes, sqesSize);
+            }
+            if (cqMap != MAP_FAILED && cqMap != sqMap)
+            {
+                munmap(cqMap, cqMapSize);
+            }
+            if (sqMap != MAP_FAILED)
+            {
+                munmap(sqMap, sqMapSize);
+            }
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+
+        template <typename T>
+        static T* At(void* base, const size_t offset) noexcept
+        {
+            return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+        }
+
+        /// Queues a submission; the caller guarantees a free slot.
+        io_uring_sqe& nextSqe(unsigned& pendingTail) const noexcept
+        {
+            const unsigned index = pendingTail & sqMask;
+            sqArray[index] = index;
+            ++pendingTail;
+            io_uring_sqe& sqe = sqes[index];
+            sqe = {};
+            return sqe;
+        }
+
+        void publish(const unsigned pendingTail) const noexcept
+        {
+            std::atomic_ref(*sqTail).store(pendingTail, std::memory_order_release);
+        }
+
+        /// Submits published entries and waits for at least minComplete completions.
+        /// @return Entries consumed by the kernel, or -errno.
+        int enter(const unsigned toSubmit, const unsigned minComplete) const noexcept
+        {
+            const long result = syscall(__NR_io_uring_enter, fd, toSubmit, minComplete,
+                                        minComplete > 0 ? IORING_ENTER_GETEVENTS : 0U, nullptr, 0);
+            return result < 0 ? -errno : static_cast<int>(result);
+        }
+    };
+
+    std::unique_ptr<AsyncFileReader::Ring> AsyncFileReader::Ring::Create(const unsigned entries)
+    {
+        auto ring = std::make_unique<Ring>();
+
+        io_uring_params params{};
+        const long fd = syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+        ring->fd = static_cast<int>(fd);
+
+        ring->sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        ring->cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap)
+        {
+            ring->sqMapSize = ring->cqMapSize = std::max(ring->sqMapSize, ring->cqMapSize);
+        }
+
+        ring->sqMap = mmap(nullptr, ring->sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                           IORING_OFF_SQ_RING);
+        if (ring->sqMap == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        ring->cqMap = singleMap
+            ? ring->sqMap
+            : mmap(nullptr, ring->cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                   IORING_OFF_CQ_RING);
+        if (ring->cqMap == MAP_FAILED)
+        {
+            return nullptr;
+        }
+
+        ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd,
+                          IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+        {
+            return nullptr;
+        }
+        ring->sqes = static_cast<io_uring_sqe*>(sqes);
+
+        ring->sqTail = At<unsigned>(ring->sqMap, params.sq_off.tail);
+        ring->sqMask = *At<unsigned>(ring->sqMap, params.sq_off.ring_mask);
+        ring->sqArray = At<unsigned>(ring->sqMap, params.sq_off.array);
+        ring->sqEntries = params.sq_entries;
+
+        ring->cqHead = At<unsigned>(ring->cqMap, params.cq_off.head);
+        ring->cqTail = At<unsigned>(ring->cqMap, params.cq_off.tail);
+        ring->cqMask = *At<unsigned>(ring->cqMap, params.cq_off.ring_mask);
+        ring->cqes = At<io_uring_cqe>(ring->cqMap, params.cq_off.cqes);
+        return ring;
+    }
+#else
+    struct AsyncFileReader::Ring
+    {
+    };
+#endif
+
+    // --- AsyncFileReader ---
+
+    AsyncFileReader::AsyncFileReader(const AsyncReaderSettings& settings) :
+        settings_(settings), pool_(BufferPool::Create())
+    {
+        settings_.queueDepth = std::clamp<size_t>(settings_.queueDepth, 1, 4096);
+
+#ifdef PSY_HAS_IO_URING
+        if (settings_.allowIoUring)
+        {
+            ring_ = Ring::Create(static_cast<unsigned>(settings_.queueDepth));
+            if (ring_)
+            {
+                // The kernel rounds the ring up; never keep more reads in flight than it has room for
+                settings_.queueDepth = std::min<size_t>(settings_.queueDepth, ring_->sqEntries);
+                backend_ = Backend::IoUring;
+                return;
+            }
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_Log("io_uring unavailable, falling back to threaded file reads");
+        }
+#endif
+        threads_ = std::make_unique<utils::ThreadPool>(settings_.threadCount);
+    }
+
+    AsyncFileReader::~AsyncFileReader() = default;
+
+    size_t AsyncFileReader::readBatch(const std::span<const std::string> paths, const CompletionHandler& onComplete,
+                                      const std::stop_token& stopToken)
+    {
+        return backend_ == Backend::IoUring
+                   ? readWithRing(paths, onComplete, stopToken)
+                   : readWithThreads(paths, onComplete, stopToken);
+    }
+
+    size_t AsyncFileReader::readWithRing(const std::span<const std::string> paths, const CompletionHandler& onComplete,
+                                         const std::stop_token& stopToken)
+    {
+#ifdef PSY_HAS_IO_URING
+        struct Slot
+        {
+            int fd = -1;
+            size_t index = 0;
+            size_t offset = 0;
+            FileBuffer buffer;
+            iovec vector{};
+        };
+
+        std::vector<Slot> slots(settings_.queueDepth);
+        std::vector<Uint32> freeSlots(slots.size());
+        for (size_t i = 0; i < freeSlots.size(); ++i)
+        {
+            freeSlots[i] = static_cast<Uint32>(freeSlots.size() - 1 - i);
+        }
+
+        size_t succeeded = 0;
+        const auto complete = [&](const size_t index, const bool ok, FileBuffer buffer)
+        {
+            FileReadResult result{.index = index, .ok = ok, .buffer = std::move(buffer)};
+            if (ok)
+            {
+                ++succeeded;
+            }
+            onComplete(result);
+        };
+
+        const auto finish = [&](const Uint32 slotIndex, const bool ok)
+        {
+            Slot& slot = slots[slotIndex];
+            ::close(slot.fd);
+            slot.fd = -1;
+            if (!ok)
+            {
+                slot.buffer = FileBuffer{};
+            }
+            complete(slot.index, ok, std::move(slot.buffer));
+            freeSlots.push_back(slotIndex);
+        };
+
+        unsigned tail = std::atomic_ref(*ring_->sqTail).load(std::memory_order_relaxed);
+        unsigned toSubmit = 0;
+        const auto queueRead = [&](const Uint32 slotIndex)
+        {
+            Slot& slot = slots[slotIndex];
+            const auto remaining = slot.buffer.mutableData().subspan(slot.offset);
+            slot.vector.iov_base = remaining.data();
+            slot.vector.iov_len = remaining.size();
+
+            io_uring_sqe& sqe = ring_->nextSqe(tail);
+            sqe.opcode = IORING_OP_READV;
+            sqe.fd = slot.fd;
+            sqe.addr = reinterpret_cast<Uint64>(&slot.vector);
+            sqe.len = 1;
+            sqe.off = slot.offset;
+            sqe.user_data = slotIndex;
+            ++toSubmit;
+        };
+
+        size_t next = 0;
+        size_t inFlight = 0; ///< Slots with a read queued; toSubmit of them are not yet seen by the kernel.
+        bool fatal = false;
+        const auto opening = [&] { return next < paths.size() && !stopToken.stop_requested(); };
+        while (opening() || inFlight > 0)
+        {
+            // Open and size files until every slot has a read queued
+            while (opening() && !freeSlots.empty())
+            {
+                const size_t index = next++;
+                const int fd = ::open(paths[index].c_str(), O_RDONLY | O_CLOEXEC);
+                struct stat info{};
+                if (fd < 0 || fstat(fd, &info) != 0)
+                {
+                    if (fd >= 0)
+                    {
+                        ::close(fd);
+                    }
+                    complete(index, false, FileBuffer{});
+                    continue;
+                }
+
+                const Uint32 slotIndex = freeSlots.back();
+                freeSlots.pop_back();
+                Slot& slot = slots[slotIndex];
+                slot.fd = fd;
+                slot.index = index;
+                slot.offset = 0;
+                slot.buffer = pool_->acquire(static_cast<size_t>(info.st_size));
+                if (slot.buffer.empty())
+                {
+                    finish(slotIndex, true);
+                    continue;
+                }
+
+                queueRead(slotIndex);
+                ++inFlight;
+            }
+
+            if (inFlight == 0)
+            {
+                continue;
+            }
+
+            ring_->publish(tail);
+            const int entered = ring_->enter(toSubmit, 1);
+            if (entered < 0 && entered != -EINTR && entered != -EAGAIN && entered != -EBUSY)
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "io_uring_enter failed: %d", -entered);
+                fatal = true;
+                break;
+            }
+            if (entered > 0)
+            {
+                toSubmit -= std::min(toSubmit, static_cast<unsigned>(entered));
+            }
+
+            // Reap everything that finished; short reads go back into the ring for the rest
+            unsigned head = std::atomic_ref(*ring_->cqHead).load(std::memory_order_relaxed);
+            const unsigned cqTail = std::atomic_ref(*ring_->cqTail).load(std::memory_order_acquire);
+            for (; head != cqTail; ++head)
+            {
+                const io_uring_cqe& cqe = ring_->cqes[head & ring_->cqMask];
+                const auto slotIndex = static_cast<Uint32>(cqe.user_data);
+                Slot& slot = slots[slotIndex];
+
+                if (cqe.res == -EINTR || cqe.res == -EAGAIN)
+                {
+                    queueRead(slotIndex);
+                    continue;
+                }
+                if (cqe.res < 0)
+                {
+                    --inFlight;
+                    finish(slotIndex, false);
+                    continue;
+                }
+
+                slot.offset += static_cast<size_t>(cqe.res);
+                if (cqe.res > 0 && slot.offset < slot.buffer.size())
+                {
+                    queueRead(slotIndex);
+                    continue;
+                }
+
+                // A zero-length read before the end means the file shrank; keep what was read
+                --inFlight;
+                finish(slotIndex, slot.offset == slot.buffer.size());
+            }
+            std::atomic_ref(*ring_->cqHead).store(head, std::memory_order_release);
+        }
+
+        if (!fatal)
+        {
+            return succeeded;
+        }
+
+        // The kernel may still be writing into slot buffers: wait until every submitted read has completed
+        // before anything is freed. Entries it never consumed die with the ring, so none reach the next batch.
+        size_t outstanding = inFlight - toSubmit;
+        while (outstanding > 0)
+        {
+            const int waited = ring_->enter(0, 1);
+            if (waited < 0 && waited != -EINTR && waited != -EAGAIN && waited != -EBUSY)
+            {
+                break;
+            }
+            unsigned head = std::atomic_ref(*ring_->cqHead).load(std::memory_order_relaxed);
+            const unsigned cqTail = std::atomic_ref(*ring_->cqTail).load(std::memory_order_acquire);
+            outstanding -= std::min<size_t>(outstanding, cqTail - head);
+            std::atomic_ref(*ring_->cqHead).store(cqTail, std::memory_order_release);
+        }
+
+        if (outstanding > 0)
+        {
+            // Cannot tell when the kernel is done with them: leak the ring and the slots rather than free
+            // memory that is still being written
+            for (Slot& slot : slots)
+            {
+                if (slot.fd >= 0)
+                {
+                    ::close(slot.fd);
+                    slot.fd = -1;
+                    complete(slot.index, false, FileBuffer{});
+                }
+            }
+            static_cast<void>(new std::vector<Slot>(std::move(slots)));
+            static_cast<void>(ring_.release());
+        }
+        else
+        {
+            ring_.reset();
+            for (Uint32 slotIndex = 0; slotIndex < slots.size(); ++slotIndex)
+            {
+                if (slots[slotIndex].fd >= 0)
+                {
+                    finish(slotIndex, false);
+                }
+            }
+        }
+
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+        SDL_Log("io_uring failed, falling back to threaded file reads");
+        backend_ = Backend::ThreadPool;
+        if (next < paths.size())
+        {
+            const size_t first = next;
+            succeeded += readWithThreads(paths.subspan(first), [&onComplete, first](FileReadResult& result)
+            {
+                result.index += first;
+                onComplete(result);
+            }, stopToken);
+        }
+        return succeeded;
+#else
+        return readWithThreads(paths, onComplete, stopToken);
+#endif
+    }
+
+    size_t AsyncFileReader::readWithThreads(const std::span<const std::string> paths,
+                                            const CompletionHandler& onComplete, const std::stop_token& stopToken)
+    {
+        if (!threads_)
+        {
+            threads_ = std::make_unique<utils::ThreadPool>(settings_.threadCount);
+        }
+
+        std::mutex mutex;
+        std::condition_variable completed;
+        std::deque<FileReadResult> results;
+
+        const auto readFile = [this, &paths, &mutex, &completed, &results](const size_t index)
+        {
+            FileReadResult result{.index = index, .ok = false, .buffer = FileBuffer{}};
+            if (SDL_IOStream* io = SDL_IOFromFile(paths[index].c_str(), "rb"))
+            {
+                if (const Sint64 size = SDL_GetIOSize(io); size >= 0)
+                {
+                    result.buffer = pool_->acquire(static_cast<size_t>(size));
+                    const auto bytes = result.buffer.mutableData();
+                    size_t offset = 0;
+                    while (offset < bytes.size())
+                    {
+                        const size_t read = SDL_ReadIO(io, bytes.data() + offset, bytes.size() - offset);
+                        if (read == 0)
+                        {
+                            break;
+                        }
+                        offset += read;
+                    }
+                    result.ok = offset == bytes.size();
+                }
+                SDL_CloseIO(io);
+            }
+            if (!result.ok)
+            {
+                result.buffer = FileBuffer{};
+            }
+
+            std::scoped_lock lock(mutex);
+            results.push_back(std::move(result));
+            completed.notify_one();
+        };
+
+        size_t next = 0;
+        size_t inFlight = 0;
+        size_t succeeded = 0;
+        const auto submitting = [&] { return next < paths.size() && !stopToken.stop_requested(); };
+        while (submitting() || inFlight > 0)
+        {
+            // Keep at most queueDepth reads outstanding so buffers do not pile up ahead of the consumer
+            for (; submitting() && inFlight < settings_.queueDepth; ++next, ++inFlight)
+            {
+                threads_->submit([readFile, index = next] { readFile(index); });
+            }
+            if (inFlight == 0)
+            {
+                break;
+            }
+
+            std::deque<FileReadResult> ready;
+            {
+                std::unique_lock lock(mutex);
+                completed.wait(lock, [&results] { return !results.empty(); });
+                ready.swap(results);
+            }
+
+            for (FileReadResult& result : ready)
+            {
+                --inFlight;
+                if (result.ok)
+                {
+                    ++succeeded;
+                }
+                onComplete(result);
+            }
+        }
+        return succeeded;
+    }
+}
@@ -0,0 +1,346 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/resources/decoded_image_cache.hpp"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include <SDL3/SDL_filesystem.h>
+#include <SDL3/SDL_iostream.h>
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_pixels.h>
+
+#include "psyengine/debug/assert.hpp"
+#include "psyengine/utils/hash.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PSY_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace psyengine::resources
+{
+    namespace
+    {
+        constexpr std::array<char, 8> MAGIC{'P', 'S', 'Y', 'I', 'M', 'G', 'C', '\0'};
+        constexpr Uint32 VERSION = 3; ///< 2: premultiplied alpha. 3: alpha mode recorded in flags.
+
+        constexpr Uint32 FLAG_PREMULTIPLIED = 1U << 0U;
+
+        /// Fixed-size record at the start of a cache file; the pixels follow it.
+        struct CacheHeader
+        {
+            std::array<char, 8> magic{};
+            Uint32 version = 0;
+            Uint32 format = 0;
+            Uint32 width = 0;
+            Uint32 height = 0;
+            Uint32 pitch = 0;
+            Uint32 flags = 0;
+            Uint64 sourceSize = 0;
+            Sint64 sourceModified = 0;
+            Uint64 contentHash = 0;
+            Uint64 pixelBytes = 0;
+        };
+
+        static_assert(sizeof(CacheHeader) == 64, "Pixels start 64-byte aligned in the mapping");
+
+        /// @return true if the header describes rows SDL can upload and its pixels fill the rest of the file.
+        bool GeometryValid(const CacheHeader& header, const size_t fileSize) noexcept
+        {
+            constexpr auto maxDimension = static_cast<Uint32>(std::numeric_limits<int>::max());
+            const Uint64 rowBytes = static_cast<Uint64>(header.width) *
+                static_cast<Uint64>(SDL_BYTESPERPIXEL(static_cast<SDL_PixelFormat>(header.format)));
+            return header.width > 0 && header.height > 0 && header.width <= maxDimension &&
+                header.height <= maxDimension && header.pitch <= maxDimension && rowBytes > 0 &&
+                header.pitch >= rowBytes && header.pixelBytes == static_cast<Uint64>(header.pitch) * header.height &&
+                fileSize - sizeof(CacheHeader) == header.pixelBytes;
+        }
+
+        /// Read-only view of a whole file, memory-mapped where the platform allows.
+        class MappedFile
+        {
+        public:
+            explicit MappedFile(const std::string& path)
+            {
+#ifdef PSY_HAS_MMAP
+                const int fd = ::open(path.c_str(), O_RDONLY);
+                if (fd < 0)
+                {
+                    return;
+                }
+                struct stat info{};
+                if (::fstat(fd, &info) == 0 && info.st_size > 0)
+                {
+                    void* address = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                    if (address != MAP_FAILED)
+                    {
+                        data_ = address;
+                        size_ = static_cast<size_t>(info.st_size);
+                    }
+                }
+                ::close(fd);
+#else
+                data_ = SDL_LoadFile(path.c_str(), &size_);
+#endif
+            }
+
+            ~MappedFile()
+            {
+                if (data_ == nullptr)
+                {
+                    return;
+                }
+#ifdef PSY_HAS_MMAP
+                ::munmap(data_, size_);
+#else
+                SDL_free(data_);
+#endif
+            }
+
+            [[nodiscard]] std::span<const std::byte> data() const noexcept
+            {
+                return {static_cast<const std::byte*>(data_), size_};
+            }
+
+            MappedFile(const MappedFile& other) = delete;
+            MappedFile(MappedFile&& other) noexcept = delete;
+            MappedFile& operator=(const MappedFile& other) = delete;
+            MappedFile& operator=(MappedFile&& other) noexcept = delete;
+
+        private:
+            void* data_ = nullptr;
+            size_t size_ = 0;
+        };
+
+        Uint64 ContentHash(const std::span<const std::byte> contents) noexcept
+        {
+            return utils::Hash64(contents.data(), contents.size());
+        }
+
+        /// Hashes the source, reading it only if the caller has not already.
+        bool SourceHash(const std::string& path, const std::span<const std::byte> contents, Uint64& hash)
+        {
+            if (!contents.empty())
+            {
+                hash = ContentHash(contents);
+                return true;
+            }
+
+            size_t size = 0;
+            void* data = SDL_LoadFile(path.c_str(), &size);
+            if (data == nullptr)
+            {
+                return false;
+            }
+            hash = ContentHash({static_cast<const std::byte*>(data), size});
+            SDL_free(data);
+            return true;
+        }
+
+        bool WriteFile(const std::string& path, const CacheHeader& header, const SDL_Surface* surface)
+        {
+            SDL_IOStream* io = SDL_IOFromFile(path.c_str(), "wb");
+            if (io == nullptr)
+            {
+                return false;
+            }
+
+            bool ok = SDL_WriteIO(io, &header, sizeof(header)) == sizeof(header);
+            const auto* row = static_cast<const std::byte*>(surface->pixels);
+            for (Uint32 y = 0; ok && y < header.height; ++y, row += surface->pitch)
+            {
+                ok = SDL_WriteIO(io, row, header.pitch) == header.pitch;
+            }
+            ok = SDL_CloseIO(io) && ok;
+            return ok;
+        }
+    }
+
+    DecodedImageCache::DecodedImageCache(std::string directory) :
+        directory_(std::move(directory))
+    {
+        if (!directory_.empty() && directory_.back() != '/' && directory_.back() != '\\')
+        {
+            directory_ += '/';
+        }
+        if (!SDL_CreateDirectory(directory_.c_str()))
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to create image cache directory %s: %s",
+                         directory_.c_str(), SDL_GetError());
+        }
+    }
+
+    SDL_PixelFormat DecodedImageCache::PreferredFormat(SDL_Renderer* renderer)
+    {
+        // The renderer lists its texture formats best first, terminated by SDL_PIXELFORMAT_UNKNOWN
+        const auto* formats = static_cast<const SDL_PixelFormat*>(SDL_GetPointerProperty(
+            SDL_GetRendererProperties(renderer), SDL_PROP_RENDERER_TEXTURE_FORMATS_POINTER, nullptr));
+        for (; formats != nullptr && *formats != SDL_PIXELFORMAT_UNKNOWN; ++formats)
+        {
+            if (!SDL_ISPIXELFORMAT_FOURCC(*formats) && SDL_ISPIXELFORMAT_ALPHA(*formats))
+            {
+                return *formats;
+            }
+        }
+        return SDL_PIXELFORMAT_ARGB8888;
+    }
+
+    std::string DecodedImageCache::entryPath(const std::string& path) const
+    {
+        std::array<char, 17> name{};
+        std::snprintf(name.data(), name.size(), "%016llx",
+                      static_cast<unsigned long long>(utils::Hash64(path.data(), path.size())));
+        return directory_ + name.data() + ".img";
+    }
+
+    SDL_Texture* DecodedImageCache::loadTexture(const std::string& path, SDL_Renderer* renderer,
+                                                const std::span<const std::byte> contents)
+    {
+        PSY_DEBUG_ASSERT(renderer != nullptr, "Renderer is null");
+
+        SDL_PathInfo info{};
+        if (!SDL_GetPathInfo(path.c_str(), &info))
+        {
+            ++stats_.misses;
+            return nullptr;
+        }
+
+        const std::string cachePath = entryPath(path);
+        SDL_Texture* texture = nullptr;
+        bool touched = false;
+        CacheHeader header;
+        {
+            const MappedFile file(cachePath);
+            const std::span<const std::byte> data = file.data();
+            if (data.size() < sizeof(CacheHeader))
+            {
+                ++stats_.misses;
+                return nullptr;
+            }
+            std::memcpy(&header, data.data(), sizeof(header));
+
+            const bool valid = header.magic == MAGIC && header.version == VERSION &&
+                               header.format == PreferredFormat(renderer) && header.sourceSize == info.size &&
+                               ((header.flags & FLAG_PREMULTIPLIED) != 0) == premultipliedAlpha_ &&
+                               GeometryValid(header, data.size());
+            if (!valid)
+            {
+                ++stats_.misses;
+                return nullptr;
+            }
+
+            if (header.sourceModified != info.modify_time)
+            {
+                Uint64 hash = 0;
+                if (!SourceHash(path, contents, hash) || hash != header.contentHash)
+                {
+                    ++stats_.misses;
+                    return nullptr;
+                }
+                touched = true;
+            }
+
+            const auto format = static_cast<SDL_PixelFormat>(header.format);
+            texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STATIC, static_cast<int>(header.width),
+                                        static_cast<int>(header.height));
+            if (texture == nullptr || !SDL_UpdateTexture(texture, nullptr, data.data() + sizeof(CacheHeader),
+                                                         static_cast<int>(header.pitch)))
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to upload cached image %s: %s", path.c_str(),
+                             SDL_GetError());
+                SDL_DestroyTexture(texture);
+                ++stats_.misses;
+                return nullptr;
+            }
+            SDL_SetTextureBlendMode(texture,
+                                    premultipliedAlpha_ ? SDL_BLENDMODE_BLEND_PREMULTIPLIED : SDL_BLENDMODE_BLEND);
+        }
+
+        // Same contents under a new timestamp: record it so the next launch takes the fast path
+        if (touched)
+        {
+            header.sourceModified = info.modify_time;
+            if (SDL_IOStream* io = SDL_IOFromFile(cachePath.c_str(), "r+b"))
+            {
+                SDL_WriteIO(io, &header, sizeof(header));
+                SDL_CloseIO(io);
+            }
+            ++stats_.revalidated;
+        }
+
+        ++stats_.hits;
+        stats_.bytesUploaded += header.pixelBytes;
+        return texture;
+    }
+
+    bool DecodedImageCache::store(const std::string& path, SDL_Surface* prepared,
+                                  const std::span<const std::byte> contents)
+    {
+        PSY_DEBUG_ASSERT(prepared != nullptr, "Surface is null");
+
+        SDL_PathInfo info{};
+        if (!SDL_GetPathInfo(path.c_str(), &info))
+        {
+            return false;
+        }
+
+        Uint64 hash = 0;
+        if (!SourceHash(path, contents, hash))
+        {
+            return false;
+        }
+
+        if (!SDL_LockSurface(prepared))
+        {
+            return false;
+        }
+
+        CacheHeader header;
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.format = prepared->format;
+        header.flags = premultipliedAlpha_ ? FLAG_PREMULTIPLIED : 0U;
+        header.width = static_cast<Uint32>(prepared->w);
+        header.height = static_cast<Uint32>(prepared->h);
+        header.pitch = static_cast<Uint32>(prepared->w) * static_cast<Uint32>(SDL_BYTESPERPIXEL(prepared->format));
+        header.sourceSize = info.size;
+        header.sourceModified = info.modify_time;
+        header.contentHash = hash;
+        header.pixelBytes = static_cast<Uint64>(header.pitch) * header.height;
+
+        // Write under a temporary name and rename, so readers never see a half-written entry
+        const std::string cachePath = entryPath(path);
+        const std::string temporaryPath = cachePath + ".tmp";
+        bool ok = WriteFile(temporaryPath, header, prepared);
+        SDL_UnlockSurface(prepared);
+
+        ok = ok && SDL_RenamePath(temporaryPath.c_str(), cachePath.c_str());
+        if (!ok)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to write image cache entry for %s: %s", path.c_str(),
+                         SDL_GetError());
+            SDL_RemovePath(temporaryPath.c_str());
+            return false;
+        }
+
+        ++stats_.stores;
+        return true;
+    }
+
+    void DecodedImageCache::remove(const std::string& path)
+    {
+        SDL_RemovePath(entryPath(path).c_str());
+    }
+}
@@ -0,0 +1,237 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/resources/preload_pipeline.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_set>
+
+#include <SDL3/SDL_log.h>
+#include <SDL3_image/SDL_image.h>
+
+#include "psyengine/debug/assert.hpp"
+#include "psyengine/graphics/pixels.hpp"
+#include "psyengine/resources/texture_manager.hpp"
+#include "psyengine/utils/thread_pool.hpp"
+
+namespace psyengine::resources
+{
+    namespace
+    {
+        size_t DecodeThreadCount(const size_t requested)
+        {
+            if (requested != 0)
+            {
+                return requested;
+            }
+            // Leave a core for the main thread, which uploads and keeps rendering
+            const size_t cores = std::thread::hardware_concurrency();
+            return cores > 1 ? cores - 1 : 1;
+        }
+    }
+
+    PreloadPipeline::PreloadPipeline(const PreloadSettings& settings) :
+        settings_(settings),
+        reader_(std::make_unique<AsyncFileReader>(settings.reader)),
+        decoders_(std::make_unique<utils::ThreadPool>(DecodeThreadCount(settings.decodeThreads)))
+    {
+        settings_.maxPending = std::max<size_t>(settings_.maxPending, 1);
+    }
+
+    PreloadPipeline::~PreloadPipeline()
+    {
+        stop();
+    }
+
+    void PreloadPipeline::stop()
+    {
+        {
+            // Under the lock, so the reader cannot miss the wakeup between checking the flag and waiting
+            std::scoped_lock lock(mutex_);
+            cancelled_ = true;
+        }
+        readerThread_.request_stop();
+        changed_.notify_all();
+        if (readerThread_.joinable())
+        {
+            readerThread_.join();
+        }
+        decoders_->waitIdle();
+
+        for (const Decoded& decoded : ready_)
+        {
+            SDL_DestroySurface(decoded.surface);
+        }
+        ready_.clear();
+        pending_ = 0;
+    }
+
+    bool PreloadPipeline::start(const AssetManifest& manifest)
+    {
+        if (!finished())
+        {
+            return false;
+        }
+        stop();
+
+        paths_.clear();
+        std::unordered_set<std::string> seen;
+        const TextureManager& textures = TextureManager::instance();
+        for (const std::string& path : manifest.textures)
+        {
+            if (!textures.contains(path) && seen.insert(path).second)
+            {
+                paths_.push_back(path);
+            }
+        }
+
+        // Decoders prepare surfaces for the renderer the textures were last uploaded for; pump() corrects it
+        format_ = textures.loader().lastUploadFormat();
+        progress_ = PreloadProgress{};
+        progress_.total = paths_.size();
+        bytesRead_ = 0;
+        cancelled_ = false;
+        startTime_ = time::Now();
+        if (paths_.empty())
+        {
+            return true;
+        }
+
+        readerThread_ = std::jthread([this](const std::stop_token& stopToken)
+        {
+            reader_->readBatch(paths_, [this](FileReadResult& result) { onRead(result); }, stopToken);
+        });
+        return true;
+    }
+
+    void PreloadPipeline::onRead(FileReadResult& result)
+    {
+        // Runs on the reader thread; pausing here stops it from reading further ahead
+        {
+            std::unique_lock lock(mutex_);
+            changed_.wait(lock, [this] { return cancelled_ || pending_ < settings_.maxPending; });
+            if (cancelled_)
+            {
+                return;
+            }
+            ++pending_;
+        }
+
+        const size_t index = result.index;
+        if (!result.ok)
+        {
+            std::scoped_lock lock(mutex_);
+            ready_.push_back(Decoded{.index = index, .surface = nullptr, .format = SDL_PIXELFORMAT_UNKNOWN});
+            changed_.notify_all();
+            return;
+        }
+        bytesRead_ += result.buffer.size();
+
+        // std::function needs a copyable callable, so the buffer is shared with the task
+        auto buffer = std::make_shared<FileBuffer>(std::move(result.buffer));
+        decoders_->submit([this, index, buffer]
+        {
+            SDL_Surface* surface = cancelled_ ? nullptr : IMG_Load_IO(buffer->openIO(), true);
+            const SDL_PixelFormat format = format_;
+            if (surface != nullptr && format != SDL_PIXELFORMAT_UNKNOWN)
+            {
+                surface = TextureManager::instance().loader().prepare(surface, format);
+            }
+
+            std::scoped_lock lock(mutex_);
+            ready_.push_back(Decoded{.index = index, .surface = surface, .format = format});
+            changed_.notify_all();
+        });
+    }
+
+    size_t PreloadPipeline::pump(SDL_Renderer* renderer, const double budgetSeconds)
+    {
+        PSY_DEBUG_ASSERT(renderer != nullptr, "Renderer is null");
+
+        const time::TimePoint start = time::Now();
+        TextureManager& textures = TextureManager::instance();
+        TextureLoader& loader = textures.loader();
+        const SDL_PixelFormat format = loader.uploadFormat(renderer);
+        format_ = format;
+        size_t completed = 0;
+        while (true)
+        {
+            Decoded decoded;
+            {
+                std::scoped_lock lock(mutex_);
+                if (ready_.empty())
+                {
+                    break;
+                }
+                decoded = ready_.front();
+                ready_.pop_front();
+                --pending_;
+            }
+            changed_.notify_all();
+
+            const std::string& path = paths_[decoded.index];
+            // Surfaces decoded before the format was known are prepared here instead. Ones prepared for another
+            // renderer only need converting, their alpha is prepared already
+            SDL_Surface* surface = decoded.surface;
+            if (surface != nullptr && decoded.format == SDL_PIXELFORMAT_UNKNOWN)
+            {
+                surface = loader.prepare(surface, format);
+            }
+            else if (surface != nullptr && decoded.format != format)
+            {
+                surface = graphics::pixels::Convert(decoded.surface, format).release();
+                SDL_DestroySurface(decoded.surface);
+            }
+
+            SDL_Texture* texture = nullptr;
+            if (surface != nullptr)
+            {
+                texture = loader.upload(renderer, surface);
+                SDL_DestroySurface(surface);
+            }
+
+            if (texture != nullptr)
+            {
+                textures.insert(path, texture);
+                ++progress_.loaded;
+            }
+            else
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to preload texture %s", path.c_str());
+                ++progress_.failed;
+            }
+            ++completed;
+
+            if (time::ElapsedSince(start) >= budgetSeconds)
+            {
+                break;
+            }
+        }
+
+        progress_.bytesRead = bytesRead_;
+        if (completed != 0 || !finished())
+        {
+            progress_.elapsed = time::ElapsedSince(startTime_);
+        }
+        if (completed != 0 && progressCallback_)
+        {
+            progressCallback_(progress_);
+        }
+        return completed;
+    }
+
+    void PreloadPipeline::wait(SDL_Renderer* renderer)
+    {
+        while (!finished())
+        {
+            {
+                std::unique_lock lock(mutex_);
+                changed_.wait(lock, [this] { return !ready_.empty(); });
+            }
+            pump(renderer, std::numeric_limits<double>::infinity());
+        }
+    }
+}
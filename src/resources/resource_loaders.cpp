@@ -0,0 +1,105 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/resources/resource_loaders.hpp"
+
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+
+#include <SDL3/SDL_log.h>
+
+namespace psyengine::resources
+{
+    std::vector<std::byte>* DataLoader::load(const std::string& path)
+    {
+        size_t size = 0;
+        void* contents = SDL_LoadFile(path.c_str(), &size);
+        if (contents == nullptr)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to read %s: %s", path.c_str(), SDL_GetError());
+            return nullptr;
+        }
+
+        const auto* bytes = static_cast<const std::byte*>(contents);
+        auto* data = new std::vector<std::byte>(bytes, bytes + size);
+        SDL_free(contents);
+        return data;
+    }
+
+    void DataLoader::destroy(const std::vector<std::byte>* data)
+    {
+        delete data;
+    }
+
+#ifdef PSYENGINE_WITH_TTF
+    std::string FontLoader::key(const std::string& path, const float pointSize)
+    {
+        std::array<char, 32> size{};
+        std::snprintf(size.data(), size.size(), "@%g", static_cast<double>(pointSize));
+        return path + size.data();
+    }
+
+    TTF_Font* FontLoader::load(const std::string& key)
+    {
+        std::string path = key;
+        float pointSize = defaultPointSize_;
+        if (const size_t at = key.rfind('@'); at != std::string::npos)
+        {
+            char* end = nullptr;
+            const float parsed = std::strtof(key.c_str() + at + 1, &end);
+            if (end != key.c_str() + at + 1 && *end == '\0' && parsed > 0.0F)
+            {
+                path.resize(at);
+                pointSize = parsed;
+            }
+        }
+
+        TTF_Font* font = TTF_OpenFont(path.c_str(), pointSize);
+        if (font == nullptr)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to open font %s: %s", path.c_str(), SDL_GetError());
+        }
+        return font;
+    }
+
+    void FontLoader::destroy(TTF_Font* font)
+    {
+        TTF_CloseFont(font);
+    }
+#endif
+
+#ifdef PSYENGINE_WITH_MIXER
+    MIX_Audio* SoundLoader::load(const std::string& path)
+    {
+        MIX_Audio* audio = MIX_LoadAudio(mixer_, path.c_str(), predecode_);
+        if (audio == nullptr)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to load sound %s: %s", path.c_str(), SDL_GetError());
+        }
+        return audio;
+    }
+
+    void SoundLoader::destroy(MIX_Audio* audio)
+    {
+        MIX_DestroyAudio(audio);
+    }
+
+    size_t SoundLoader::cost(const MIX_Audio& audio) const
+    {
+        // The mixer API takes non-const pointers even for queries
+        auto* queried = const_cast<MIX_Audio*>(&audio);
+        SDL_AudioSpec spec{};
+        const Sint64 frames = MIX_GetAudioDuration(queried);
+        if (!predecode_ || frames <= 0 || !MIX_GetAudioFormat(queried, &spec))
+        {
+            return 0;
+        }
+        return static_cast<size_t>(frames) * static_cast<size_t>(SDL_AUDIO_FRAMESIZE(spec));
+    }
+#endif
+}
@@ -0,0 +1,105 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/server/world_context.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace psyengine::server
+{
+    namespace
+    {
+        thread_local WorldContext* CurrentWorld = nullptr;
+
+        constexpr double NANOSECONDS_PER_SECOND = 1'000'000'000.0;
+        constexpr double SECONDS_PER_MILLISECOND = 0.001;
+    }
+
+    WorldContext::WorldContext(std::string name, const size_t tickRate) :
+        name_(std::move(name)), tickRate_(std::max<size_t>(1, tickRate)), pendingTickRate_(tickRate_)
+    {
+        clock_.start();
+    }
+
+    WorldContext::~WorldContext()
+    {
+        // States may reach for current() in onExit
+        WorldContext* previous = std::exchange(CurrentWorld, this);
+        states_.clear();
+        CurrentWorld = previous;
+    }
+
+    WorldContext* WorldContext::current() noexcept
+    {
+        return CurrentWorld;
+    }
+
+    void WorldContext::postEvent(const SDL_Event& event)
+    {
+        std::scoped_lock lock(inboxMutex_);
+        inbox_.push_back(event);
+    }
+
+    void WorldContext::tick()
+    {
+        WorldContext* previous = std::exchange(CurrentWorld, this);
+
+        if (const size_t pending = pendingTickRate_.load(std::memory_order_relaxed); pending != tickRate_)
+        {
+            states_.fixedUpdateFrequencyChanged(std::exchange(tickRate_, pending), pending);
+        }
+
+        {
+            std::scoped_lock lock(inboxMutex_);
+            processing_.swap(inbox_);
+        }
+
+        for (const auto& event : processing_)
+        {
+            input_.handleEvent(event);
+            states_.handleEvent(event);
+        }
+        processing_.clear();
+
+        input_.update();
+        states_.fixedUpdate(tickStep());
+        ++tickCount_;
+
+        if (tickHashLog_ != nullptr)
+        {
+            tickHashLog_->recordStates(tickCount_, states_);
+        }
+
+        CurrentWorld = previous;
+    }
+
+    void WorldContext::recordTick(const double latency, const double duration)
+    {
+        std::scoped_lock lock(statsMutex_);
+        latencyHistogram_.record(static_cast<Uint64>(std::max(0.0, latency) * NANOSECONDS_PER_SECOND));
+        totalDuration_ += duration;
+
+        ++stats_.ticks;
+        stats_.lastLatency = latency;
+        stats_.lastDuration = duration;
+    }
+
+    void WorldContext::recordDroppedTicks(const Uint64 count)
+    {
+        std::scoped_lock lock(statsMutex_);
+        stats_.droppedTicks += count;
+    }
+
+    WorldStats WorldContext::stats() const
+    {
+        std::scoped_lock lock(statsMutex_);
+        WorldStats result = stats_;
+        result.meanLatency = latencyHistogram_.meanMs() * SECONDS_PER_MILLISECOND;
+        result.p99Latency = latencyHistogram_.percentileMs(99.0) * SECONDS_PER_MILLISECOND;
+        result.maxLatency = latencyHistogram_.maxMs() * SECONDS_PER_MILLISECOND;
+        result.meanDuration = result.ticks == 0 ? 0.0 : totalDuration_ / static_cast<double>(result.ticks);
+        return result;
+    }
+}
@@ -0,0 +1,219 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/server/world_scheduler.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace psyengine::server
+{
+    namespace
+    {
+        using Seconds = std::chrono::duration<double>;
+    }
+
+    WorldScheduler::WorldScheduler(const size_t threadCount, const size_t maxCatchUpTicks) :
+        maxCatchUpTicks_(std::max<size_t>(1, maxCatchUpTicks)), pool_(threadCount) {}
+
+    WorldScheduler::~WorldScheduler()
+    {
+        stop();
+    }
+
+    void WorldScheduler::addWorld(std::shared_ptr<WorldContext> world)
+    {
+        if (!world)
+        {
+            return;
+        }
+
+        {
+            std::scoped_lock lock(mutex_);
+            if (findRegistration(world.get()) != nullptr)
+            {
+                return;
+            }
+            const Uint64 generation = ++nextGeneration_;
+            worlds_.push_back({.world = world, .generation = generation});
+
+            // A tick left over from a previous registration queues the first one when it finishes
+            if (std::ranges::find(ticking_, world.get()) != ticking_.end())
+            {
+                return;
+            }
+            queue_.push({.deadline = ClockType::now(), .world = std::move(world), .generation = generation});
+        }
+        wakeup_.notify_one();
+    }
+
+    bool WorldScheduler::removeWorld(const WorldContext* world)
+    {
+        std::scoped_lock lock(mutex_);
+        const auto it = std::ranges::find(worlds_, world, [](const Registration& r) { return r.world.get(); });
+        if (it == worlds_.end())
+        {
+            return false;
+        }
+
+        // The queue entry is discarded lazily when it comes due; its generation no longer matches
+        worlds_.erase(it);
+        return true;
+    }
+
+    void WorldScheduler::start()
+    {
+        if (dispatcher_.joinable())
+        {
+            return;
+        }
+
+        {
+            // Worlds added while stopped should not try to catch up on the idle time
+            std::scoped_lock lock(mutex_);
+            std::vector<Entry> entries;
+            while (!queue_.empty())
+            {
+                entries.push_back(queue_.top());
+                queue_.pop();
+            }
+            const auto now = ClockType::now();
+            for (auto& entry : entries)
+            {
+                entry.deadline = std::max(entry.deadline, now);
+                queue_.push(std::move(entry));
+            }
+        }
+
+        dispatcher_ = std::jthread([this](const std::stop_token& stopToken)
+        {
+            dispatchLoop(stopToken);
+        });
+    }
+
+    void WorldScheduler::stop()
+    {
+        if (!dispatcher_.joinable())
+        {
+            return;
+        }
+
+        dispatcher_.request_stop();
+        wakeup_.notify_all();
+        dispatcher_.join();
+        dispatcher_ = {};
+
+        pool_.waitIdle();
+    }
+
+    size_t WorldScheduler::worldCount() const
+    {
+        std::scoped_lock lock(mutex_);
+        return worlds_.size();
+    }
+
+    std::vector<std::shared_ptr<WorldContext>> WorldScheduler::worlds() const
+    {
+        std::scoped_lock lock(mutex_);
+        std::vector<std::shared_ptr<WorldContext>> worlds;
+        worlds.reserve(worlds_.size());
+        for (const Registration& registration : worlds_)
+        {
+            worlds.push_back(registration.world);
+        }
+        return worlds;
+    }
+
+    const WorldScheduler::Registration* WorldScheduler::findRegistration(const WorldContext* world) const
+    {
+        const auto it = std::ranges::find(worlds_, world, [](const Registration& r) { return r.world.get(); });
+        return it != worlds_.end() ? &*it : nullptr;
+    }
+
+    bool WorldScheduler::isCurrent(const Entry& entry) const
+    {
+        const Registration* registration = findRegistration(entry.world.get());
+        return registration != nullptr && registration->generation == entry.generation;
+    }
+
+    void WorldScheduler::dispatchLoop(const std::stop_token& stopToken)
+    {
+        std::unique_lock lock(mutex_);
+        while (!stopToken.stop_requested())
+        {
+            if (queue_.empty())
+            {
+                wakeup_.wait(lock, stopToken, [this] { return !queue_.empty(); });
+                continue;
+            }
+
+            const auto deadline = queue_.top().deadline;
+            if (ClockType::now() < deadline)
+            {
+                // Wakes early when a world with an earlier deadline is added or on stop
+                wakeup_.wait_until(lock, stopToken, deadline, [this, deadline]
+                {
+                    return !queue_.empty() && queue_.top().deadline < deadline;
+                });
+                continue;
+            }
+
+            Entry entry = queue_.top();
+            queue_.pop();
+            if (!isCurrent(entry))
+            {
+                continue;
+            }
+
+            ticking_.push_back(entry.world.get());
+            pool_.submit([this, entry = std::move(entry)]() mutable
+            {
+                runTick(std::move(entry));
+            });
+        }
+    }
+
+    void WorldScheduler::runTick(Entry entry)
+    {
+        WorldContext& world = *entry.world;
+        const auto started = ClockType::now();
+        world.tick();
+        const auto finished = ClockType::now();
+
+        // The pending rate, read after the tick, so a rate change made during it schedules the next tick at the
+        // new rate; the next tick applies it before simulating
+        const auto step = std::chrono::duration_cast<ClockType::duration>(Seconds(world.nextTickStep()));
+
+        world.recordTick(Seconds(started - entry.deadline).count(), Seconds(finished - started).count());
+
+        auto next = entry.deadline + step;
+        if (finished - next > step * static_cast<ClockType::rep>(maxCatchUpTicks_))
+        {
+            const auto behind = static_cast<Uint64>((finished - next) / step);
+            world.recordDroppedTicks(behind);
+            next += step * static_cast<ClockType::rep>(behind);
+        }
+        entry.deadline = next;
+
+        {
+            std::scoped_lock lock(mutex_);
+            std::erase(ticking_, &world);
+
+            // Requeued even when stopped, so that start() picks the world up again
+            const Registration* registration = findRegistration(&world);
+            if (registration == nullptr)
+            {
+                return;
+            }
+            if (registration->generation != entry.generation)
+            {
+                // Removed and added back during the tick: the new registration starts now
+                entry.deadline = finished;
+                entry.generation = registration->generation;
+            }
+            queue_.push(std::move(entry));
+        }
+        wakeup_.notify_one();
+    }
+}
@@ -0,0 +1,85 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/state/loading_state.hpp"
+
+#include <utility>
+
+#include <SDL3/SDL_log.h>
+#include <SDL3/SDL_render.h>
+
+#include "psyengine/debug/assert.hpp"
+#include "psyengine/graphics/render_context.hpp"
+#include "psyengine/resources/texture_manager.hpp"
+#include "psyengine/state/state_manager.hpp"
+
+namespace psyengine::state
+{
+    LoadingState::LoadingState(std::unique_ptr<BaseState> next, const resources::PreloadSettings& settings) :
+        next_(std::move(next)),
+        pipeline_(settings)
+    {
+        PSY_ASSERT(next_ != nullptr, "Next state is null");
+    }
+
+    bool LoadingState::onEnter()
+    {
+        resources::AssetManifest manifest;
+        next_->declareAssets(manifest);
+        return pipeline_.start(manifest);
+    }
+
+    void LoadingState::update([[maybe_unused]] const double deltaTime)
+    {
+        if (!pipeline_.finished())
+        {
+            return;
+        }
+
+        const resources::PreloadProgress& progress = pipeline_.progress();
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+        SDL_Log("Preloaded %zu assets (%zu failed), %.1f MB in %.2f s: %.1f MB/s, %.0f assets/s", progress.loaded,
+                progress.failed, static_cast<double>(progress.bytesRead) / (1024.0 * 1024.0), progress.elapsed,
+                progress.megabytesPerSecond(), progress.assetsPerSecond());
+
+        // Replacing the top state destroys this one, so nothing may touch members afterwards
+        std::unique_ptr<BaseState> next = std::move(next_);
+        StateManager::instance().replaceTopState(std::move(next));
+    }
+
+    void LoadingState::render(graphics::RenderContext& context, [[maybe_unused]] const float interpolationFactor)
+    {
+        // The pipeline creates textures through the loader, so its uploads are counted from the loader's stats
+        const resources::TextureManager& textures = resources::TextureManager::instance();
+        const resources::TextureUploadStats before = textures.uploadStats();
+        pipeline_.pump(context.renderer(), uploadBudget_);
+        if (const resources::TextureUploadStats after = textures.uploadStats(); after.uploads > before.uploads)
+        {
+            context.recordUpload(after.bytes - before.bytes, static_cast<size_t>(after.uploads - before.uploads));
+        }
+        renderProgress(context, pipeline_.progress());
+    }
+
+    void LoadingState::renderProgress(graphics::RenderContext& context, const resources::PreloadProgress& progress)
+    {
+        int width = 0;
+        int height = 0;
+        SDL_GetCurrentRenderOutputSize(context.renderer(), &width, &height);
+
+        context.setDrawColor(0, 0, 0, SDL_ALPHA_OPAQUE);
+        context.clear();
+
+        const float barWidth = static_cast<float>(width) * 0.6F;
+        const float barHeight = static_cast<float>(height) * 0.03F;
+        const SDL_FRect outline{
+            (static_cast<float>(width) - barWidth) * 0.5F, (static_cast<float>(height) - barHeight) * 0.5F, barWidth,
+            barHeight
+        };
+        const SDL_FRect fill{outline.x, outline.y, barWidth * progress.fraction(), barHeight};
+
+        context.setDrawColor(255, 255, 255, SDL_ALPHA_OPAQUE);
+        context.renderFillRect(&fill);
+        context.renderRect(&outline);
+    }
+}
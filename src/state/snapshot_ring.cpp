@@ -0,0 +1,142 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/state/snapshot_ring.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "psyengine/debug/assert.hpp"
+#include "psyengine/time/time.hpp"
+
+namespace psyengine::state
+{
+    SnapshotRing::SnapshotRing(const size_t frameCount) :
+        frames_(std::max<size_t>(1, frameCount)) {}
+
+    SnapshotRing::RegionId SnapshotRing::addRegion(void* data, const size_t size)
+    {
+        PSY_ASSERT(data != nullptr || size == 0, "Snapshot region must not be null");
+
+        const RegionId id = nextId_++;
+        regions_.push_back({.id = id, .data = static_cast<std::byte*>(data), .size = size, .offset = 0});
+        relayout();
+        return id;
+    }
+
+    bool SnapshotRing::removeRegion(const RegionId id)
+    {
+        const auto it = std::ranges::find(regions_, id, &Region::id);
+        if (it == regions_.end())
+        {
+            return false;
+        }
+
+        regions_.erase(it);
+        relayout();
+        return true;
+    }
+
+    void SnapshotRing::clear()
+    {
+        regions_.clear();
+        relayout();
+    }
+
+    void SnapshotRing::capture(const Uint64 tick)
+    {
+        const time::TimePoint start = time::Now();
+
+        Frame& frame = frames_[tick % frames_.size()];
+        for (const auto& region : regions_)
+        {
+            std::memcpy(frame.bytes.data() + region.offset, region.data, region.size);
+        }
+        frame.tick = tick;
+
+        lastCaptureTime_ = time::ElapsedSince(start);
+    }
+
+    bool SnapshotRing::restore(const Uint64 tick)
+    {
+        const Frame* frame = find(tick);
+        if (frame == nullptr)
+        {
+            return false;
+        }
+
+        const time::TimePoint start = time::Now();
+        for (const auto& region : regions_)
+        {
+            std::memcpy(region.data, frame->bytes.data() + region.offset, region.size);
+        }
+        lastRestoreTime_ = time::ElapsedSince(start);
+        return true;
+    }
+
+    bool SnapshotRing::contains(const Uint64 tick) const noexcept
+    {
+        return frames_[tick % frames_.size()].tick == tick;
+    }
+
+    std::optional<Uint64> SnapshotRing::oldestTick() const noexcept
+    {
+        std::optional<Uint64> oldest;
+        for (const auto& frame : frames_)
+        {
+            if (frame.tick && (!oldest || *frame.tick < *oldest))
+            {
+                oldest = frame.tick;
+            }
+        }
+        return oldest;
+    }
+
+    std::optional<Uint64> SnapshotRing::newestTick() const noexcept
+    {
+        std::optional<Uint64> newest;
+        for (const auto& frame : frames_)
+        {
+            if (frame.tick && (!newest || *frame.tick > *newest))
+            {
+                newest = frame.tick;
+            }
+        }
+        return newest;
+    }
+
+    void SnapshotRing::discardAfter(const Uint64 tick) noexcept
+    {
+        for (auto& frame : frames_)
+        {
+            if (frame.tick && *frame.tick > tick)
+            {
+                frame.tick.reset();
+            }
+        }
+    }
+
+    void SnapshotRing::relayout()
+    {
+        // Regions are packed back to back so a frame is one allocation
+        totalSize_ = 0;
+        for (auto& region : regions_)
+        {
+            region.offset = totalSize_;
+            totalSize_ += region.size;
+        }
+
+        for (auto& frame : frames_)
+        {
+            frame.tick.reset();
+            frame.bytes.resize(totalSize_);
+        }
+    }
+
+    SnapshotRing::Frame* SnapshotRing::find(const Uint64 tick) noexcept
+    {
+        Frame& frame = frames_[tick % frames_.size()];
+        return frame.tick == tick ? &frame : nullptr;
+    }
+}
@@ -14,6 +14,11 @@ namespace psyengine::state
         return inst;
     }
 
+    StateManager::~StateManager()
+    {
+        clear();
+    }
+
     void StateManager::handleEvent(const SDL_Event& event) const
     {
         if (states_.empty())
@@ -44,7 +49,41 @@ namespace psyengine::state
         states_.back()->update(deltaTime);
     }
 
-    void StateManager::render(SDL_Renderer * const renderer, const float interpolationFactor)
+    void StateManager::lateUpdate(const double deltaTime) const
+    {
+        if (states_.empty())
+        {
+            return;
+        }
+
+        states_.back()->lateUpdate(deltaTime);
+    }
+
+    void StateManager::fixedUpdateFrequencyChanged(const size_t oldFrequency, const size_t newFrequency) const
+    {
+        for (const auto& state : states_)
+        {
+            state->onFixedUpdateFrequencyChanged(oldFrequency, newFrequency);
+        }
+    }
+
+    void StateManager::hashSimulation(utils::Hasher& hasher) const
+    {
+        for (const auto& state : states_)
+        {
+            state->hashSimulation(hasher);
+        }
+    }
+
+    void StateManager::snapshotRestored(const Uint64 tick) const
+    {
+        for (const auto& state : states_)
+        {
+            state->onSnapshotRestored(tick);
+        }
+    }
+
+    void StateManager::render(graphics::RenderContext& context, const float interpolationFactor)
     const
     {
         if (states_.empty())
@@ -52,7 +91,7 @@ namespace psyengine::state
             return;
         }
 
-        states_.back()->render(renderer, interpolationFactor);
+        states_.back()->render(context, interpolationFactor);
     }
 
     bool StateManager::pushState(std::unique_ptr<BaseState> state)
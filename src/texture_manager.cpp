@@ -5,37 +5,327 @@
 #include "psyengine/resources/texture_manager.hpp"
 
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <SDL3/SDL_init.h>
+#include <SDL3/SDL_log.h>
 #include <SDL3_image/SDL_image.h>
 
 #include "psyengine/debug/assert.hpp"
+#include "psyengine/graphics/pixels.hpp"
+#include "psyengine/resources/asset_pack.hpp"
+#include "psyengine/resources/async_file_reader.hpp"
 
 namespace psyengine::resources
 {
+    namespace
+    {
+        /// Runs a callable on the main thread and waits for it; runs it directly when already there.
+        template <typename Func>
+        void RunOnMainThread(Func&& func)
+        {
+            if (SDL_IsMainThread())
+            {
+                func();
+                return;
+            }
+
+            SDL_RunOnMainThread([](void* userdata) { (*static_cast<std::remove_reference_t<Func>*>(userdata))(); },
+                                &func, true);
+        }
+    }
+
     TextureManager& TextureManager::instance()
     {
         static TextureManager inst;
         return inst;
     }
 
-    std::shared_ptr<SDL_Texture> TextureManager::loadTexture(const std::string& path, SDL_Renderer* renderer)
+    SDL_Texture* TextureLoader::load(const std::string& path, SDL_Renderer* renderer)
     {
         PSY_DEBUG_ASSERT(renderer != nullptr, "Renderer is null");
         PSY_DEBUG_ASSERT(!path.empty(), "Path is empty");
 
-        const auto it = textures_.find(path);
-        if (it != std::end(textures_))
+        const SDL_PixelFormat format = uploadFormat(renderer);
+        SDL_Surface* surface = nullptr;
+        if (hasDiskCache())
+        {
+            size_t size = 0;
+            void* contents = SDL_LoadFile(path.c_str(), &size);
+            if (contents == nullptr)
+            {
+                return nullptr;
+            }
+
+            const std::span bytes(static_cast<const std::byte*>(contents), size);
+            SDL_Texture* cached = nullptr;
+            RunOnMainThread([&]
+            {
+                std::scoped_lock lock(diskMutex_);
+                cached = diskCache_ != nullptr ? diskCache_->loadTexture(path, renderer, bytes) : nullptr;
+            });
+
+            surface = cached == nullptr ? decodeAndStore(path, format, bytes) : nullptr;
+            SDL_free(contents);
+            if (cached != nullptr)
+            {
+                return cached;
+            }
+        }
+        else if (SDL_Surface* decoded = IMG_Load(path.c_str()))
+        {
+            surface = prepare(decoded, format);
+        }
+
+        if (surface == nullptr)
+        {
+            return nullptr;
+        }
+
+        SDL_Texture* texture = nullptr;
+        RunOnMainThread([&] { texture = upload(renderer, surface); });
+        SDL_DestroySurface(surface);
+        return texture;
+    }
+
+    SDL_PixelFormat TextureLoader::uploadFormat(SDL_Renderer* renderer)
+    {
+        const SDL_PixelFormat format = DecodedImageCache::PreferredFormat(renderer);
+        lastFormat_.store(format, std::memory_order_relaxed);
+        return format;
+    }
+
+    SDL_Surface* TextureLoader::prepare(SDL_Surface* decoded, const SDL_PixelFormat format)
+    {
+        PSY_DEBUG_ASSERT(decoded != nullptr, "Surface is null");
+
+        const time::TimePoint start = time::Now();
+        SDL_Surface* surface = decoded;
+        if (decoded->format != format)
+        {
+            surface = graphics::pixels::Convert(decoded, format).release();
+            SDL_DestroySurface(decoded);
+        }
+
+        // The SIMD kernels cover the 32-bit formats renderers prefer; SDL handles anything else
+        if (surface != nullptr && premultipliesAlpha() && SDL_ISPIXELFORMAT_ALPHA(format) &&
+            !graphics::pixels::Premultiply(surface) && !SDL_PremultiplySurfaceAlpha(surface, false))
+        {
+            SDL_DestroySurface(surface);
+            surface = nullptr;
+        }
+        if (surface == nullptr)
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to convert image: %s", SDL_GetError());
+            return nullptr;
+        }
+
+        prepareTicks_.fetch_add(time::Now() - start, std::memory_order_relaxed);
+        prepared_.fetch_add(1, std::memory_order_relaxed);
+        return surface;
+    }
+
+    SDL_Texture* TextureLoader::upload(SDL_Renderer* renderer, SDL_Surface* prepared)
+    {
+        PSY_DEBUG_ASSERT(renderer != nullptr, "Renderer is null");
+        PSY_DEBUG_ASSERT(prepared != nullptr, "Surface is null");
+
+        const time::TimePoint start = time::Now();
+        SDL_Texture* texture = SDL_CreateTexture(renderer, prepared->format, SDL_TEXTUREACCESS_STATIC, prepared->w,
+                                                 prepared->h);
+        if (texture == nullptr || !SDL_UpdateTexture(texture, nullptr, prepared->pixels, prepared->pitch))
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to upload texture: %s", SDL_GetError());
+            SDL_DestroyTexture(texture);
+            return nullptr;
+        }
+        SDL_SetTextureBlendMode(texture,
+                                premultipliesAlpha() ? SDL_BLENDMODE_BLEND_PREMULTIPLIED : SDL_BLENDMODE_BLEND);
+
+        uploadTicks_.fetch_add(time::Now() - start, std::memory_order_relaxed);
+        uploadBytes_.fetch_add(static_cast<Uint64>(prepared->pitch) * static_cast<Uint64>(prepared->h),
+                               std::memory_order_relaxed);
+        uploads_.fetch_add(1, std::memory_order_relaxed);
+        return texture;
+    }
+
+    TextureUploadStats TextureLoader::uploadStats() const noexcept
+    {
+        return TextureUploadStats{
+            .prepared = prepared_.load(std::memory_order_relaxed),
+            .uploads = uploads_.load(std::memory_order_relaxed),
+            .bytes = uploadBytes_.load(std::memory_order_relaxed),
+            .prepareSeconds = time::TicksToSeconds(prepareTicks_.load(std::memory_order_relaxed)),
+            .uploadSeconds = time::TicksToSeconds(uploadTicks_.load(std::memory_order_relaxed))
+        };
+    }
+
+    void TextureLoader::destroy(SDL_Texture* texture)
+    {
+        if (SDL_IsMainThread())
+        {
+            SDL_DestroyTexture(texture);
+            return;
+        }
+
+        // Queued without waiting: the main thread may itself be waiting on the worker that released the texture
+        if (!SDL_RunOnMainThread([](void* userdata) { SDL_DestroyTexture(static_cast<SDL_Texture*>(userdata)); },
+                                 texture, false))
+        {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to queue texture destruction: %s", SDL_GetError());
+        }
+    }
+
+    size_t TextureLoader::cost(const SDL_Texture& texture) const noexcept
+    {
+        return static_cast<size_t>(texture.w) * static_cast<size_t>(texture.h) *
+            static_cast<size_t>(SDL_BYTESPERPIXEL(texture.format));
+    }
+
+    SDL_Texture* TextureLoader::loadCached(const std::string& path, SDL_Renderer* renderer)
+    {
+        std::scoped_lock lock(diskMutex_);
+        return diskCache_ != nullptr ? diskCache_->loadTexture(path, renderer) : nullptr;
+    }
+
+    size_t TextureManager::loadTextures(const std::span<const std::string> paths, SDL_Renderer* renderer,
+                                        AsyncFileReader& reader)
+    {
+        PSY_DEBUG_ASSERT(renderer != nullptr, "Renderer is null");
+
+        std::vector<std::string> missing;
+        size_t loaded = 0;
+        for (const std::string& path : paths)
+        {
+            if (contains(path))
+            {
+                ++loaded;
+                continue;
+            }
+
+            if (SDL_Texture* cached = loader().loadCached(path, renderer); cached != nullptr)
+            {
+                insert(path, cached);
+                ++loaded;
+            }
+            else
+            {
+                missing.push_back(path);
+            }
+        }
+
+        TextureLoader& textureLoader = loader();
+        reader.readBatch(missing, [&](FileReadResult& result)
+        {
+            const std::string& path = missing[result.index];
+            if (!result.ok)
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to read texture %s", path.c_str());
+                return;
+            }
+
+            SDL_Texture* texture = textureLoader.decodeAndUpload(path, renderer, result.buffer.data());
+            if (texture == nullptr)
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to decode texture %s: %s", path.c_str(),
+                             SDL_GetError());
+                return;
+            }
+
+            insert(path, texture);
+            ++loaded;
+        });
+        return loaded;
+    }
+
+    size_t TextureManager::loadPack(AssetPack& pack, SDL_Renderer* renderer, utils::ThreadPool& threads)
+    {
+        PSY_DEBUG_ASSERT(renderer != nullptr, "Renderer is null");
+
+        TextureLoader& textureLoader = loader();
+        const SDL_PixelFormat format = textureLoader.uploadFormat(renderer);
+        size_t uploaded = 0;
+        pack.loadSurfaces(threads, [&](LoadedSurface& loaded)
         {
-            return it->second;
+            const std::string& name = pack.entries()[loaded.index].name;
+            SDL_Surface* surface = textureLoader.prepare(loaded.surface, format);
+            SDL_Texture* texture = surface != nullptr ? textureLoader.upload(renderer, surface) : nullptr;
+            SDL_DestroySurface(surface);
+            if (texture == nullptr)
+            {
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg) — SDL logging uses C-style varargs by design
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Failed to upload texture %s: %s", name.c_str(),
+                             SDL_GetError());
+                return;
+            }
+
+            insert(name, texture);
+            ++uploaded;
+        });
+        return uploaded;
+    }
+
+    void TextureLoader::setDiskCache(std::unique_ptr<DecodedImageCache> cache)
+    {
+        std::scoped_lock lock(diskMutex_);
+        diskCache_ = std::move(cache);
+        if (diskCache_ != nullptr)
+        {
+            diskCache_->setPremultipliedAlpha(premultipliesAlpha());
         }
+    }
 
-        const auto texture = IMG_LoadTexture(renderer, path.c_str());
-        if (texture == nullptr)
+    void TextureLoader::setPremultiplyAlpha(const bool premultiply)
+    {
+        std::scoped_lock lock(diskMutex_);
+        premultiply_.store(premultiply, std::memory_order_relaxed);
+        if (diskCache_ != nullptr)
+        {
+            diskCache_->setPremultipliedAlpha(premultiply);
+        }
+    }
+
+    bool TextureLoader::hasDiskCache() const
+    {
+        std::scoped_lock lock(diskMutex_);
+        return diskCache_ != nullptr;
+    }
+
+    SDL_Surface* TextureLoader::decodeAndStore(const std::string& path, const SDL_PixelFormat format,
+                                                const std::span<const std::byte> contents)
+    {
+        SDL_Surface* decoded = IMG_Load_IO(SDL_IOFromConstMem(contents.data(), contents.size()), true);
+        SDL_Surface* surface = decoded != nullptr ? prepare(decoded, format) : nullptr;
+        if (surface == nullptr)
+        {
+            return nullptr;
+        }
+
+        std::scoped_lock lock(diskMutex_);
+        if (diskCache_ != nullptr)
+        {
+            diskCache_->store(path, surface, contents);
+        }
+        return surface;
+    }
+
+    SDL_Texture* TextureLoader::decodeAndUpload(const std::string& path, SDL_Renderer* renderer,
+                                                const std::span<const std::byte> contents)
+    {
+        SDL_Surface* surface = decodeAndStore(path, uploadFormat(renderer), contents);
+        if (surface == nullptr)
         {
             return nullptr;
         }
 
-        auto texturePtr = std::shared_ptr<SDL_Texture>(texture, SDL_DestroyTexture);
-        textures_[path] = texturePtr;
-        return texturePtr;
+        SDL_Texture* texture = upload(renderer, surface);
+        SDL_DestroySurface(surface);
+        return texture;
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,250 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/utils/hash.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+#include <SDL3/SDL_cpuinfo.h>
+#include <SDL3/SDL_endian.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#define PSY_HASH_AVX2 1
+#if defined(__GNUC__) || defined(__clang__)
+#define PSY_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define PSY_TARGET_AVX2
+#endif
+#endif
+
+namespace psyengine::utils
+{
+    namespace
+    {
+        constexpr size_t STRIPES_PER_BLOCK = 16;
+
+        constexpr Uint64 PRIME32_1 = 0x9E3779B1U;
+        constexpr Uint64 PRIME32_2 = 0x85EBCA77U;
+        constexpr Uint64 PRIME32_3 = 0xC2B2AE3DU;
+        constexpr Uint64 PRIME64_1 = 0x9E3779B185EBCA87ULL;
+        constexpr Uint64 PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+        constexpr Uint64 PRIME64_3 = 0x165667B19E3779F9ULL;
+        constexpr Uint64 PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+        constexpr Uint64 PRIME64_5 = 0x27D4EB2F165667C5ULL;
+
+        // Stripe n of a block keys lanes with SECRET[n .. n + 7]; the scramble and merge use the words after that
+        constexpr size_t SCRAMBLE_OFFSET = STRIPES_PER_BLOCK + Hasher::LANE_COUNT;
+        constexpr size_t MERGE_OFFSET = SCRAMBLE_OFFSET + Hasher::LANE_COUNT;
+        constexpr size_t SECRET_SIZE = MERGE_OFFSET + Hasher::LANE_COUNT;
+
+        constexpr std::array<Uint64, SECRET_SIZE> SECRET = []
+        {
+            // SplitMix64 keeps the words well distributed without pasting a table
+            std::array<Uint64, SECRET_SIZE> secret{};
+            Uint64 state = PRIME64_5;
+            for (auto& word : secret)
+            {
+                state += 0x9E3779B97F4A7C15ULL;
+                Uint64 z = state;
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                word = z ^ (z >> 31);
+            }
+            return secret;
+        }();
+
+        constexpr Uint64 Avalanche(Uint64 h) noexcept
+        {
+            h ^= h >> 37;
+            h *= 0x165667919E3779F9ULL;
+            h ^= h >> 32;
+            return h;
+        }
+
+        Uint64 Load64(const Uint8* data) noexcept
+        {
+            Uint64 value;
+            std::memcpy(&value, data, sizeof(value));
+            return SDL_Swap64LE(value);
+        }
+
+        using AccumulateFn = void (*)(Uint64* lanes, const Uint8* data, const Uint64* secret, size_t stripeCount);
+
+        void AccumulateScalar(Uint64* lanes, const Uint8* data, const Uint64* secret, const size_t stripeCount)
+        {
+            for (size_t s = 0; s < stripeCount; ++s)
+            {
+                const Uint8* stripe = data + s * Hasher::STRIPE_SIZE;
+                for (size_t i = 0; i < Hasher::LANE_COUNT; ++i)
+                {
+                    const Uint64 value = Load64(stripe + i * sizeof(Uint64));
+                    const Uint64 keyed = value ^ secret[s + i];
+                    lanes[i ^ 1] += value;
+                    lanes[i] += (keyed & 0xFFFFFFFFU) * (keyed >> 32);
+                }
+            }
+        }
+
+#ifdef PSY_HASH_AVX2
+        PSY_TARGET_AVX2
+        void AccumulateAvx2(Uint64* lanes, const Uint8* data, const Uint64* secret, const size_t stripeCount)
+        {
+            // Same arithmetic as the scalar kernel, four lanes per register; x86 is little-endian already
+            __m256i acc[2] = {
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes + 4)),
+            };
+
+            for (size_t s = 0; s < stripeCount; ++s)
+            {
+                const Uint8* stripe = data + s * Hasher::STRIPE_SIZE;
+                for (size_t half = 0; half < 2; ++half)
+                {
+                    const __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(stripe + half * 32));
+                    const __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret + s + half * 4));
+                    const __m256i keyed = _mm256_xor_si256(value, key);
+                    const __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+                    const __m256i swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+                    acc[half] = _mm256_add_epi64(acc[half], _mm256_add_epi64(product, swapped));
+                }
+            }
+
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc[0]);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes + 4), acc[1]);
+        }
+#endif
+
+        AccumulateFn SelectKernel() noexcept
+        {
+#ifdef PSY_HASH_AVX2
+            if (SDL_HasAVX2())
+            {
+                return &AccumulateAvx2;
+            }
+#endif
+            return &AccumulateScalar;
+        }
+
+        AccumulateFn Accumulate() noexcept
+        {
+            static const AccumulateFn KERNEL = SelectKernel();
+            return KERNEL;
+        }
+
+        void Scramble(std::array<Uint64, Hasher::LANE_COUNT>& lanes) noexcept
+        {
+            for (size_t i = 0; i < Hasher::LANE_COUNT; ++i)
+            {
+                Uint64 lane = lanes[i];
+                lane ^= lane >> 47;
+                lane ^= SECRET[SCRAMBLE_OFFSET + i];
+                lanes[i] = lane * PRIME32_1;
+            }
+        }
+    }
+
+    Hasher::Hasher(const Uint64 seed) noexcept
+    {
+        reset(seed);
+    }
+
+    void Hasher::reset(const Uint64 seed) noexcept
+    {
+        lanes_ = {
+            PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3,
+            PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1
+        };
+        for (size_t i = 0; i < LANE_COUNT; ++i)
+        {
+            lanes_[i] += (i % 2 == 0) ? seed : 0 - seed;
+        }
+
+        buffered_ = 0;
+        stripesInBlock_ = 0;
+        totalSize_ = 0;
+        seed_ = seed;
+    }
+
+    void Hasher::update(const void* data, size_t size) noexcept
+    {
+        auto bytes = static_cast<const Uint8*>(data);
+        totalSize_ += size;
+
+        if (buffered_ > 0)
+        {
+            const size_t fill = std::min(size, STRIPE_SIZE - buffered_);
+            std::memcpy(buffer_.data() + buffered_, bytes, fill);
+            buffered_ += fill;
+            bytes += fill;
+            size -= fill;
+
+            if (buffered_ < STRIPE_SIZE)
+            {
+                return;
+            }
+            consumeStripes(buffer_.data(), 1);
+            buffered_ = 0;
+        }
+
+        const size_t stripes = size / STRIPE_SIZE;
+        consumeStripes(bytes, stripes);
+        bytes += stripes * STRIPE_SIZE;
+        size -= stripes * STRIPE_SIZE;
+
+        if (size > 0)
+        {
+            std::memcpy(buffer_.data(), bytes, size);
+            buffered_ = size;
+        }
+    }
+
+    void Hasher::consumeStripes(const Uint8* data, size_t stripeCount) noexcept
+    {
+        const AccumulateFn accumulate = Accumulate();
+        while (stripeCount > 0)
+        {
+            const size_t count = std::min(stripeCount, STRIPES_PER_BLOCK - stripesInBlock_);
+            accumulate(lanes_.data(), data, SECRET.data() + stripesInBlock_, count);
+
+            data += count * STRIPE_SIZE;
+            stripeCount -= count;
+            stripesInBlock_ += count;
+
+            if (stripesInBlock_ == STRIPES_PER_BLOCK)
+            {
+                Scramble(lanes_);
+                stripesInBlock_ = 0;
+            }
+        }
+    }
+
+    Uint64 Hasher::digest() const noexcept
+    {
+        std::array<Uint64, LANE_COUNT> lanes = lanes_;
+        if (buffered_ > 0)
+        {
+            // The zero padding is disambiguated by the length mixed in below
+            std::array<Uint8, STRIPE_SIZE> tail{};
+            std::memcpy(tail.data(), buffer_.data(), buffered_);
+            AccumulateScalar(lanes.data(), tail.data(), SECRET.data() + stripesInBlock_, 1);
+        }
+
+        Uint64 h = totalSize_ * PRIME64_1 ^ seed_;
+        for (size_t i = 0; i < LANE_COUNT; ++i)
+        {
+            h = std::rotl(h ^ Avalanche(lanes[i] ^ SECRET[MERGE_OFFSET + i]), 27) * PRIME64_1 + PRIME64_4;
+        }
+        return Avalanche(h);
+    }
+
+    Uint64 Hash64(const void* data, const size_t size, const Uint64 seed) noexcept
+    {
+        Hasher hasher(seed);
+        hasher.update(data, size);
+        return hasher.digest();
+    }
+}
@@ -0,0 +1,87 @@
+﻿//
+// Created by blomq on 2026-10-18.
+//
+
+#include "psyengine/utils/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace psyengine::utils
+{
+    ThreadPool::ThreadPool(size_t threadCount)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+        }
+
+        workers_.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; ++i)
+        {
+            workers_.emplace_back([this](const std::stop_token& stopToken)
+            {
+                workerLoop(stopToken);
+            });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        waitIdle();
+
+        for (auto& worker : workers_)
+        {
+            worker.request_stop();
+        }
+        taskAvailable_.notify_all();
+        workers_.clear();
+    }
+
+    void ThreadPool::submit(std::function<void()> task)
+    {
+        {
+            std::scoped_lock lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+        taskAvailable_.notify_one();
+    }
+
+    void ThreadPool::waitIdle()
+    {
+        std::unique_lock lock(mutex_);
+        idle_.wait(lock, [this]
+        {
+            return tasks_.empty() && activeTasks_ == 0;
+        });
+    }
+
+    void ThreadPool::workerLoop(const std::stop_token& stopToken)
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock lock(mutex_);
+                if (!taskAvailable_.wait(lock, stopToken, [this] { return !tasks_.empty(); }))
+                {
+                    return;
+                }
+
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+                ++activeTasks_;
+            }
+
+            task();
+
+            {
+                std::scoped_lock lock(mutex_);
+                --activeTasks_;
+                if (tasks_.empty() && activeTasks_ == 0)
+                {
+                    idle_.notify_all();
+                }
+            }
+        }
+    }
+}